@@ -0,0 +1,67 @@
+#ifndef AUTOBAUD_H
+#define AUTOBAUD_H
+
+#include <stdint.h>
+
+/**
+ * @file autobaud.h
+ * @brief Public interface for the USART1 automatic baud rate detection.
+ *
+ * The host sends the sync byte 0x55 ('U'). Sent LSB first with its start and
+ * stop bits it toggles the line on every bit, so its five falling edges
+ * (start bit, bits 1, 3, 5 and 7) lie two bit times apart and the first and
+ * last are exactly eight bit times apart.
+ *
+ * The RX pin (PD6) is routed to EXTI line 6 with AFIO_ConfigInterrupt(), and
+ * each falling edge is timestamped from the SysTick counter, which runs at
+ * HCLK. Eight bit times in HCLK cycles, divided by 8, are the USART divisor
+ * itself, so the rate locks at the last edge of the sync byte, within one
+ * character, with no division and no table of standard rates. Non-standard
+ * rates lock just as well.
+ *
+ * Every edge interval must be within 25 % of the first, otherwise the edge
+ * is taken as a new start; bytes other than 0x55 at the wrong rate never get
+ * five evenly spaced falling edges. The receiver is off while searching and
+ * is enabled at the locked rate during bit 7, so the sync byte itself never
+ * reaches the application.
+ *
+ * Interrupt latency cancels out (every edge has the same), but each edge
+ * must be served before the next, two bit times later: up to about 115200
+ * baud on the 24 MHz HSI and twice that at 48 MHz. SYSTICK_Init() and
+ * USART_Init() must be called first.
+ */
+
+// --- TYPES ---
+
+/**
+ * @brief Function run from the EXTI interrupt when the rate is locked.
+ * @param divisor The new divisor, in HCLK cycles per bit.
+ */
+typedef void (*AUTOBAUD_CALLBACK)(uint32_t divisor);
+
+// --- FUNCTION PROTOTYPES ---
+
+/**
+ * @brief Disables the receiver and waits for the sync byte.
+ * @param done Function run when the rate is locked, or NULL.
+ */
+void AUTOBAUD_Start(AUTOBAUD_CALLBACK done);
+
+/**
+ * @brief Stops searching and enables the receiver at the previous rate.
+ */
+void AUTOBAUD_Cancel(void);
+
+/**
+ * @brief Returns 1 once the rate is locked.
+ * @return uint8_t: 1 if locked, 0 while searching or when never started.
+ */
+uint8_t AUTOBAUD_IsLocked(void);
+
+/**
+ * @brief Returns the baud rate the divisor stands for at the current HCLK.
+ * @return uint32_t: The baud rate in bit/s.
+ */
+uint32_t AUTOBAUD_GetBaudRate(void);
+
+#endif /* AUTOBAUD_H */
@@ -0,0 +1,167 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stdint.h>
+#include "TIM/tim.h"
+
+/**
+ * @file capture.h
+ * @brief Public interface for the input capture frequency and duty meter.
+ *
+ * Every edge is captured by the timer and copied by its channel's DMA
+ * request into a circular buffer of 16-bit timestamps; no code runs per
+ * edge. At each counter overflow the timer's update DMA request copies
+ * the capture DMA count, so where the DMA stood at the overflow (a mark) is
+ * exact however late the overflow interrupt runs. That interrupt, once per
+ * 65536 ticks whatever the input does, only files the mark, so the CPU
+ * time spent is the same for a 1 Hz and a 1 MHz input. The measurement itself is computed on request by CAPTURE_Read()
+ * from the newest edges in the buffer, averaged over as many periods as
+ * asked for.
+ *
+ * CAPTURE_MODE_FREQUENCY: the counter runs free and the timestamps are
+ * extended to 32 bits. Consecutive timestamps less than 65536 ticks apart
+ * need nothing but a 16-bit difference; for longer gaps, every overflow
+ * mark that falls between two edges adds 65536 ticks. The marks cover the
+ * last CAPTURE_MARKS overflows, so any input down to tickRate /
+ * (65536 * (CAPTURE_MARKS - 1)) per period is measured, and faster inputs
+ * are limited only by the DMA (use CAPTURE_INPUT_DIVIDER well above 1 MHz).
+ * Any channel 1..4 can be used.
+ *
+ * CAPTURE_MODE_PWM: PWM input on channel 1 or 2. The counter is reset at
+ * each rising edge (slave reset mode), so the channel captures whole
+ * periods, and the other channel of the pair captures the falling edge of
+ * the same pin, i.e. the high time. Both are streamed into their own
+ * buffer. Periods must be shorter than 65536 ticks; a longer one shows up
+ * as an overflow and is reported.
+ *
+ * DMA channels: TIM1 CH1..CH4 use 2, 3, 6 and 4, TIM2 CH1..CH4 use 5, 7, 1
+ * and 7; TIM2 CH1 and TIM1 CH4 share theirs with USART1 RX / TX DMA. The
+ * update request takes channel 5 on TIM1, shared with USART1 RX DMA, and
+ * channel 2 on TIM2, shared with SPI1 RX DMA and a TIM2 stream. The meter owns the timer and its
+ * update interrupt (through TIM_SetHandler()), so on TIM2 it cannot run next
+ * to the Modbus slave or the WS2812 encoder.
+ */
+
+// --- CONFIGURATION ---
+
+/**
+ * @brief Timestamps kept per channel (8..128, a power of two). A reading
+ * averages over at most CAPTURE_BUFFER_SIZE - 1 periods.
+ */
+#ifndef CAPTURE_BUFFER_SIZE
+#define CAPTURE_BUFFER_SIZE 32
+#endif
+
+/**
+ * @brief Counter overflows remembered (2..16, a power of two). Sets the
+ * slowest input CAPTURE_MODE_FREQUENCY can measure.
+ */
+#ifndef CAPTURE_MARKS
+#define CAPTURE_MARKS 8
+#endif
+
+/**
+ * @brief Edges per capture in CAPTURE_MODE_FREQUENCY (1, 2, 4 or 8). Higher
+ * values cut the DMA load for fast inputs.
+ */
+#ifndef CAPTURE_INPUT_DIVIDER
+#define CAPTURE_INPUT_DIVIDER 1
+#endif
+
+/**
+ * @brief Input filter, TIM_CAPTURE_FILTER_2 / 4 / 8 or 0 for none.
+ */
+#ifndef CAPTURE_FILTER
+#define CAPTURE_FILTER 0
+#endif
+
+// --- ENUMERATED TYPES ---
+
+/**
+ * @brief Measurement modes for CAPTURE_Init().
+ */
+typedef enum
+{
+    CAPTURE_MODE_FREQUENCY, /**< Free-running counter, rising edge timestamps extended to 32 bits. */
+    CAPTURE_MODE_PWM        /**< Counter reset at each rising edge; period and high time. */
+} CAPTURE_MODE;
+
+/**
+ * @brief Status codes returned by the meter functions.
+ */
+typedef enum
+{
+    CAPTURE_STATUS_SUCCESS,          /**< Operation completed. */
+    CAPTURE_STATUS_INVALID_ARGUMENT, /**< Channel, mode or number of periods out of range. */
+    CAPTURE_STATUS_NOT_READY,        /**< Not enough edges captured since CAPTURE_Init(). */
+    CAPTURE_STATUS_NO_SIGNAL,        /**< No edge for CAPTURE_MARKS overflows (PWM mode: one). */
+    CAPTURE_STATUS_OUT_OF_RANGE      /**< The periods asked for span more overflows than are remembered. */
+} CAPTURE_STATUS;
+
+// --- TYPES ---
+
+/**
+ * @brief One reading, as filled in by CAPTURE_Read().
+ */
+typedef struct
+{
+    uint32_t ticks;     /**< Counter ticks spanned by the periods. */
+    uint32_t highTicks; /**< Ticks the input was high in those periods (CAPTURE_MODE_PWM only). */
+    uint16_t periods;   /**< Number of input periods averaged. */
+} CAPTURE_RESULT;
+
+// --- FUNCTION PROTOTYPES ---
+
+/**
+ * @brief Sets up the timer, the pin and the DMA channels and starts capturing.
+ * @param timer TIMER1 or TIMER2.
+ * @param channel The input channel (TIM_CHANNEL_1 or TIM_CHANNEL_2 in CAPTURE_MODE_PWM).
+ * @param remap The timer's pin remap (0..3).
+ * @param tickRate Counter ticks per second: the resolution.
+ * @param mode The measurement mode.
+ * @return CAPTURE_STATUS: CAPTURE_STATUS_SUCCESS or CAPTURE_STATUS_INVALID_ARGUMENT.
+ */
+CAPTURE_STATUS CAPTURE_Init(TIM_Typedef *timer, TIM_CHANNEL channel, uint8_t remap, uint32_t tickRate,
+                            CAPTURE_MODE mode);
+
+/**
+ * @brief Stops capturing and releases the timer's update interrupt.
+ */
+void CAPTURE_Stop(void);
+
+/**
+ * @brief Measures the newest captures.
+ * @param captures Number of captures to average over (1..CAPTURE_BUFFER_SIZE - 1).
+ * @param result Receives the reading.
+ * @return CAPTURE_STATUS: CAPTURE_STATUS_SUCCESS or an error code.
+ */
+CAPTURE_STATUS CAPTURE_Read(uint8_t captures, CAPTURE_RESULT *result);
+
+/**
+ * @brief Returns the counter tick rate actually set.
+ * @return uint32_t: Counter ticks per second.
+ */
+uint32_t CAPTURE_GetTickRate(void);
+
+/**
+ * @brief Returns the mean input frequency of a reading.
+ * @param result The reading.
+ * @return uint32_t: Frequency in mHz, 0xFFFFFFFF if above 4.29 MHz.
+ */
+uint32_t CAPTURE_GetFrequency(const CAPTURE_RESULT *result);
+
+/**
+ * @brief Returns the mean input period of a reading.
+ * @param result The reading.
+ * @return uint32_t: Period in ns, 0xFFFFFFFF if above 4.29 s.
+ */
+uint32_t CAPTURE_GetPeriod(const CAPTURE_RESULT *result);
+
+/**
+ * @brief Returns the mean duty cycle of a CAPTURE_MODE_PWM reading.
+ * @param result The reading.
+ * @return uint16_t: High time in 1/100 %, 0..10000.
+ */
+uint16_t CAPTURE_GetDuty(const CAPTURE_RESULT *result);
+
+#endif /* CAPTURE_H */
@@ -0,0 +1,109 @@
+#ifndef CRITICAL_H
+#define CRITICAL_H
+
+#include <stdint.h>
+
+/**
+ * @file critical.h
+ * @brief Public interface for priority-threshold critical sections.
+ *
+ * CRITICAL_Enter() raises PFIC_ITHRESDR so that only interrupts with a PFIC
+ * priority value below the ceiling stay live. Shared state can then be
+ * protected from the handlers that touch it without delaying more urgent ones
+ * (e.g., motor control). CRITICAL_EnterGlobal() clears mstatus.MIE and is
+ * meant for short sequences that must be atomic against everything.
+ *
+ * Both kinds nest: each Enter returns the previous state, which the matching
+ * Exit restores. A threshold section never lowers an already stricter ceiling.
+ *
+ * With CRITICAL_TRACK enabled, the longest section of each kind is recorded
+ * together with the address it was entered from. Times come from the SysTick
+ * counter, which must be running at HCLK, and include any time the section
+ * spent preempted by interrupts above the ceiling.
+ */
+
+// --- CONFIGURATION ---
+
+/**
+ * @brief Set to 1 to compile the blocking-time tracker in. Costs a SysTick
+ * stamp on every Enter and Exit; the benchmark builds of User/main.c need it
+ * in the project defines.
+ */
+#ifndef CRITICAL_TRACK
+#define CRITICAL_TRACK 0
+#endif
+
+/**
+ * @brief Maximum nesting depth followed by the tracker.
+ */
+#ifndef CRITICAL_MAX_NEST
+#define CRITICAL_MAX_NEST 4
+#endif
+
+// --- ENUMERATED TYPES ---
+
+/**
+ * @brief Kind of critical section, used to select tracker statistics.
+ */
+typedef enum
+{
+    CRITICAL_KIND_THRESHOLD, /**< Sections entered with CRITICAL_Enter(). */
+    CRITICAL_KIND_GLOBAL,    /**< Sections entered with CRITICAL_EnterGlobal(). */
+    CRITICAL_KINDS           /**< Number of kinds. */
+} CRITICAL_KIND;
+
+/**
+ * @brief Saved state returned by the Enter functions.
+ */
+typedef uint32_t CRITICAL_STATE;
+
+/**
+ * @brief Worst-case blocking statistics for one kind of section.
+ */
+typedef struct
+{
+    uint32_t count;     /**< Number of sections completed. */
+    uint32_t maxCycles; /**< Longest section, in HCLK cycles. */
+    void *maxSite;      /**< Return address of the CRITICAL_Enter call of the longest section. */
+} CRITICAL_STATS;
+
+// --- FUNCTION PROTOTYPES ---
+
+/**
+ * @brief Masks every interrupt whose PFIC priority value is >= ceiling.
+ * @param ceiling Nonzero IPRIOR value (e.g., PREEMPT_Msk masks the low preemption level).
+ * @return CRITICAL_STATE: The previous threshold, to pass to CRITICAL_Exit().
+ */
+CRITICAL_STATE CRITICAL_Enter(uint8_t ceiling);
+
+/**
+ * @brief Restores the threshold saved by the matching CRITICAL_Enter().
+ * @param state The value returned by CRITICAL_Enter().
+ */
+void CRITICAL_Exit(CRITICAL_STATE state);
+
+/**
+ * @brief Disables every maskable interrupt.
+ * @return CRITICAL_STATE: The previous global enable state, to pass to CRITICAL_ExitGlobal().
+ */
+CRITICAL_STATE CRITICAL_EnterGlobal(void);
+
+/**
+ * @brief Restores the global enable state saved by the matching CRITICAL_EnterGlobal().
+ * @param state The value returned by CRITICAL_EnterGlobal().
+ */
+void CRITICAL_ExitGlobal(CRITICAL_STATE state);
+
+/**
+ * @brief Returns the tracker statistics for one kind of section.
+ * @param kind CRITICAL_KIND_THRESHOLD or CRITICAL_KIND_GLOBAL.
+ * @return const CRITICAL_STATS*: Pointer to the live record.
+ */
+const CRITICAL_STATS *CRITICAL_GetStats(CRITICAL_KIND kind);
+
+/**
+ * @brief Clears the tracker statistics of both kinds.
+ */
+void CRITICAL_ResetStats(void);
+
+#endif /* CRITICAL_H */
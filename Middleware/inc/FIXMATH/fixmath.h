@@ -0,0 +1,238 @@
+#ifndef FIXMATH_H
+#define FIXMATH_H
+
+#include <stdint.h>
+
+/**
+ * @file fixmath.h
+ * @brief Public interface for the multiply-free fixed-point math library.
+ *
+ * RV32EC has no multiply instruction and no FPU, so float math goes through
+ * soft-float and every integer '*' through __mulsi3. The routines here use
+ * shifts, adds and table lookups instead:
+ *   - FIXMATH_SinCos(), FIXMATH_Sin(), FIXMATH_Cos(): CORDIC rotation,
+ *     Q15 results within 1 LSB.
+ *   - FIXMATH_Atan2(): CORDIC vectoring, any input scale, result within 1 LSB
+ *     of FIXMATH_ANGLE.
+ *   - FIXMATH_Sqrt32(), FIXMATH_SqrtQ16(): bitwise integer square root.
+ *   - FIXMATH_IIR1 and FIXMATH_AVERAGE: first-order low-pass with a
+ *     power-of-two coefficient and power-of-two moving average.
+ * Angles are binary angles: the full turn is 65536, so wrap-around is free
+ * and no range reduction by pi is needed.
+ *
+ * FIXMATH_Q16Mul() splits its operands into 16-bit halves, which keeps every
+ * partial product on the short path of the RTLIB __mulsi3 and avoids the
+ * 64-bit __muldi3. Scaling by powers of two (FIXMATH_Q16Scale()) is a shift.
+ *
+ * Tools/fixmath_check.py measures the accuracy against the host libm and,
+ * with an RV32EC build of fixmath.c, the cycle counts against newlib libm on
+ * the simulator of Tools/rtlib_bench.py ('make fixmath-bench'). The cycle
+ * comparison has not been run yet: no speedup over libm is claimed.
+ */
+
+// --- CONFIGURATION ---
+
+/**
+ * @brief CORDIC iterations (at most 18). 16 or more give 1 LSB Q15 accuracy.
+ */
+#ifndef FIXMATH_CORDIC_STEPS
+#define FIXMATH_CORDIC_STEPS 18
+#endif
+
+// --- TYPES ---
+
+/**
+ * @brief Q15 fraction: -1.0 .. 1.0 - 2^-15.
+ */
+typedef int16_t FIXMATH_Q15;
+
+/**
+ * @brief Q16.16 signed fixed point.
+ */
+typedef int32_t FIXMATH_Q16;
+
+/**
+ * @brief Binary angle: 65536 is one full turn (0x4000 = 90 degrees).
+ */
+typedef uint16_t FIXMATH_ANGLE;
+
+/**
+ * @brief First-order IIR low-pass: y += (x - y) / 2^shift.
+ */
+typedef struct
+{
+    int32_t state; /**< Output in Q16 of the input unit, keeps the fraction the shift would drop. */
+    uint8_t shift; /**< Coefficient as a power of two (time constant ~2^shift samples). */
+} FIXMATH_IIR1;
+
+/**
+ * @brief Moving average over 2^order samples, kept as a running sum.
+ */
+typedef struct
+{
+    int16_t *buffer; /**< 2^order samples, supplied by the caller. */
+    int32_t sum;     /**< Sum of the samples in the buffer. */
+    uint8_t order;   /**< Window length as a power of two (at most 16). */
+    uint16_t index;  /**< Next sample to replace. */
+} FIXMATH_AVERAGE;
+
+// --- FUNCTION PROTOTYPES ---
+
+/**
+ * @brief Computes sine and cosine together.
+ * @param angle The angle.
+ * @param sine Receives sin(angle) in Q15, may be NULL.
+ * @param cosine Receives cos(angle) in Q15, may be NULL.
+ */
+void FIXMATH_SinCos(FIXMATH_ANGLE angle, FIXMATH_Q15 *sine, FIXMATH_Q15 *cosine);
+
+/**
+ * @brief Returns sin(angle) in Q15 (1.0 saturates to 32767).
+ * @param angle The angle.
+ * @return FIXMATH_Q15: The sine.
+ */
+FIXMATH_Q15 FIXMATH_Sin(FIXMATH_ANGLE angle);
+
+/**
+ * @brief Returns cos(angle) in Q15 (1.0 saturates to 32767).
+ * @param angle The angle.
+ * @return FIXMATH_Q15: The cosine.
+ */
+FIXMATH_Q15 FIXMATH_Cos(FIXMATH_ANGLE angle);
+
+/**
+ * @brief Returns the angle of the vector (x, y).
+ * @param y The y component, any scale.
+ * @param x The x component, same scale as y.
+ * @return FIXMATH_ANGLE: The angle, 0 for (0, 0).
+ */
+FIXMATH_ANGLE FIXMATH_Atan2(int32_t y, int32_t x);
+
+/**
+ * @brief Returns floor(sqrt(value)).
+ * @param value The radicand.
+ * @return uint16_t: The integer square root.
+ */
+uint16_t FIXMATH_Sqrt32(uint32_t value);
+
+/**
+ * @brief Returns the square root of a Q16.16 value, rounded.
+ * @param value The radicand, 0 for negative values.
+ * @return FIXMATH_Q16: The square root.
+ */
+FIXMATH_Q16 FIXMATH_SqrtQ16(FIXMATH_Q16 value);
+
+/**
+ * @brief Returns a * b in Q16.16, rounded. Wraps on overflow.
+ * @param a First factor.
+ * @param b Second factor.
+ * @return FIXMATH_Q16: The product.
+ */
+FIXMATH_Q16 FIXMATH_Q16Mul(FIXMATH_Q16 a, FIXMATH_Q16 b);
+
+/**
+ * @brief Sets up a low-pass filter.
+ * @param filter The filter.
+ * @param shift Coefficient as a power of two (1..15).
+ * @param initial Initial output.
+ */
+void FIXMATH_IIR1Init(FIXMATH_IIR1 *filter, uint8_t shift, int16_t initial);
+
+/**
+ * @brief Feeds one sample to a low-pass filter.
+ * @param filter The filter.
+ * @param sample The new sample.
+ * @return int16_t: The filtered value.
+ */
+int16_t FIXMATH_IIR1Update(FIXMATH_IIR1 *filter, int16_t sample);
+
+/**
+ * @brief Sets up a moving average and clears its window.
+ * @param average The moving average.
+ * @param buffer Storage for 2^order samples.
+ * @param order Window length as a power of two (0..16).
+ */
+void FIXMATH_AverageInit(FIXMATH_AVERAGE *average, int16_t *buffer, uint8_t order);
+
+/**
+ * @brief Feeds one sample to a moving average.
+ * @param average The moving average.
+ * @param sample The new sample.
+ * @return int16_t: The rounded mean of the window.
+ */
+int16_t FIXMATH_AverageUpdate(FIXMATH_AVERAGE *average, int16_t sample);
+
+// --- INLINE FUNCTIONS ---
+
+/**
+ * @brief Clamps a value to the Q15 range.
+ * @param value The value.
+ * @return FIXMATH_Q15: The saturated value.
+ */
+static inline FIXMATH_Q15 FIXMATH_Q15Sat(int32_t value)
+{
+    if (value > INT16_MAX)
+        return INT16_MAX;
+    if (value < INT16_MIN)
+        return INT16_MIN;
+    return (FIXMATH_Q15)value;
+}
+
+/**
+ * @brief Returns a * b in Q15, rounded and saturated (-1.0 * -1.0 gives 32767).
+ *
+ * The 16 x 16-bit product stays on the short path of __mulsi3.
+ *
+ * @param a First factor.
+ * @param b Second factor.
+ * @return FIXMATH_Q15: The product.
+ */
+static inline FIXMATH_Q15 FIXMATH_Q15Mul(FIXMATH_Q15 a, FIXMATH_Q15 b)
+{
+    return FIXMATH_Q15Sat(((int32_t)a * b + 0x4000) >> 15);
+}
+
+/**
+ * @brief Returns value * 2^shift, rounded to nearest when shifting right. Wraps on overflow.
+ * @param value The value.
+ * @param shift Power of two (-31..31).
+ * @return FIXMATH_Q16: The scaled value.
+ */
+static inline FIXMATH_Q16 FIXMATH_Q16Scale(FIXMATH_Q16 value, int8_t shift)
+{
+    if (shift >= 0)
+        return (FIXMATH_Q16)((uint32_t)value << shift);
+    return (FIXMATH_Q16)((uint32_t)value + (1UL << (-shift - 1))) >> -shift;
+}
+
+// --- MACROS ---
+
+/**
+ * @brief Converts an integer constant or variable to Q16.16.
+ */
+#define FIXMATH_Q16_FROM_INT(x) ((FIXMATH_Q16)((uint32_t)(x) << 16))
+
+/**
+ * @brief Converts Q16.16 to an integer, rounding halves up.
+ *
+ * The rounding bit is added after the shift, so values near INT32_MAX cannot
+ * overflow. x is evaluated twice.
+ */
+#define FIXMATH_Q16_TO_INT(x) ((int32_t)((FIXMATH_Q16)(x) >> 16) + (int32_t)(((uint32_t)(x) >> 15) & 1U))
+
+/**
+ * @brief Converts a floating-point constant to Q16.16 at compile time.
+ */
+#define FIXMATH_Q16_CONST(x) ((FIXMATH_Q16)((x) * 65536.0 + ((x) >= 0 ? 0.5 : -0.5)))
+
+/**
+ * @brief Converts a floating-point constant to Q15 at compile time.
+ */
+#define FIXMATH_Q15_CONST(x) ((FIXMATH_Q15)((x) * 32768.0 + ((x) >= 0 ? 0.5 : -0.5)))
+
+/**
+ * @brief Converts a floating-point constant in degrees to a FIXMATH_ANGLE at compile time.
+ */
+#define FIXMATH_ANGLE_DEG(x) ((FIXMATH_ANGLE)((int32_t)((x) * 65536.0 / 360.0 + 0.5)))
+
+#endif /* FIXMATH_H */
@@ -0,0 +1,179 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stdint.h>
+#include "SYSTICK/systick_reg.h"
+#include "TIM/tim_reg.h"
+
+/**
+ * @file latency.h
+ * @brief Public interface for the interrupt latency and jitter measurement harness.
+ *
+ * The SysTick counter, free-running at HCLK, is sampled at the trigger point
+ * (e.g., right before EXTI_SWInterruptTrigger()) and again as the first
+ * statement of the handler. The difference in core cycles is accumulated into
+ * a LATENCY_STATS record: sample count, min, max, sum for the mean and a
+ * fixed-width histogram. Several records can be kept side by side to compare
+ * nesting, priority, HPE or VTF settings.
+ *
+ * Wake-up latency from an external edge cannot be stamped in software, so
+ * the edge is timestamped in hardware instead: PD2 is both TIM1 CH1, captured
+ * at HCLK, and EXTI line 2. LATENCY_MeasureEventWake() and
+ * LATENCY_MeasureInterruptWake() compare waking on the event line with the
+ * interrupt path for the same edges, fed to PD2 by any pulse source.
+ */
+
+// --- CONFIGURATION ---
+
+/**
+ * @brief Number of histogram bins. The last bin also collects every larger sample.
+ */
+#ifndef LATENCY_HIST_BINS
+#define LATENCY_HIST_BINS 16
+#endif
+
+/**
+ * @brief Histogram bin width as a power of two, in cycles (2 -> 4 cycles per bin).
+ */
+#ifndef LATENCY_HIST_SHIFT
+#define LATENCY_HIST_SHIFT 2
+#endif
+
+// --- TYPES ---
+
+/**
+ * @brief Accumulated latency statistics, in HCLK cycles.
+ */
+typedef struct
+{
+    uint32_t count;                    /**< Number of samples. */
+    uint32_t min;                      /**< Smallest latency seen. */
+    uint32_t max;                      /**< Largest latency seen. */
+    uint32_t sum;                      /**< Sum of all samples, for the mean. */
+    uint16_t hist[LATENCY_HIST_BINS];  /**< Sample count per bin. */
+} LATENCY_STATS;
+
+/**
+ * @brief Character output used by LATENCY_Dump() (e.g., a UART transmit routine).
+ */
+typedef void (*LATENCY_PUTC)(char c);
+
+/**
+ * @brief Counter value captured by LATENCY_MarkTrigger(). Do not access directly.
+ */
+extern volatile uint32_t latencyTriggerStamp;
+
+// --- FUNCTION PROTOTYPES ---
+
+/**
+ * @brief Starts the SysTick counter free-running at HCLK (if not already running)
+ * and calibrates the cost of a trigger/entry stamp pair.
+ */
+void LATENCY_Init(void);
+
+/**
+ * @brief Clears a statistics record.
+ * @param stats The record to clear.
+ */
+void LATENCY_Reset(LATENCY_STATS *stats);
+
+/**
+ * @brief Adds one sample to a statistics record.
+ *
+ * The calibrated stamping cost is subtracted before the sample is accumulated.
+ * @param stats The record to update.
+ * @param cycles The raw counter difference between trigger and entry stamps.
+ */
+void LATENCY_Record(LATENCY_STATS *stats, uint32_t cycles);
+
+/**
+ * @brief Returns the mean latency of a record, in cycles.
+ * @param stats The record to read.
+ * @return uint32_t: sum / count, or 0 if the record is empty.
+ */
+uint32_t LATENCY_GetMean(const LATENCY_STATS *stats);
+
+/**
+ * @brief Writes a record as text: one summary line and one line per histogram bin.
+ * @param stats The record to dump.
+ * @param putChar Character output function.
+ */
+void LATENCY_Dump(const LATENCY_STATS *stats, LATENCY_PUTC putChar);
+
+/**
+ * @brief Returns the calibrated cost of a stamp pair, subtracted from every sample.
+ * @return uint32_t: Overhead in cycles.
+ */
+uint32_t LATENCY_GetOverhead(void);
+
+/**
+ * @brief Sets up TIM1 free-running at HCLK with CH1 capturing rising edges on
+ * PD2, and EXTI line 2 on the rising edge of PD2.
+ *
+ * Takes TIM1 and EXTI line 2 over for the wake-up measurements.
+ */
+void LATENCY_EdgeInit(void);
+
+/**
+ * @brief Adds one edge-to-entry sample, read from TIM1, to a statistics record.
+ *
+ * The stamping overhead is not subtracted: the edge is stamped in hardware.
+ * @param stats The record to update.
+ * @param cycles Cycles from the captured edge to the entry stamp.
+ */
+void LATENCY_RecordEdge(LATENCY_STATS *stats, uint16_t cycles);
+
+/**
+ * @brief Sleeps on EXTI event line 2 and records the cycles from each edge to
+ * the first instruction after the sleep. LATENCY_EdgeInit() must be called first.
+ * @param stats The record to update.
+ * @param samples Number of edges to wait for.
+ */
+void LATENCY_MeasureEventWake(LATENCY_STATS *stats, uint16_t samples);
+
+/**
+ * @brief Sleeps with EXTI interrupt line 2 enabled and records the cycles from
+ * each edge to the start of its callback in the EXTI7_0 dispatcher.
+ * LATENCY_EdgeInit() must be called first and interrupts enabled globally.
+ * @param stats The record to update.
+ * @param samples Number of edges to wait for.
+ */
+void LATENCY_MeasureInterruptWake(LATENCY_STATS *stats, uint16_t samples);
+
+// --- INLINE FUNCTIONS ---
+
+/**
+ * @brief Stamps the trigger point. Call immediately before raising the interrupt.
+ */
+static inline void LATENCY_MarkTrigger(void)
+{
+    latencyTriggerStamp = SYSTICK->CNT;
+}
+
+/**
+ * @brief Stamps handler entry and records the latency since the last trigger.
+ *
+ * Must be the first statement of the handler under test.
+ * @param stats The record to update.
+ */
+static inline void LATENCY_MarkEntry(LATENCY_STATS *stats)
+{
+    uint32_t now = SYSTICK->CNT;
+
+    LATENCY_Record(stats, now - latencyTriggerStamp);
+}
+
+/**
+ * @brief Stamps entry against the last edge on PD2 and records the latency.
+ *
+ * Must be the first statement after the wake-up or of the handler under test.
+ * @param stats The record to update.
+ */
+static inline void LATENCY_MarkEdge(LATENCY_STATS *stats)
+{
+    uint16_t now = (uint16_t)TIMER1->CNT;
+
+    LATENCY_RecordEdge(stats, (uint16_t)(now - TIMER1->CHCVR[0]));
+}
+
+#endif /* LATENCY_H */
@@ -0,0 +1,148 @@
+#ifndef MODBUS_H
+#define MODBUS_H
+
+#include <stdint.h>
+
+/**
+ * @file modbus.h
+ * @brief Public interface for the Modbus RTU slave on USART1.
+ *
+ * Frame boundaries are found in hardware time, not by polling: the USART
+ * receive hook stores each byte, folds it into the CRC and restarts TIM2,
+ * which runs as a one-pulse timer with 1 us ticks. When it expires, t3.5 of
+ * silence have passed and TIM2_IRQHandler ends the frame. A byte that comes
+ * after more than t1.5 of silence, but before t3.5, marks the frame as
+ * broken (the counter value at that byte tells the gap). Above 19200 baud
+ * the fixed 750 us / 1750 us of the specification are used.
+ *
+ * The CRC-16 is computed byte by byte on the receive path with a 256-entry
+ * table (512 bytes of flash), a shift, an XOR and a load per byte. When t3.5
+ * expires the frame is already checked: a valid frame leaves a CRC of 0, so
+ * validation at the frame end is a compare, well inside the turnaround
+ * window at 115200 baud on the 24 MHz HSI.
+ *
+ * Valid frames for this slave (or broadcast, address 0) are executed by
+ * MODBUS_Poll() from the main loop against the register map, and the
+ * response is built in the receive buffer and sent from there. Supported
+ * functions: 0x03 Read Holding Registers, 0x04 Read Input Registers,
+ * 0x06 Write Single Register and 0x10 Write Multiple Registers. A request
+ * must lie inside one region of the map, otherwise exception 0x02 is
+ * returned. Broadcast writes are executed without a response.
+ *
+ * The slave owns USART1 (through USART_SetRxHook()) and TIM2 (through
+ * TIM_SetHandler()) and needs USART_RX_DMA set to 0; with DMA receive the
+ * module is left out of the build. The link is 8N1; masters set to even
+ * parity must be configured for no parity. RS-485 driver enable is not
+ * handled.
+ */
+
+// --- CONFIGURATION ---
+
+/**
+ * @brief Receive and response buffer size in bytes (8..256). 256 holds any
+ * Modbus RTU frame; a smaller buffer limits the registers per request.
+ */
+#ifndef MODBUS_BUFFER_SIZE
+#define MODBUS_BUFFER_SIZE 256
+#endif
+
+// --- ENUMERATED TYPES ---
+
+/**
+ * @brief Status codes returned by MODBUS_Init().
+ */
+typedef enum
+{
+    MODBUS_STATUS_SUCCESS,         /**< Slave running. */
+    MODBUS_STATUS_INVALID_ADDRESS, /**< Slave address outside 1..247. */
+    MODBUS_STATUS_INVALID_BAUD     /**< Baud rate below 600 or out of range for the USART. */
+} MODBUS_STATUS;
+
+/**
+ * @brief Modbus exception codes, returned to the master.
+ */
+typedef enum
+{
+    MODBUS_EXCEPTION_NONE,                 /**< No exception. */
+    MODBUS_EXCEPTION_ILLEGAL_FUNCTION,     /**< Function code not supported. */
+    MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS, /**< Register range not inside one region. */
+    MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE,   /**< Bad quantity, byte count or frame length. */
+    MODBUS_EXCEPTION_DEVICE_FAILURE        /**< Reported by a write callback. */
+} MODBUS_EXCEPTION;
+
+// --- TYPES ---
+
+/**
+ * @brief A run of consecutive registers in the register map.
+ */
+typedef struct MODBUS_REGION
+{
+    uint16_t start;  /**< Modbus address of the first register. */
+    uint16_t count;  /**< Number of registers. */
+    uint16_t *data;  /**< The register values, count entries. */
+
+    /**
+     * @brief Called from MODBUS_Poll() after a write stored new values
+     * (holding regions only, may be NULL).
+     * @param region This region.
+     * @param offset Index of the first written register in data.
+     * @param count Number of written registers.
+     * @return MODBUS_EXCEPTION: MODBUS_EXCEPTION_NONE, or an exception for the master.
+     */
+    MODBUS_EXCEPTION (*written)(const struct MODBUS_REGION *region, uint16_t offset, uint16_t count);
+} MODBUS_REGION;
+
+/**
+ * @brief Register map: tables of holding and input register regions.
+ */
+typedef struct
+{
+    const MODBUS_REGION *holding; /**< Read / write registers (functions 0x03, 0x06, 0x10). */
+    uint8_t holdingCount;         /**< Number of holding regions. */
+    const MODBUS_REGION *input;   /**< Read-only registers (function 0x04). */
+    uint8_t inputCount;           /**< Number of input regions. */
+} MODBUS_MAP;
+
+/**
+ * @brief Frame counters.
+ */
+typedef struct
+{
+    uint32_t requests;   /**< Valid frames for this slave or broadcast. */
+    uint32_t crcErrors;  /**< Frames with a bad CRC. */
+    uint32_t gapErrors;  /**< Frames broken by a t1.5 gap, a framing error or an overrun. */
+    uint32_t overflows;  /**< Frames longer than MODBUS_BUFFER_SIZE. */
+    uint32_t exceptions; /**< Exception responses sent. */
+} MODBUS_STATS;
+
+// --- FUNCTION PROTOTYPES ---
+
+/**
+ * @brief Sets up USART1, TIM2 and the register map and starts listening.
+ * @param slaveAddress This slave's address (1..247).
+ * @param baudRate Baud rate in bit/s.
+ * @param map The register map; must stay valid.
+ * @return MODBUS_STATUS: MODBUS_STATUS_SUCCESS or an error code.
+ */
+MODBUS_STATUS MODBUS_Init(uint8_t slaveAddress, uint32_t baudRate, const MODBUS_MAP *map);
+
+/**
+ * @brief Executes a received request and starts its response.
+ */
+void MODBUS_Poll(void);
+
+/**
+ * @brief Computes the Modbus CRC-16 of a buffer.
+ * @param data The bytes.
+ * @param length Number of bytes.
+ * @return uint16_t: The CRC, sent low byte first.
+ */
+uint16_t MODBUS_Crc16(const uint8_t *data, uint16_t length);
+
+/**
+ * @brief Copies the frame counters.
+ * @param stats Receives the counters.
+ */
+void MODBUS_GetStats(MODBUS_STATS *stats);
+
+#endif /* MODBUS_H */
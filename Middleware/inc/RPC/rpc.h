@@ -0,0 +1,190 @@
+#ifndef RPC_H
+#define RPC_H
+
+#include <stdint.h>
+
+/**
+ * @file rpc.h
+ * @brief Public interface for the COBS-framed binary RPC layer over USART1.
+ *
+ * Frame, before COBS encoding (multi-byte fields little-endian):
+ *   request:  seq (1) | command (1) | payload (0..RPC_PAYLOAD_SIZE) | CRC-16 (2)
+ *   response: seq (1) | status (1)  | payload (0..RPC_PAYLOAD_SIZE) | CRC-16 (2)
+ * Each frame is COBS encoded and ends with a 0x00 delimiter. The CRC is
+ * CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF) over seq,
+ * command / status and payload. The response echoes the request's seq.
+ *
+ * Frames are limited to 254 decoded bytes, so COBS adds exactly one code byte
+ * and every code byte stands where a zero byte was. Decoding and encoding
+ * are therefore done in place: a request's codes are turned back into zeros
+ * where it was received and the handler reads the payload there. With
+ * USART_RX_DMA that is the DMA buffer itself for a frame within one receive
+ * view; a frame that spans views or the wrap of the buffer is copied into a
+ * receive buffer first. With the RX ring, USART_Read() copies the bytes into
+ * the receive buffer, and only a partial frame left at its end is moved back
+ * to its start. The handler writes its reply into a transmit buffer, which is
+ * encoded in place and sent from there as a USART_WriteChain() segment.
+ *
+ * The command byte indexes the table given to RPC_Init(); the length limits
+ * in the table are checked before the handler runs. Requests may be
+ * pipelined: the host sends several frames without waiting, and RPC_Poll()
+ * answers them in order while the previous responses are still being sent,
+ * up to RPC_TX_BUFFERS at a time. Further requests wait in the USART driver.
+ *
+ * A frame with a bad CRC or a broken COBS code is dropped without a response
+ * and counted; the host sees a timeout for its seq. A frame longer than the
+ * receive buffer is dropped up to the next delimiter. A lone 0x00 is ignored,
+ * so a host may send one first to end any partial frame.
+ *
+ * Tools/rpc_client.py is the host side; Tools/rpc_loopback.py builds this
+ * file for the host and runs the client against it over a pty.
+ */
+
+// --- CONFIGURATION ---
+
+/**
+ * @brief Largest decoded frame in bytes, seq and CRC included (5..254).
+ */
+#ifndef RPC_FRAME_SIZE
+#define RPC_FRAME_SIZE 64
+#endif
+
+/**
+ * @brief Number of response buffers (RPC_FRAME_SIZE + 2 bytes each), i.e.
+ * responses in flight at once. Only 1 is used without USART_TX_DMA.
+ */
+#ifndef RPC_TX_BUFFERS
+#define RPC_TX_BUFFERS 2
+#endif
+
+// --- ENUMERATED TYPES ---
+
+/**
+ * @brief Status byte of a response. Handlers may return their own codes from
+ * RPC_STATUS_USER up.
+ */
+typedef enum
+{
+    RPC_STATUS_SUCCESS,          /**< Command executed. */
+    RPC_STATUS_UNKNOWN_COMMAND,  /**< No handler for the command byte. */
+    RPC_STATUS_INVALID_LENGTH,   /**< Payload length outside the table limits. */
+    RPC_STATUS_INVALID_ARGUMENT, /**< Payload rejected by the handler. */
+    RPC_STATUS_USER = 0x80       /**< First application-defined status. */
+} RPC_STATUS;
+
+// --- TYPES ---
+
+/**
+ * @brief Command handler.
+ *
+ * @param request The request payload, inside the receive buffer or the DMA
+ * receive view. Only valid until the handler returns.
+ * @param length Payload length, within the table limits.
+ * @param response Response payload buffer, RPC_PAYLOAD_SIZE bytes.
+ * @param responseLength Set to the response payload length (0 on entry).
+ * @return uint8_t: Status byte of the response (RPC_STATUS or a user code).
+ */
+typedef uint8_t (*RPC_HANDLER)(const uint8_t *request, uint8_t length, uint8_t *response, uint8_t *responseLength);
+
+/**
+ * @brief Command table entry; the command byte is the entry's index.
+ */
+typedef struct
+{
+    RPC_HANDLER handler; /**< NULL for an unused command. */
+    uint8_t minLength;   /**< Shortest accepted request payload. */
+    uint8_t maxLength;   /**< Longest accepted request payload. */
+} RPC_COMMAND;
+
+/**
+ * @brief Frame counters.
+ */
+typedef struct
+{
+    uint32_t requests;  /**< Valid requests answered. */
+    uint32_t crcErrors; /**< Frames dropped for a bad CRC or COBS code, or shorter than 4 bytes. */
+    uint32_t overflows; /**< Frames dropped for being longer than RPC_FRAME_SIZE. */
+} RPC_STATS;
+
+// --- FUNCTION PROTOTYPES ---
+
+/**
+ * @brief Sets the command table and empties the receive buffer.
+ * @param table Command table, indexed by the command byte.
+ * @param count Number of entries.
+ */
+void RPC_Init(const RPC_COMMAND *table, uint8_t count);
+
+/**
+ * @brief Receives pending bytes and answers every complete request that has a free response buffer.
+ */
+void RPC_Poll(void);
+
+/**
+ * @brief Computes the CRC-16/CCITT-FALSE of a buffer.
+ * @param data The bytes.
+ * @param length Number of bytes.
+ * @return uint16_t: The CRC.
+ */
+uint16_t RPC_Crc16(const uint8_t *data, uint16_t length);
+
+/**
+ * @brief Copies the frame counters.
+ * @param stats Receives the counters.
+ */
+void RPC_GetStats(RPC_STATS *stats);
+
+// --- INLINE FUNCTIONS ---
+
+/**
+ * @brief Reads a little-endian 16-bit field of a payload (any alignment).
+ * @param data First byte of the field.
+ * @return uint16_t: The value.
+ */
+static inline uint16_t RPC_GetU16(const uint8_t *data)
+{
+    return (uint16_t)(data[0] | (data[1] << 8));
+}
+
+/**
+ * @brief Reads a little-endian 32-bit field of a payload (any alignment).
+ * @param data First byte of the field.
+ * @return uint32_t: The value.
+ */
+static inline uint32_t RPC_GetU32(const uint8_t *data)
+{
+    return data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+/**
+ * @brief Writes a little-endian 16-bit field of a payload (any alignment).
+ * @param data First byte of the field.
+ * @param value The value.
+ */
+static inline void RPC_PutU16(uint8_t *data, uint16_t value)
+{
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)(value >> 8);
+}
+
+/**
+ * @brief Writes a little-endian 32-bit field of a payload (any alignment).
+ * @param data First byte of the field.
+ * @param value The value.
+ */
+static inline void RPC_PutU32(uint8_t *data, uint32_t value)
+{
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)(value >> 8);
+    data[2] = (uint8_t)(value >> 16);
+    data[3] = (uint8_t)(value >> 24);
+}
+
+// --- MACROS ---
+
+/**
+ * @brief Largest request or response payload in bytes.
+ */
+#define RPC_PAYLOAD_SIZE (RPC_FRAME_SIZE - 4)
+
+#endif /* RPC_H */
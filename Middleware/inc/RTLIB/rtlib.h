@@ -0,0 +1,84 @@
+#ifndef RTLIB_H
+#define RTLIB_H
+
+#include <stdint.h>
+
+/**
+ * @file rtlib.h
+ * @brief Divide-by-constant helpers of the project runtime library.
+ *
+ * Middleware/src/RTLIB replaces the libgcc and newlib-nano routines the
+ * compiler calls on RV32EC, where there is no multiply or divide instruction:
+ *   - rtlib_arith.S: __mulsi3, __udivsi3, __umodsi3, __divsi3, __modsi3, with
+ *     early exits for small operands.
+ *   - rtlib_mem.S: memcpy, memmove, memset, word-wise once the destination
+ *     is aligned. Only assembled with RTLIB_MEM_ENABLE set to 1 (assembler
+ *     define, default 0): turn it on once 'make rtlib-bench' against the
+ *     toolchain's libc_nano.a shows no size or alignment case slower.
+ * They are picked up by the linker ahead of the libraries, so no call site
+ * changes. Tools/rtlib_bench.py runs both sets on a simulated RV32EC core and
+ * compares their cycle counts.
+ *
+ * The compiler still turns a division by a constant into a __udivsi3 call
+ * (a reciprocal multiply would need __mulsi3 as well). The helpers below
+ * divide by 10, 100 and 1000 with shifts and adds only, for digit conversion
+ * and cycle-to-time scaling in hot paths. They are exact for every uint32_t.
+ */
+
+// --- INLINE FUNCTIONS ---
+
+/**
+ * @brief Returns n / 10.
+ *
+ * Builds n * 0.8 from shifted copies, divides by 8 and corrects the
+ * estimate, which is low by at most one, from the remainder.
+ *
+ * @param n The dividend.
+ * @return uint32_t: The quotient.
+ */
+static inline uint32_t RTLIB_DivU10(uint32_t n)
+{
+    uint32_t q = (n >> 1) + (n >> 2);
+    uint32_t r;
+
+    q += q >> 4;
+    q += q >> 8;
+    q += q >> 16;
+    q >>= 3;
+    r = n - (((q << 2) + q) << 1);
+
+    return q + (r > 9);
+}
+
+/**
+ * @brief Returns n / 100.
+ *
+ * Builds n * 0.64 from shifted copies, divides by 64 and corrects the
+ * estimate from the remainder.
+ *
+ * @param n The dividend.
+ * @return uint32_t: The quotient.
+ */
+static inline uint32_t RTLIB_DivU100(uint32_t n)
+{
+    uint32_t q = (n >> 1) + (n >> 3) + (n >> 6) - (n >> 10) + (n >> 12) + (n >> 13) - (n >> 16);
+    uint32_t r;
+
+    q += q >> 20;
+    q >>= 6;
+    r = n - ((q << 6) + (q << 5) + (q << 2));
+
+    return q + ((r + 28) >> 7);
+}
+
+/**
+ * @brief Returns n / 1000, as (n / 100) / 10.
+ * @param n The dividend.
+ * @return uint32_t: The quotient.
+ */
+static inline uint32_t RTLIB_DivU1000(uint32_t n)
+{
+    return RTLIB_DivU10(RTLIB_DivU100(n));
+}
+
+#endif /* RTLIB_H */
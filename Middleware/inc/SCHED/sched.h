@@ -0,0 +1,122 @@
+#ifndef SCHED_H
+#define SCHED_H
+
+#include <stdint.h>
+
+/**
+ * @file sched.h
+ * @brief Public interface for the single-stack, run-to-completion preemptive scheduler.
+ *
+ * Tasks are plain functions that handle one event and return. They all run on
+ * the main stack, so a task costs only its event ring in RAM instead of a
+ * private stack.
+ *
+ * Each PFIC preemption level has its own dispatch vector: SW_Handler for the
+ * low level (PREEMPT_Msk set) and PFIC_IRQ_SW2 for the high level. A task runs
+ * inside the vector of its level, at that level's hardware priority.
+ *
+ * The module is compiled out unless SCHED_ENABLE is set. Define it
+ * project-wide: it also turns on PFIC_SW2_ENABLE, which hands the
+ * PFIC_SW2_IRQ vector (I2C1 error by default) over to the scheduler.
+ *
+ * - Posting from the main loop or an interrupt handler pends the target's
+ *   vector, which dispatches every ready task of its level that outranks the
+ *   task it interrupted. A high-level task therefore preempts a running
+ *   low-level task as soon as the posting handler returns.
+ * - Posting from a task to a higher-priority task of the same level preempts
+ *   the poster right away by running the target as a nested call on the same
+ *   stack. A higher-level target is reached through its vector instead.
+ * - Like two interrupts of the same preemption level, an event posted from an
+ *   interrupt handler to a task of the running task's level waits until that
+ *   task returns, then runs before any lower-priority work of the level.
+ *
+ * Priority 0 is the main loop (idle); tasks use 1..SCHED_MAX_TASKS, higher is
+ * more urgent. Every high-level task must outrank every low-level task.
+ *
+ * Context switch cost can be measured with the LATENCY harness: stamp the
+ * post with LATENCY_MarkTrigger() and the task with LATENCY_MarkEntry() (see
+ * MAIN_SCHED_BENCH in User/main.c).
+ */
+
+// --- CONFIGURATION ---
+
+/**
+ * @brief Set to 1 to compile the scheduler in.
+ */
+#ifndef SCHED_ENABLE
+#define SCHED_ENABLE 0
+#endif
+
+/**
+ * @brief Number of task priorities (at most 8, one task per priority).
+ */
+#ifndef SCHED_MAX_TASKS
+#define SCHED_MAX_TASKS 8
+#endif
+
+/**
+ * @brief Number of queued events per task. Must be a power of two.
+ */
+#ifndef SCHED_QUEUE_DEPTH
+#define SCHED_QUEUE_DEPTH 4
+#endif
+
+// --- ENUMERATED TYPES ---
+
+/**
+ * @brief Status codes returned by the scheduler functions.
+ */
+typedef enum
+{
+    SCHED_STATUS_SUCCESS, /**< Operation completed successfully. */
+    SCHED_STATUS_FULL,    /**< The task's event ring is full, event dropped. */
+    SCHED_STATUS_FAILURE  /**< Invalid priority or task not created. */
+} SCHED_STATUS;
+
+/**
+ * @brief Event delivered to a task.
+ */
+typedef uint8_t SCHED_EVENT;
+
+/**
+ * @brief Task body. Runs to completion for every event.
+ * @param event The event that was posted.
+ */
+typedef void (*SCHED_TASK_FN)(SCHED_EVENT event);
+
+// --- FUNCTION PROTOTYPES ---
+
+/**
+ * @brief Installs the scheduler on SW_Handler and PFIC_IRQ_SW2 and enables both.
+ *
+ * @note This replaces any SW_Handler hook set by WORKQ_Init(WORKQ_DRAIN_SW).
+ */
+void SCHED_Init(void);
+
+/**
+ * @brief Registers a task.
+ * @param prio Task priority (1..SCHED_MAX_TASKS), unique per task.
+ * @param fn Task body.
+ * @param pficPrio PFIC priority byte of the task. PREEMPT_Msk selects the
+ *        level; the most urgent byte given for a level becomes its vector's
+ *        priority (e.g., PREEMPT_Msk | SUBPRIO_Msk to run below every interrupt).
+ * @return SCHED_STATUS: SCHED_STATUS_SUCCESS or SCHED_STATUS_FAILURE on an invalid
+ *         priority or a level that does not follow the task priorities.
+ */
+SCHED_STATUS SCHED_CreateTask(uint8_t prio, SCHED_TASK_FN fn, uint8_t pficPrio);
+
+/**
+ * @brief Posts an event to a task. Safe to call from tasks, handlers and the main loop.
+ * @param prio Priority of the target task.
+ * @param event The event to deliver.
+ * @return SCHED_STATUS: SCHED_STATUS_SUCCESS, SCHED_STATUS_FULL or SCHED_STATUS_FAILURE.
+ */
+SCHED_STATUS SCHED_Post(uint8_t prio, SCHED_EVENT event);
+
+/**
+ * @brief Returns the priority of the task currently running (0 in the main loop).
+ * @return uint8_t: Current priority.
+ */
+uint8_t SCHED_GetCurrentPriority(void);
+
+#endif /* SCHED_H */
@@ -0,0 +1,69 @@
+#ifndef STACK_H
+#define STACK_H
+
+#include <stdint.h>
+
+/**
+ * @file stack.h
+ * @brief Public interface for the stack high-water mark and overflow guard.
+ *
+ * handle_reset paints the whole .stack region (_susrstack.._eusrstack) with
+ * STACK_PAINT before main(). The stack grows down from _eusrstack, so the
+ * deepest point ever reached is the lowest word that no longer holds the
+ * pattern.
+ *
+ * The lowest STACK_GUARD_BYTES of the region form a guard zone. STACK_Check(),
+ * called periodically (e.g., from the main loop or a timer tick), reports an
+ * overflow as soon as anything is written into the guard zone, i.e. before the
+ * stack runs past _susrstack into .noinit and .bss.
+ *
+ * The static worst case per entry point is reported by the stack-report make
+ * target (see makefile.targets and Tools/stack_report.py).
+ */
+
+// --- CONFIGURATION ---
+
+/**
+ * @brief Fill pattern written by handle_reset. Must match Startup/startup_ch32v00x.S.
+ */
+#define STACK_PAINT 0xA5A5A5A5UL
+
+/**
+ * @brief Size of the guard zone at the bottom of the stack, in bytes (multiple of 4).
+ */
+#ifndef STACK_GUARD_BYTES
+#define STACK_GUARD_BYTES 16
+#endif
+
+// --- ENUMERATED TYPES ---
+
+/**
+ * @brief Status codes returned by STACK_Check().
+ */
+typedef enum
+{
+    STACK_STATUS_OK,      /**< Guard zone intact. */
+    STACK_STATUS_OVERFLOW /**< Guard zone written or stack pointer inside it. */
+} STACK_STATUS;
+
+// --- FUNCTION PROTOTYPES ---
+
+/**
+ * @brief Returns the size of the .stack region.
+ * @return uint32_t: Size in bytes.
+ */
+uint32_t STACK_GetSize(void);
+
+/**
+ * @brief Returns the deepest stack usage since reset.
+ * @return uint32_t: High-water mark in bytes, measured from _eusrstack.
+ */
+uint32_t STACK_GetHighWater(void);
+
+/**
+ * @brief Checks the guard zone and the current stack pointer.
+ * @return STACK_STATUS: STACK_STATUS_OK or STACK_STATUS_OVERFLOW.
+ */
+STACK_STATUS STACK_Check(void);
+
+#endif /* STACK_H */
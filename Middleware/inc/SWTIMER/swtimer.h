@@ -0,0 +1,114 @@
+#ifndef SWTIMER_H
+#define SWTIMER_H
+
+#include <stdint.h>
+
+/**
+ * @file swtimer.h
+ * @brief Public interface for the tickless software timer service.
+ *
+ * Timers live in a static pool and are kept in a hashed timing wheel of
+ * SWTIMER_SLOTS slots, one millisecond per slot. Each slot is a doubly linked
+ * list, so starting and stopping a timer is O(1).
+ *
+ * There is no periodic tick. The SysTick alarm is armed for the nearest
+ * deadline only, and the expired timers are run from SysTick_Handler when it
+ * fires. Stopping a timer never re-arms the alarm, which at worst causes one
+ * wake-up with nothing to do. Sleeps longer than SWTIMER_MAX_SLEEP_MS are
+ * split, so a long timer costs one wake-up per SWTIMER_MAX_SLEEP_MS.
+ *
+ * Callbacks run in interrupt context at the SysTick priority and must be
+ * short; heavier work can be posted to the work queue. SYSTICK_Init() must be
+ * called before SWTIMER_Init().
+ */
+
+// --- CONFIGURATION ---
+
+/**
+ * @brief Number of timers in the pool (at most 255).
+ */
+#ifndef SWTIMER_COUNT
+#define SWTIMER_COUNT 32
+#endif
+
+/**
+ * @brief Number of wheel slots. Must be a power of two no larger than 32.
+ */
+#ifndef SWTIMER_SLOTS
+#define SWTIMER_SLOTS 32
+#endif
+
+/**
+ * @brief Longest single sleep, in ms. Keeps ms * cycles-per-ms within 32 bits up to 71 MHz.
+ */
+#ifndef SWTIMER_MAX_SLEEP_MS
+#define SWTIMER_MAX_SLEEP_MS 60000
+#endif
+
+// --- ENUMERATED TYPES ---
+
+/**
+ * @brief Status codes returned by the timer functions.
+ */
+typedef enum
+{
+    SWTIMER_STATUS_SUCCESS, /**< Operation completed. */
+    SWTIMER_STATUS_FAILURE  /**< Invalid timer ID. */
+} SWTIMER_STATUS;
+
+// --- TYPES ---
+
+/**
+ * @brief Timer handle returned by SWTIMER_Create().
+ */
+typedef uint8_t SWTIMER_ID;
+
+/**
+ * @brief Value returned by SWTIMER_Create() when the pool is exhausted.
+ */
+#define SWTIMER_INVALID 0xFF
+
+/**
+ * @brief Expiry callback, run from SysTick_Handler.
+ */
+typedef void (*SWTIMER_FN)(uint32_t arg);
+
+// --- FUNCTION PROTOTYPES ---
+
+/**
+ * @brief Resets the pool and the wheel.
+ */
+void SWTIMER_Init(void);
+
+/**
+ * @brief Allocates a timer from the pool. The timer is created stopped.
+ * @param fn Function to run on expiry.
+ * @param arg Argument passed to fn.
+ * @return SWTIMER_ID: The timer handle, or SWTIMER_INVALID if the pool is full.
+ */
+SWTIMER_ID SWTIMER_Create(SWTIMER_FN fn, uint32_t arg);
+
+/**
+ * @brief Starts or restarts a timer.
+ * @param id The timer handle.
+ * @param delayMs Time to the first expiry, in ms (0 is treated as 1).
+ * @param periodMs Reload period in ms, or 0 for a one-shot timer.
+ * @return SWTIMER_STATUS: SWTIMER_STATUS_SUCCESS or SWTIMER_STATUS_FAILURE.
+ */
+SWTIMER_STATUS SWTIMER_Start(SWTIMER_ID id, uint32_t delayMs, uint32_t periodMs);
+
+/**
+ * @brief Stops a timer. Stopping a stopped timer is not an error.
+ * @param id The timer handle.
+ * @return SWTIMER_STATUS: SWTIMER_STATUS_SUCCESS or SWTIMER_STATUS_FAILURE.
+ */
+SWTIMER_STATUS SWTIMER_Stop(SWTIMER_ID id);
+
+/**
+ * @brief Reports whether a timer is running.
+ * @param id The timer handle.
+ * @return uint8_t: 1 if running, 0 if stopped or invalid.
+ */
+uint8_t SWTIMER_IsActive(SWTIMER_ID id);
+
+#endif /* SWTIMER_H */
@@ -0,0 +1,101 @@
+#ifndef WORKQ_H
+#define WORKQ_H
+
+#include <stdint.h>
+
+/**
+ * @file workq.h
+ * @brief Public interface for the deferred work queue (ISR bottom halves).
+ *
+ * Interrupt handlers post small work items (a function pointer and a 32-bit
+ * argument) and return immediately. The items are executed later, either from
+ * the main loop or from the SW_Handler software interrupt, at a priority below
+ * every peripheral interrupt.
+ *
+ * There is one single-producer/single-consumer ring per PFIC preemption level.
+ * Handlers of the same preemption level never nest, so each ring has exactly
+ * one writer at a time and needs no locking.
+ */
+
+// --- CONFIGURATION ---
+
+/**
+ * @brief Number of items per ring. Must be a power of two (8 bytes per item).
+ */
+#ifndef WORKQ_DEPTH
+#define WORKQ_DEPTH 8
+#endif
+
+// --- ENUMERATED TYPES ---
+
+/**
+ * @brief Ring selection, matching the preemption level of the posting handler.
+ */
+typedef enum
+{
+    WORKQ_LEVEL_HIGH, /**< Posted from handlers with preemption bit 0. */
+    WORKQ_LEVEL_LOW,  /**< Posted from handlers with preemption bit 1. */
+    WORKQ_LEVELS      /**< Number of rings. */
+} WORKQ_LEVEL;
+
+/**
+ * @brief Context in which queued work is executed.
+ */
+typedef enum
+{
+    WORKQ_DRAIN_MAIN, /**< The main loop calls WORKQ_Drain(). */
+    WORKQ_DRAIN_SW    /**< Posting pends SW_Handler, which drains the rings. */
+} WORKQ_DRAIN;
+
+/**
+ * @brief Status codes returned by the work queue functions.
+ */
+typedef enum
+{
+    WORKQ_STATUS_SUCCESS, /**< Item queued. */
+    WORKQ_STATUS_FULL     /**< Ring full, item dropped. */
+} WORKQ_STATUS;
+
+/**
+ * @brief Deferred work function.
+ * @param arg The 32-bit argument given to WORKQ_Post().
+ */
+typedef void (*WORKQ_FN)(uint32_t arg);
+
+// --- FUNCTION PROTOTYPES ---
+
+/**
+ * @brief Selects where queued work is executed.
+ *
+ * In WORKQ_DRAIN_SW mode the software interrupt is given the lowest priority
+ * and enabled.
+ *
+ * @param drainMode WORKQ_DRAIN_MAIN or WORKQ_DRAIN_SW.
+ */
+void WORKQ_Init(WORKQ_DRAIN drainMode);
+
+/**
+ * @brief Queues a work item. Safe to call from any interrupt handler.
+ * @param level The ring matching the caller's preemption level.
+ * @param fn The function to execute later.
+ * @param arg The argument passed to fn.
+ * @return WORKQ_STATUS_SUCCESS, or WORKQ_STATUS_FULL if the ring has no free slot.
+ */
+WORKQ_STATUS WORKQ_Post(WORKQ_LEVEL level, WORKQ_FN fn, uint32_t arg);
+
+/**
+ * @brief Executes every queued item, high level first.
+ *
+ * Must only be called from one context (the main loop in WORKQ_DRAIN_MAIN mode).
+ * @return uint32_t: The number of items executed.
+ */
+uint32_t WORKQ_Drain(void);
+
+/**
+ * @brief Returns the number of items dropped because a ring was full.
+ * @param level The ring to query.
+ * @return uint32_t: Dropped item count since reset.
+ */
+uint32_t WORKQ_GetDropCount(WORKQ_LEVEL level);
+
+#endif /* WORKQ_H */
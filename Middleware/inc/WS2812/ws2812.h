@@ -0,0 +1,118 @@
+#ifndef WS2812_H
+#define WS2812_H
+
+#include <stdint.h>
+
+/**
+ * @file ws2812.h
+ * @brief Public interface for the WS2812 / SK6812 LED strip encoder.
+ *
+ * Each bit on the strip is one 800 kHz TIM2 PWM period whose high time
+ * encodes the bit (0.35 us for 0, 0.7 us for 1). The compare values are
+ * streamed into the channel's compare register by the TIM2 update DMA
+ * request (DMA1 channel 2), so no CPU time is spent per bit.
+ *
+ * The pixels stay bit-packed in the caller's buffer (3 or 4 bytes per LED,
+ * in wire order). Only a small circular DMA buffer of one compare byte per
+ * bit is kept, split in two halves of WS2812_DMA_LEDS LEDs each: the DMA
+ * half and full transfer interrupts re-encode the half that was just sent
+ * from the next pixels, once per WS2812_DMA_LEDS LEDs. With the defaults
+ * that is 96 bytes of RAM instead of 24 per LED.
+ *
+ * After the last pixel the line is held low for WS2812_RESET_US, so the
+ * strip latches the frame before WS2812_IsBusy() clears. The encoder owns
+ * TIM2 and cannot be used together with the Modbus slave.
+ *
+ * The module is compiled out unless WS2812_ENABLE is set: its handler
+ * overrides the DMA1 channel 2 vector, which other TIM2 update or TIM1 CH1
+ * DMA users need, and it keeps the handler, the encoder and the DMA buffer
+ * in RAM.
+ */
+
+// --- CONFIGURATION ---
+
+/**
+ * @brief Set to 1 to build the encoder and its DMA1_Channel2_IRQHandler.
+ */
+#ifndef WS2812_ENABLE
+#define WS2812_ENABLE 0
+#endif
+
+/**
+ * @brief TIM2 channel driving the strip (TIM_CHANNEL_1..TIM_CHANNEL_4).
+ */
+#ifndef WS2812_CHANNEL
+#define WS2812_CHANNEL TIM_CHANNEL_1
+#endif
+
+/**
+ * @brief TIM2 pin remap (0..3), default channel 1 on PD4.
+ */
+#ifndef WS2812_REMAP
+#define WS2812_REMAP 0
+#endif
+
+/**
+ * @brief Bytes per LED: 3 for WS2812 / SK6812 RGB (G, R, B), 4 for SK6812 RGBW (G, R, B, W).
+ */
+#ifndef WS2812_BYTES_PER_LED
+#define WS2812_BYTES_PER_LED 3
+#endif
+
+/**
+ * @brief LEDs per half of the DMA buffer. Larger halves mean fewer
+ * interrupts and more RAM (2 * 8 * WS2812_BYTES_PER_LED bytes per LED).
+ */
+#ifndef WS2812_DMA_LEDS
+#define WS2812_DMA_LEDS 2
+#endif
+
+/**
+ * @brief Low time after a frame, in us. 280 covers the newer WS2812B parts; older ones need 50.
+ */
+#ifndef WS2812_RESET_US
+#define WS2812_RESET_US 280
+#endif
+
+// --- ENUMERATED TYPES ---
+
+/**
+ * @brief Status codes returned by the strip functions.
+ */
+typedef enum
+{
+    WS2812_STATUS_SUCCESS,      /**< Operation completed. */
+    WS2812_STATUS_BUSY,         /**< A frame is still being sent. */
+    WS2812_STATUS_INVALID_CLOCK /**< HCLK does not give an 800 kHz period of 10..255 ticks. */
+} WS2812_STATUS;
+
+// --- FUNCTION PROTOTYPES ---
+
+/**
+ * @brief Sets up TIM2, its pin and the DMA channel for a strip.
+ * @param pixels The pixel buffer, count * WS2812_BYTES_PER_LED bytes; must stay valid.
+ * @param count Number of LEDs.
+ * @return WS2812_STATUS: WS2812_STATUS_SUCCESS or WS2812_STATUS_INVALID_CLOCK.
+ */
+WS2812_STATUS WS2812_Init(uint8_t *pixels, uint16_t count);
+
+/**
+ * @brief Stores one LED's colour in the pixel buffer, in wire order.
+ * @param index LED index.
+ * @param color 0xWWRRGGBB (white only used with 4 bytes per LED).
+ */
+void WS2812_SetPixel(uint16_t index, uint32_t color);
+
+/**
+ * @brief Starts sending the pixel buffer to the strip.
+ * @return WS2812_STATUS: WS2812_STATUS_SUCCESS or WS2812_STATUS_BUSY.
+ */
+WS2812_STATUS WS2812_Show(void);
+
+/**
+ * @brief Returns 1 until the frame is sent and latched.
+ * @return uint8_t: 1 while busy, 0 when the pixel buffer may be changed again.
+ */
+uint8_t WS2812_IsBusy(void);
+
+#endif /* WS2812_H */
@@ -0,0 +1,160 @@
+#include <stddef.h>
+#include "AUTOBAUD/autobaud.h"
+#include "EXTI/exti.h"
+#include "GPIO/afio.h"
+#include "PFIC/pfic.h"
+#include "SYS/sys.h"
+#include "SYSTICK/systick.h"
+#include "USART/usart.h"
+
+// Falling edges of the sync byte 0x55, and the bit times between the first and last
+#define AUTOBAUD_EDGES 5
+#define AUTOBAUD_BITS_SHIFT 3
+
+/**
+ * @brief Detector state, shared by the EXTI callback and the API.
+ */
+typedef enum
+{
+    AUTOBAUD_STATE_IDLE,      /**< Never started, or cancelled. */
+    AUTOBAUD_STATE_SEARCHING, /**< Timestamping falling edges on RX. */
+    AUTOBAUD_STATE_LOCKED     /**< Divisor programmed, receiver enabled. */
+} AUTOBAUD_STATE;
+
+static volatile AUTOBAUD_STATE autobaudState;
+static AUTOBAUD_CALLBACK autobaudDone;
+
+// SysTick counter at the first and at the latest falling edge
+static uint32_t autobaudFirst;
+static uint32_t autobaudLast;
+
+// HCLK cycles between the first two edges (two bit times)
+static uint32_t autobaudPeriod;
+static uint8_t autobaudEdges;
+
+/**
+ * @brief Stops edge detection on the RX pin.
+ */
+static void AUTOBAUD_Disarm(void)
+{
+    EXTI_InterruptInit(EXTI_INT_EVEN_DISABLE, EXTI_INT_EVEN_MR6);
+    EXTI_EdgeTriggerConfig(EXTI_INT_EVEN_DISABLE, EXTI_EDGETRG_EN_FALL, EXTI_EDGETRG_TR6);
+    EXTI_RegisterCallback(EXTI_INT_EVEN_MR6, NULL);
+}
+
+/**
+ * @brief EXTI line 6 callback: timestamps a falling edge on RX.
+ *
+ * Placed in RAM so the time from the edge to the counter read does not vary
+ * with flash wait states.
+ */
+static HIGHCODE void AUTOBAUD_Edge(void)
+{
+    uint32_t now = SYSTICK->CNT;
+    uint32_t interval = now - autobaudLast;
+    uint32_t divisor;
+
+    autobaudLast = now;
+
+    if (autobaudEdges == 0)
+    {
+        autobaudFirst = now;
+        autobaudEdges = 1;
+        return;
+    }
+
+    if (autobaudEdges == 1)
+    {
+        autobaudPeriod = interval;
+    }
+    else if (interval - autobaudPeriod + (autobaudPeriod >> 2) > (autobaudPeriod >> 1))
+    {
+        // Off by more than 25 %: not a sync byte, this edge may start one
+        autobaudFirst = now;
+        autobaudEdges = 1;
+        return;
+    }
+
+    if (++autobaudEdges < AUTOBAUD_EDGES)
+        return;
+
+    // Eight bit times, rounded to cycles per bit
+    divisor = (now - autobaudFirst + (1 << (AUTOBAUD_BITS_SHIFT - 1))) >> AUTOBAUD_BITS_SHIFT;
+    autobaudEdges = 0;
+    if (USART_SetDivisor(divisor) != USART_STATUS_SUCCESS)
+        return;
+
+    AUTOBAUD_Disarm();
+    USART_SetReceiver(1);
+    autobaudState = AUTOBAUD_STATE_LOCKED;
+
+    if (autobaudDone != NULL)
+        autobaudDone(divisor);
+}
+
+/**
+ * @brief Disables the receiver and waits for the sync byte.
+ *
+ * Can be called again at any time, for instance after a link timeout, to
+ * follow a host that changed its rate.
+ *
+ * @param done Function run from the EXTI interrupt when the rate is locked, or NULL.
+ */
+void AUTOBAUD_Start(AUTOBAUD_CALLBACK done)
+{
+    AUTOBAUD_Disarm();
+    USART_SetReceiver(0);
+
+    autobaudDone = done;
+    autobaudEdges = 0;
+    autobaudState = AUTOBAUD_STATE_SEARCHING;
+
+    // The AFIO clock is enabled by SystemInit()
+    AFIO_ConfigInterrupt(AFIO_EXTI_GPIO_GPIOD, GPIO_PIN_6);
+    EXTI_ClearInterruptFlag(EXTI_CLR_INT_FLAG_IF6);
+    EXTI_RegisterCallback(EXTI_INT_EVEN_MR6, AUTOBAUD_Edge);
+    EXTI_EdgeTriggerConfig(EXTI_INT_EVEN_ENABLE, EXTI_EDGETRG_EN_FALL, EXTI_EDGETRG_TR6);
+    EXTI_InterruptInit(EXTI_INT_EVEN_ENABLE, EXTI_INT_EVEN_MR6);
+    PFIC_EnableIRQ(PFIC_IRQ_EXTI7_0);
+}
+
+/**
+ * @brief Stops searching and enables the receiver at the previous rate.
+ */
+void AUTOBAUD_Cancel(void)
+{
+    uint32_t irqState = PFIC_DisableGlobalIRQ();
+
+    if (autobaudState == AUTOBAUD_STATE_SEARCHING)
+    {
+        AUTOBAUD_Disarm();
+        autobaudState = AUTOBAUD_STATE_IDLE;
+        USART_SetReceiver(1);
+    }
+
+    PFIC_RestoreGlobalIRQ(irqState);
+}
+
+/**
+ * @brief Returns 1 once the rate is locked.
+ * @return uint8_t: 1 if locked, 0 while searching or when never started.
+ */
+uint8_t AUTOBAUD_IsLocked(void)
+{
+    return autobaudState == AUTOBAUD_STATE_LOCKED;
+}
+
+/**
+ * @brief Returns the baud rate the divisor stands for at the current HCLK.
+ *
+ * HCLK is taken from SysTick, which caches it; rcc.h cannot be included
+ * next to afio.h, as both define AFIO.
+ *
+ * @return uint32_t: The baud rate in bit/s.
+ */
+uint32_t AUTOBAUD_GetBaudRate(void)
+{
+    uint32_t divisor = USART_GetDivisor();
+
+    return (SYSTICK_GetClock() + (divisor >> 1)) / divisor;
+}
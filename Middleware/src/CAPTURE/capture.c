@@ -0,0 +1,483 @@
+#include <stddef.h>
+#include <string.h>
+#include "CAPTURE/capture.h"
+#include "DMA/dma.h"
+#include "GPIO/afio.h"
+#include "PFIC/pfic.h"
+#include "TIM/tim.h"
+
+#if CAPTURE_BUFFER_SIZE < 8 || CAPTURE_BUFFER_SIZE > 128 || (CAPTURE_BUFFER_SIZE & (CAPTURE_BUFFER_SIZE - 1))
+#error "CAPTURE_BUFFER_SIZE must be a power of two within 8..128"
+#endif
+
+#if CAPTURE_MARKS < 2 || CAPTURE_MARKS > 16 || (CAPTURE_MARKS & (CAPTURE_MARKS - 1))
+#error "CAPTURE_MARKS must be a power of two within 2..16"
+#endif
+
+#if CAPTURE_INPUT_DIVIDER == 1
+#define CAPTURE_DIVIDER_OPTION 0
+#elif CAPTURE_INPUT_DIVIDER == 2
+#define CAPTURE_DIVIDER_OPTION TIM_CAPTURE_DIV2
+#elif CAPTURE_INPUT_DIVIDER == 4
+#define CAPTURE_DIVIDER_OPTION TIM_CAPTURE_DIV4
+#elif CAPTURE_INPUT_DIVIDER == 8
+#define CAPTURE_DIVIDER_OPTION TIM_CAPTURE_DIV8
+#else
+#error "CAPTURE_INPUT_DIVIDER must be 1, 2, 4 or 8"
+#endif
+
+#define CAPTURE_INDEX_MASK (CAPTURE_BUFFER_SIZE - 1)
+#define CAPTURE_COUNTER_PERIOD 0x10000UL
+
+// Capture count of a counter period in which the DMA may have gone round the whole buffer
+#define CAPTURE_MANY 0xFF
+
+// Flag polls that outlast the DMA serving a pending capture request
+#define CAPTURE_DMA_WAIT 8
+
+/**
+ * @brief Where the DMA stood at one counter overflow.
+ */
+typedef struct
+{
+    uint8_t position; /**< Buffer index of the first capture after the overflow. */
+    uint8_t count;    /**< Captures since the previous overflow, or CAPTURE_MANY. */
+} CAPTURE_MARK;
+
+static TIM_Typedef *captureTimer;
+static TIM_CHANNEL captureChannel;
+static CAPTURE_MODE captureMode;
+static uint32_t captureTickRate;
+
+// Timestamps (CAPTURE_MODE_FREQUENCY) or periods (CAPTURE_MODE_PWM) of the input channel
+static volatile uint16_t captureValues[CAPTURE_BUFFER_SIZE];
+
+// High times captured by the paired channel (CAPTURE_MODE_PWM)
+static volatile uint16_t captureHigh[CAPTURE_BUFFER_SIZE];
+
+// Ring of the last CAPTURE_MARKS overflows, indexed by the overflow count
+static CAPTURE_MARK captureMarks[CAPTURE_MARKS];
+static volatile uint32_t captureOverflows;
+
+// Captures before the newest overflow, saturating at CAPTURE_BUFFER_SIZE
+static volatile uint8_t captureTotal;
+
+// Count of the input channel's DMA at the last update event, copied there by
+// the update DMA request
+static volatile uint16_t captureSnapshot;
+
+/**
+ * @brief Returns the buffer index the DMA of a channel writes next.
+ */
+static inline uint8_t CAPTURE_Position(TIM_CHANNEL channel)
+{
+    return (uint8_t)((CAPTURE_BUFFER_SIZE - DMA_GetRemaining(TIM_GetCaptureDmaChannel(captureTimer, channel))) &
+                     CAPTURE_INDEX_MASK);
+}
+
+/**
+ * @brief Returns 1 if the DMA passed both the middle and the end of the
+ * buffer since the flags were last cleared, so it may have gone all the way
+ * round.
+ */
+static inline uint8_t CAPTURE_MayHaveLapped(uint32_t flags)
+{
+    return (flags & (DMA_FLAG_HALF | DMA_FLAG_COMPLETE)) == (DMA_FLAG_HALF | DMA_FLAG_COMPLETE);
+}
+
+/**
+ * @brief Timer update handler: records an overflow mark.
+ *
+ * The mark is not taken from where the DMA stands now, but from the count
+ * the update DMA request copied at the overflow itself, so edges that
+ * arrive before this handler runs are on the right side of it. The update
+ * request outranks the capture request, so the only captures that can
+ * reach the buffer after the copy and still belong to the old period are
+ * those latched in its last ticks, whose DMA request was still waiting.
+ * They hold values near 65535, above the counter read here, and the mark is
+ * moved past them. Before the buffer is looked at, the channel's capture
+ * flag is polled until the DMA has read the capture register, so no
+ * capture latched before the counter read is still on its way. The DMA
+ * half and full flags are only used to see whether the DMA went round the
+ * buffer since the last mark; no DMA interrupt is enabled.
+ *
+ * Also called by CAPTURE_Read() for an overflow whose interrupt is still
+ * pending; the interrupt then finds the flag cleared and returns.
+ *
+ * @param flags Pending timer flags (only the update flag is enabled).
+ */
+static void CAPTURE_Overflow(uint32_t flags)
+{
+    DMA_CHANNEL dma = TIM_GetCaptureDmaChannel(captureTimer, captureChannel);
+    CAPTURE_MARK *mark = &captureMarks[captureOverflows & (CAPTURE_MARKS - 1)];
+    uint8_t previous = captureMarks[(captureOverflows - 1) & (CAPTURE_MARKS - 1)].position;
+    uint32_t dmaFlags;
+    uint8_t position;
+    uint8_t live;
+    uint16_t now;
+    uint8_t count;
+
+    if (!(flags & TIM_FLAG_UPDATE))
+        return;
+
+    now = TIM_GetCounter(captureTimer);
+
+    // A capture latched before now may still wait for the DMA; its flag clears when the DMA reads it
+    for (uint8_t wait = 0; wait < CAPTURE_DMA_WAIT && (TIM_GetFlags(captureTimer) & (TIM_FLAG_CC1 << captureChannel));
+         wait++)
+        ;
+
+    dmaFlags = DMA_GetFlags(dma);
+    DMA_ClearFlags(dma, dmaFlags);
+    position = (uint8_t)((CAPTURE_BUFFER_SIZE - captureSnapshot) & CAPTURE_INDEX_MASK);
+    live = CAPTURE_Position(captureChannel);
+
+    // In PWM mode the values are periods, and an overflow is out of range anyway
+    while (captureMode == CAPTURE_MODE_FREQUENCY && position != live && captureValues[position] > now)
+        position = (uint8_t)((position + 1) & CAPTURE_INDEX_MASK);
+
+    if (captureOverflows == 0)
+        previous = 0;
+    count = (uint8_t)((position - previous) & CAPTURE_INDEX_MASK);
+    if (CAPTURE_MayHaveLapped(dmaFlags))
+        count = CAPTURE_MANY;
+
+    mark->position = position;
+    mark->count = count;
+
+    if (count == CAPTURE_MANY || captureTotal + count >= CAPTURE_BUFFER_SIZE)
+        captureTotal = CAPTURE_BUFFER_SIZE;
+    else
+        captureTotal += count;
+
+    captureOverflows++;
+}
+
+/**
+ * @brief Returns the value captured age captures ago (0 = newest).
+ * @param values The buffer.
+ * @param position Buffer index the DMA writes next.
+ * @param age Captures back from the newest.
+ */
+static inline uint16_t CAPTURE_Value(const volatile uint16_t *values, uint8_t position, uint16_t age)
+{
+    return values[(position - 1 - age) & CAPTURE_INDEX_MASK];
+}
+
+/**
+ * @brief Returns a * b, built with shifts and adds.
+ */
+static uint64_t CAPTURE_Multiply(uint32_t a, uint32_t b)
+{
+    uint64_t addend = a;
+    uint64_t product = 0;
+
+    for (; b != 0; b >>= 1, addend <<= 1)
+    {
+        if (b & 1)
+            product += addend;
+    }
+
+    return product;
+}
+
+/**
+ * @brief Returns a * b / (c * d), rounded and saturated to 32 bits.
+ *
+ * The 64-bit quotient is built bit by bit with a restoring division, so
+ * neither the 64-bit multiply nor the 64-bit divide of libgcc is pulled in.
+ * Only used for the unit conversions, not on the capture path.
+ */
+static uint32_t CAPTURE_Ratio(uint32_t a, uint32_t b, uint32_t c, uint32_t d)
+{
+    uint64_t divisor = CAPTURE_Multiply(c, d);
+    uint64_t dividend;
+    uint64_t remainder = 0;
+    uint64_t quotient = 0;
+
+    if (divisor == 0)
+        return 0xFFFFFFFF;
+
+    dividend = CAPTURE_Multiply(a, b) + (divisor >> 1);
+
+    for (uint8_t bit = 0; bit < 64; bit++)
+    {
+        remainder = (remainder << 1) | (dividend >> 63);
+        dividend <<= 1;
+        quotient <<= 1;
+
+        if (remainder >= divisor)
+        {
+            remainder -= divisor;
+            quotient |= 1;
+        }
+    }
+
+    return quotient > 0xFFFFFFFF ? 0xFFFFFFFF : (uint32_t)quotient;
+}
+
+/**
+ * @brief Sets up the timer, the pin and the DMA channels and starts capturing.
+ *
+ * The counter runs over its full 16 bits at the tick rate nearest to
+ * tickRate (see CAPTURE_GetTickRate()). A higher rate gives a finer
+ * reading; in CAPTURE_MODE_PWM it must still leave each input period below
+ * 65536 ticks. The remap is applied with AFIO_PinRemap(); the AFIO clock is
+ * enabled by SystemInit().
+ *
+ * @param timer TIMER1 or TIMER2.
+ * @param channel The input channel (TIM_CHANNEL_1 or TIM_CHANNEL_2 in CAPTURE_MODE_PWM).
+ * @param remap The timer's pin remap (0..3).
+ * @param tickRate Counter ticks per second: the resolution.
+ * @param mode The measurement mode.
+ * @return CAPTURE_STATUS: CAPTURE_STATUS_SUCCESS or CAPTURE_STATUS_INVALID_ARGUMENT.
+ */
+CAPTURE_STATUS CAPTURE_Init(TIM_Typedef *timer, TIM_CHANNEL channel, uint8_t remap, uint32_t tickRate,
+                            CAPTURE_MODE mode)
+{
+    TIM_CHANNEL partner = (TIM_CHANNEL)(channel ^ 0x01);
+    uint16_t prescaler = TIM_GetPrescaler(tickRate);
+
+    if (channel > TIM_CHANNEL_4 || remap > 3 || (mode == CAPTURE_MODE_PWM && channel > TIM_CHANNEL_2))
+        return CAPTURE_STATUS_INVALID_ARGUMENT;
+
+    captureTimer = timer;
+    captureChannel = channel;
+    captureMode = mode;
+    captureTickRate = TIM_GetTickRate(prescaler);
+    captureOverflows = 0;
+    captureTotal = 0;
+    captureSnapshot = CAPTURE_BUFFER_SIZE;
+
+    AFIO_PinRemap(timer == TIMER1 ? AFIO_RM_TMI1_RM : AFIO_RM_TIM2_RM, (AFIO_MAP)remap);
+    TIM_TimeBaseInit(timer, prescaler, 0xFFFF, mode == CAPTURE_MODE_PWM ? TIM_MODE_UPDATE_ON_OVERFLOW : 0);
+    TIM_CapturePinInit(timer, channel, remap);
+
+    if (mode == CAPTURE_MODE_PWM)
+    {
+        TIM_CaptureInit(timer, channel, CAPTURE_FILTER);
+        TIM_CaptureInit(timer, partner, TIM_CAPTURE_INDIRECT | TIM_CAPTURE_FALLING);
+        TIM_SetSlaveMode(timer, channel == TIM_CHANNEL_1 ? TIM_TRIGGER_TI1FP1 : TIM_TRIGGER_TI2FP2, TIM_SLAVE_RESET);
+        TIM_CaptureDmaInit(timer, partner, DMA_MODE_CIRCULAR | DMA_MODE_PRIORITY_HIGH);
+        TIM_CaptureStart(timer, partner, captureHigh, CAPTURE_BUFFER_SIZE);
+    }
+    else
+    {
+        TIM_CaptureInit(timer, channel, CAPTURE_DIVIDER_OPTION | CAPTURE_FILTER);
+        TIM_SetSlaveMode(timer, TIM_TRIGGER_ITR0, TIM_SLAVE_DISABLED);
+    }
+
+    TIM_CaptureDmaInit(timer, channel, DMA_MODE_CIRCULAR | DMA_MODE_PRIORITY_HIGH);
+    TIM_CaptureStart(timer, channel, captureValues, CAPTURE_BUFFER_SIZE);
+
+    // Each update copies the input channel's DMA count, ahead of a capture requested at the same time
+    DMA_ChannelInit(TIM_GetUpdateDmaChannel(timer), DMA_MODE_CIRCULAR | DMA_MODE_SIZE_16 | DMA_MODE_PRIORITY_VERY_HIGH,
+                    &DMA_CHANNEL_REGS(TIM_GetCaptureDmaChannel(timer, channel))->CNTR);
+    DMA_ChannelStart(TIM_GetUpdateDmaChannel(timer), &captureSnapshot, 1);
+
+    TIM_SetHandler(timer, CAPTURE_Overflow);
+    TIM_EnableInterrupts(timer, TIM_IRQ_UPDATE | TIM_DMA_UPDATE);
+    PFIC_EnableIRQ(timer == TIMER1 ? PFIC_IRQ_TIM1_UP : PFIC_IRQ_TIM2);
+    TIM_Start(timer);
+
+    return CAPTURE_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Stops capturing and releases the timer's update interrupt.
+ */
+void CAPTURE_Stop(void)
+{
+    if (captureTimer == NULL)
+        return;
+
+    TIM_Stop(captureTimer);
+    TIM_DisableInterrupts(captureTimer,
+                          TIM_IRQ_UPDATE | TIM_DMA_UPDATE | TIM_DMA_CC1 | TIM_DMA_CC2 | TIM_DMA_CC3 | TIM_DMA_CC4);
+    DMA_ChannelStop(TIM_GetUpdateDmaChannel(captureTimer));
+    TIM_CaptureStop(captureTimer, captureChannel);
+    if (captureMode == CAPTURE_MODE_PWM)
+        TIM_CaptureStop(captureTimer, (TIM_CHANNEL)(captureChannel ^ 0x01));
+    TIM_SetHandler(captureTimer, NULL);
+    captureTimer = NULL;
+}
+
+/**
+ * @brief Measures the newest captures.
+ *
+ * The overflow marks are walked from the newest back, each one placed by
+ * the captures counted since it, until one lies before the oldest capture
+ * used. The cost depends on captures and CAPTURE_MARKS only.
+ *
+ * CAPTURE_MODE_FREQUENCY: the span from the oldest to the newest timestamp
+ * is their 16-bit difference plus one counter period for each wrap between
+ * two consecutive timestamps (the later one is smaller) and for each
+ * further overflow between them. An overflow that falls where the
+ * timestamps show no wrap stands for a gap of more than a counter period.
+ * Where the DMA may have gone round the buffer within one counter period,
+ * the marks before that point are not used: the input is fast there, and
+ * only a burst followed by a gap of more than a counter period within the
+ * same reading would be measured short.
+ *
+ * CAPTURE_MODE_PWM: the captured periods and high times are summed. An
+ * overflow among them means a period of 65536 ticks or more, which the
+ * captured value does not hold.
+ *
+ * @param captures Number of captures to average over (1..CAPTURE_BUFFER_SIZE - 1).
+ * @param result Receives the reading.
+ * @return CAPTURE_STATUS: CAPTURE_STATUS_SUCCESS or an error code.
+ */
+CAPTURE_STATUS CAPTURE_Read(uint8_t captures, CAPTURE_RESULT *result)
+{
+    CAPTURE_MARK marks[CAPTURE_MARKS];
+    uint32_t overflows;
+    uint32_t irqState;
+    uint32_t dmaFlags;
+    uint32_t wraps = 0;
+    uint32_t ticks = 0;
+    uint32_t highTicks = 0;
+    uint16_t since;
+    uint16_t pair = 0;
+    uint8_t position;
+    uint8_t total;
+    uint8_t idle = 0;
+    uint8_t i;
+
+    if (captureTimer == NULL || captures == 0 || captures >= CAPTURE_BUFFER_SIZE)
+        return CAPTURE_STATUS_INVALID_ARGUMENT;
+
+    irqState = PFIC_DisableGlobalIRQ();
+
+    // An overflow whose interrupt has not run yet is marked here first
+    if (TIM_GetFlags(captureTimer) & TIM_FLAG_UPDATE)
+    {
+        TIM_ClearFlags(captureTimer, TIM_FLAG_UPDATE);
+        CAPTURE_Overflow(TIM_FLAG_UPDATE);
+    }
+
+    dmaFlags = DMA_GetFlags(TIM_GetCaptureDmaChannel(captureTimer, captureChannel));
+    position = CAPTURE_Position(captureChannel);
+    overflows = captureOverflows;
+    total = captureTotal;
+    memcpy(marks, captureMarks, sizeof(marks));
+    PFIC_RestoreGlobalIRQ(irqState);
+
+    // Captures since the newest overflow (since the start before the first one)
+    since = (uint16_t)((position - (overflows != 0 ? marks[(overflows - 1) & (CAPTURE_MARKS - 1)].position : 0)) &
+                       CAPTURE_INDEX_MASK);
+    if (CAPTURE_MayHaveLapped(dmaFlags))
+        since = CAPTURE_BUFFER_SIZE;
+
+    if ((uint16_t)total + since <= captures)
+        return CAPTURE_STATUS_NOT_READY;
+
+    if (captureMode == CAPTURE_MODE_FREQUENCY)
+    {
+        for (uint8_t age = 0; age < captures; age++)
+        {
+            if (CAPTURE_Value(captureValues, position, age) < CAPTURE_Value(captureValues, position, age + 1))
+                wraps++;
+        }
+    }
+
+    for (i = 0; i < CAPTURE_MARKS && i < overflows && since <= captures; i++)
+    {
+        const CAPTURE_MARK *mark = &marks[(overflows - 1 - i) & (CAPTURE_MARKS - 1)];
+
+        if (since == 0)
+        {
+            idle++;
+        }
+        else if (captureMode == CAPTURE_MODE_PWM)
+        {
+            return CAPTURE_STATUS_OUT_OF_RANGE;
+        }
+        else if (since == pair)
+        {
+            // A further overflow between the same two timestamps
+            wraps++;
+        }
+        else
+        {
+            // The first one is the wrap, unless the timestamps do not show it
+            pair = since;
+            if (CAPTURE_Value(captureValues, position, since - 1) >= CAPTURE_Value(captureValues, position, since))
+                wraps++;
+        }
+
+        if (mark->count == CAPTURE_MANY)
+            break;
+        since += mark->count;
+    }
+
+    if (idle != 0 && (captureMode == CAPTURE_MODE_PWM || idle == CAPTURE_MARKS))
+        return CAPTURE_STATUS_NO_SIGNAL;
+
+    // The next older overflow is not remembered but may lie among the captures
+    if (i == CAPTURE_MARKS && since <= captures)
+        return CAPTURE_STATUS_OUT_OF_RANGE;
+
+    if (captureMode == CAPTURE_MODE_FREQUENCY)
+    {
+        ticks = (uint32_t)CAPTURE_Value(captureValues, position, 0) - CAPTURE_Value(captureValues, position, captures) +
+                wraps * CAPTURE_COUNTER_PERIOD;
+        result->periods = (uint16_t)(captures * CAPTURE_INPUT_DIVIDER);
+    }
+    else
+    {
+        uint8_t highPosition = CAPTURE_Position((TIM_CHANNEL)(captureChannel ^ 0x01));
+
+        for (uint8_t age = 0; age < captures; age++)
+        {
+            ticks += CAPTURE_Value(captureValues, position, age);
+            highTicks += CAPTURE_Value(captureHigh, highPosition, age);
+        }
+        result->periods = captures;
+    }
+
+    result->ticks = ticks;
+    result->highTicks = highTicks;
+
+    return CAPTURE_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Returns the counter tick rate actually set.
+ * @return uint32_t: Counter ticks per second.
+ */
+uint32_t CAPTURE_GetTickRate(void)
+{
+    return captureTickRate;
+}
+
+/**
+ * @brief Returns the mean input frequency of a reading.
+ * @param result The reading.
+ * @return uint32_t: Frequency in mHz, 0xFFFFFFFF if above 4.29 MHz.
+ */
+uint32_t CAPTURE_GetFrequency(const CAPTURE_RESULT *result)
+{
+    return CAPTURE_Ratio(captureTickRate, (uint32_t)result->periods * 1000, result->ticks, 1);
+}
+
+/**
+ * @brief Returns the mean input period of a reading.
+ * @param result The reading.
+ * @return uint32_t: Period in ns, 0xFFFFFFFF if above 4.29 s.
+ */
+uint32_t CAPTURE_GetPeriod(const CAPTURE_RESULT *result)
+{
+    return CAPTURE_Ratio(result->ticks, 1000000000, captureTickRate, result->periods);
+}
+
+/**
+ * @brief Returns the mean duty cycle of a CAPTURE_MODE_PWM reading.
+ * @param result The reading.
+ * @return uint16_t: High time in 1/100 %, 0..10000.
+ */
+uint16_t CAPTURE_GetDuty(const CAPTURE_RESULT *result)
+{
+    uint32_t duty = CAPTURE_Ratio(result->highTicks, 10000, result->ticks, 1);
+
+    return (uint16_t)(duty > 10000 ? 10000 : duty);
+}
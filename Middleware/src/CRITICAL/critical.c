@@ -0,0 +1,160 @@
+#include "CRITICAL/critical.h"
+#include "PFIC/pfic.h"
+#include "SYSTICK/systick_reg.h"
+
+#if CRITICAL_TRACK
+
+// Entry stamp and call site per nesting level, used as a LIFO stack
+static uint32_t criticalStamp[CRITICAL_MAX_NEST];
+static void *criticalSite[CRITICAL_MAX_NEST];
+static volatile uint8_t criticalDepth;
+
+static CRITICAL_STATS criticalStats[CRITICAL_KINDS];
+
+/**
+ * @brief Pushes the entry time and call site of a section.
+ *
+ * A handler that preempts this sequence pushes and pops its own sections
+ * before returning, so the depth counter stays consistent without locking.
+ */
+static void CRITICAL_TrackEnter(void *site)
+{
+    uint8_t depth = criticalDepth++;
+
+    if (depth < CRITICAL_MAX_NEST)
+    {
+        criticalStamp[depth] = SYSTICK->CNT;
+        criticalSite[depth] = site;
+    }
+}
+
+/**
+ * @brief Pops a section and updates the worst case of its kind.
+ */
+static void CRITICAL_TrackExit(CRITICAL_KIND kind)
+{
+    uint8_t depth = --criticalDepth;
+
+    if (depth < CRITICAL_MAX_NEST)
+    {
+        uint32_t cycles = SYSTICK->CNT - criticalStamp[depth];
+        CRITICAL_STATS *stats = &criticalStats[kind];
+
+        stats->count++;
+        if (cycles > stats->maxCycles)
+        {
+            stats->maxCycles = cycles;
+            stats->maxSite = criticalSite[depth];
+        }
+    }
+}
+
+#endif /* CRITICAL_TRACK */
+
+/**
+ * @brief Masks every interrupt whose PFIC priority value is >= ceiling.
+ *
+ * The threshold is only written when it is stricter than the current one, so a
+ * nested section with a looser ceiling cannot re-open interrupts. The register
+ * is read back to make sure the new threshold is in effect before returning.
+ *
+ * @param ceiling Nonzero IPRIOR value.
+ * @return CRITICAL_STATE: The previous threshold.
+ */
+CRITICAL_STATE CRITICAL_Enter(uint8_t ceiling)
+{
+    uint32_t prev = PFIC->PFIC_ITHRESDR;
+
+    // A threshold of 0 means "no threshold", anything else masks prio >= value
+    if (prev == 0 || ceiling < prev)
+    {
+        PFIC->PFIC_ITHRESDR = ceiling;
+        (void)PFIC->PFIC_ITHRESDR;
+    }
+
+#if CRITICAL_TRACK
+    CRITICAL_TrackEnter(__builtin_return_address(0));
+#endif
+
+    return prev;
+}
+
+/**
+ * @brief Restores the threshold saved by the matching CRITICAL_Enter().
+ * @param state The value returned by CRITICAL_Enter().
+ */
+void CRITICAL_Exit(CRITICAL_STATE state)
+{
+#if CRITICAL_TRACK
+    CRITICAL_TrackExit(CRITICAL_KIND_THRESHOLD);
+#endif
+
+    PFIC->PFIC_ITHRESDR = state;
+}
+
+/**
+ * @brief Disables every maskable interrupt.
+ * @return CRITICAL_STATE: The previous global enable state.
+ */
+CRITICAL_STATE CRITICAL_EnterGlobal(void)
+{
+    CRITICAL_STATE state = PFIC_DisableGlobalIRQ();
+
+#if CRITICAL_TRACK
+    CRITICAL_TrackEnter(__builtin_return_address(0));
+#endif
+
+    return state;
+}
+
+/**
+ * @brief Restores the global enable state saved by the matching CRITICAL_EnterGlobal().
+ * @param state The value returned by CRITICAL_EnterGlobal().
+ */
+void CRITICAL_ExitGlobal(CRITICAL_STATE state)
+{
+#if CRITICAL_TRACK
+    CRITICAL_TrackExit(CRITICAL_KIND_GLOBAL);
+#endif
+
+    PFIC_RestoreGlobalIRQ(state);
+}
+
+/**
+ * @brief Returns the tracker statistics for one kind of section.
+ *
+ * The record stays all zero when CRITICAL_TRACK is disabled.
+ *
+ * @param kind CRITICAL_KIND_THRESHOLD or CRITICAL_KIND_GLOBAL.
+ * @return const CRITICAL_STATS*: Pointer to the live record.
+ */
+const CRITICAL_STATS *CRITICAL_GetStats(CRITICAL_KIND kind)
+{
+#if CRITICAL_TRACK
+    return &criticalStats[kind];
+#else
+    static const CRITICAL_STATS emptyStats;
+
+    (void)kind;
+    return &emptyStats;
+#endif
+}
+
+/**
+ * @brief Clears the tracker statistics of both kinds.
+ */
+void CRITICAL_ResetStats(void)
+{
+#if CRITICAL_TRACK
+    uint32_t irqState = PFIC_DisableGlobalIRQ();
+
+    for (uint8_t kind = 0; kind < CRITICAL_KINDS; kind++)
+    {
+        criticalStats[kind].count = 0;
+        criticalStats[kind].maxCycles = 0;
+        criticalStats[kind].maxSite = 0;
+    }
+
+    PFIC_RestoreGlobalIRQ(irqState);
+#endif
+}
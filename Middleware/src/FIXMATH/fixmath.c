@@ -0,0 +1,368 @@
+#include <stddef.h>
+#include "FIXMATH/fixmath.h"
+
+#if FIXMATH_CORDIC_STEPS > 18
+#error "FIXMATH_CORDIC_STEPS must not exceed 18"
+#endif
+
+// CORDIC vector scale: 2^30, leaves headroom for the gain and the 45 degree fold
+#define FIXMATH_CORDIC_ONE (1L << 30)
+
+// 1 / CORDIC gain (0.6072529350) at the 2^30 scale
+#define FIXMATH_CORDIC_INV_GAIN 652032874L
+
+// atan2 normalizes its inputs into [2^28, 2^29] before the vectoring loop
+#define FIXMATH_ATAN2_MAX (1L << 29)
+#define FIXMATH_ATAN2_MIN (1L << 28)
+
+/**
+ * @brief atan(2^-i) as 32-bit binary angles (2^32 = full turn).
+ */
+static const uint32_t fixmathAtanTable[18] = {
+    0x20000000, 0x12E4051E, 0x09FB385B, 0x051111D4, 0x028B0D43, 0x0145D7E1,
+    0x00A2F61E, 0x00517C55, 0x0028BE53, 0x00145F2F, 0x000A2F98, 0x000517CC,
+    0x00028BE6, 0x000145F3, 0x0000A2FA, 0x0000517D, 0x000028BE, 0x0000145F,
+};
+
+/**
+ * @brief Rounds a 2^30 scaled CORDIC component to Q15.
+ */
+static FIXMATH_Q15 FIXMATH_CordicToQ15(int32_t value)
+{
+    return FIXMATH_Q15Sat((value + (1L << 14)) >> 15);
+}
+
+/**
+ * @brief Computes sine and cosine together.
+ *
+ * The angle is folded into [-90, 90] degrees (turning by 180 degrees negates
+ * both results), then rotated from (1 / gain, 0) with one shift-add step per
+ * table entry.
+ *
+ * @param angle The angle.
+ * @param sine Receives sin(angle) in Q15, may be NULL.
+ * @param cosine Receives cos(angle) in Q15, may be NULL.
+ */
+void FIXMATH_SinCos(FIXMATH_ANGLE angle, FIXMATH_Q15 *sine, FIXMATH_Q15 *cosine)
+{
+    int32_t z = (int32_t)((uint32_t)angle << 16);
+    int32_t x = FIXMATH_CORDIC_INV_GAIN;
+    int32_t y = 0;
+    uint8_t negate = 0;
+
+    if (z > FIXMATH_CORDIC_ONE || z < -FIXMATH_CORDIC_ONE)
+    {
+        z = (int32_t)((uint32_t)z + 0x80000000UL);
+        negate = 1;
+    }
+
+    for (uint8_t step = 0; step < FIXMATH_CORDIC_STEPS; step++)
+    {
+        int32_t dx = y >> step;
+        int32_t dy = x >> step;
+
+        if (z >= 0)
+        {
+            x -= dx;
+            y += dy;
+            z -= (int32_t)fixmathAtanTable[step];
+        }
+        else
+        {
+            x += dx;
+            y -= dy;
+            z += (int32_t)fixmathAtanTable[step];
+        }
+    }
+
+    if (negate)
+    {
+        x = -x;
+        y = -y;
+    }
+
+    if (sine != NULL)
+        *sine = FIXMATH_CordicToQ15(y);
+    if (cosine != NULL)
+        *cosine = FIXMATH_CordicToQ15(x);
+}
+
+/**
+ * @brief Returns sin(angle) in Q15 (1.0 saturates to 32767).
+ * @param angle The angle.
+ * @return FIXMATH_Q15: The sine.
+ */
+FIXMATH_Q15 FIXMATH_Sin(FIXMATH_ANGLE angle)
+{
+    FIXMATH_Q15 sine;
+
+    FIXMATH_SinCos(angle, &sine, NULL);
+    return sine;
+}
+
+/**
+ * @brief Returns cos(angle) in Q15 (1.0 saturates to 32767).
+ * @param angle The angle.
+ * @return FIXMATH_Q15: The cosine.
+ */
+FIXMATH_Q15 FIXMATH_Cos(FIXMATH_ANGLE angle)
+{
+    FIXMATH_Q15 cosine;
+
+    FIXMATH_SinCos(angle, NULL, &cosine);
+    return cosine;
+}
+
+/**
+ * @brief Returns the angle of the vector (x, y).
+ *
+ * The vector is scaled by a power of two so its larger component lies in
+ * [2^28, 2^29]: large inputs cannot overflow with the CORDIC gain, and small
+ * ones keep their resolution. Vectors with a negative x are turned by 180
+ * degrees first, then rotated onto the x axis while the applied angles are
+ * summed.
+ *
+ * @param y The y component, any scale.
+ * @param x The x component, same scale as y.
+ * @return FIXMATH_ANGLE: The angle, 0 for (0, 0).
+ */
+FIXMATH_ANGLE FIXMATH_Atan2(int32_t y, int32_t x)
+{
+    uint32_t z = 0;
+
+    if (x == 0 && y == 0)
+        return 0;
+
+    while (x > FIXMATH_ATAN2_MAX || x < -FIXMATH_ATAN2_MAX || y > FIXMATH_ATAN2_MAX || y < -FIXMATH_ATAN2_MAX)
+    {
+        x >>= 1;
+        y >>= 1;
+    }
+
+    while (x < FIXMATH_ATAN2_MIN && x > -FIXMATH_ATAN2_MIN && y < FIXMATH_ATAN2_MIN && y > -FIXMATH_ATAN2_MIN)
+    {
+        x = (int32_t)((uint32_t)x << 1);
+        y = (int32_t)((uint32_t)y << 1);
+    }
+
+    if (x < 0)
+    {
+        x = -x;
+        y = -y;
+        z = 0x80000000UL;
+    }
+
+    for (uint8_t step = 0; step < FIXMATH_CORDIC_STEPS; step++)
+    {
+        int32_t dx = y >> step;
+        int32_t dy = x >> step;
+
+        if (y < 0)
+        {
+            x -= dx;
+            y += dy;
+            z -= fixmathAtanTable[step];
+        }
+        else
+        {
+            x += dx;
+            y -= dy;
+            z += fixmathAtanTable[step];
+        }
+    }
+
+    return (FIXMATH_ANGLE)((z + 0x8000) >> 16);
+}
+
+/**
+ * @brief Bitwise square root step loop, two radicand bits per result bit.
+ *
+ * On return *remainder holds value - root^2 in the loop's scale.
+ *
+ * @param remainder Radicand in, remainder out.
+ * @param root Partial root in, root out.
+ * @param bit Highest radicand bit pair to process (a power of four).
+ */
+static void FIXMATH_SqrtSteps(uint32_t *remainder, uint32_t *root, uint32_t bit)
+{
+    uint32_t num = *remainder;
+    uint32_t res = *root;
+
+    while (bit)
+    {
+        if (num >= res + bit)
+        {
+            num -= res + bit;
+            res = (res >> 1) + bit;
+        }
+        else
+        {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    *remainder = num;
+    *root = res;
+}
+
+/**
+ * @brief Returns floor(sqrt(value)).
+ * @param value The radicand.
+ * @return uint16_t: The integer square root.
+ */
+uint16_t FIXMATH_Sqrt32(uint32_t value)
+{
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > value)
+        bit >>= 2;
+
+    FIXMATH_SqrtSteps(&value, &root, bit);
+    return (uint16_t)root;
+}
+
+/**
+ * @brief Returns the square root of a Q16.16 value, rounded.
+ *
+ * sqrt(x / 2^16) * 2^16 = sqrt(x * 2^16) needs a 48-bit radicand. The first
+ * pass produces the 16 integer bits of the root from the 32-bit value. The
+ * remainder and root are then shifted up by 16 bits and a second pass adds
+ * the 8 fractional bits. When the remainder does not fit 16 bits, the shift
+ * would overflow, so the first step of the second pass is taken in advance.
+ *
+ * @param value The radicand, 0 for negative values.
+ * @return FIXMATH_Q16: The square root.
+ */
+FIXMATH_Q16 FIXMATH_SqrtQ16(FIXMATH_Q16 value)
+{
+    uint32_t num = (uint32_t)value;
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+
+    if (value <= 0)
+        return 0;
+
+    while (bit > num)
+        bit >>= 2;
+
+    FIXMATH_SqrtSteps(&num, &root, bit);
+
+    if (num > 0xFFFF)
+    {
+        num = ((num - root) << 16) - 0x8000;
+        root = (root << 16) + 0x8000;
+    }
+    else
+    {
+        num <<= 16;
+        root <<= 16;
+    }
+
+    FIXMATH_SqrtSteps(&num, &root, 1UL << 14);
+
+    if (num > root)
+        root++;
+
+    return (FIXMATH_Q16)root;
+}
+
+/**
+ * @brief Returns a * b in Q16.16, rounded. Wraps on overflow.
+ *
+ * (ah * 2^16 + al) * (bh * 2^16 + bl) / 2^16 from four 16 x 16-bit products,
+ * with ah and bh signed and al and bl unsigned.
+ *
+ * @param a First factor.
+ * @param b Second factor.
+ * @return FIXMATH_Q16: The product.
+ */
+FIXMATH_Q16 FIXMATH_Q16Mul(FIXMATH_Q16 a, FIXMATH_Q16 b)
+{
+    int32_t ah = a >> 16;
+    int32_t bh = b >> 16;
+    uint32_t al = (uint32_t)a & 0xFFFF;
+    uint32_t bl = (uint32_t)b & 0xFFFF;
+    uint32_t result;
+
+    result = (uint32_t)(ah * bh) << 16;
+    result += (uint32_t)(ah * (int32_t)bl);
+    result += (uint32_t)((int32_t)al * bh);
+    result += (al * bl + 0x8000) >> 16;
+
+    return (FIXMATH_Q16)result;
+}
+
+/**
+ * @brief Sets up a low-pass filter.
+ * @param filter The filter.
+ * @param shift Coefficient as a power of two (1..15).
+ * @param initial Initial output.
+ */
+void FIXMATH_IIR1Init(FIXMATH_IIR1 *filter, uint8_t shift, int16_t initial)
+{
+    filter->state = (int32_t)((uint32_t)(int32_t)initial << 16);
+    filter->shift = shift;
+}
+
+/**
+ * @brief Feeds one sample to a low-pass filter.
+ *
+ * Both terms are shifted before the subtraction, so the difference of two
+ * full-scale values cannot overflow.
+ *
+ * @param filter The filter.
+ * @param sample The new sample.
+ * @return int16_t: The filtered value.
+ */
+int16_t FIXMATH_IIR1Update(FIXMATH_IIR1 *filter, int16_t sample)
+{
+    int32_t input = (int32_t)((uint32_t)(int32_t)sample << 16);
+
+    filter->state += (input >> filter->shift) - (filter->state >> filter->shift);
+
+    return (int16_t)((filter->state + 0x8000) >> 16);
+}
+
+/**
+ * @brief Sets up a moving average and clears its window.
+ * @param average The moving average.
+ * @param buffer Storage for 2^order samples.
+ * @param order Window length as a power of two (0..16).
+ */
+void FIXMATH_AverageInit(FIXMATH_AVERAGE *average, int16_t *buffer, uint8_t order)
+{
+    average->buffer = buffer;
+    average->sum = 0;
+    average->order = order;
+    average->index = 0;
+
+    for (uint32_t index = 0; index < (1UL << order); index++)
+        buffer[index] = 0;
+}
+
+/**
+ * @brief Feeds one sample to a moving average.
+ *
+ * The oldest sample is swapped for the new one in the running sum, so the
+ * cost does not depend on the window length.
+ *
+ * @param average The moving average.
+ * @param sample The new sample.
+ * @return int16_t: The rounded mean of the window.
+ */
+int16_t FIXMATH_AverageUpdate(FIXMATH_AVERAGE *average, int16_t sample)
+{
+    uint16_t mask = (uint16_t)((1UL << average->order) - 1);
+    uint16_t index = average->index & mask;
+
+    average->sum += sample - average->buffer[index];
+    average->buffer[index] = sample;
+    average->index = (uint16_t)(index + 1);
+
+    if (average->order == 0)
+        return (int16_t)average->sum;
+
+    return (int16_t)((average->sum + (1L << (average->order - 1))) >> average->order);
+}
@@ -0,0 +1,289 @@
+#include "LATENCY/latency.h"
+#include "EXTI/exti.h"
+#include "GPIO/afio.h"
+#include "PFIC/pfic.h"
+#include "TIM/tim.h"
+
+// Number of back-to-back stamp pairs used to calibrate the overhead
+#define LATENCY_CAL_RUNS 8
+
+volatile uint32_t latencyTriggerStamp;
+
+static uint32_t latencyOverhead;
+
+// Record and samples left for the EXTI line 2 callback of LATENCY_MeasureInterruptWake()
+static LATENCY_STATS *latencyEdgeStats;
+static volatile uint16_t latencyEdgeLeft;
+
+/**
+ * @brief Writes a zero-terminated string through the output function.
+ */
+static void LATENCY_PutString(LATENCY_PUTC putChar, const char *str)
+{
+    while (*str)
+        putChar(*str++);
+}
+
+/**
+ * @brief Writes an unsigned value in decimal through the output function.
+ */
+static void LATENCY_PutDecimal(LATENCY_PUTC putChar, uint32_t value)
+{
+    char digits[10];
+    uint8_t len = 0;
+
+    do
+    {
+        digits[len++] = '0' + (value % 10);
+        value /= 10;
+    } while (value);
+
+    while (len)
+        putChar(digits[--len]);
+}
+
+/**
+ * @brief Starts the SysTick counter and calibrates the stamping overhead.
+ *
+ * If SysTick is already running it is left untouched. Otherwise it is set to
+ * count up from 0 at HCLK with no auto-reload, so the 32-bit counter wraps
+ * naturally and unsigned differences stay valid across the wrap.
+ *
+ * The overhead is the smallest difference between a trigger stamp and an
+ * entry-style read executed back to back, i.e. the part of each sample that
+ * is not interrupt latency.
+ */
+void LATENCY_Init(void)
+{
+    uint32_t best = UINT32_MAX;
+
+    if (!(SYSTICK->CTLR & STE_Msk))
+    {
+        SYSTICK->CTLR = 0;
+        SYSTICK->CNT = 0;
+        SYSTICK->CTLR = STCLK_Msk | STE_Msk;
+    }
+
+    for (uint8_t run = 0; run < LATENCY_CAL_RUNS; run++)
+    {
+        LATENCY_MarkTrigger();
+        uint32_t now = SYSTICK->CNT;
+
+        if ((now - latencyTriggerStamp) < best)
+            best = now - latencyTriggerStamp;
+    }
+
+    latencyOverhead = best;
+}
+
+/**
+ * @brief Clears a statistics record.
+ * @param stats The record to clear.
+ */
+void LATENCY_Reset(LATENCY_STATS *stats)
+{
+    stats->count = 0;
+    stats->min = UINT32_MAX;
+    stats->max = 0;
+    stats->sum = 0;
+
+    for (uint8_t bin = 0; bin < LATENCY_HIST_BINS; bin++)
+        stats->hist[bin] = 0;
+}
+
+/**
+ * @brief Accumulates a sample that needs no correction.
+ *
+ * Histogram bins saturate at UINT16_MAX instead of wrapping.
+ */
+static void LATENCY_Accumulate(LATENCY_STATS *stats, uint32_t cycles)
+{
+    uint32_t bin;
+
+    stats->count++;
+    stats->sum += cycles;
+
+    if (cycles < stats->min)
+        stats->min = cycles;
+
+    if (cycles > stats->max)
+        stats->max = cycles;
+
+    bin = cycles >> LATENCY_HIST_SHIFT;
+    if (bin >= LATENCY_HIST_BINS)
+        bin = LATENCY_HIST_BINS - 1;
+
+    if (stats->hist[bin] != UINT16_MAX)
+        stats->hist[bin]++;
+}
+
+/**
+ * @brief Adds one sample to a statistics record.
+ * @param stats The record to update.
+ * @param cycles The raw counter difference between trigger and entry stamps.
+ */
+void LATENCY_Record(LATENCY_STATS *stats, uint32_t cycles)
+{
+    // Remove the stamping cost, clamping at zero
+    LATENCY_Accumulate(stats, (cycles > latencyOverhead) ? (cycles - latencyOverhead) : 0);
+}
+
+/**
+ * @brief Returns the mean latency of a record, in cycles.
+ * @param stats The record to read.
+ * @return uint32_t: sum / count, or 0 if the record is empty.
+ */
+uint32_t LATENCY_GetMean(const LATENCY_STATS *stats)
+{
+    if (stats->count == 0)
+        return 0;
+
+    return stats->sum / stats->count;
+}
+
+/**
+ * @brief Writes a record as text.
+ *
+ * Format:
+ *   n=<count> min=<min> max=<max> mean=<mean> ovh=<overhead>
+ *   <bin start>: <samples>      (one line per bin, last bin is open-ended)
+ *
+ * @param stats The record to dump.
+ * @param putChar Character output function.
+ */
+void LATENCY_Dump(const LATENCY_STATS *stats, LATENCY_PUTC putChar)
+{
+    LATENCY_PutString(putChar, "n=");
+    LATENCY_PutDecimal(putChar, stats->count);
+    LATENCY_PutString(putChar, " min=");
+    LATENCY_PutDecimal(putChar, stats->count ? stats->min : 0);
+    LATENCY_PutString(putChar, " max=");
+    LATENCY_PutDecimal(putChar, stats->max);
+    LATENCY_PutString(putChar, " mean=");
+    LATENCY_PutDecimal(putChar, LATENCY_GetMean(stats));
+    LATENCY_PutString(putChar, " ovh=");
+    LATENCY_PutDecimal(putChar, latencyOverhead);
+    LATENCY_PutString(putChar, "\r\n");
+
+    for (uint8_t bin = 0; bin < LATENCY_HIST_BINS; bin++)
+    {
+        LATENCY_PutDecimal(putChar, (uint32_t)bin << LATENCY_HIST_SHIFT);
+        LATENCY_PutString(putChar, (bin == LATENCY_HIST_BINS - 1) ? "+: " : ": ");
+        LATENCY_PutDecimal(putChar, stats->hist[bin]);
+        LATENCY_PutString(putChar, "\r\n");
+    }
+}
+
+/**
+ * @brief Returns the calibrated cost of a stamp pair.
+ * @return uint32_t: Overhead in cycles.
+ */
+uint32_t LATENCY_GetOverhead(void)
+{
+    return latencyOverhead;
+}
+
+/**
+ * @brief Sets up the hardware edge timestamp on PD2.
+ *
+ * TIM1 counts at HCLK with no reload, so the 16-bit difference between its
+ * counter and the CH1 capture is the time since the edge, up to 65535 cycles.
+ * Both the capture and the EXTI line go through an input synchronizer of
+ * their own, so their delays largely cancel.
+ */
+void LATENCY_EdgeInit(void)
+{
+    TIM_TimeBaseInit(TIMER1, 0, 0xFFFF, 0);
+    TIM_CaptureInit(TIMER1, TIM_CHANNEL_1, 0);
+    TIM_CapturePinInit(TIMER1, TIM_CHANNEL_1, 0);
+
+    AFIO_ConfigInterrupt(AFIO_EXTI_GPIO_GPIOD, GPIO_PIN_2);
+    EXTI_EdgeTriggerConfig(EXTI_INT_EVEN_ENABLE, EXTI_EDGETRG_EN_RISE, EXTI_EDGETRG_TR2);
+
+    TIM_Start(TIMER1);
+}
+
+/**
+ * @brief Adds one edge-to-entry sample to a statistics record.
+ * @param stats The record to update.
+ * @param cycles Cycles from the captured edge to the entry stamp.
+ */
+void LATENCY_RecordEdge(LATENCY_STATS *stats, uint16_t cycles)
+{
+    LATENCY_Accumulate(stats, cycles);
+}
+
+/**
+ * @brief Measures waking on EXTI event line 2.
+ *
+ * The sequence of EXTI_WaitForEvent() is spelled out here so the stamp is
+ * taken by the first instruction after the sleep, not after its clean-up.
+ *
+ * @param stats The record to update.
+ * @param samples Number of edges to wait for.
+ */
+void LATENCY_MeasureEventWake(LATENCY_STATS *stats, uint16_t samples)
+{
+    uint32_t evenr = EXTI->EVENR;
+
+    while (samples--)
+    {
+        PFIC_ClearEvent();
+        EXTI->EVENR = evenr | MR2_Msk;
+
+        __asm volatile("wfi");
+        LATENCY_MarkEdge(stats);
+
+        PFIC->PFIC_SCTLR &= ~WFITOWFE_Msk;
+        EXTI->EVENR = evenr;
+    }
+}
+
+/**
+ * @brief EXTI line 2 callback of LATENCY_MeasureInterruptWake().
+ */
+static void LATENCY_EdgeCallback(void)
+{
+    LATENCY_MarkEdge(latencyEdgeStats);
+
+    if (latencyEdgeLeft)
+        latencyEdgeLeft--;
+}
+
+/**
+ * @brief Measures waking through the EXTI7_0 interrupt on line 2.
+ *
+ * The samples include the dispatcher's flag scan, i.e. the path an
+ * application callback sees, and the re-enabling of MIE after the wfi. An edge that arrives before the core is asleep
+ * is still recorded, as interrupt latency from running code.
+ *
+ * @param stats The record to update.
+ * @param samples Number of edges to wait for.
+ */
+void LATENCY_MeasureInterruptWake(LATENCY_STATS *stats, uint16_t samples)
+{
+    uint32_t irqState;
+    uint16_t left;
+
+    latencyEdgeStats = stats;
+    latencyEdgeLeft = samples;
+
+    EXTI_RegisterCallback(EXTI_INT_EVEN_MR2, LATENCY_EdgeCallback);
+    EXTI_ClearInterruptFlag(EXTI_CLR_INT_FLAG_IF2);
+    EXTI_InterruptInit(EXTI_INT_EVEN_ENABLE, EXTI_INT_EVEN_MR2);
+    PFIC_EnableIRQ(PFIC_IRQ_EXTI7_0);
+
+    // Test and sleep with MIE clear, so an edge between the two cannot be
+    // missed: it stays pending, wakes the core and is taken on the restore
+    do
+    {
+        irqState = PFIC_DisableGlobalIRQ();
+        left = latencyEdgeLeft;
+        if (left)
+            __asm volatile("wfi");
+        PFIC_RestoreGlobalIRQ(irqState);
+    } while (left);
+
+    EXTI_InterruptInit(EXTI_INT_EVEN_DISABLE, EXTI_INT_EVEN_MR2);
+    EXTI_RegisterCallback(EXTI_INT_EVEN_MR2, 0);
+}
@@ -0,0 +1,497 @@
+#include <stddef.h>
+#include "MODBUS/modbus.h"
+#include "PFIC/pfic.h"
+#include "TIM/tim.h"
+#include "USART/usart.h"
+
+#if MODBUS_BUFFER_SIZE < 8 || MODBUS_BUFFER_SIZE > 256
+#error "MODBUS_BUFFER_SIZE must be within 8..256"
+#endif
+
+// The slave needs the per-byte USART receive hook, which the DMA receive
+// path does not have; with USART_RX_DMA the module compiles to nothing
+#if !USART_RX_DMA
+
+// Function codes
+#define MODBUS_READ_HOLDING 0x03
+#define MODBUS_READ_INPUT 0x04
+#define MODBUS_WRITE_SINGLE 0x06
+#define MODBUS_WRITE_MULTIPLE 0x10
+#define MODBUS_EXCEPTION_FLAG 0x80
+
+#define MODBUS_BROADCAST 0
+#define MODBUS_ADDRESS_MAX 247
+
+// Registers per request: the protocol limits, or what the buffer holds
+// (address, function, byte count, data and CRC)
+#define MODBUS_READ_MAX_PDU 125
+#define MODBUS_WRITE_MAX_PDU 123
+#define MODBUS_READ_MAX \
+    (((MODBUS_BUFFER_SIZE - 5) / 2) < MODBUS_READ_MAX_PDU ? ((MODBUS_BUFFER_SIZE - 5) / 2) : MODBUS_READ_MAX_PDU)
+#define MODBUS_WRITE_MAX \
+    (((MODBUS_BUFFER_SIZE - 9) / 2) < MODBUS_WRITE_MAX_PDU ? ((MODBUS_BUFFER_SIZE - 9) / 2) : MODBUS_WRITE_MAX_PDU)
+
+// Timer ticks per second (1 us), and the lowest baud rate whose t3.5 fits 16 bits
+#define MODBUS_TICK_RATE 1000000UL
+#define MODBUS_BAUD_MIN 600
+
+// Character times in bit times: t1.5 and t3.5 are defined for 11-bit
+// characters, the 8N1 characters on the line take 10
+#define MODBUS_T15_BITS_US (15UL * 11 * MODBUS_TICK_RATE / 10)
+#define MODBUS_T35_BITS_US (35UL * 11 * MODBUS_TICK_RATE / 10)
+#define MODBUS_CHAR_BITS_US (10UL * MODBUS_TICK_RATE)
+
+// Fixed timings above 19200 baud
+#define MODBUS_FIXED_BAUD 19200
+#define MODBUS_FIXED_T15_US 750
+#define MODBUS_FIXED_T35_US 1750
+
+/**
+ * @brief Receive state, shared by the USART hook, the TIM2 handler and MODBUS_Poll().
+ */
+typedef enum
+{
+    MODBUS_STATE_WAIT,      /**< Waiting for t3.5 of silence before the first frame. */
+    MODBUS_STATE_IDLE,      /**< The next byte starts a frame. */
+    MODBUS_STATE_RECEIVING, /**< Storing a frame until t3.5 of silence. */
+    MODBUS_STATE_READY,     /**< A valid frame waits for MODBUS_Poll(). */
+    MODBUS_STATE_SENDING    /**< The response is being sent from the buffer. */
+} MODBUS_STATE;
+
+// CRC-16/MODBUS (reflected polynomial 0xA001), one entry per byte value
+static const uint16_t modbusCrcTable[256] = {
+    0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+    0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+    0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+    0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+    0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+    0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+    0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+    0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+    0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+    0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+    0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+    0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+    0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+    0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+    0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+    0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+    0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+    0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+    0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+    0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+    0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+    0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+    0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+    0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+    0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+    0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+    0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+    0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+    0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+    0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+    0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+    0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040};
+
+static const MODBUS_MAP *modbusMap;
+static uint8_t modbusAddress;
+
+// Counter value above which the gap before a byte exceeded t1.5
+static uint16_t modbusGapTicks;
+
+// Frame buffer, written by the USART hook while receiving and by
+// MODBUS_Poll() for the response
+static uint8_t modbusBuffer[MODBUS_BUFFER_SIZE];
+static uint16_t modbusLength;
+static uint16_t modbusCrc;
+static uint8_t modbusBroken;
+static uint8_t modbusOverflow;
+static volatile MODBUS_STATE modbusState;
+
+static MODBUS_STATS modbusStats;
+
+#if USART_TX_DMA
+static USART_SEGMENT modbusSegment;
+#endif
+
+/**
+ * @brief Reads a big-endian 16-bit field.
+ */
+static inline uint16_t MODBUS_GetU16(const uint8_t *data)
+{
+    return (uint16_t)((data[0] << 8) | data[1]);
+}
+
+/**
+ * @brief Writes a big-endian 16-bit field.
+ */
+static inline void MODBUS_PutU16(uint8_t *data, uint16_t value)
+{
+    data[0] = (uint8_t)(value >> 8);
+    data[1] = (uint8_t)value;
+}
+
+/**
+ * @brief Folds one byte into a running CRC.
+ */
+static inline uint16_t MODBUS_CrcUpdate(uint16_t crc, uint8_t byte)
+{
+    return (uint16_t)((crc >> 8) ^ modbusCrcTable[(uint8_t)(crc ^ byte)]);
+}
+
+/**
+ * @brief USART receive hook: stores a byte and restarts the t3.5 timer.
+ *
+ * Runs in USART1_IRQHandler. The counter still holds the time since the
+ * previous byte's stop bit, plus this byte's own character time; above
+ * modbusGapTicks the silence was longer than t1.5. A stopped counter reads
+ * 0, so the first byte of a frame never counts as a gap.
+ *
+ * @param byte The received byte.
+ * @param error 1 for a framing or noise error or a preceding overrun.
+ */
+static void MODBUS_RxByte(uint8_t byte, uint8_t error)
+{
+    uint16_t gap = TIM_GetCounter(TIMER2);
+    MODBUS_STATE state = modbusState;
+
+    TIM_SetCounter(TIMER2, 0);
+    TIM_Start(TIMER2);
+
+    if (state == MODBUS_STATE_IDLE)
+    {
+        modbusLength = 0;
+        modbusCrc = 0xFFFF;
+        modbusBroken = 0;
+        modbusOverflow = 0;
+        modbusState = MODBUS_STATE_RECEIVING;
+    }
+    else if (state == MODBUS_STATE_RECEIVING)
+    {
+        if (gap > modbusGapTicks)
+            modbusBroken = 1;
+    }
+    else
+    {
+        // Waiting for silence, or busy with the previous frame
+        return;
+    }
+
+    if (error)
+        modbusBroken = 1;
+
+    if (modbusLength < MODBUS_BUFFER_SIZE)
+    {
+        modbusBuffer[modbusLength++] = byte;
+        modbusCrc = MODBUS_CrcUpdate(modbusCrc, byte);
+    }
+    else
+    {
+        modbusOverflow = 1;
+    }
+}
+
+/**
+ * @brief TIM2 handler: t3.5 of silence have passed, the frame is complete.
+ *
+ * The CRC over a valid frame, its own CRC included, is 0, so the check is
+ * already done. Frames for other slaves are dropped silently.
+ *
+ * @param flags The pending TIM2 flags.
+ */
+static void MODBUS_TimerHandler(uint32_t flags)
+{
+    if (!(flags & TIM_FLAG_UPDATE))
+        return;
+
+    if (modbusState == MODBUS_STATE_WAIT)
+    {
+        modbusState = MODBUS_STATE_IDLE;
+        return;
+    }
+
+    if (modbusState != MODBUS_STATE_RECEIVING)
+        return;
+
+    modbusState = MODBUS_STATE_IDLE;
+
+    if (modbusOverflow)
+        modbusStats.overflows++;
+    else if (modbusBroken)
+        modbusStats.gapErrors++;
+    else if (modbusLength < 4 || modbusCrc != 0)
+        modbusStats.crcErrors++;
+    else if (modbusBuffer[0] == modbusAddress || modbusBuffer[0] == MODBUS_BROADCAST)
+    {
+        modbusStats.requests++;
+        modbusState = MODBUS_STATE_READY;
+    }
+}
+
+#if USART_TX_DMA
+/**
+ * @brief Chain segment done callback: the response is out of the buffer.
+ * @param segment The response segment.
+ */
+static void MODBUS_TxDone(USART_SEGMENT *segment)
+{
+    (void)segment;
+
+    modbusState = MODBUS_STATE_IDLE;
+}
+#endif
+
+/**
+ * @brief Returns the region that holds a whole register range.
+ * @param regions The region table.
+ * @param count Number of regions.
+ * @param address First register.
+ * @param quantity Number of registers (at least 1).
+ * @return const MODBUS_REGION*: The region, NULL if no region holds the whole range.
+ */
+static const MODBUS_REGION *MODBUS_FindRegion(const MODBUS_REGION *regions, uint8_t count, uint16_t address,
+                                              uint16_t quantity)
+{
+    for (uint8_t index = 0; index < count; index++)
+    {
+        const MODBUS_REGION *region = &regions[index];
+
+        if (address >= region->start && (uint32_t)address + quantity <= (uint32_t)region->start + region->count)
+            return region;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Executes 0x03 / 0x04: the register values replace the request.
+ * @param regions The holding or input region table.
+ * @param count Number of regions.
+ * @param length Request length without CRC.
+ * @param responseLength Receives the response length without CRC.
+ * @return MODBUS_EXCEPTION: MODBUS_EXCEPTION_NONE or the exception to return.
+ */
+static MODBUS_EXCEPTION MODBUS_ReadRegisters(const MODBUS_REGION *regions, uint8_t count, uint16_t length,
+                                             uint16_t *responseLength)
+{
+    uint16_t address = MODBUS_GetU16(&modbusBuffer[2]);
+    uint16_t quantity = MODBUS_GetU16(&modbusBuffer[4]);
+    const MODBUS_REGION *region;
+    const uint16_t *data;
+
+    if (length != 6 || quantity == 0 || quantity > MODBUS_READ_MAX)
+        return MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+
+    region = MODBUS_FindRegion(regions, count, address, quantity);
+    if (region == NULL)
+        return MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+
+    data = &region->data[address - region->start];
+    modbusBuffer[2] = (uint8_t)(quantity << 1);
+    for (uint16_t index = 0; index < quantity; index++)
+        MODBUS_PutU16(&modbusBuffer[3 + (index << 1)], data[index]);
+
+    *responseLength = 3 + (quantity << 1);
+    return MODBUS_EXCEPTION_NONE;
+}
+
+/**
+ * @brief Executes 0x06 / 0x10: the response is the first 6 bytes of the request.
+ * @param length Request length without CRC.
+ * @return MODBUS_EXCEPTION: MODBUS_EXCEPTION_NONE or the exception to return.
+ */
+static MODBUS_EXCEPTION MODBUS_WriteRegisters(uint16_t length)
+{
+    uint16_t address = MODBUS_GetU16(&modbusBuffer[2]);
+    const uint8_t *values = &modbusBuffer[4];
+    uint16_t quantity = 1;
+    const MODBUS_REGION *region;
+    uint16_t offset;
+
+    if (modbusBuffer[1] == MODBUS_WRITE_SINGLE)
+    {
+        if (length != 6)
+            return MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+    }
+    else
+    {
+        quantity = MODBUS_GetU16(&modbusBuffer[4]);
+        values = &modbusBuffer[7];
+        if (length < 7 || quantity == 0 || quantity > MODBUS_WRITE_MAX || modbusBuffer[6] != (quantity << 1) ||
+            length != 7 + (quantity << 1))
+            return MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+    }
+
+    region = MODBUS_FindRegion(modbusMap->holding, modbusMap->holdingCount, address, quantity);
+    if (region == NULL)
+        return MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+
+    offset = address - region->start;
+    for (uint16_t index = 0; index < quantity; index++)
+        region->data[offset + index] = MODBUS_GetU16(&values[index << 1]);
+
+    if (region->written != NULL)
+        return region->written(region, offset, quantity);
+
+    return MODBUS_EXCEPTION_NONE;
+}
+
+/**
+ * @brief Sets up USART1, TIM2 and the register map and starts listening.
+ *
+ * t1.5 and t3.5 follow the specification: 16.5 and 38.5 bit times up to
+ * 19200 baud, 750 us and 1750 us above. The first frame is accepted after
+ * t3.5 of silence.
+ *
+ * @param slaveAddress This slave's address (1..247).
+ * @param baudRate Baud rate in bit/s (at least 600, for t3.5 to fit TIM2).
+ * @param map The register map; must stay valid.
+ * @return MODBUS_STATUS: MODBUS_STATUS_SUCCESS, MODBUS_STATUS_INVALID_ADDRESS
+ * or MODBUS_STATUS_INVALID_BAUD.
+ */
+MODBUS_STATUS MODBUS_Init(uint8_t slaveAddress, uint32_t baudRate, const MODBUS_MAP *map)
+{
+    uint32_t t15;
+    uint32_t t35;
+
+    if (slaveAddress == MODBUS_BROADCAST || slaveAddress > MODBUS_ADDRESS_MAX)
+        return MODBUS_STATUS_INVALID_ADDRESS;
+    if (baudRate < MODBUS_BAUD_MIN || USART_Init(baudRate) != USART_STATUS_SUCCESS)
+        return MODBUS_STATUS_INVALID_BAUD;
+
+    if (baudRate > MODBUS_FIXED_BAUD)
+    {
+        t15 = MODBUS_FIXED_T15_US;
+        t35 = MODBUS_FIXED_T35_US;
+    }
+    else
+    {
+        t15 = MODBUS_T15_BITS_US / baudRate;
+        t35 = MODBUS_T35_BITS_US / baudRate;
+    }
+
+    modbusMap = map;
+    modbusAddress = slaveAddress;
+    modbusGapTicks = (uint16_t)(t15 + MODBUS_CHAR_BITS_US / baudRate);
+    modbusState = MODBUS_STATE_WAIT;
+    modbusStats = (MODBUS_STATS){0};
+
+    TIM_TimeBaseInit(TIMER2, TIM_GetPrescaler(MODBUS_TICK_RATE), (uint16_t)(t35 - 1),
+                     TIM_MODE_ONE_PULSE | TIM_MODE_UPDATE_ON_OVERFLOW);
+    TIM_SetHandler(TIMER2, MODBUS_TimerHandler);
+    TIM_EnableInterrupts(TIMER2, TIM_IRQ_UPDATE);
+    PFIC_EnableIRQ(PFIC_IRQ_TIM2);
+
+    USART_SetRxHook(MODBUS_RxByte);
+    TIM_Start(TIMER2);
+
+    return MODBUS_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Executes a received request and starts its response.
+ *
+ * Call from the main loop. Register values and write callbacks are only
+ * touched here, never from an interrupt handler. The response goes out
+ * through DMA from the frame buffer; no new request is accepted until it is
+ * sent, which a half-duplex master never notices.
+ */
+void MODBUS_Poll(void)
+{
+    uint16_t length;
+    uint16_t responseLength = 6;
+    MODBUS_EXCEPTION exception;
+    uint16_t crc;
+
+    if (modbusState != MODBUS_STATE_READY)
+        return;
+
+    length = modbusLength - 2;
+
+    switch (modbusBuffer[1])
+    {
+    case MODBUS_READ_HOLDING:
+        exception = MODBUS_ReadRegisters(modbusMap->holding, modbusMap->holdingCount, length, &responseLength);
+        break;
+
+    case MODBUS_READ_INPUT:
+        exception = MODBUS_ReadRegisters(modbusMap->input, modbusMap->inputCount, length, &responseLength);
+        break;
+
+    case MODBUS_WRITE_SINGLE:
+    case MODBUS_WRITE_MULTIPLE:
+        exception = MODBUS_WriteRegisters(length);
+        break;
+
+    default:
+        exception = MODBUS_EXCEPTION_ILLEGAL_FUNCTION;
+        break;
+    }
+
+    if (modbusBuffer[0] == MODBUS_BROADCAST)
+    {
+        modbusState = MODBUS_STATE_IDLE;
+        return;
+    }
+
+    if (exception != MODBUS_EXCEPTION_NONE)
+    {
+        modbusBuffer[1] |= MODBUS_EXCEPTION_FLAG;
+        modbusBuffer[2] = exception;
+        responseLength = 3;
+        modbusStats.exceptions++;
+    }
+
+    crc = MODBUS_Crc16(modbusBuffer, responseLength);
+    modbusBuffer[responseLength++] = (uint8_t)crc;
+    modbusBuffer[responseLength++] = (uint8_t)(crc >> 8);
+
+    modbusState = MODBUS_STATE_SENDING;
+
+#if USART_TX_DMA
+    modbusSegment.data = modbusBuffer;
+    modbusSegment.length = responseLength;
+    modbusSegment.next = NULL;
+    modbusSegment.done = MODBUS_TxDone;
+    USART_WriteChain(&modbusSegment);
+#else
+    for (uint16_t sent = 0; sent < responseLength;)
+        sent += USART_Write(&modbusBuffer[sent], responseLength - sent);
+
+    modbusState = MODBUS_STATE_IDLE;
+#endif
+}
+
+/**
+ * @brief Computes the Modbus CRC-16 of a buffer.
+ *
+ * Initial value 0xFFFF, reflected polynomial 0xA001, one table lookup per byte.
+ *
+ * @param data The bytes.
+ * @param length Number of bytes.
+ * @return uint16_t: The CRC, sent low byte first.
+ */
+uint16_t MODBUS_Crc16(const uint8_t *data, uint16_t length)
+{
+    uint16_t crc = 0xFFFF;
+
+    while (length--)
+        crc = MODBUS_CrcUpdate(crc, *data++);
+
+    return crc;
+}
+
+/**
+ * @brief Copies the frame counters.
+ * @param stats Receives the counters.
+ */
+void MODBUS_GetStats(MODBUS_STATS *stats)
+{
+    uint32_t irqState = PFIC_DisableGlobalIRQ();
+
+    *stats = modbusStats;
+
+    PFIC_RestoreGlobalIRQ(irqState);
+}
+
+#endif /* !USART_RX_DMA */
@@ -0,0 +1,394 @@
+#include <stddef.h>
+#include <string.h>
+#include "RPC/rpc.h"
+#include "USART/usart.h"
+
+#if RPC_FRAME_SIZE < 5 || RPC_FRAME_SIZE > 254
+#error "RPC_FRAME_SIZE must be between 5 and 254"
+#endif
+
+#if RPC_TX_BUFFERS < 1
+#error "RPC_TX_BUFFERS must be at least 1"
+#endif
+
+// Encoded frame: code byte, RPC_FRAME_SIZE bytes and the delimiter
+#define RPC_ENCODED_SIZE (RPC_FRAME_SIZE + 2)
+
+// Without DMA the response is copied into the TX ring, one buffer is enough
+#if USART_TX_DMA
+#define RPC_TX_COUNT RPC_TX_BUFFERS
+#else
+#define RPC_TX_COUNT 1
+#endif
+
+/**
+ * @brief Response buffer, sent in place as a chain segment.
+ */
+typedef struct
+{
+    USART_SEGMENT segment;          /**< First member: the done callback gets the buffer back from it. */
+    volatile uint8_t busy;          /**< Set while the DMA reads data. */
+    uint8_t data[RPC_ENCODED_SIZE]; /**< Code byte, frame and delimiter. */
+} RPC_TX_BUFFER;
+
+// CRC-16/CCITT-FALSE, four bits per step: 32 bytes of table instead of 512
+static const uint16_t rpcCrcTable[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF};
+
+static const RPC_COMMAND *rpcTable;
+static uint8_t rpcCount;
+
+// Received bytes not yet handled. With the RX ring they are
+// rpcRx[rpcRxStart..rpcRxEnd) and the bytes before rpcRxScan hold no
+// delimiter; with USART_RX_DMA only a frame that spans receive views or the
+// wrap of the DMA buffer is copied here, up to its delimiter
+static uint8_t rpcRx[RPC_ENCODED_SIZE];
+static uint16_t rpcRxEnd;
+
+#if !USART_RX_DMA
+static uint16_t rpcRxStart;
+static uint16_t rpcRxScan;
+#else
+// Bytes of the oldest receive view already handled
+static uint16_t rpcViewUsed;
+#endif
+
+// Set while an overlong frame is dropped up to its delimiter
+static uint8_t rpcRxDiscard;
+
+static RPC_TX_BUFFER rpcTx[RPC_TX_COUNT];
+static RPC_STATS rpcStats;
+
+#if USART_TX_DMA
+/**
+ * @brief Chain segment done callback: frees the response buffer.
+ *
+ * Runs in the DMA1 channel 4 handler.
+ *
+ * @param segment The segment of the buffer.
+ */
+static void RPC_TxDone(USART_SEGMENT *segment)
+{
+    ((RPC_TX_BUFFER *)segment)->busy = 0;
+}
+#endif
+
+/**
+ * @brief Returns a response buffer that is not being sent.
+ * @return RPC_TX_BUFFER*: A free buffer, NULL if all are in flight.
+ */
+static RPC_TX_BUFFER *RPC_GetFreeTx(void)
+{
+    for (uint8_t index = 0; index < RPC_TX_COUNT; index++)
+    {
+        if (!rpcTx[index].busy)
+            return &rpcTx[index];
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Adds the CRC, COBS encodes a response in place and sends it.
+ *
+ * The frame is at data[1..length]. Each zero byte is replaced by the
+ * distance to the next zero (or to the end), and data[0] takes the distance
+ * to the first one; with at most 254 bytes no other code is needed.
+ *
+ * @param tx The response buffer.
+ * @param length Frame length: seq, status, payload and CRC.
+ */
+static void RPC_Send(RPC_TX_BUFFER *tx, uint16_t length)
+{
+    uint8_t *data = tx->data;
+    uint16_t code = 0;
+
+    RPC_PutU16(&data[length - 1], RPC_Crc16(&data[1], (uint16_t)(length - 2)));
+
+    for (uint16_t index = 1; index <= length; index++)
+    {
+        if (data[index] == 0)
+        {
+            data[code] = (uint8_t)(index - code);
+            code = index;
+        }
+    }
+    data[code] = (uint8_t)(length + 1 - code);
+    data[length + 1] = 0;
+
+#if USART_TX_DMA
+    tx->busy = 1;
+    tx->segment.data = data;
+    tx->segment.length = (uint16_t)(length + 2);
+    tx->segment.next = NULL;
+    tx->segment.done = RPC_TxDone;
+    USART_WriteChain(&tx->segment);
+#else
+    for (uint16_t sent = 0; sent < length + 2;)
+        sent += USART_Write(&data[sent], (uint16_t)(length + 2 - sent));
+#endif
+}
+
+/**
+ * @brief Decodes a received frame in place, checks it and answers it.
+ *
+ * The encoded frame is encoded[0..length), without its delimiter. Every code
+ * byte is the distance to the next one; each one after the first is turned
+ * back into the zero it stands for, leaving the frame at encoded[1].
+ *
+ * @param encoded The encoded frame, in rpcRx or in a receive view.
+ * @param length Encoded length.
+ * @param tx A free response buffer.
+ */
+static void RPC_Handle(uint8_t *encoded, uint16_t length, RPC_TX_BUFFER *tx)
+{
+    uint8_t *frame = &encoded[1];
+    uint8_t *response = &tx->data[1];
+    uint16_t index = encoded[0];
+    uint16_t frameLength = length - 1;
+    const RPC_COMMAND *command = NULL;
+    uint8_t payloadLength;
+    uint8_t responseLength = 0;
+    uint8_t status;
+
+    while (index < length)
+    {
+        uint8_t code = encoded[index];
+
+        encoded[index] = 0;
+        index += code;
+    }
+
+    if (index != length || frameLength < 4 ||
+        RPC_Crc16(frame, (uint16_t)(frameLength - 2)) != RPC_GetU16(&frame[frameLength - 2]))
+    {
+        rpcStats.crcErrors++;
+        return;
+    }
+
+    payloadLength = (uint8_t)(frameLength - 4);
+    if (frame[1] < rpcCount)
+        command = &rpcTable[frame[1]];
+
+    if (command == NULL || command->handler == NULL)
+        status = RPC_STATUS_UNKNOWN_COMMAND;
+    else if (payloadLength < command->minLength || payloadLength > command->maxLength)
+        status = RPC_STATUS_INVALID_LENGTH;
+    else
+        status = command->handler(&frame[2], payloadLength, &response[2], &responseLength);
+
+    response[0] = frame[0];
+    response[1] = status;
+    rpcStats.requests++;
+
+    RPC_Send(tx, (uint16_t)(responseLength + 4));
+}
+
+/**
+ * @brief Sets the command table and empties the receive buffer.
+ *
+ * USART1 must be initialised by the caller. Bytes already in the USART
+ * driver are kept; a partial frame among them fails its CRC.
+ *
+ * @param table Command table, indexed by the command byte.
+ * @param count Number of entries.
+ */
+void RPC_Init(const RPC_COMMAND *table, uint8_t count)
+{
+    rpcTable = table;
+    rpcCount = count;
+#if !USART_RX_DMA
+    rpcRxStart = 0;
+    rpcRxScan = 0;
+#else
+    rpcViewUsed = 0;
+#endif
+    rpcRxEnd = 0;
+    rpcRxDiscard = 0;
+    rpcStats = (RPC_STATS){0};
+}
+
+#if USART_RX_DMA
+/**
+ * @brief Adds the bytes of a frame that spans receive views to rpcRx.
+ * @param data The bytes, in a receive view.
+ * @param count Number of bytes.
+ */
+static void RPC_Append(const uint8_t *data, uint16_t count)
+{
+    if (rpcRxDiscard)
+        return;
+
+    // Longer than a frame with its code byte: drop it up to the delimiter
+    if (count > sizeof(rpcRx) - 1 - rpcRxEnd)
+    {
+        rpcStats.overflows++;
+        rpcRxDiscard = 1;
+        rpcRxEnd = 0;
+        return;
+    }
+
+    memcpy(&rpcRx[rpcRxEnd], data, count);
+    rpcRxEnd += count;
+}
+#endif
+
+/**
+ * @brief Receives pending bytes and answers every complete request that has a free response buffer.
+ *
+ * Call from the main loop. Handlers run here, not in interrupt context. When
+ * every response buffer is in flight nothing is read, so the next requests
+ * wait in the USART driver.
+ *
+ * With the RX ring, frames are read into rpcRx and handled where they
+ * landed; only a partial frame left at the end of rpcRx is moved to its
+ * start. With USART_RX_DMA, a frame that lies within one receive view is
+ * decoded in the DMA buffer itself, and only a frame that spans views or
+ * the wrap of the buffer is copied into rpcRx.
+ */
+void RPC_Poll(void)
+{
+    RPC_TX_BUFFER *tx;
+
+#if !USART_RX_DMA
+    while ((tx = RPC_GetFreeTx()) != NULL)
+    {
+        uint16_t index;
+
+        // Make room after a partial frame at the end of rpcRx
+        if (rpcRxEnd == sizeof(rpcRx) && rpcRxStart != 0)
+        {
+            rpcRxEnd -= rpcRxStart;
+            rpcRxScan -= rpcRxStart;
+            memmove(rpcRx, &rpcRx[rpcRxStart], rpcRxEnd);
+            rpcRxStart = 0;
+        }
+
+        rpcRxEnd += USART_Read(&rpcRx[rpcRxEnd], (uint16_t)(sizeof(rpcRx) - rpcRxEnd));
+
+        index = rpcRxScan;
+        while (index < rpcRxEnd && rpcRx[index] != 0)
+            index++;
+
+        if (index == rpcRxEnd)
+        {
+            rpcRxScan = index;
+            if (rpcRxEnd < sizeof(rpcRx))
+                return;
+
+            // Full after earlier frames: move this one to the start first
+            if (rpcRxStart != 0)
+                continue;
+
+            // Full without a delimiter: the frame cannot fit, drop it
+            if (!rpcRxDiscard)
+                rpcStats.overflows++;
+            rpcRxDiscard = 1;
+            rpcRxEnd = 0;
+            rpcRxScan = 0;
+            continue;
+        }
+
+        if (rpcRxDiscard)
+            rpcRxDiscard = 0;
+        else if (index != rpcRxStart)
+            RPC_Handle(&rpcRx[rpcRxStart], (uint16_t)(index - rpcRxStart), tx);
+
+        // The next frame starts after the delimiter
+        rpcRxStart = (uint16_t)(index + 1);
+        rpcRxScan = rpcRxStart;
+        if (rpcRxStart == rpcRxEnd)
+        {
+            rpcRxStart = 0;
+            rpcRxEnd = 0;
+            rpcRxScan = 0;
+        }
+    }
+#else
+    while ((tx = RPC_GetFreeTx()) != NULL)
+    {
+        USART_RX_VIEW view;
+        uint8_t *data;
+        uint16_t start;
+        uint16_t index;
+
+        if (USART_PeekRxView(&view) != USART_STATUS_SUCCESS)
+            return;
+
+        data = USART_GetRxDmaBuffer() + view.offset;
+        start = rpcViewUsed;
+        index = start;
+        while (index < view.length && data[index] != 0)
+            index++;
+
+        if (index == view.length)
+        {
+            // No delimiter: the frame continues in the next view
+            RPC_Append(&data[start], (uint16_t)(index - start));
+        }
+        else
+        {
+            rpcViewUsed = (uint16_t)(index + 1);
+
+            if (rpcRxEnd != 0 || rpcRxDiscard)
+            {
+                // End of a frame that began in an earlier view
+                RPC_Append(&data[start], (uint16_t)(index - start));
+                if (rpcRxDiscard)
+                    rpcRxDiscard = 0;
+                else
+                    RPC_Handle(rpcRx, rpcRxEnd, tx);
+                rpcRxEnd = 0;
+            }
+            else if ((uint16_t)(index - start) > sizeof(rpcRx) - 1)
+            {
+                rpcStats.overflows++;
+            }
+            else if (index != start)
+            {
+                RPC_Handle(&data[start], (uint16_t)(index - start), tx);
+            }
+
+            if (rpcViewUsed < view.length)
+                continue;
+        }
+
+        USART_ReleaseRxView();
+        rpcViewUsed = 0;
+    }
+#endif
+}
+
+/**
+ * @brief Computes the CRC-16/CCITT-FALSE of a buffer.
+ *
+ * Polynomial 0x1021, initial value 0xFFFF, no reflection, no final XOR.
+ *
+ * @param data The bytes.
+ * @param length Number of bytes.
+ * @return uint16_t: The CRC.
+ */
+uint16_t RPC_Crc16(const uint8_t *data, uint16_t length)
+{
+    uint16_t crc = 0xFFFF;
+
+    while (length--)
+    {
+        uint8_t byte = *data++;
+
+        crc = (uint16_t)(crc << 4) ^ rpcCrcTable[(crc >> 12) ^ (byte >> 4)];
+        crc = (uint16_t)(crc << 4) ^ rpcCrcTable[(crc >> 12) ^ (byte & 0x0F)];
+    }
+
+    return crc;
+}
+
+/**
+ * @brief Copies the frame counters.
+ * @param stats Receives the counters.
+ */
+void RPC_GetStats(RPC_STATS *stats)
+{
+    *stats = rpcStats;
+}
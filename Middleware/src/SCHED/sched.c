@@ -0,0 +1,278 @@
+#include "SCHED/sched.h"
+#include "PFIC/pfic.h"
+
+#if SCHED_ENABLE
+
+#if !PFIC_SW2_ENABLE
+#error "SCHED needs PFIC_SW2_ENABLE: define SCHED_ENABLE project-wide, not only for this file"
+#endif
+
+#if SCHED_MAX_TASKS > 8
+#error "SCHED_MAX_TASKS must not exceed 8"
+#endif
+
+#if (SCHED_QUEUE_DEPTH & (SCHED_QUEUE_DEPTH - 1)) != 0 || SCHED_QUEUE_DEPTH > 128
+#error "SCHED_QUEUE_DEPTH must be a power of two no larger than 128"
+#endif
+
+// Index of a task's preemption level: 0 for the high level, 1 for the low one
+#define SCHED_LEVEL(pficPrio) (((pficPrio) & PREEMPT_Msk) ? 1 : 0)
+
+// Number of PFIC preemption levels, each with its own dispatch vector
+#define SCHED_LEVELS 2
+
+// Bit of an interrupt in PFIC_IACTR1 (word 0) or PFIC_IACTR2 (word 1), 0 in the other word
+#define SCHED_VECTOR_BIT(irq, word) (((irq) >> 5) == (word) ? 1UL << ((irq) & 31) : 0UL)
+
+/**
+ * @brief Task control block: body, PFIC priority and event ring.
+ */
+typedef struct
+{
+    SCHED_TASK_FN fn;
+    uint8_t pficPrio;
+    uint8_t head;
+    uint8_t tail;
+    SCHED_EVENT events[SCHED_QUEUE_DEPTH];
+} SCHED_TASK;
+
+// Dispatch vector of each level, indexed by SCHED_LEVEL()
+static const PFIC_IRQ schedVectors[SCHED_LEVELS] = {PFIC_IRQ_SW2, PFIC_IRQ_SW};
+
+// Indexed by priority, entry 0 (the main loop) is unused
+static SCHED_TASK schedTasks[SCHED_MAX_TASKS + 1];
+
+// Ready bits of the tasks created on each level
+static uint8_t schedLevelTasks[SCHED_LEVELS];
+
+// Bit (prio - 1) is set while the task has queued events
+static volatile uint8_t schedReady;
+
+// Priority of the task currently running, 0 for the main loop
+static volatile uint8_t schedCurrPrio;
+
+/**
+ * @brief Returns the highest priority set in a ready mask (0 if empty).
+ */
+static uint8_t SCHED_HighestReady(uint8_t ready)
+{
+    uint8_t prio = 0;
+
+    while (ready)
+    {
+        prio++;
+        ready >>= 1;
+    }
+
+    return prio;
+}
+
+/**
+ * @brief Reports whether the caller is a task, i.e. only dispatch vectors are active.
+ */
+static uint8_t SCHED_InTaskContext(void)
+{
+    const uint32_t vectors1 = SCHED_VECTOR_BIT(PFIC_IRQ_SW, 0) | SCHED_VECTOR_BIT(PFIC_IRQ_SW2, 0);
+    const uint32_t vectors2 = SCHED_VECTOR_BIT(PFIC_IRQ_SW2, 1);
+    uint32_t active1 = PFIC->PFIC_IACTR1;
+    uint32_t active2 = PFIC->PFIC_IACTR2;
+
+    return ((active1 | active2) != 0) && ((active1 & ~vectors1) == 0) && ((active2 & ~vectors2) == 0);
+}
+
+/**
+ * @brief Runs every ready task of a level that outranks the current one, highest first.
+ *
+ * Called with interrupts disabled. Each task runs with interrupts enabled and
+ * the current priority raised to its own, so only higher-priority work can
+ * preempt it. The previous priority is restored on return.
+ *
+ * @param level The level whose tasks may run.
+ */
+static void SCHED_Activate(uint8_t level)
+{
+    uint8_t pin = schedCurrPrio;
+    uint8_t prio;
+
+    while ((prio = SCHED_HighestReady(schedReady & schedLevelTasks[level])) > pin)
+    {
+        SCHED_TASK *task = &schedTasks[prio];
+        SCHED_EVENT event = task->events[task->tail & (SCHED_QUEUE_DEPTH - 1)];
+
+        task->tail++;
+        if (task->tail == task->head)
+            schedReady &= ~(1 << (prio - 1));
+
+        schedCurrPrio = prio;
+
+        PFIC_EnableGlobalIRQ();
+        task->fn(event);
+        PFIC_DisableGlobalIRQ();
+    }
+
+    schedCurrPrio = pin;
+}
+
+/**
+ * @brief Dispatches the tasks of a level from its vector.
+ *
+ * Any re-pend of the vector raised while the loop ran has already been
+ * served, so it is discarded.
+ *
+ * @param level The level of the vector that was taken.
+ */
+static void SCHED_Dispatch(uint8_t level)
+{
+    uint32_t irqState = PFIC_DisableGlobalIRQ();
+
+    SCHED_Activate(level);
+
+    PFIC_ClearPendingIRQ(schedVectors[level]);
+
+    PFIC_RestoreGlobalIRQ(irqState);
+}
+
+/**
+ * @brief PFIC_IRQ_SW2 hook: dispatches the high-level tasks.
+ */
+static void SCHED_HighHook(void)
+{
+    SCHED_Dispatch(0);
+}
+
+/**
+ * @brief SW_Handler hook: dispatches the low-level tasks.
+ */
+static void SCHED_LowHook(void)
+{
+    SCHED_Dispatch(1);
+}
+
+/**
+ * @brief Installs the scheduler on both dispatch vectors and enables them.
+ *
+ * The vectors start at the lowest sub-priority of their level, so a
+ * hardware interrupt of the same level pending at the same time goes first.
+ */
+void SCHED_Init(void)
+{
+    schedReady = 0;
+    schedCurrPrio = 0;
+    schedLevelTasks[0] = 0;
+    schedLevelTasks[1] = 0;
+
+    PFIC_SetSWHook(SCHED_LowHook);
+    PFIC_SetSW2Hook(SCHED_HighHook);
+    PFIC_SetPriority(PFIC_IRQ_SW, PREEMPT_Msk | SUBPRIO_Msk);
+    PFIC_SetPriority(PFIC_IRQ_SW2, SUBPRIO_Msk);
+    PFIC_EnableIRQ(PFIC_IRQ_SW);
+    PFIC_EnableIRQ(PFIC_IRQ_SW2);
+}
+
+/**
+ * @brief Registers a task.
+ *
+ * A task may be re-created with a new body or level. The level must keep the
+ * priorities in order: no low-level task may outrank a high-level one, since
+ * a vector only ever preempts tasks below its own level.
+ *
+ * @param prio Task priority (1..SCHED_MAX_TASKS).
+ * @param fn Task body.
+ * @param pficPrio PFIC priority byte of the task.
+ * @return SCHED_STATUS: SCHED_STATUS_SUCCESS or SCHED_STATUS_FAILURE.
+ */
+SCHED_STATUS SCHED_CreateTask(uint8_t prio, SCHED_TASK_FN fn, uint8_t pficPrio)
+{
+    uint8_t level = SCHED_LEVEL(pficPrio);
+    uint8_t bit;
+    uint32_t irqState;
+
+    if (prio == 0 || prio > SCHED_MAX_TASKS || fn == 0)
+        return SCHED_STATUS_FAILURE;
+
+    bit = 1 << (prio - 1);
+
+    // Low-level tasks must all sit below the high-level ones
+    if (level == 0 ? (schedLevelTasks[1] & ~bit) > bit : (schedLevelTasks[0] & ~bit & (bit - 1)) != 0)
+        return SCHED_STATUS_FAILURE;
+
+    irqState = PFIC_DisableGlobalIRQ();
+
+    schedTasks[prio].fn = fn;
+    schedTasks[prio].pficPrio = pficPrio;
+    schedTasks[prio].head = 0;
+    schedTasks[prio].tail = 0;
+    schedReady &= ~bit;
+    schedLevelTasks[level ^ 1] &= ~bit;
+    schedLevelTasks[level] |= bit;
+
+    if (pficPrio < PFIC->PFIC_IPRIORX[schedVectors[level]])
+        PFIC_SetPriority(schedVectors[level], pficPrio);
+
+    PFIC_RestoreGlobalIRQ(irqState);
+
+    return SCHED_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Posts an event to a task.
+ *
+ * A task posting to a higher-priority task of its own level starts it
+ * synchronously. Everything else pends the target's level vector: it is
+ * taken at once if that level outranks whatever is running, and otherwise
+ * when the running work of its level returns.
+ *
+ * @param prio Priority of the target task.
+ * @param event The event to deliver.
+ * @return SCHED_STATUS: SCHED_STATUS_SUCCESS, SCHED_STATUS_FULL or SCHED_STATUS_FAILURE.
+ */
+SCHED_STATUS SCHED_Post(uint8_t prio, SCHED_EVENT event)
+{
+    SCHED_TASK *task;
+    uint8_t level;
+    uint32_t irqState;
+
+    if (prio == 0 || prio > SCHED_MAX_TASKS || schedTasks[prio].fn == 0)
+        return SCHED_STATUS_FAILURE;
+
+    task = &schedTasks[prio];
+    level = SCHED_LEVEL(task->pficPrio);
+    irqState = PFIC_DisableGlobalIRQ();
+
+    if ((uint8_t)(task->head - task->tail) >= SCHED_QUEUE_DEPTH)
+    {
+        PFIC_RestoreGlobalIRQ(irqState);
+        return SCHED_STATUS_FULL;
+    }
+
+    task->events[task->head & (SCHED_QUEUE_DEPTH - 1)] = event;
+    task->head++;
+    schedReady |= (1 << (prio - 1));
+
+    if (prio > schedCurrPrio && schedCurrPrio != 0 && SCHED_InTaskContext() &&
+        (schedLevelTasks[level] & (1 << (schedCurrPrio - 1))))
+    {
+        // Task-to-task on the same level: preempt the poster on the same stack
+        SCHED_Activate(level);
+    }
+    else
+    {
+        // Main loop, handler or another level: dispatch from the target's vector
+        PFIC_SetPendingIRQ(schedVectors[level]);
+    }
+
+    PFIC_RestoreGlobalIRQ(irqState);
+
+    return SCHED_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Returns the priority of the task currently running (0 in the main loop).
+ * @return uint8_t: Current priority.
+ */
+uint8_t SCHED_GetCurrentPriority(void)
+{
+    return schedCurrPrio;
+}
+
+#endif /* SCHED_ENABLE */
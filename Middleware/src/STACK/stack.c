@@ -0,0 +1,65 @@
+#include "STACK/stack.h"
+
+#if (STACK_GUARD_BYTES & 0x03) != 0
+#error "STACK_GUARD_BYTES must be a multiple of 4"
+#endif
+
+// Bounds of the .stack region, from Ld/Link.ld
+extern uint32_t _susrstack[];
+extern uint32_t _eusrstack[];
+
+/**
+ * @brief Returns the size of the .stack region.
+ * @return uint32_t: Size in bytes.
+ */
+uint32_t STACK_GetSize(void)
+{
+    return (uint32_t)(_eusrstack - _susrstack) * sizeof(uint32_t);
+}
+
+/**
+ * @brief Returns the deepest stack usage since reset.
+ *
+ * Scans upward from the bottom of the region for the first word that no longer
+ * holds STACK_PAINT. A value that happens to equal the pattern makes the result
+ * at most that many words low.
+ *
+ * @return uint32_t: High-water mark in bytes, measured from _eusrstack.
+ */
+uint32_t STACK_GetHighWater(void)
+{
+    const uint32_t *word = _susrstack;
+
+    while (word < _eusrstack && *word == STACK_PAINT)
+        word++;
+
+    return (uint32_t)(_eusrstack - word) * sizeof(uint32_t);
+}
+
+/**
+ * @brief Checks the guard zone and the current stack pointer.
+ *
+ * Cheap enough to run from a periodic tick: it reads STACK_GUARD_BYTES / 4
+ * words. A stack pointer already inside the guard zone is reported even if
+ * the words it points at were not written yet.
+ *
+ * @return STACK_STATUS: STACK_STATUS_OK or STACK_STATUS_OVERFLOW.
+ */
+STACK_STATUS STACK_Check(void)
+{
+    const uint32_t *guardEnd = _susrstack + (STACK_GUARD_BYTES / 4);
+    uintptr_t sp;
+
+    __asm__ volatile("mv %0, sp" : "=r"(sp));
+
+    if (sp < (uintptr_t)guardEnd)
+        return STACK_STATUS_OVERFLOW;
+
+    for (const uint32_t *word = _susrstack; word < guardEnd; word++)
+    {
+        if (*word != STACK_PAINT)
+            return STACK_STATUS_OVERFLOW;
+    }
+
+    return STACK_STATUS_OK;
+}
@@ -0,0 +1,403 @@
+#include "SWTIMER/swtimer.h"
+#include "PFIC/pfic.h"
+#include "SYSTICK/systick.h"
+
+#if (SWTIMER_SLOTS & (SWTIMER_SLOTS - 1)) != 0 || SWTIMER_SLOTS > 32
+#error "SWTIMER_SLOTS must be a power of two no larger than 32"
+#endif
+
+#if SWTIMER_COUNT > 255
+#error "SWTIMER_COUNT must not exceed 255"
+#endif
+
+// End of a slot list
+#define SWTIMER_NONE 0xFF
+
+/**
+ * @brief Life cycle of a pool entry.
+ */
+typedef enum
+{
+    SWTIMER_STATE_IDLE,    /**< Stopped, not linked. */
+    SWTIMER_STATE_RUNNING, /**< Linked into its wheel slot. */
+    SWTIMER_STATE_FIRING   /**< Expired, waiting for its callback in SWTIMER_Expire(). */
+} SWTIMER_STATE;
+
+/**
+ * @brief Pool entry: callback, absolute expiry in ms and slot list links.
+ */
+typedef struct
+{
+    SWTIMER_FN fn;
+    uint32_t arg;
+    uint32_t expiry;
+    uint32_t period;
+    uint8_t next;
+    uint8_t prev;
+    uint8_t state;
+} SWTIMER_ENTRY;
+
+static SWTIMER_ENTRY swTimers[SWTIMER_COUNT];
+static uint8_t swTimerCount;
+
+// First entry of each slot, and bit (slot) set while the slot is not empty
+static uint8_t swTimerHeads[SWTIMER_SLOTS];
+static uint32_t swTimerBusy;
+
+// Last millisecond whose slot has been processed
+static uint32_t swTimerLast;
+
+// Millisecond the SysTick alarm is armed for, valid while swTimerArmed is set
+static uint32_t swTimerAlarm;
+static uint8_t swTimerArmed;
+
+// Set while SWTIMER_Expire() runs callbacks, which defers re-arming to its end
+static volatile uint8_t swTimerExpiring;
+
+static void SWTIMER_Expire(void);
+
+/**
+ * @brief Returns the current time in ms, truncated to 32 bits.
+ */
+static uint32_t SWTIMER_Now(void)
+{
+    return (uint32_t)SYSTICK_GetMillis();
+}
+
+/**
+ * @brief Inserts a timer at the head of the slot of its expiry.
+ */
+static void SWTIMER_Link(uint8_t id)
+{
+    SWTIMER_ENTRY *timer = &swTimers[id];
+    uint8_t slot = timer->expiry & (SWTIMER_SLOTS - 1);
+    uint8_t head = swTimerHeads[slot];
+
+    timer->prev = SWTIMER_NONE;
+    timer->next = head;
+
+    if (head != SWTIMER_NONE)
+        swTimers[head].prev = id;
+
+    swTimerHeads[slot] = id;
+    swTimerBusy |= (1UL << slot);
+}
+
+/**
+ * @brief Removes a timer from its slot.
+ */
+static void SWTIMER_Unlink(uint8_t id)
+{
+    SWTIMER_ENTRY *timer = &swTimers[id];
+    uint8_t slot = timer->expiry & (SWTIMER_SLOTS - 1);
+
+    if (timer->prev != SWTIMER_NONE)
+        swTimers[timer->prev].next = timer->next;
+    else
+        swTimerHeads[slot] = timer->next;
+
+    if (timer->next != SWTIMER_NONE)
+        swTimers[timer->next].prev = timer->prev;
+
+    if (swTimerHeads[slot] == SWTIMER_NONE)
+        swTimerBusy &= ~(1UL << slot);
+}
+
+/**
+ * @brief Arms the SysTick alarm for a deadline, capped at SWTIMER_MAX_SLEEP_MS.
+ *
+ * The cycle count is read after now, so the alarm can be late by the time
+ * between both reads but never early.
+ */
+static void SWTIMER_Arm(uint32_t expiry, uint32_t now)
+{
+    int32_t delta = (int32_t)(expiry - now);
+
+    if (delta < 0)
+        delta = 0;
+
+    if (delta > SWTIMER_MAX_SLEEP_MS)
+        delta = SWTIMER_MAX_SLEEP_MS;
+
+    swTimerAlarm = now + delta;
+    swTimerArmed = 1;
+
+    SYSTICK_SetAlarm(SYSTICK_GetCycles() + ((uint32_t)delta * SYSTICK_GetCyclesPerMilli()),
+                     SWTIMER_Expire);
+}
+
+/**
+ * @brief Arms the alarm for the nearest deadline, or disarms it if no timer runs.
+ *
+ * Every running timer expires after swTimerLast, so the search starts there
+ * rather than at now: timers that fell due while the callbacks of the last
+ * batch ran are found first and fire immediately. The slots of the following
+ * SWTIMER_SLOTS milliseconds are searched in time order, skipping empty ones
+ * through the busy mask. Only when every running timer is at least one wheel
+ * revolution away are all entries scanned for the minimum.
+ * Called with interrupts disabled.
+ */
+static void SWTIMER_Rearm(uint32_t now)
+{
+    uint32_t best = 0;
+    uint8_t found = 0;
+
+    for (uint32_t step = 1; step <= SWTIMER_SLOTS && !found; step++)
+    {
+        uint32_t tick = swTimerLast + step;
+        uint8_t slot = tick & (SWTIMER_SLOTS - 1);
+
+        if (!(swTimerBusy & (1UL << slot)))
+            continue;
+
+        for (uint8_t id = swTimerHeads[slot]; id != SWTIMER_NONE; id = swTimers[id].next)
+        {
+            if (swTimers[id].expiry == tick)
+            {
+                best = tick;
+                found = 1;
+                break;
+            }
+        }
+    }
+
+    if (!found && swTimerBusy)
+    {
+        for (uint8_t slot = 0; slot < SWTIMER_SLOTS; slot++)
+        {
+            for (uint8_t id = swTimerHeads[slot]; id != SWTIMER_NONE; id = swTimers[id].next)
+            {
+                if (!found || (int32_t)(swTimers[id].expiry - best) < 0)
+                    best = swTimers[id].expiry;
+                found = 1;
+            }
+        }
+    }
+
+    if (found)
+    {
+        SWTIMER_Arm(best, now);
+    }
+    else
+    {
+        swTimerArmed = 0;
+        SYSTICK_CancelAlarm();
+    }
+}
+
+/**
+ * @brief SysTick alarm: runs every expired timer and re-arms for the next one.
+ *
+ * The slots between the last processed millisecond and now are walked with
+ * interrupts disabled and the due entries moved to a local list. Callbacks then
+ * run with interrupts enabled. A timer stopped or restarted by an earlier
+ * callback of the same batch is skipped.
+ */
+static void SWTIMER_Expire(void)
+{
+    uint8_t due[SWTIMER_COUNT];
+    uint8_t dueCount = 0;
+    uint32_t irqState = PFIC_DisableGlobalIRQ();
+    uint32_t now = SWTIMER_Now();
+    uint32_t steps = now - swTimerLast;
+    uint32_t tick = swTimerLast + 1;
+
+    swTimerArmed = 0;
+    swTimerExpiring = 1;
+
+    if (steps > SWTIMER_SLOTS)
+        steps = SWTIMER_SLOTS;
+
+    for (; steps; steps--, tick++)
+    {
+        uint8_t id = swTimerHeads[tick & (SWTIMER_SLOTS - 1)];
+
+        while (id != SWTIMER_NONE)
+        {
+            SWTIMER_ENTRY *timer = &swTimers[id];
+            uint8_t next = timer->next;
+
+            if ((int32_t)(timer->expiry - now) <= 0)
+            {
+                SWTIMER_Unlink(id);
+                timer->state = SWTIMER_STATE_FIRING;
+                due[dueCount++] = id;
+
+                if (timer->period)
+                {
+                    // Keep the phase, unless whole periods were missed
+                    timer->expiry += timer->period;
+                    if ((int32_t)(timer->expiry - now) <= 0)
+                        timer->expiry = now + timer->period;
+                }
+            }
+
+            id = next;
+        }
+    }
+
+    swTimerLast = now;
+    PFIC_RestoreGlobalIRQ(irqState);
+
+    for (uint8_t index = 0; index < dueCount; index++)
+    {
+        SWTIMER_ENTRY *timer = &swTimers[due[index]];
+        uint8_t fire = 0;
+
+        irqState = PFIC_DisableGlobalIRQ();
+
+        if (timer->state == SWTIMER_STATE_FIRING)
+        {
+            if (timer->period)
+            {
+                SWTIMER_Link(due[index]);
+                timer->state = SWTIMER_STATE_RUNNING;
+            }
+            else
+            {
+                timer->state = SWTIMER_STATE_IDLE;
+            }
+            fire = 1;
+        }
+
+        PFIC_RestoreGlobalIRQ(irqState);
+
+        if (fire)
+            timer->fn(timer->arg);
+    }
+
+    irqState = PFIC_DisableGlobalIRQ();
+    swTimerExpiring = 0;
+    SWTIMER_Rearm(SWTIMER_Now());
+    PFIC_RestoreGlobalIRQ(irqState);
+}
+
+/**
+ * @brief Resets the pool and the wheel.
+ */
+void SWTIMER_Init(void)
+{
+    SYSTICK_CancelAlarm();
+
+    swTimerCount = 0;
+    swTimerBusy = 0;
+    swTimerArmed = 0;
+    swTimerExpiring = 0;
+    swTimerLast = SWTIMER_Now();
+
+    for (uint8_t slot = 0; slot < SWTIMER_SLOTS; slot++)
+        swTimerHeads[slot] = SWTIMER_NONE;
+}
+
+/**
+ * @brief Allocates a timer from the pool. The timer is created stopped.
+ * @param fn Function to run on expiry.
+ * @param arg Argument passed to fn.
+ * @return SWTIMER_ID: The timer handle, or SWTIMER_INVALID if the pool is full.
+ */
+SWTIMER_ID SWTIMER_Create(SWTIMER_FN fn, uint32_t arg)
+{
+    SWTIMER_ID id = SWTIMER_INVALID;
+    uint32_t irqState;
+
+    if (fn == 0)
+        return SWTIMER_INVALID;
+
+    irqState = PFIC_DisableGlobalIRQ();
+
+    if (swTimerCount < SWTIMER_COUNT)
+    {
+        id = swTimerCount++;
+        swTimers[id].fn = fn;
+        swTimers[id].arg = arg;
+        swTimers[id].state = SWTIMER_STATE_IDLE;
+    }
+
+    PFIC_RestoreGlobalIRQ(irqState);
+
+    return id;
+}
+
+/**
+ * @brief Starts or restarts a timer.
+ *
+ * O(1): the timer is unlinked if running, then pushed onto the slot of its new
+ * expiry. The alarm is only re-armed when the new deadline is earlier than the
+ * one it is armed for.
+ *
+ * @param id The timer handle.
+ * @param delayMs Time to the first expiry, in ms (0 is treated as 1).
+ * @param periodMs Reload period in ms, or 0 for a one-shot timer.
+ * @return SWTIMER_STATUS: SWTIMER_STATUS_SUCCESS or SWTIMER_STATUS_FAILURE.
+ */
+SWTIMER_STATUS SWTIMER_Start(SWTIMER_ID id, uint32_t delayMs, uint32_t periodMs)
+{
+    SWTIMER_ENTRY *timer;
+    uint32_t irqState;
+    uint32_t now;
+
+    if (id >= swTimerCount)
+        return SWTIMER_STATUS_FAILURE;
+
+    timer = &swTimers[id];
+    irqState = PFIC_DisableGlobalIRQ();
+
+    // Read inside the section, so the expiry is always after swTimerLast
+    now = SWTIMER_Now();
+
+    if (timer->state == SWTIMER_STATE_RUNNING)
+        SWTIMER_Unlink(id);
+
+    timer->expiry = now + (delayMs ? delayMs : 1);
+    timer->period = periodMs;
+    timer->state = SWTIMER_STATE_RUNNING;
+    SWTIMER_Link(id);
+
+    if (!swTimerExpiring && (!swTimerArmed || (int32_t)(timer->expiry - swTimerAlarm) < 0))
+        SWTIMER_Arm(timer->expiry, now);
+
+    PFIC_RestoreGlobalIRQ(irqState);
+
+    return SWTIMER_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Stops a timer. Stopping a stopped timer is not an error.
+ *
+ * O(1): the alarm is left armed and finds nothing to do if this timer was the
+ * nearest one.
+ *
+ * @param id The timer handle.
+ * @return SWTIMER_STATUS: SWTIMER_STATUS_SUCCESS or SWTIMER_STATUS_FAILURE.
+ */
+SWTIMER_STATUS SWTIMER_Stop(SWTIMER_ID id)
+{
+    uint32_t irqState;
+
+    if (id >= swTimerCount)
+        return SWTIMER_STATUS_FAILURE;
+
+    irqState = PFIC_DisableGlobalIRQ();
+
+    if (swTimers[id].state == SWTIMER_STATE_RUNNING)
+        SWTIMER_Unlink(id);
+
+    swTimers[id].state = SWTIMER_STATE_IDLE;
+
+    PFIC_RestoreGlobalIRQ(irqState);
+
+    return SWTIMER_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Reports whether a timer is running.
+ * @param id The timer handle.
+ * @return uint8_t: 1 if running, 0 if stopped or invalid.
+ */
+uint8_t SWTIMER_IsActive(SWTIMER_ID id)
+{
+    if (id >= swTimerCount)
+        return 0;
+
+    return swTimers[id].state != SWTIMER_STATE_IDLE;
+}
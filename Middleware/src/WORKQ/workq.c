@@ -0,0 +1,145 @@
+#include "WORKQ/workq.h"
+#include "PFIC/pfic.h"
+
+#if (WORKQ_DEPTH & (WORKQ_DEPTH - 1)) != 0 || WORKQ_DEPTH > 128
+#error "WORKQ_DEPTH must be a power of two no larger than 128"
+#endif
+
+/**
+ * @brief A deferred work item.
+ */
+typedef struct
+{
+    WORKQ_FN fn;  /**< Function to execute. */
+    uint32_t arg; /**< Argument passed to fn. */
+} WORKQ_ITEM;
+
+/**
+ * @brief Single-producer/single-consumer ring.
+ *
+ * head and tail are free-running 8-bit counters; head is only written by the
+ * producer and tail only by the consumer, so no lock is required.
+ */
+typedef struct
+{
+    WORKQ_ITEM items[WORKQ_DEPTH];
+    volatile uint8_t head;
+    volatile uint8_t tail;
+    uint32_t drops;
+} WORKQ_RING;
+
+static WORKQ_RING workRings[WORKQ_LEVELS];
+static WORKQ_DRAIN workDrainMode;
+
+/**
+ * @brief SW_Handler hook used in WORKQ_DRAIN_SW mode.
+ */
+static void WORKQ_SWDrain(void)
+{
+    WORKQ_Drain();
+}
+
+/**
+ * @brief Selects where queued work is executed.
+ *
+ * In WORKQ_DRAIN_SW mode the software interrupt gets the lowest preemption level
+ * and sub-priority, so every peripheral interrupt with preemption bit 0 can still
+ * preempt the deferred work.
+ *
+ * @param drainMode WORKQ_DRAIN_MAIN or WORKQ_DRAIN_SW.
+ */
+void WORKQ_Init(WORKQ_DRAIN drainMode)
+{
+    workDrainMode = drainMode;
+
+    if (drainMode == WORKQ_DRAIN_SW)
+    {
+        PFIC_SetSWHook(WORKQ_SWDrain);
+        PFIC_SetPriority(PFIC_IRQ_SW, PREEMPT_Msk | SUBPRIO_Msk);
+        PFIC_EnableIRQ(PFIC_IRQ_SW);
+    }
+}
+
+/**
+ * @brief Queues a work item.
+ *
+ * The item is fully written before head is advanced, so the consumer never sees
+ * a half-written slot.
+ *
+ * @param level The ring matching the caller's preemption level.
+ * @param fn The function to execute later.
+ * @param arg The argument passed to fn.
+ * @return WORKQ_STATUS: WORKQ_STATUS_SUCCESS, or WORKQ_STATUS_FULL if the ring has no free slot.
+ */
+WORKQ_STATUS WORKQ_Post(WORKQ_LEVEL level, WORKQ_FN fn, uint32_t arg)
+{
+    WORKQ_RING *ring = &workRings[level];
+    uint8_t head = ring->head;
+
+    // Ring full: count the drop and let the caller decide
+    if ((uint8_t)(head - ring->tail) >= WORKQ_DEPTH)
+    {
+        ring->drops++;
+        return WORKQ_STATUS_FULL;
+    }
+
+    ring->items[head & (WORKQ_DEPTH - 1)].fn = fn;
+    ring->items[head & (WORKQ_DEPTH - 1)].arg = arg;
+
+    // Publish the slot only after its contents are in memory
+    __asm volatile("" ::: "memory");
+    ring->head = head + 1;
+
+    if (workDrainMode == WORKQ_DRAIN_SW)
+        PFIC_SetPendingIRQ(PFIC_IRQ_SW);
+
+    return WORKQ_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Executes every queued item, high level first.
+ *
+ * After each item the scan restarts at the high level, so work posted by a
+ * high-priority handler in the meantime overtakes the remaining low-level items.
+ *
+ * @return uint32_t: The number of items executed.
+ */
+uint32_t WORKQ_Drain(void)
+{
+    uint32_t count = 0;
+    uint8_t level = 0;
+
+    while (level < WORKQ_LEVELS)
+    {
+        WORKQ_RING *ring = &workRings[level];
+        uint8_t tail = ring->tail;
+
+        if (tail == ring->head)
+        {
+            level++;
+            continue;
+        }
+
+        WORKQ_ITEM item = ring->items[tail & (WORKQ_DEPTH - 1)];
+
+        // Release the slot only after it has been copied out
+        __asm volatile("" ::: "memory");
+        ring->tail = tail + 1;
+
+        item.fn(item.arg);
+        count++;
+        level = 0;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Returns the number of items dropped because a ring was full.
+ * @param level The ring to query.
+ * @return uint32_t: Dropped item count since reset.
+ */
+uint32_t WORKQ_GetDropCount(WORKQ_LEVEL level)
+{
+    return workRings[level].drops;
+}
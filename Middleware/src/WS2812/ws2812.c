@@ -0,0 +1,201 @@
+#include <stddef.h>
+#include "WS2812/ws2812.h"
+#include "DMA/dma.h"
+#include "GPIO/afio.h"
+#include "PFIC/pfic.h"
+#include "SYS/sys.h"
+#include "SYS/profile.h"
+#include "TIM/tim.h"
+
+#if WS2812_ENABLE
+
+#if WS2812_BYTES_PER_LED != 3 && WS2812_BYTES_PER_LED != 4
+#error "WS2812_BYTES_PER_LED must be 3 or 4"
+#endif
+
+#if WS2812_DMA_LEDS < 1 || WS2812_DMA_LEDS > 8
+#error "WS2812_DMA_LEDS must be within 1..8"
+#endif
+
+#define WS2812_BIT_RATE 800000UL
+
+// Shortest period that still separates the 0 and 1 high times
+#define WS2812_PERIOD_MIN 10
+#define WS2812_PERIOD_MAX 255
+
+// High times as fractions of the 1.25 us period: 0.35 us and 0.7 us
+#define WS2812_T0_NUM 7
+#define WS2812_T1_NUM 14
+#define WS2812_T_DEN 25
+
+// Compare values per DMA half, and the zero halves that make up the reset time
+#define WS2812_HALF (WS2812_DMA_LEDS * WS2812_BYTES_PER_LED * 8)
+#define WS2812_RESET_BITS ((WS2812_RESET_US * (WS2812_BIT_RATE / 1000) + 999) / 1000)
+#define WS2812_RESET_HALVES ((WS2812_RESET_BITS + WS2812_HALF - 1) / WS2812_HALF + 1)
+
+void DMA1_Channel2_IRQHandler(void) PFIC_INTERRUPT_HANDLER HIGHCODE;
+
+// Circular DMA buffer: one compare value per bit, two halves
+static uint8_t ws2812Dma[2 * WS2812_HALF];
+
+static uint8_t *ws2812Pixels;
+static uint16_t ws2812Length;
+
+// Next pixel byte to encode, and zero halves still to send after the pixels
+static uint16_t ws2812Next;
+static uint8_t ws2812Zeros;
+
+// Compare values for a 0 and a 1 bit
+static uint8_t ws2812T0;
+static uint8_t ws2812T1;
+
+static volatile uint8_t ws2812Busy;
+
+/**
+ * @brief Encodes the next pixel bytes into one DMA half, MSB first.
+ *
+ * After the last pixel the half is padded with zeros, which keep the line
+ * low; WS2812_RESET_HALVES zero halves follow before the stream ends.
+ *
+ * @param out The half to fill.
+ * @return uint8_t: 1 if the half was filled, 0 if the frame is complete.
+ */
+static HIGHCODE uint8_t WS2812_Fill(uint8_t *out)
+{
+    uint8_t *start = out;
+    uint8_t *end = out + WS2812_HALF;
+    uint8_t t0 = ws2812T0;
+    uint8_t t1 = ws2812T1;
+
+    while (out < end && ws2812Next < ws2812Length)
+    {
+        uint8_t byte = ws2812Pixels[ws2812Next++];
+
+        for (uint8_t bit = 0; bit < 8; bit++, byte <<= 1)
+            *out++ = (byte & 0x80) ? t1 : t0;
+    }
+
+    if (out == start)
+    {
+        if (ws2812Zeros == 0)
+            return 0;
+        ws2812Zeros--;
+    }
+
+    while (out < end)
+        *out++ = 0;
+
+    return 1;
+}
+
+/**
+ * @brief Sets up TIM2, its pin and the DMA channel for a strip.
+ *
+ * TIM2 runs without prescaler at HCLK / 800 kHz ticks per period (30 at
+ * 24 MHz, 60 at 48 MHz). The selected remap is applied with
+ * AFIO_PinRemap(); the AFIO clock is enabled by SystemInit().
+ *
+ * @param pixels The pixel buffer, count * WS2812_BYTES_PER_LED bytes; must stay valid.
+ * @param count Number of LEDs.
+ * @return WS2812_STATUS: WS2812_STATUS_SUCCESS or WS2812_STATUS_INVALID_CLOCK.
+ */
+WS2812_STATUS WS2812_Init(uint8_t *pixels, uint16_t count)
+{
+    // The rounded HCLK / 800 kHz, minus one
+    uint32_t period = (uint32_t)TIM_GetPrescaler(WS2812_BIT_RATE) + 1;
+
+    if (period < WS2812_PERIOD_MIN || period > WS2812_PERIOD_MAX)
+        return WS2812_STATUS_INVALID_CLOCK;
+
+    ws2812Pixels = pixels;
+    ws2812Length = count * WS2812_BYTES_PER_LED;
+    ws2812T0 = (uint8_t)((period * WS2812_T0_NUM + WS2812_T_DEN / 2) / WS2812_T_DEN);
+    ws2812T1 = (uint8_t)((period * WS2812_T1_NUM + WS2812_T_DEN / 2) / WS2812_T_DEN);
+    ws2812Busy = 0;
+
+    AFIO_PinRemap(AFIO_RM_TIM2_RM, (AFIO_MAP)WS2812_REMAP);
+    TIM_TimeBaseInit(TIMER2, 0, (uint16_t)(period - 1), 0);
+    TIM_PwmInit(TIMER2, WS2812_CHANNEL, 0, TIM_PWM_PRELOAD);
+    TIM_PwmPinInit(TIMER2, WS2812_CHANNEL, WS2812_REMAP);
+    TIM_StreamInit(TIMER2, WS2812_CHANNEL,
+                   DMA_MODE_CIRCULAR | DMA_MODE_IRQ_HALF | DMA_MODE_IRQ_COMPLETE | DMA_MODE_PRIORITY_HIGH);
+    PFIC_EnableIRQ(PFIC_IRQ_DMA1_CHANNEL2);
+
+    return WS2812_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Stores one LED's colour in the pixel buffer, in wire order.
+ * @param index LED index.
+ * @param color 0xWWRRGGBB (white only used with 4 bytes per LED).
+ */
+void WS2812_SetPixel(uint16_t index, uint32_t color)
+{
+    uint8_t *pixel = &ws2812Pixels[index * WS2812_BYTES_PER_LED];
+
+    pixel[0] = (uint8_t)(color >> 8);
+    pixel[1] = (uint8_t)(color >> 16);
+    pixel[2] = (uint8_t)color;
+#if WS2812_BYTES_PER_LED == 4
+    pixel[3] = (uint8_t)(color >> 24);
+#endif
+}
+
+/**
+ * @brief Starts sending the pixel buffer to the strip.
+ *
+ * Both DMA halves are encoded here, the rest from the DMA interrupt. The
+ * pixel buffer must not change until WS2812_IsBusy() returns 0.
+ *
+ * @return WS2812_STATUS: WS2812_STATUS_SUCCESS or WS2812_STATUS_BUSY.
+ */
+WS2812_STATUS WS2812_Show(void)
+{
+    if (ws2812Busy)
+        return WS2812_STATUS_BUSY;
+
+    ws2812Busy = 1;
+    ws2812Next = 0;
+    ws2812Zeros = WS2812_RESET_HALVES;
+
+    WS2812_Fill(&ws2812Dma[0]);
+    WS2812_Fill(&ws2812Dma[WS2812_HALF]);
+
+    TIM_StreamStart(TIMER2, ws2812Dma, sizeof(ws2812Dma));
+    TIM_Start(TIMER2);
+
+    return WS2812_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Returns 1 until the frame is sent and latched.
+ * @return uint8_t: 1 while busy, 0 when the pixel buffer may be changed again.
+ */
+uint8_t WS2812_IsBusy(void)
+{
+    return ws2812Busy;
+}
+
+/**
+ * @brief TIM2 update DMA half / full transfer handler, overriding the weak
+ * vector. Runs from RAM: with the defaults it refills a half every 60 us.
+ *
+ * Re-encodes the half the DMA just left. Once the reset time has been
+ * sent, the stream and the timer are stopped with the output low (the last
+ * compare value was 0).
+ */
+PROFILE_IRQ_HANDLER(DMA1_Channel2_IRQHandler, PFIC_IRQ_DMA1_CHANNEL2)
+{
+    uint32_t flags = DMA_GetFlags(TIM_GetUpdateDmaChannel(TIMER2));
+
+    DMA_ClearFlags(TIM_GetUpdateDmaChannel(TIMER2), DMA_FLAG_ALL);
+
+    if (WS2812_Fill((flags & DMA_FLAG_COMPLETE) ? &ws2812Dma[WS2812_HALF] : &ws2812Dma[0]))
+        return;
+
+    TIM_StreamStop(TIMER2);
+    TIM_Stop(TIMER2);
+    ws2812Busy = 0;
+}
+
+#endif /* WS2812_ENABLE */
@@ -0,0 +1,150 @@
+#ifndef DMA_H
+#define DMA_H
+
+#include <stdint.h>
+#include "dma_bits.h"
+#include "dma_reg.h"
+
+/**
+ * @file dma.h
+ * @brief Public interface for the DMA1 channel driver.
+ *
+ * A channel is set up once with DMA_ChannelInit() (direction, increments,
+ * sizes, interrupts and the peripheral register) and then started for each
+ * transfer with DMA_ChannelStart(), which only rewrites the memory address
+ * and the count. The start, stop and flag helpers are inline so that
+ * interrupt handlers can chain transfers with a handful of stores.
+ *
+ * Request mapping used by the drivers: USART1 TX = channel 4,
+ * USART1 RX = channel 5, TIM1 update = channel 5, TIM2 update = channel 2,
+ * timer compare / capture channels as listed below (TIM_GetCaptureDmaChannel()).
+ */
+
+// --- ENUMERATED TYPES ---
+
+/**
+ * @brief DMA1 channels.
+ */
+typedef enum
+{
+    DMA_CHANNEL_1, /**< ADC1, TIM2 CH3. */
+    DMA_CHANNEL_2, /**< SPI1 RX, TIM1 CH1, TIM2 UP. */
+    DMA_CHANNEL_3, /**< SPI1 TX, TIM1 CH2. */
+    DMA_CHANNEL_4, /**< USART1 TX, TIM1 CH4/TRIG/COM. */
+    DMA_CHANNEL_5, /**< USART1 RX, TIM1 UP, TIM2 CH1. */
+    DMA_CHANNEL_6, /**< I2C1 TX, TIM1 CH3. */
+    DMA_CHANNEL_7  /**< I2C1 RX, TIM2 CH2/CH4. */
+} DMA_CHANNEL;
+
+/**
+ * @brief Channel options for DMA_ChannelInit(), combined with '|'.
+ *
+ * The defaults (no option) are: peripheral to memory, normal mode, no
+ * increments, 8-bit transfers, low priority, no interrupts. The memory and
+ * peripheral sizes may differ, e.g. bytes from RAM into a 32-bit timer
+ * register.
+ */
+typedef enum
+{
+    DMA_MODE_MEM_TO_PERIPH = DMA_DIR_Msk,            /**< Read memory, write the peripheral. */
+    DMA_MODE_CIRCULAR = DMA_CIRC_Msk,                /**< Reload the count and addresses at the end. */
+    DMA_MODE_PERIPH_INC = DMA_PINC_Msk,              /**< Increment the peripheral address. */
+    DMA_MODE_MEM_INC = DMA_MINC_Msk,                 /**< Increment the memory address. */
+    DMA_MODE_IRQ_COMPLETE = DMA_TCIE_Msk,            /**< Interrupt on transfer complete. */
+    DMA_MODE_IRQ_HALF = DMA_HTIE_Msk,                /**< Interrupt on half transfer. */
+    DMA_MODE_IRQ_ERROR = DMA_TEIE_Msk,               /**< Interrupt on transfer error. */
+    DMA_MODE_SIZE_16 = (0x01 << DMA_PSIZE_Pos) | (0x01 << DMA_MSIZE_Pos), /**< 16-bit transfers. */
+    DMA_MODE_SIZE_32 = (0x02 << DMA_PSIZE_Pos) | (0x02 << DMA_MSIZE_Pos), /**< 32-bit transfers. */
+    DMA_MODE_MEM_SIZE_16 = 0x01 << DMA_MSIZE_Pos,    /**< 16-bit memory side only. */
+    DMA_MODE_PERIPH_SIZE_16 = 0x01 << DMA_PSIZE_Pos, /**< 16-bit peripheral side only. */
+    DMA_MODE_PERIPH_SIZE_32 = 0x02 << DMA_PSIZE_Pos, /**< 32-bit peripheral side only; narrower reads are zero-extended. */
+    DMA_MODE_PRIORITY_MEDIUM = 0x01 << DMA_PL_Pos,   /**< Medium arbitration priority. */
+    DMA_MODE_PRIORITY_HIGH = 0x02 << DMA_PL_Pos,     /**< High arbitration priority. */
+    DMA_MODE_PRIORITY_VERY_HIGH = 0x03 << DMA_PL_Pos /**< Very high arbitration priority. */
+} DMA_MODE;
+
+/**
+ * @brief Channel event flags, as returned by DMA_GetFlags().
+ */
+typedef enum
+{
+    DMA_FLAG_GLOBAL = DMA_GIF_Msk,            /**< Any of the events below. */
+    DMA_FLAG_COMPLETE = DMA_TCIF_Msk,         /**< Count reached 0. */
+    DMA_FLAG_HALF = DMA_HTIF_Msk,             /**< Count reached half its start value. */
+    DMA_FLAG_ERROR = DMA_TEIF_Msk,            /**< Bus error, the channel was disabled. */
+    DMA_FLAG_ALL = DMA_GIF_Msk | DMA_TCIF_Msk | DMA_HTIF_Msk | DMA_TEIF_Msk /**< All four flags. */
+} DMA_FLAG;
+
+// --- FUNCTION PROTOTYPES ---
+
+/**
+ * @brief Enables the DMA clock and configures a stopped channel.
+ * @param channel The channel.
+ * @param mode DMA_MODE options combined with '|'.
+ * @param peripheral Address of the peripheral data register.
+ */
+void DMA_ChannelInit(DMA_CHANNEL channel, uint32_t mode, volatile void *peripheral);
+
+// --- INLINE FUNCTIONS ---
+
+/**
+ * @brief Starts a transfer on a configured channel.
+ *
+ * The channel is disabled first, since the count and addresses can only be
+ * written while it is stopped. Pending flags of the channel are cleared.
+ *
+ * @param channel The channel.
+ * @param memory Start of the memory buffer.
+ * @param count Number of transfers (1..65535).
+ */
+static inline void DMA_ChannelStart(DMA_CHANNEL channel, const volatile void *memory, uint16_t count)
+{
+    DMA_Channel_Typedef *regs = DMA_CHANNEL_REGS(channel);
+
+    regs->CFGR &= ~DMA_EN_Msk;
+    DMA->INTFCR = (uint32_t)DMA_FLAG_ALL << (DMA_FLAG_STRIDE * channel);
+    regs->MADDR = (uint32_t)(uintptr_t)memory;
+    regs->CNTR = count;
+    regs->CFGR |= DMA_EN_Msk;
+}
+
+/**
+ * @brief Stops a channel. The remaining count stays readable.
+ * @param channel The channel.
+ */
+static inline void DMA_ChannelStop(DMA_CHANNEL channel)
+{
+    DMA_CHANNEL_REGS(channel)->CFGR &= ~DMA_EN_Msk;
+}
+
+/**
+ * @brief Returns the number of transfers left on a channel.
+ * @param channel The channel.
+ * @return uint16_t: The current count.
+ */
+static inline uint16_t DMA_GetRemaining(DMA_CHANNEL channel)
+{
+    return (uint16_t)DMA_CHANNEL_REGS(channel)->CNTR;
+}
+
+/**
+ * @brief Returns the pending event flags of a channel.
+ * @param channel The channel.
+ * @return uint32_t: DMA_FLAG bits.
+ */
+static inline uint32_t DMA_GetFlags(DMA_CHANNEL channel)
+{
+    return (DMA->INTFR >> (DMA_FLAG_STRIDE * channel)) & DMA_FLAG_ALL;
+}
+
+/**
+ * @brief Clears event flags of a channel.
+ * @param channel The channel.
+ * @param flags DMA_FLAG bits to clear.
+ */
+static inline void DMA_ClearFlags(DMA_CHANNEL channel, uint32_t flags)
+{
+    DMA->INTFCR = flags << (DMA_FLAG_STRIDE * channel);
+}
+
+#endif /* DMA_H */
@@ -0,0 +1,66 @@
+#ifndef DMA_BITS_H
+#define DMA_BITS_H
+
+/**
+ * @file dma_bits.h
+ * @brief Register Bit Definitions for the DMA1 controller.
+ *
+ * Field names carry a DMA_ prefix, as in usart_bits.h. INTFR and INTFCR hold
+ * four bits per channel; the positions below are for channel 1 and move up by
+ * DMA_FLAG_STRIDE per channel.
+ */
+
+// DMA Interrupt Status Register (DMA_INTFR) / Flag Clear Register (DMA_INTFCR)
+
+// Bits per channel
+#define DMA_FLAG_STRIDE 4
+// Single bit field position (channel 1)
+#define DMA_GIF_Pos 0
+#define DMA_TCIF_Pos 1
+#define DMA_HTIF_Pos 2
+#define DMA_TEIF_Pos 3
+// Single bit field mask (channel 1)
+#define DMA_GIF_Msk (0x01 << DMA_GIF_Pos)
+#define DMA_TCIF_Msk (0x01 << DMA_TCIF_Pos)
+#define DMA_HTIF_Msk (0x01 << DMA_HTIF_Pos)
+#define DMA_TEIF_Msk (0x01 << DMA_TEIF_Pos)
+
+// DMA Channel Configuration Register (DMA_CFGRx)
+
+// Single bit field position
+#define DMA_EN_Pos 0
+#define DMA_TCIE_Pos 1
+#define DMA_HTIE_Pos 2
+#define DMA_TEIE_Pos 3
+#define DMA_DIR_Pos 4
+#define DMA_CIRC_Pos 5
+#define DMA_PINC_Pos 6
+#define DMA_MINC_Pos 7
+#define DMA_MEM2MEM_Pos 14
+// Single bit field mask
+#define DMA_EN_Msk (0x01 << DMA_EN_Pos)
+#define DMA_TCIE_Msk (0x01 << DMA_TCIE_Pos)
+#define DMA_HTIE_Msk (0x01 << DMA_HTIE_Pos)
+#define DMA_TEIE_Msk (0x01 << DMA_TEIE_Pos)
+#define DMA_DIR_Msk (0x01 << DMA_DIR_Pos)
+#define DMA_CIRC_Msk (0x01 << DMA_CIRC_Pos)
+#define DMA_PINC_Msk (0x01 << DMA_PINC_Pos)
+#define DMA_MINC_Msk (0x01 << DMA_MINC_Pos)
+#define DMA_MEM2MEM_Msk (0x01 << DMA_MEM2MEM_Pos)
+// Multi bit field position
+#define DMA_PSIZE_Pos 8
+#define DMA_MSIZE_Pos 10
+#define DMA_PL_Pos 12
+// Multi bit field mask
+#define DMA_PSIZE_Msk (0x03 << DMA_PSIZE_Pos)
+#define DMA_MSIZE_Msk (0x03 << DMA_MSIZE_Pos)
+#define DMA_PL_Msk (0x03 << DMA_PL_Pos)
+
+// DMA Channel Transfer Count Register (DMA_CNTRx)
+
+// Multi bit field position
+#define DMA_NDT_Pos 0
+// Multi bit field mask
+#define DMA_NDT_Msk (0xFFFF << DMA_NDT_Pos)
+
+#endif /* DMA_BITS_H */
@@ -0,0 +1,77 @@
+#ifndef DMA_REG_H
+#define DMA_REG_H
+
+#include <stdint.h>
+#include "dma_bits.h"
+
+/**
+ * @brief Base address of the DMA1 controller.
+ * * Seven channels, each hard-wired to a set of peripheral requests (e.g.,
+ * USART1 TX on channel 4, USART1 RX on channel 5).
+ */
+#define DMA_BASE 0x40020000UL
+
+/**
+ * @brief Offset of the channel 1 registers and distance between channels.
+ */
+#define DMA_CHANNEL_OFFSET 0x08UL
+#define DMA_CHANNEL_STRIDE 0x14UL
+
+/**
+ * @brief DMA controller Register Map Structure (shared flag registers).
+ */
+typedef struct
+{
+    /** @brief Interrupt Status Register (DMA_INTFR)
+     * Global, transfer complete, half transfer and error flags, four per channel.
+     */
+    volatile uint32_t INTFR;
+
+    /** @brief Interrupt Flag Clear Register (DMA_INTFCR)
+     * Write 1 to clear the matching INTFR flag.
+     */
+    volatile uint32_t INTFCR;
+} DMA_Typedef;
+
+/**
+ * @brief DMA channel Register Map Structure.
+ */
+typedef struct
+{
+    /** @brief Channel Configuration Register (DMA_CFGRx)
+     * Enable, interrupt enables, direction, circular mode, increments, data
+     * sizes and priority. Only EN may be changed while the channel runs.
+     */
+    volatile uint32_t CFGR;
+
+    /** @brief Channel Transfer Count Register (DMA_CNTRx)
+     * Transfers left. Writable only while the channel is disabled.
+     */
+    volatile uint32_t CNTR;
+
+    /** @brief Channel Peripheral Address Register (DMA_PADDRx)
+     */
+    volatile uint32_t PADDR;
+
+    /** @brief Channel Memory Address Register (DMA_MADDRx)
+     */
+    volatile uint32_t MADDR;
+
+    /** @brief Reserved memory space (Offset 0x10)
+     */
+    volatile uint32_t RESERVED;
+} DMA_Channel_Typedef;
+
+/**
+ * @brief Pointer definition for accessing the DMA flag registers.
+ * * Named DMA because DMA1 is already the RCC_PERIPHERAL enumerator.
+ */
+#define DMA ((DMA_Typedef *)DMA_BASE)
+
+/**
+ * @brief Pointer to the registers of a channel, from its DMA_CHANNEL index.
+ */
+#define DMA_CHANNEL_REGS(channel) \
+    ((DMA_Channel_Typedef *)(DMA_BASE + DMA_CHANNEL_OFFSET + DMA_CHANNEL_STRIDE * (uint32_t)(channel)))
+
+#endif /* DMA_REG_H */
@@ -95,6 +95,11 @@ typedef enum
     EXTI_CLR_INT_FLAG_IF9
 } EXTI_CLR_INT_FLAG;
 
+/**
+ * @brief Callback run by the EXTI7_0 interrupt dispatcher for one line.
+ */
+typedef void (*EXTI_CALLBACK)(void);
+
 // --- FUNCTION PROTOTYPES ---
 
 /**
@@ -111,6 +116,14 @@ void EXTI_InterruptInit(EXTI_INT_EVEN_EN enable_disable, EXTI_INT_EVEN channel);
  */
 void EXTI_EventInit(EXTI_INT_EVEN_EN enable_disable, EXTI_INT_EVEN channel);
 
+/**
+ * @brief Sleeps the core until one of the selected EXTI event lines fires.
+ *
+ * Execution resumes right after the sleep instruction, with no interrupt entry.
+ * @param lineMask OR of the MRx_Msk bits of the lines allowed to wake the core.
+ */
+void EXTI_WaitForEvent(uint32_t lineMask);
+
 /**
  * @brief Configures the edge detection (Rising or Falling).
  *
@@ -133,4 +146,13 @@ void EXTI_SWInterruptTrigger(EXTI_SW_INT channel);
  */
 void EXTI_ClearInterruptFlag(EXTI_CLR_INT_FLAG channel);
 
+/**
+ * @brief Registers the callback the EXTI7_0 interrupt dispatcher runs for a line.
+ *
+ * The dispatcher clears the pending flag before running the callback.
+ * @param channel The EXTI line (0-7).
+ * @param callback The function to run, or 0 to ignore the line.
+ */
+void EXTI_RegisterCallback(EXTI_INT_EVEN channel, EXTI_CALLBACK callback);
+
 #endif /* EXTI_H */
\ No newline at end of file
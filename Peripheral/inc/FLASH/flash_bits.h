@@ -0,0 +1,15 @@
+#ifndef FLASH_BITS_H
+#define FLASH_BITS_H
+
+// Flash Access Control Register (FLASH_ACTLR)
+
+// Multi bit field position
+#define LATENCY_Pos 0
+// Multi bit field mask
+#define LATENCY_Msk (0x03 << LATENCY_Pos)
+// LATENCY field values
+#define LATENCY_0WS (0x00 << LATENCY_Pos) /**< 0 wait states, SYSCLK <= 24 MHz. */
+#define LATENCY_1WS (0x01 << LATENCY_Pos) /**< 1 wait state, 24 MHz < SYSCLK <= 48 MHz. */
+#define LATENCY_2WS (0x02 << LATENCY_Pos) /**< 2 wait states. */
+
+#endif /* FLASH_BITS_H */
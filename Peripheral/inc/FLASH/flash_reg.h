@@ -0,0 +1,58 @@
+#ifndef FLASH_REG_H
+#define FLASH_REG_H
+
+#include <stdint.h>
+#include "flash_bits.h"
+
+/**
+ * @brief Base address of the Flash memory interface registers.
+ */
+#define FLASH_BASE 0x40022000UL
+
+/**
+ * @brief Flash Interface Register Map Structure.
+ */
+typedef struct
+{
+    /** @brief Access Control Register (FLASH_ACTLR)
+     * Number of wait states inserted on flash reads, set according to SYSCLK.
+     */
+    volatile uint32_t ACTLR;
+
+    /** @brief FPEC Key Register (FLASH_KEYR) */
+    volatile uint32_t KEYR;
+
+    /** @brief OBKEY Register (FLASH_OBKEYR) */
+    volatile uint32_t OBKEYR;
+
+    /** @brief Status Register (FLASH_STATR) */
+    volatile uint32_t STATR;
+
+    /** @brief Configuration Register (FLASH_CTLR) */
+    volatile uint32_t CTLR;
+
+    /** @brief Address Register (FLASH_ADDR) */
+    volatile uint32_t ADDR;
+
+    /** @brief Reserved memory space (Offset 0x18) */
+    volatile uint32_t RESERVED0;
+
+    /** @brief Option Byte Register (FLASH_OBR) */
+    volatile uint32_t OBR;
+
+    /** @brief Write Protection Register (FLASH_WPR) */
+    volatile uint32_t WPR;
+
+    /** @brief Extended Key Register (FLASH_MODEKEYR) */
+    volatile uint32_t MODEKEYR;
+
+    /** @brief Boot Key Register (FLASH_BOOT_MODEKEYR) */
+    volatile uint32_t BOOT_MODEKEYR;
+} FLASH_Typedef;
+
+/**
+ * @brief Pointer definition for accessing Flash interface registers.
+ */
+#define FLASH ((FLASH_Typedef *)FLASH_BASE)
+
+#endif /* FLASH_REG_H */
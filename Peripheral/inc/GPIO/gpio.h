@@ -121,7 +121,8 @@ uint8_t GPIO_ReadPin(GPIO_Typedef *GPIOPort, GPIO_PIN GPIOPin);
  * @brief Sets or Clears the output state of a single GPIO pin.
  *
  * Uses the Port Bit Set/Reset Register (BSHR) for atomic and safe manipulation
- * of the pin's output state.
+ * of the pin's output state. Placed in RAM (HIGHCODE) with GPIO_ReadPin and
+ * GPIO_TogglePin.
  *
  * @param GPIOPort Pointer to the GPIO Port structure.
  * @param GPIOPin The pin number to write to.
@@ -132,8 +133,8 @@ void GPIO_WritePin(GPIO_Typedef *GPIOPort, GPIO_PIN GPIOPin, GPIO_VALUE Value);
 /**
  * @brief Inverts the current output state of a single GPIO pin.
  *
- * This function performs a read-modify-write operation on the OUTDR or uses the
- * BSHR/BCR registers to flip the pin state.
+ * Reads OUTDR and writes the opposite state through BSHR, so other pins of the
+ * port are never touched.
  *
  * @param GPIOPort Pointer to the GPIO Port structure.
  * @param GPIOPin The pin number to toggle.
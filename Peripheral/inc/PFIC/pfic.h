@@ -0,0 +1,221 @@
+#ifndef PFIC_H
+#define PFIC_H
+
+#include <stdint.h>
+#include "pfic_bits.h"
+#include "pfic_reg.h"
+
+/**
+ * @file pfic.h
+ * @brief Public interface for the Programmable Fast Interrupt Controller (PFIC) Driver.
+ *
+ * This header defines the interrupt numbers of the CH32V003 vector table and the
+ * function prototypes for enabling, pending and prioritizing interrupts, as well as
+ * the core sleep primitives controlled through PFIC_SCTLR.
+ */
+
+/**
+ * @brief Attribute for interrupt handlers that override the weak vectors.
+ *
+ * handle_reset enables the hardware prologue/epilogue, which stacks the
+ * caller-saved registers on entry, so the compiler only has to emit mret.
+ */
+#define PFIC_INTERRUPT_HANDLER __attribute__((interrupt("WCH-Interrupt-fast")))
+
+// --- CONFIGURATION ---
+
+/**
+ * @brief Set to 1 to turn the PFIC_SW2_IRQ vector into a second software
+ * interrupt (PFIC_IRQ_SW2) with a priority of its own. Follows SCHED_ENABLE
+ * unless set, the scheduler being its user; define either project-wide.
+ */
+#ifndef PFIC_SW2_ENABLE
+#if defined(SCHED_ENABLE) && SCHED_ENABLE
+#define PFIC_SW2_ENABLE 1
+#else
+#define PFIC_SW2_ENABLE 0
+#endif
+#endif
+
+/**
+ * @brief Vector taken by PFIC_IRQ_SW2 and its handler name in the startup
+ * file, defined together. The peripheral must have no driver in the build;
+ * the default is the I2C1 error interrupt.
+ */
+#ifndef PFIC_SW2_IRQ
+#define PFIC_SW2_IRQ PFIC_IRQ_I2C1_ER
+#define PFIC_SW2_HANDLER I2C1_ER_IRQHandler
+#endif
+
+#if PFIC_SW2_ENABLE && !defined(PFIC_SW2_HANDLER)
+#error "PFIC_SW2_IRQ needs PFIC_SW2_HANDLER, the name of its vector"
+#endif
+
+// --- ENUMERATED TYPES ---
+
+/**
+ * @brief Interrupt numbers, matching the vector table in startup_ch32v00x.S.
+ */
+typedef enum
+{
+    PFIC_IRQ_NMI = 2,           /**< Non-Maskable Interrupt */
+    PFIC_IRQ_HARDFAULT = 3,     /**< Hard Fault exception */
+    PFIC_IRQ_SYSTICK = 12,      /**< SysTick timer */
+    PFIC_IRQ_SW = 14,           /**< Software interrupt (SW_Handler) */
+    PFIC_IRQ_WWDG = 16,         /**< Window Watchdog */
+    PFIC_IRQ_PVD,               /**< PVD through EXTI line detect */
+    PFIC_IRQ_FLASH,             /**< Flash */
+    PFIC_IRQ_RCC,               /**< RCC */
+    PFIC_IRQ_EXTI7_0,           /**< EXTI lines 7..0 */
+    PFIC_IRQ_AWU,               /**< Auto Wake-Up */
+    PFIC_IRQ_DMA1_CHANNEL1,     /**< DMA1 channel 1 */
+    PFIC_IRQ_DMA1_CHANNEL2,     /**< DMA1 channel 2 */
+    PFIC_IRQ_DMA1_CHANNEL3,     /**< DMA1 channel 3 */
+    PFIC_IRQ_DMA1_CHANNEL4,     /**< DMA1 channel 4 */
+    PFIC_IRQ_DMA1_CHANNEL5,     /**< DMA1 channel 5 */
+    PFIC_IRQ_DMA1_CHANNEL6,     /**< DMA1 channel 6 */
+    PFIC_IRQ_DMA1_CHANNEL7,     /**< DMA1 channel 7 */
+    PFIC_IRQ_ADC1,              /**< ADC1 */
+    PFIC_IRQ_I2C1_EV,           /**< I2C1 event */
+    PFIC_IRQ_I2C1_ER,           /**< I2C1 error */
+    PFIC_IRQ_USART1,            /**< USART1 */
+    PFIC_IRQ_SPI1,              /**< SPI1 */
+    PFIC_IRQ_TIM1_BRK,          /**< TIM1 break */
+    PFIC_IRQ_TIM1_UP,           /**< TIM1 update */
+    PFIC_IRQ_TIM1_TRG_COM,      /**< TIM1 trigger and commutation */
+    PFIC_IRQ_TIM1_CC,           /**< TIM1 capture compare */
+    PFIC_IRQ_TIM2               /**< TIM2 */
+} PFIC_IRQ;
+
+#if PFIC_SW2_ENABLE
+/**
+ * @brief Interrupt used as a second software interrupt, with its own priority.
+ *
+ * Only entered when pended by software; its handler runs the
+ * PFIC_SetSW2Hook() hook.
+ */
+#define PFIC_IRQ_SW2 PFIC_SW2_IRQ
+#endif
+
+/**
+ * @brief Function run by SW_Handler (or the PFIC_IRQ_SW2 handler) when the
+ * software interrupt is taken.
+ */
+typedef void (*PFIC_SW_HOOK)(void);
+
+// --- FUNCTION PROTOTYPES ---
+
+/**
+ * @brief Enables the specified interrupt in the PFIC.
+ * @param irq The interrupt number to enable.
+ */
+void PFIC_EnableIRQ(PFIC_IRQ irq);
+
+/**
+ * @brief Disables the specified interrupt in the PFIC.
+ * @param irq The interrupt number to disable.
+ */
+void PFIC_DisableIRQ(PFIC_IRQ irq);
+
+/**
+ * @brief Sets the pending flag of the specified interrupt (software trigger).
+ * @param irq The interrupt number to pend.
+ */
+void PFIC_SetPendingIRQ(PFIC_IRQ irq);
+
+/**
+ * @brief Clears the pending flag of the specified interrupt.
+ * @param irq The interrupt number to un-pend.
+ */
+void PFIC_ClearPendingIRQ(PFIC_IRQ irq);
+
+/**
+ * @brief Reports whether the specified interrupt is currently being serviced.
+ * @param irq The interrupt number to query.
+ * @return uint8_t: 1 if the interrupt is active, 0 otherwise.
+ */
+uint8_t PFIC_GetActive(PFIC_IRQ irq);
+
+/**
+ * @brief Sets the priority of the specified interrupt.
+ *
+ * With interrupt nesting enabled, bit 7 selects the preemption level and bit 6
+ * the sub-priority. A lower value means a higher priority.
+ *
+ * @param irq The interrupt number to configure.
+ * @param priority The raw IPRIOR byte (e.g., PREEMPT_Msk for the low preemption level).
+ */
+void PFIC_SetPriority(PFIC_IRQ irq, uint8_t priority);
+
+/**
+ * @brief Installs the function that SW_Handler runs.
+ *
+ * SW_Handler is owned by this driver so that several modules (deferred work,
+ * scheduler) can share the software interrupt without duplicate definitions.
+ * @param hook The function to run, or 0 to make SW_Handler return immediately.
+ */
+void PFIC_SetSWHook(PFIC_SW_HOOK hook);
+
+#if PFIC_SW2_ENABLE
+/**
+ * @brief Installs the function that the PFIC_IRQ_SW2 handler runs.
+ * @param hook The function to run, or 0 to make the handler return immediately.
+ */
+void PFIC_SetSW2Hook(PFIC_SW_HOOK hook);
+#endif
+
+/**
+ * @brief Discards any latched wake-up event and arms WFI to behave as WFE.
+ *
+ * Must be called before the event sources are unmasked, so an event that
+ * arrives in between is latched and not lost.
+ */
+void PFIC_ClearEvent(void);
+
+/**
+ * @brief Sleeps until a wake-up event arrives, then resumes inline.
+ *
+ * No vector is fetched and no context is saved: execution continues with the
+ * instruction after the sleep. PFIC_ClearEvent() must have been called first.
+ */
+void PFIC_WaitForEvent(void);
+
+/**
+ * @brief Resets the whole system (core and peripherals). Does not return.
+ */
+void PFIC_SystemReset(void) __attribute__((noreturn));
+
+// --- INLINE FUNCTIONS ---
+
+/**
+ * @brief Disables interrupts globally by clearing mstatus.MIE.
+ * @return uint32_t: The previous MIE state, to be handed to PFIC_RestoreGlobalIRQ().
+ */
+static inline uint32_t PFIC_DisableGlobalIRQ(void)
+{
+    uint32_t mstatus;
+
+    __asm volatile("csrrci %0, mstatus, %1" : "=r"(mstatus) : "i"(MIE_Msk) : "memory");
+
+    return mstatus & MIE_Msk;
+}
+
+/**
+ * @brief Re-enables interrupts globally if they were enabled before PFIC_DisableGlobalIRQ().
+ * @param state The value returned by PFIC_DisableGlobalIRQ().
+ */
+static inline void PFIC_RestoreGlobalIRQ(uint32_t state)
+{
+    if (state)
+        __asm volatile("csrsi mstatus, %0" : : "i"(MIE_Msk) : "memory");
+}
+
+/**
+ * @brief Enables interrupts globally by setting mstatus.MIE.
+ */
+static inline void PFIC_EnableGlobalIRQ(void)
+{
+    __asm volatile("csrsi mstatus, %0" : : "i"(MIE_Msk) : "memory");
+}
+
+#endif /* PFIC_H */
@@ -0,0 +1,74 @@
+#ifndef PFIC_BITS_H
+#define PFIC_BITS_H
+
+// Interrupt Priority Threshold Configuration Register (PFIC_ITHRESDR)
+
+// Multi bit field position
+#define THRESHOLD_Pos 0
+// Multi bit field mask
+#define THRESHOLD_Msk (0xFF << THRESHOLD_Pos)
+
+// Interrupt Configuration Register (PFIC_CFGR)
+
+// Single bit field position
+#define RESETSYS_Pos 7
+// Single bit field mask
+#define RESETSYS_Msk (0x01 << RESETSYS_Pos)
+// Multi bit field position
+#define KEYCODE_Pos 16
+// Multi bit field mask
+#define KEYCODE_Msk (0xFFFF << KEYCODE_Pos)
+// Key values that unlock writes to PFIC_CFGR
+#define KEYCODE_KEY1 (0xFA05UL << KEYCODE_Pos)
+#define KEYCODE_KEY2 (0xBCAFUL << KEYCODE_Pos)
+#define KEYCODE_KEY3 (0xBEEFUL << KEYCODE_Pos)
+
+// Interrupt Global Status Register (PFIC_GISR)
+
+// Single bit field position
+#define GACTSTA_Pos 8
+#define GPENDSTA_Pos 9
+// Single bit field mask
+#define GACTSTA_Msk (0x01 << GACTSTA_Pos)
+#define GPENDSTA_Msk (0x01 << GPENDSTA_Pos)
+// Multi bit field position
+#define NESTSTA_Pos 0
+// Multi bit field mask
+#define NESTSTA_Msk (0xFF << NESTSTA_Pos)
+
+// Interrupt Priority Configuration Register (PFIC_IPRIORx)
+
+// Single bit field position (valid when interrupt nesting is enabled)
+#define PREEMPT_Pos 7
+#define SUBPRIO_Pos 6
+// Single bit field mask
+#define PREEMPT_Msk (0x01 << PREEMPT_Pos)
+#define SUBPRIO_Msk (0x01 << SUBPRIO_Pos)
+
+// System Control Register (PFIC_SCTLR)
+
+// Single bit field position
+#define SLEEPONEXIT_Pos 1
+#define SLEEPDEEP_Pos 2
+#define WFITOWFE_Pos 3
+#define SEVONPEND_Pos 4
+#define SETEVENT_Pos 5
+#define SYSRESET_Pos 31
+// Single bit field mask
+#define SLEEPONEXIT_Msk (0x01 << SLEEPONEXIT_Pos)
+#define SLEEPDEEP_Msk (0x01 << SLEEPDEEP_Pos)
+#define WFITOWFE_Msk (0x01 << WFITOWFE_Pos)
+#define SEVONPEND_Msk (0x01 << SEVONPEND_Pos)
+#define SETEVENT_Msk (0x01 << SETEVENT_Pos)
+#define SYSRESET_Msk (0x01UL << SYSRESET_Pos)
+
+// Machine Status CSR (mstatus)
+
+// Single bit field position
+#define MIE_Pos 3
+#define MPIE_Pos 7
+// Single bit field mask
+#define MIE_Msk (0x01 << MIE_Pos)
+#define MPIE_Msk (0x01 << MPIE_Pos)
+
+#endif /* PFIC_BITS_H */
@@ -2,6 +2,7 @@
 #define PFIC_REG_H
 
 #include <stdint.h>
+#include "pfic_bits.h"
 
 /**
  * @brief Base address of the Programmable Fast Interrupt Controller (PFIC).
@@ -17,50 +18,50 @@
  */
 typedef struct
 {
-    volatile uint32_t PFIC_ISR1; /**< Interrupt Status Register 1 */
+    volatile uint32_t PFIC_ISR1; /**< Interrupt Status Register 1 (Offset 0x00) */
     volatile uint32_t PFIC_ISR2; /**< Interrupt Status Register 2 */
-    volatile uint32_t RESERVED0[7];
+    volatile uint32_t RESERVED0[6];
 
-    volatile uint32_t IPR1; /**< Interrupt Pending Status Register 1 */
+    volatile uint32_t IPR1; /**< Interrupt Pending Status Register 1 (Offset 0x20) */
     volatile uint32_t IPR2; /**< Interrupt Pending Status Register 2 */
-    volatile uint32_t RESERVED1[7];
+    volatile uint32_t RESERVED1[6];
 
-    volatile uint32_t PFIC_ITHRESDR; /**< Interrupt Priority Threshold Configuration Register */
-    volatile uint32_t RESERVED2[2];
+    volatile uint32_t PFIC_ITHRESDR; /**< Interrupt Priority Threshold Configuration Register (Offset 0x40) */
+    volatile uint32_t RESERVED2;
 
-    volatile uint32_t PFIC_CFGR;   /**< Interrupt Configuration Register */
-    volatile uint32_t PFIC_GISR;   /**< Interrupt Global Status Register */
-    volatile uint32_t PFIC_VTFIDR; /**< VTF (Vector Table Free) Interrupt ID Configuration Register */
-    volatile uint32_t RESERVED3[4];
+    volatile uint32_t PFIC_CFGR;   /**< Interrupt Configuration Register (Offset 0x48) */
+    volatile uint32_t PFIC_GISR;   /**< Interrupt Global Status Register (Offset 0x4C) */
+    volatile uint32_t PFIC_VTFIDR; /**< VTF (Vector Table Free) Interrupt ID Configuration Register (Offset 0x50) */
+    volatile uint32_t RESERVED3[3];
 
-    volatile uint32_t PFIC_VTFADDR0; /**< VTF Interrupt 0 Offset Address Register */
+    volatile uint32_t PFIC_VTFADDR0; /**< VTF Interrupt 0 Offset Address Register (Offset 0x60) */
     volatile uint32_t PFIC_VTFADDR1; /**< VTF Interrupt 1 Offset Address Register */
-    volatile uint32_t RESERVED4[39];
+    volatile uint32_t RESERVED4[38];
 
-    volatile uint32_t PFIC_IENR1; /**< Interrupt Enable Setting Register 1 (Set-Enable) */
+    volatile uint32_t PFIC_IENR1; /**< Interrupt Enable Setting Register 1 (Set-Enable, Offset 0x100) */
     volatile uint32_t PFIC_IENR2; /**< Interrupt Enable Setting Register 2 (Set-Enable) */
-    volatile uint32_t RESERVED5[31];
+    volatile uint32_t RESERVED5[30];
 
-    volatile uint32_t PFIC_IRER1; /**< Interrupt Enable Clear Register 1 (Clear-Enable) */
+    volatile uint32_t PFIC_IRER1; /**< Interrupt Enable Clear Register 1 (Clear-Enable, Offset 0x180) */
     volatile uint32_t PFIC_IRER2; /**< Interrupt Enable Clear Register 2 (Clear-Enable) */
-    volatile uint32_t RESERVED6[31];
+    volatile uint32_t RESERVED6[30];
 
-    volatile uint32_t PFIC_IPSR1; /**< Interrupt Pending Setting Register 1 */
+    volatile uint32_t PFIC_IPSR1; /**< Interrupt Pending Setting Register 1 (Offset 0x200) */
     volatile uint32_t PFIC_IPSR2; /**< Interrupt Pending Setting Register 2 */
-    volatile uint32_t RESERVED7[31];
+    volatile uint32_t RESERVED7[30];
 
-    volatile uint32_t PFIC_IPRR1; /**< Interrupt Pending Clear Register 1 */
+    volatile uint32_t PFIC_IPRR1; /**< Interrupt Pending Clear Register 1 (Offset 0x280) */
     volatile uint32_t PFIC_IPRR2; /**< Interrupt Pending Clear Register 2 */
-    volatile uint32_t RESERVED8[31];
+    volatile uint32_t RESERVED8[30];
 
-    volatile uint32_t PFIC_IACTR1; /**< Interrupt Activation Status Register 1 */
+    volatile uint32_t PFIC_IACTR1; /**< Interrupt Activation Status Register 1 (Offset 0x300) */
     volatile uint32_t PFIC_IACTR2; /**< Interrupt Activation Status Register 2 */
-    volatile uint32_t RESERVED9[63];
+    volatile uint32_t RESERVED9[62];
 
-    volatile uint32_t PFIC_IPRIORX; /**< Interrupt Priority Configuration Register */
-    volatile uint32_t RESERVED10[580];
+    volatile uint8_t PFIC_IPRIORX[256]; /**< Interrupt Priority Configuration Registers, one byte per IRQ (Offset 0x400) */
+    volatile uint32_t RESERVED10[516];
 
-    volatile uint32_t PFIC_SCTLR; /**< System Control Register */
+    volatile uint32_t PFIC_SCTLR; /**< System Control Register (Offset 0xD10) */
 } PFIC_Typedef;
 
 /**
@@ -69,4 +70,4 @@ typedef struct
 
 #define PFIC ((PFIC_Typedef *)PFIC_BASE)
 
-#endif /* PFIC_REG_H */
\ No newline at end of file
+#endif /* PFIC_REG_H */
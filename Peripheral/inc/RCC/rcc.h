@@ -12,6 +12,20 @@
 #include <stdint.h>
 #include "rcc_reg.h"
 
+// --- CONFIGURATION ---
+
+/**
+ * @brief Frequency of the internal RC oscillator, in Hz.
+ */
+#define RCC_HSI_VALUE 24000000UL
+
+/**
+ * @brief Frequency of the external crystal or clock, in Hz. Override to match the board.
+ */
+#ifndef RCC_HSE_VALUE
+#define RCC_HSE_VALUE 24000000UL
+#endif
+
 // --- ENUMERATED TYPES ---
 
 /**
@@ -179,6 +193,14 @@ RCC_STATUS RCC_SetAHBPrescaler(RCC_AHB_PRESCALER ahbPreScaler);
  */
 RCC_SYSCLK_SRC RCC_GetSystemClock(void);
 
+/**
+ * @brief Computes the current AHB clock (HCLK) frequency from the RCC configuration.
+ *
+ * Uses RCC_HSI_VALUE and RCC_HSE_VALUE for the oscillator frequencies.
+ * @return uint32_t: HCLK frequency in Hz.
+ */
+uint32_t RCC_GetHCLKFreq(void);
+
 /**
  * @brief Sets the System Clock (SYSCLK) source.
  *
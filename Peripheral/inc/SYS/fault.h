@@ -0,0 +1,99 @@
+#ifndef FAULT_H
+#define FAULT_H
+
+#include <stdint.h>
+
+/**
+ * @file fault.h
+ * @brief Public interface for the HardFault/NMI crash capture.
+ *
+ * HardFault_Handler and NMI_Handler (overriding the weak spin loops of the
+ * startup file) store the trap CSRs, the faulting sp, ra and a0 and the
+ * FAULT_STACK_WORDS words at sp into a checksummed record in .noinit RAM,
+ * then reset the system. The record survives the reset, so the application
+ * can report the crash at the next boot with FAULT_GetRecord() and discard it
+ * with FAULT_Clear(), resuming service within milliseconds.
+ *
+ * The handlers switch to the top of the stack before running any C code, so
+ * a fault caused by a stack overflow is still captured. The stack window is
+ * only copied when sp points into RAM. With HPE enabled (INTSYSCR bit 0, set
+ * by the startup file) the frame HPE pushed on trap entry is skipped, so sp
+ * and the window are those of the faulting code, not of the saved registers.
+ */
+
+// --- CONFIGURATION ---
+
+/**
+ * @brief Number of stack words captured from the faulting sp upward.
+ */
+#ifndef FAULT_STACK_WORDS
+#define FAULT_STACK_WORDS 8
+#endif
+
+// --- ENUMERATED TYPES ---
+
+/**
+ * @brief Trap that produced a record.
+ */
+typedef enum
+{
+    FAULT_SOURCE_HARDFAULT, /**< HardFault_Handler (exception or hard fault escalation). */
+    FAULT_SOURCE_NMI        /**< NMI_Handler (e.g., HSE clock security). */
+} FAULT_SOURCE;
+
+/**
+ * @brief Status codes returned by FAULT_GetRecord().
+ */
+typedef enum
+{
+    FAULT_STATUS_VALID, /**< A crash record is present. */
+    FAULT_STATUS_NONE   /**< No record, or the record failed its checksum. */
+} FAULT_STATUS;
+
+// --- TYPES ---
+
+/**
+ * @brief Crash record kept in .noinit RAM.
+ */
+typedef struct
+{
+    uint32_t magic;                    /**< Marks an initialized record. */
+    uint32_t count;                    /**< Crashes since the record was last cleared. */
+    uint32_t source;                   /**< FAULT_SOURCE of the last crash. */
+    uint32_t mcause;                   /**< Trap cause. */
+    uint32_t mepc;                     /**< Address of the faulting instruction. */
+    uint32_t mtval;                    /**< Faulting address or instruction, cause dependent. */
+    uint32_t sp;                       /**< Stack pointer at the fault, before the HPE frame. */
+    uint32_t ra;                       /**< Return address at the fault. */
+    uint32_t a0;                       /**< a0 at the fault. */
+    uint32_t stack[FAULT_STACK_WORDS]; /**< Words at sp, 0 if sp was not in RAM. */
+    uint32_t checksum;                 /**< Checksum of every field above. */
+} FAULT_RECORD;
+
+/**
+ * @brief Character output used by FAULT_Dump() (e.g., a UART transmit routine).
+ */
+typedef void (*FAULT_PUTC)(char c);
+
+// --- FUNCTION PROTOTYPES ---
+
+/**
+ * @brief Copies the crash record left by a previous fault.
+ * @param record Receives the record when valid.
+ * @return FAULT_STATUS: FAULT_STATUS_VALID or FAULT_STATUS_NONE.
+ */
+FAULT_STATUS FAULT_GetRecord(FAULT_RECORD *record);
+
+/**
+ * @brief Discards the crash record.
+ */
+void FAULT_Clear(void);
+
+/**
+ * @brief Writes a crash record as text, one "name=0xVALUE" field per line.
+ * @param record The record to dump.
+ * @param putChar Character output function.
+ */
+void FAULT_Dump(const FAULT_RECORD *record, FAULT_PUTC putChar);
+
+#endif /* FAULT_H */
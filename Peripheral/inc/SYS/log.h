@@ -0,0 +1,212 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdint.h>
+
+/**
+ * @file log.h
+ * @brief Public interface for the tokenized (deferred formatting) logger.
+ *
+ * LOG_INFO("adc %d mV", millivolts) does not format anything on the target.
+ * The format string is placed in the .log_fmt section, which the linker
+ * script keeps in the ELF as a non-loaded (INFO) section: it costs no flash.
+ * The address of the string in that section is the message's 16-bit format
+ * ID. A log call appends the ID and the raw 32-bit arguments to a word ring
+ * in RAM, a few dozen cycles with interrupts disabled, so it is safe from
+ * any context. Tools/log_decode.py reads the strings back from the ELF and
+ * does the printf formatting on the host.
+ *
+ * Stream format, little-endian 32-bit words:
+ *   header: bits 0..15 format ID, bits 16..18 argument count (0..4),
+ *           bits 24..31 sequence number (gaps show dropped messages)
+ *   followed by one word per argument.
+ *
+ * The stored string is "<level letter>|<file>:<line>|<format>". Arguments are
+ * integers or pointers cast to an integer; %s, %f and 64-bit values are not
+ * supported, since only the argument words reach the host.
+ *
+ * The ring is drained by LOG_Drain() over any byte output, or without copying
+ * through LOG_Peek() / LOG_Release(), e.g. as a USART_WriteChain() segment
+ * released from its done callback. A message that does not fit the free
+ * space is dropped whole and counted.
+ */
+
+// --- CONFIGURATION ---
+
+/**
+ * @brief Set to 0 to compile every log call out.
+ */
+#ifndef LOG_ENABLE
+#define LOG_ENABLE 1
+#endif
+
+/**
+ * @brief Most verbose level compiled in: calls above it compile to nothing.
+ */
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+/**
+ * @brief Ring size in 32-bit words. Must be a power of two no larger than 32768.
+ */
+#ifndef LOG_BUFFER_WORDS
+#define LOG_BUFFER_WORDS 64
+#endif
+
+// --- TYPES ---
+
+/**
+ * @brief Byte output used by LOG_Drain() (e.g., a UART transmit routine).
+ */
+typedef void (*LOG_PUTC)(uint8_t byte);
+
+// --- FUNCTION PROTOTYPES ---
+
+/**
+ * @brief Empties the ring and resets the sequence number and drop counter.
+ */
+void LOG_Init(void);
+
+/**
+ * @brief Appends a message without arguments. Use the LOG_ macros.
+ * @param id Format ID.
+ */
+void LOG_Write0(uint16_t id);
+
+/**
+ * @brief Appends a message with one argument. Use the LOG_ macros.
+ * @param id Format ID.
+ * @param a0 First argument.
+ */
+void LOG_Write1(uint16_t id, uint32_t a0);
+
+/**
+ * @brief Appends a message with two arguments. Use the LOG_ macros.
+ * @param id Format ID.
+ * @param a0 First argument.
+ * @param a1 Second argument.
+ */
+void LOG_Write2(uint16_t id, uint32_t a0, uint32_t a1);
+
+/**
+ * @brief Appends a message with three arguments. Use the LOG_ macros.
+ * @param id Format ID.
+ * @param a0 First argument.
+ * @param a1 Second argument.
+ * @param a2 Third argument.
+ */
+void LOG_Write3(uint16_t id, uint32_t a0, uint32_t a1, uint32_t a2);
+
+/**
+ * @brief Appends a message with four arguments. Use the LOG_ macros.
+ * @param id Format ID.
+ * @param a0 First argument.
+ * @param a1 Second argument.
+ * @param a2 Third argument.
+ * @param a3 Fourth argument.
+ */
+void LOG_Write4(uint16_t id, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3);
+
+/**
+ * @brief Returns the oldest contiguous run of pending stream bytes.
+ * @param data Receives the start of the run.
+ * @return uint16_t: Number of bytes, 0 if the ring is empty.
+ */
+uint16_t LOG_Peek(const uint8_t **data);
+
+/**
+ * @brief Frees bytes returned by LOG_Peek() once they are sent.
+ * @param length Number of bytes, a multiple of 4.
+ */
+void LOG_Release(uint16_t length);
+
+/**
+ * @brief Writes every pending message to a byte output.
+ * @param putByte Byte output function.
+ */
+void LOG_Drain(LOG_PUTC putByte);
+
+/**
+ * @brief Returns the number of messages dropped because the ring was full.
+ * @return uint32_t: Dropped messages since LOG_Init().
+ */
+uint32_t LOG_GetDropped(void);
+
+// --- INLINE FUNCTIONS ---
+
+/**
+ * @brief Never called: lets the compiler check the format against the arguments.
+ */
+static inline void LOG_CheckFormat(const char *format, ...) __attribute__((format(printf, 1, 2)));
+static inline void LOG_CheckFormat(const char *format, ...)
+{
+    (void)format;
+}
+
+// --- MACROS ---
+
+/**
+ * @brief Verbosity levels for LOG_LEVEL.
+ */
+#define LOG_LEVEL_ERROR 0
+#define LOG_LEVEL_WARN 1
+#define LOG_LEVEL_INFO 2
+#define LOG_LEVEL_DEBUG 3
+
+#define LOG_STRINGIFY_(x) #x
+#define LOG_STRINGIFY(x) LOG_STRINGIFY_(x)
+#define LOG_CAT_(a, b) a##b
+#define LOG_CAT(a, b) LOG_CAT_(a, b)
+
+/**
+ * @brief Number of variadic arguments (0..4).
+ */
+#define LOG_ARGC_(_0, _1, _2, _3, _4, n, ...) n
+#define LOG_ARGC(...) LOG_ARGC_(_, ##__VA_ARGS__, 4, 3, 2, 1, 0)
+
+/**
+ * @brief Stores the format string in .log_fmt and appends the message.
+ *
+ * aligned(1) keeps the compiler from padding the strings, so the section is
+ * the strings back to back.
+ */
+#if LOG_ENABLE
+#define LOG_MESSAGE(letter, format, ...)                                                         \
+    do                                                                                           \
+    {                                                                                            \
+        static const char logFormat[] __attribute__((section(".log_fmt"), aligned(1), used)) =   \
+            letter "|" __FILE__ ":" LOG_STRINGIFY(__LINE__) "|" format;                          \
+        if (0)                                                                                   \
+            LOG_CheckFormat(format, ##__VA_ARGS__);                                              \
+        LOG_CAT(LOG_Write, LOG_ARGC(__VA_ARGS__))((uint16_t)(uintptr_t)logFormat, ##__VA_ARGS__); \
+    } while (0)
+#else
+#define LOG_MESSAGE(letter, format, ...) ((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(format, ...) LOG_MESSAGE("E", format, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(format, ...) ((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(format, ...) LOG_MESSAGE("W", format, ##__VA_ARGS__)
+#else
+#define LOG_WARN(format, ...) ((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(format, ...) LOG_MESSAGE("I", format, ##__VA_ARGS__)
+#else
+#define LOG_INFO(format, ...) ((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(format, ...) LOG_MESSAGE("D", format, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(format, ...) ((void)0)
+#endif
+
+#endif /* LOG_H */
@@ -0,0 +1,216 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+#include "PFIC/pfic.h"
+#include "SYSTICK/systick_reg.h"
+
+/**
+ * @file profile.h
+ * @brief Public interface for the CPU load meter and per-interrupt accounting.
+ *
+ * Interrupt handlers are defined with PROFILE_IRQ_HANDLER() instead of a plain
+ * function. With PROFILE_ENABLE set, the wrapper stamps the SysTick counter on
+ * entry and exit and adds the handler's own cycles (time spent in nested
+ * handlers excluded) and one call to the record of its IRQ number. With
+ * PROFILE_ENABLE cleared it expands to the bare handler definition.
+ *
+ * The main loop brackets its idle part (e.g., the WFI or the "nothing to do"
+ * branch) with PROFILE_IdleEnter() / PROFILE_IdleExit(). Interrupts taken while
+ * idle are not counted as idle. The CPU load over the window since
+ * PROFILE_Reset() is then 1 - idle / window.
+ *
+ * Counters are 32 bits of HCLK cycles, so a window must be read and reset at
+ * least every 2^32 cycles (89 s at 48 MHz). The SysTick counter must be
+ * running at HCLK (SYSTICK_Init()).
+ *
+ * Usage:
+ *   PROFILE_IRQ_HANDLER(TIM2_IRQHandler, PFIC_IRQ_TIM2)
+ *   {
+ *       ...
+ *   }
+ */
+
+// --- CONFIGURATION ---
+
+/**
+ * @brief Set to 1 to compile the profiler in. Costs 8 bytes of RAM per IRQ from
+ * PROFILE_FIRST_IRQ to PFIC_IRQ_TIM2 and about 15 instructions per interrupt.
+ */
+#ifndef PROFILE_ENABLE
+#define PROFILE_ENABLE 0
+#endif
+
+/**
+ * @brief Lowest IRQ number with a record. Faults and NMI are not profiled.
+ */
+#define PROFILE_FIRST_IRQ PFIC_IRQ_SYSTICK
+
+/**
+ * @brief Number of per-IRQ records.
+ */
+#define PROFILE_IRQ_COUNT (PFIC_IRQ_TIM2 - PROFILE_FIRST_IRQ + 1)
+
+// --- TYPES ---
+
+/**
+ * @brief Entry stamp of a profiled section, kept on the stack of the section.
+ */
+typedef struct
+{
+    uint32_t start;  /**< SysTick counter at entry. */
+    uint32_t nested; /**< Handler cycles accumulated at entry. */
+} PROFILE_FRAME;
+
+/**
+ * @brief Accumulated cost of one IRQ.
+ */
+typedef struct
+{
+    uint32_t calls;  /**< Number of handler runs. */
+    uint32_t cycles; /**< Handler cycles, nested handlers excluded. */
+} PROFILE_IRQ_STATS;
+
+/**
+ * @brief Byte output used by PROFILE_Dump() (e.g., a UART transmit routine).
+ */
+typedef void (*PROFILE_PUTC)(uint8_t byte);
+
+#if PROFILE_ENABLE
+
+/**
+ * @brief Profiler state. Do not access directly.
+ */
+extern PROFILE_IRQ_STATS profileIrq[PROFILE_IRQ_COUNT];
+extern volatile uint32_t profileNested;
+extern uint32_t profileIdle;
+
+#endif /* PROFILE_ENABLE */
+
+// --- FUNCTION PROTOTYPES ---
+
+/**
+ * @brief Clears every record and starts a new measurement window.
+ */
+void PROFILE_Reset(void);
+
+/**
+ * @brief Returns the CPU load over the current window.
+ * @return uint16_t: Busy time in per mille (0-1000), 0 when the profiler is disabled.
+ */
+uint16_t PROFILE_GetLoad(void);
+
+/**
+ * @brief Copies the record of one IRQ.
+ * @param irq The IRQ number (PROFILE_FIRST_IRQ..PFIC_IRQ_TIM2).
+ * @param stats Receives the record, all zero when the profiler is disabled.
+ */
+void PROFILE_GetIrqStats(PFIC_IRQ irq, PROFILE_IRQ_STATS *stats);
+
+/**
+ * @brief Writes the current window as a compact binary record.
+ *
+ * Format, little-endian:
+ *   'P', <N: uint8>, <window cycles: uint32>, <idle cycles: uint32>,
+ *   N x { <irq: uint8>, <calls: uint32>, <cycles: uint32> }
+ * Only IRQs with at least one call are written. N is 0 when disabled.
+ *
+ * @param putByte Byte output function.
+ */
+void PROFILE_Dump(PROFILE_PUTC putByte);
+
+// --- INLINE FUNCTIONS ---
+
+#if PROFILE_ENABLE
+
+/**
+ * @brief Stamps the start of a profiled section.
+ * @return PROFILE_FRAME: The entry stamp, to pass to the matching exit.
+ */
+static inline PROFILE_FRAME PROFILE_Enter(void)
+{
+    PROFILE_FRAME frame;
+
+    frame.start = SYSTICK->CNT;
+    frame.nested = profileNested;
+
+    return frame;
+}
+
+/**
+ * @brief Accounts a handler run to its IRQ.
+ *
+ * Cycles of handlers that nested inside this one are subtracted, and the
+ * full elapsed time is passed on to the handler this one preempted.
+ *
+ * @param irq The IRQ number of the handler.
+ * @param frame The stamp returned by PROFILE_Enter().
+ */
+static inline void PROFILE_Exit(PFIC_IRQ irq, const PROFILE_FRAME *frame)
+{
+    uint32_t elapsed = SYSTICK->CNT - frame->start;
+    PROFILE_IRQ_STATS *stats = &profileIrq[irq - PROFILE_FIRST_IRQ];
+
+    stats->cycles += elapsed - (profileNested - frame->nested);
+    stats->calls++;
+    profileNested = frame->nested + elapsed;
+}
+
+/**
+ * @brief Stamps the start of an idle section of the main loop.
+ * @return PROFILE_FRAME: The entry stamp, to pass to PROFILE_IdleExit().
+ */
+static inline PROFILE_FRAME PROFILE_IdleEnter(void)
+{
+    return PROFILE_Enter();
+}
+
+/**
+ * @brief Adds the idle section to the idle time, minus the handlers it contained.
+ * @param frame The stamp returned by PROFILE_IdleEnter().
+ */
+static inline void PROFILE_IdleExit(const PROFILE_FRAME *frame)
+{
+    uint32_t elapsed = SYSTICK->CNT - frame->start;
+
+    profileIdle += elapsed - (profileNested - frame->nested);
+}
+
+/**
+ * @brief Defines a profiled interrupt handler. Follow with the handler body.
+ *
+ * The body becomes an always-inline static function, so `return` works as
+ * usual and the stamps stay the first and last things the handler does.
+ */
+#define PROFILE_IRQ_HANDLER(handler, irq)                                \
+    static inline void handler##_Body(void) __attribute__((always_inline)); \
+    void handler(void) PFIC_INTERRUPT_HANDLER;                           \
+    void handler(void)                                                   \
+    {                                                                    \
+        PROFILE_FRAME profileFrame = PROFILE_Enter();                    \
+        handler##_Body();                                                \
+        PROFILE_Exit(irq, &profileFrame);                                \
+    }                                                                    \
+    static inline void handler##_Body(void)
+
+#else
+
+static inline PROFILE_FRAME PROFILE_IdleEnter(void)
+{
+    PROFILE_FRAME frame = {0, 0};
+
+    return frame;
+}
+
+static inline void PROFILE_IdleExit(const PROFILE_FRAME *frame)
+{
+    (void)frame;
+}
+
+#define PROFILE_IRQ_HANDLER(handler, irq)      \
+    void handler(void) PFIC_INTERRUPT_HANDLER; \
+    void handler(void)
+
+#endif /* PROFILE_ENABLE */
+
+#endif /* PROFILE_H */
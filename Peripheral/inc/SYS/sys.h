@@ -0,0 +1,38 @@
+#ifndef SYS_H
+#define SYS_H
+
+/**
+ * @file sys.h
+ * @brief Section placement attributes shared by the drivers and the application.
+ */
+
+/**
+ * @brief Places a function in the .highcode section, executed from RAM.
+ *
+ * handle_reset copies .highcode from flash to RAM before main(). RAM is fetched
+ * without wait states, while flash needs one wait state above 24 MHz SYSCLK,
+ * so short hot paths (interrupt dispatchers, GPIO fast paths, tight loops)
+ * gain roughly one cycle per fetched instruction at 48 MHz. At 24 MHz and below
+ * flash runs with zero wait states and RAM placement only costs RAM.
+ *
+ * Every byte placed here is taken twice (flash image + RAM copy) and counts
+ * against the RAM budget checked in Ld/Link.ld. Define SYS_NO_HIGHCODE to keep
+ * everything in flash.
+ */
+#ifndef SYS_NO_HIGHCODE
+#define HIGHCODE __attribute__((section(".highcode")))
+#else
+#define HIGHCODE
+#endif
+
+/**
+ * @brief Places a variable in the .noinit section, which handle_reset neither
+ * copies nor zeroes.
+ *
+ * Meant for large DMA and log buffers that are always written before being
+ * read, and for records that must survive a software reset. The content is
+ * undefined after power-up. Variables must not have an initializer.
+ */
+#define NOINIT __attribute__((section(".noinit")))
+
+#endif /* SYS_H */
@@ -0,0 +1,122 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+/**
+ * @file trace.h
+ * @brief Public interface for the RAM trace ring.
+ *
+ * TRACE_EVENT() appends a fixed 8-byte record (event ID, time since the
+ * previous record, 32-bit argument) to a power-of-two ring in .noinit RAM.
+ * The append is one short sequence with interrupts disabled, so it is safe
+ * from the main loop and from handlers of any priority, and the oldest
+ * records are overwritten when the ring is full.
+ *
+ * Times are SysTick counts (SYSTICK_Init() must have started the counter)
+ * shifted right by TRACE_TIME_SHIFT. A gap that does not fit the 16-bit delta
+ * is written as an extra TRACE_ID_SYNC record carrying the full cycle count.
+ *
+ * The ring lives in .noinit and TRACE_Init() keeps a valid ring, so the last
+ * events before a watchdog or software reset can still be dumped afterwards.
+ * TRACE_Dump() writes the ring over any byte output (e.g., the UART), and
+ * Tools/trace_decode.py turns the dump into a timeline on the host.
+ *
+ * With TRACE_ENABLE cleared, TRACE_EVENT() compiles to nothing.
+ */
+
+// --- CONFIGURATION ---
+
+/**
+ * @brief Set to 1 to compile tracing in, including the driver trace points.
+ */
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE 0
+#endif
+
+/**
+ * @brief Number of records in the ring. Must be a power of two (8 bytes per record).
+ */
+#ifndef TRACE_DEPTH
+#define TRACE_DEPTH 32
+#endif
+
+/**
+ * @brief Delta resolution as a power of two, in HCLK cycles (4 -> 16 cycles, 0.33 us at 48 MHz).
+ */
+#ifndef TRACE_TIME_SHIFT
+#define TRACE_TIME_SHIFT 4
+#endif
+
+// --- ENUMERATED TYPES ---
+
+/**
+ * @brief Event IDs used by the drivers. Application events start at TRACE_ID_USER.
+ */
+typedef enum
+{
+    TRACE_ID_SYNC,        /**< Long gap, arg = cycles since the previous record. */
+    TRACE_ID_EXTI,        /**< EXTI7_0 dispatch, arg = line. */
+    TRACE_ID_RCC_SYSCLK,  /**< SYSCLK switched, arg = RCC_SYSCLK_SRC. */
+    TRACE_ID_GPIO_WRITE,  /**< GPIO_WritePin, arg = port base | pin << 1 | value. */
+    TRACE_ID_GPIO_TOGGLE, /**< GPIO_TogglePin, arg = port base | pin << 1. */
+    TRACE_ID_USER = 0x100 /**< First application event ID. */
+} TRACE_ID;
+
+// --- TYPES ---
+
+/**
+ * @brief One trace record, 8 bytes.
+ */
+typedef struct
+{
+    uint16_t id;    /**< Event ID. */
+    uint16_t delta; /**< Time since the previous record, in 2^TRACE_TIME_SHIFT cycles. */
+    uint32_t arg;   /**< Event argument. */
+} TRACE_RECORD;
+
+/**
+ * @brief Byte output used by TRACE_Dump() (e.g., a UART transmit routine).
+ */
+typedef void (*TRACE_PUTC)(uint8_t byte);
+
+// --- FUNCTION PROTOTYPES ---
+
+/**
+ * @brief Validates the ring left in .noinit, or clears it if it is not valid.
+ */
+void TRACE_Init(void);
+
+/**
+ * @brief Discards every record.
+ */
+void TRACE_Clear(void);
+
+/**
+ * @brief Appends a record. Use TRACE_EVENT() so the call compiles out when disabled.
+ * @param id Event ID.
+ * @param arg Event argument.
+ */
+void TRACE_Event(uint16_t id, uint32_t arg);
+
+/**
+ * @brief Writes the ring, oldest record first, as a binary dump.
+ *
+ * Format, little-endian:
+ *   'T', <version: uint8 = 1>, <TRACE_TIME_SHIFT: uint8>, <reserved: uint8>,
+ *   <HCLK: uint32>, <N: uint16>, N x { <id: uint16>, <delta: uint16>, <arg: uint32> }
+ *
+ * Tracing is paused while the dump is written.
+ * @param putByte Byte output function.
+ */
+void TRACE_Dump(TRACE_PUTC putByte);
+
+// --- MACROS ---
+
+#if TRACE_ENABLE
+#define TRACE_EVENT(id, arg) TRACE_Event((id), (uint32_t)(arg))
+#else
+#define TRACE_EVENT(id, arg) ((void)0)
+#endif
+
+#endif /* TRACE_H */
@@ -0,0 +1,114 @@
+#ifndef SYSTICK_H
+#define SYSTICK_H
+
+#include <stdint.h>
+#include "systick_bits.h"
+#include "systick_reg.h"
+
+/**
+ * @file systick.h
+ * @brief Public interface for the SysTick timebase driver.
+ *
+ * The 32-bit counter free-runs upward at HCLK and is never reloaded. It is
+ * extended to 64 bits by an epoch counter that SysTick_Handler increments
+ * twice per counter period, on compare events at 0x80000000 and at the wrap
+ * (every 44.7 s at 48 MHz). There is no periodic tick.
+ *
+ * The readers are lock-free. A compare event that the handler has not yet
+ * served (interrupts masked, or a higher priority handler running) is detected
+ * from the top counter bit, so time stays monotonic as long as the handler is
+ * never held off for more than half a counter period.
+ *
+ * The compare register also serves one one-shot alarm (SYSTICK_SetAlarm()),
+ * which tickless services such as the software timers use to sleep until
+ * their next deadline. The compare value is always the nearer of the alarm
+ * and the next half period boundary.
+ *
+ * Delays and unit conversions use the HCLK frequency computed by
+ * RCC_GetHCLKFreq(). Call SYSTICK_UpdateClock() after changing SYSCLK or the
+ * AHB prescaler.
+ */
+
+// --- TYPES ---
+
+/**
+ * @brief Function run from SysTick_Handler when the alarm is reached.
+ */
+typedef void (*SYSTICK_ALARM_FN)(void);
+
+// --- FUNCTION PROTOTYPES ---
+
+/**
+ * @brief Starts the counter from 0 at HCLK and enables the wrap compare interrupt.
+ */
+void SYSTICK_Init(void);
+
+/**
+ * @brief Reloads the HCLK frequency after a clock change.
+ *
+ * Time elapsed so far is kept: micros and millis continue from their current
+ * values at the new rate.
+ */
+void SYSTICK_UpdateClock(void);
+
+/**
+ * @brief Returns the HCLK frequency the driver currently works with.
+ * @return uint32_t: Frequency in Hz.
+ */
+uint32_t SYSTICK_GetClock(void);
+
+/**
+ * @brief Returns the number of HCLK cycles per millisecond at the current clock.
+ * @return uint32_t: HCLK / 1000.
+ */
+uint32_t SYSTICK_GetCyclesPerMilli(void);
+
+/**
+ * @brief Returns the number of HCLK cycles since SYSTICK_Init().
+ * @return uint64_t: Monotonic cycle count.
+ */
+uint64_t SYSTICK_GetCycles(void);
+
+/**
+ * @brief Returns the number of microseconds since SYSTICK_Init().
+ * @return uint64_t: Monotonic time in us.
+ */
+uint64_t SYSTICK_GetMicros(void);
+
+/**
+ * @brief Returns the number of milliseconds since SYSTICK_Init().
+ * @return uint64_t: Monotonic time in ms.
+ */
+uint64_t SYSTICK_GetMillis(void);
+
+/**
+ * @brief Busy-waits for a number of HCLK cycles.
+ * @param cycles Cycles to wait (up to 2^32 - 1).
+ */
+void SYSTICK_DelayCycles(uint32_t cycles);
+
+/**
+ * @brief Busy-waits for a number of microseconds.
+ * @param us Microseconds to wait.
+ */
+void SYSTICK_DelayMicros(uint32_t us);
+
+/**
+ * @brief Busy-waits for a number of milliseconds.
+ * @param ms Milliseconds to wait.
+ */
+void SYSTICK_DelayMillis(uint32_t ms);
+
+/**
+ * @brief Arms the one-shot alarm, replacing any previous one.
+ * @param cycles Absolute cycle count, as returned by SYSTICK_GetCycles().
+ * @param fn The function to run from SysTick_Handler.
+ */
+void SYSTICK_SetAlarm(uint64_t cycles, SYSTICK_ALARM_FN fn);
+
+/**
+ * @brief Disarms the alarm.
+ */
+void SYSTICK_CancelAlarm(void);
+
+#endif /* SYSTICK_H */
@@ -0,0 +1,30 @@
+#ifndef SYSTICK_BITS_H
+#define SYSTICK_BITS_H
+
+// SysTick Control Register (STK_CTLR)
+
+// Single bit field position
+#define STE_Pos 0
+#define STIE_Pos 1
+#define STCLK_Pos 2
+#define STRE_Pos 3
+#define MODE_Pos 4
+#define INIT_Pos 5
+#define SWIE_Pos 31
+// Single bit field mask
+#define STE_Msk (0x01 << STE_Pos)
+#define STIE_Msk (0x01 << STIE_Pos)
+#define STCLK_Msk (0x01 << STCLK_Pos)
+#define STRE_Msk (0x01 << STRE_Pos)
+#define MODE_Msk (0x01 << MODE_Pos)
+#define INIT_Msk (0x01 << INIT_Pos)
+#define SWIE_Msk (0x01UL << SWIE_Pos)
+
+// SysTick Count Status Register (STK_SR)
+
+// Single bit field position
+#define CNTIF_Pos 0
+// Single bit field mask
+#define CNTIF_Msk (0x01 << CNTIF_Pos)
+
+#endif /* SYSTICK_BITS_H */
@@ -0,0 +1,53 @@
+#ifndef SYSTICK_REG_H
+#define SYSTICK_REG_H
+
+#include <stdint.h>
+#include "systick_bits.h"
+
+/**
+ * @brief Base address of the SysTick timer (STK).
+ * * The SysTick on the CH32V003 is a 32-bit up/down counter clocked from HCLK or
+ * HCLK/8, with a 32-bit compare register that can raise an interrupt.
+ */
+#define SYSTICK_BASE 0xE000F000UL
+
+/**
+ * @brief SysTick Register Map Structure.
+ */
+typedef struct
+{
+    /** @brief System Count Control Register (STK_CTLR)
+     * Enables the counter, selects its clock, direction and auto-reload.
+     */
+    volatile uint32_t CTLR;
+
+    /** @brief System Count Status Register (STK_SR)
+     * CNTIF is set when the counter reaches the compare value. Write 0 to clear.
+     */
+    volatile uint32_t SR;
+
+    /** @brief System Counter Register (STK_CNTL)
+     * Current 32-bit counter value.
+     */
+    volatile uint32_t CNT;
+
+    /** @brief Reserved memory space (Offset 0x0C)
+     */
+    volatile uint32_t RESERVED0;
+
+    /** @brief System Count Compare Register (STK_CMPLR)
+     * Compare value for the CNTIF flag and the auto-reload.
+     */
+    volatile uint32_t CMP;
+
+    /** @brief Reserved memory space (Offset 0x14)
+     */
+    volatile uint32_t RESERVED1;
+} SYSTICK_Typedef;
+
+/**
+ * @brief Pointer definition for accessing SysTick registers.
+ */
+#define SYSTICK ((SYSTICK_Typedef *)SYSTICK_BASE)
+
+#endif /* SYSTICK_REG_H */
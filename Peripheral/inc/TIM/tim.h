@@ -0,0 +1,613 @@
+#ifndef TIM_H
+#define TIM_H
+
+#include <stdint.h>
+#include "tim_bits.h"
+#include "tim_reg.h"
+#include "DMA/dma.h"
+
+/**
+ * @file tim.h
+ * @brief Public interface for the TIM1 / TIM2 timer driver.
+ *
+ * Both timers share one register layout, so every function takes the timer
+ * (TIMER1 or TIMER2) as its first argument, like the GPIO functions take a
+ * port. The counter clock is HCLK / (prescaler + 1) on either timer.
+ *
+ * TIM_TimeBaseInit() sets up the counter. Starting, stopping and the flag and
+ * interrupt helpers are inline, since they are mostly used from interrupt
+ * handlers.
+ *
+ * The driver owns the TIM2 interrupt vector and the four TIM1 vectors
+ * (break, update, trigger / commutation, compare) and dispatches them to the
+ * handler installed with TIM_SetHandler(), so several modules can use a
+ * timer without fighting over its vectors. Each TIM1 vector passes only its
+ * own flags. Enabling the PFIC interrupts is left to the caller.
+ *
+ * PWM: TIM_PwmInit() puts a channel in PWM mode 1 (active while the counter
+ * is below the compare value, so the duty is compare / (reload + 1)), and
+ * TIM_PwmPinInit() sets its pin up as an alternate function output. The pin
+ * depends on the timer's remap, which is selected separately with
+ * AFIO_PinRemap(AFIO_RM_TMI1_RM / AFIO_RM_TIM2_RM, ...): afio.h and rcc.h
+ * cannot be included together, both define AFIO.
+ *
+ * Motor control (TIM1): with TIM_MODE_CENTER the counter runs up and down,
+ * so the pulses of all channels are centred on the same instant. Channels 1
+ * to 3 drive complementary outputs (TIM_PWM_COMPLEMENTARY) separated by the
+ * dead time set in nanoseconds with TIM_SetDeadTime(). TIM_BreakInit() arms
+ * the break input: an active level clears MOE in hardware and drives every
+ * output to its inactive level, without any code in the path.
+ * TIM_BeginUpdate() / TIM_EndUpdate() hold the update event while several
+ * preloaded compare values are written, so they all switch in the same
+ * period. For six-step commutation, TIM_CommutationInit() preloads the
+ * output modes and enables set with TIM_SetPhase(); the whole next step is
+ * applied at once by the COM event, from TIM_GenerateCommutation() or from
+ * the trigger input (e.g. TIM2 as hall sensor timer), and the COM interrupt
+ * preloads the step after it.
+ *
+ * Streaming: TIM_StreamInit() points the timer's update DMA request at a
+ * channel's compare register, and TIM_StreamStart() then writes one value
+ * from a RAM buffer per period without the CPU. With TIM_PWM_PRELOAD each
+ * value takes effect at the update that ends the period it was written in,
+ * so every period gets exactly one value. TIM2 update requests are served by
+ * DMA1 channel 2, TIM1's by channel 5 (shared with USART1 RX).
+ *
+ * Capture: TIM_CaptureInit() latches the counter into a channel's register
+ * on an input edge, and TIM_CaptureDmaInit() / TIM_CaptureStart() copy every
+ * captured value into a RAM buffer through the channel's own DMA request, so
+ * edges cost no CPU time. With TIM_CAPTURE_INDIRECT a channel captures the
+ * input of its pair (1 / 2, 3 / 4), so both edges of one pin can be taken.
+ * TIM_SetSlaveMode() resets the counter on an edge of CH1 or CH2, which
+ * turns the captured values into periods (PWM input).
+ */
+
+// --- ENUMERATED TYPES ---
+
+/**
+ * @brief Counter options for TIM_TimeBaseInit(), combined with '|'.
+ *
+ * The default (no option) is a free-running up-counter with the auto-reload
+ * value written straight through.
+ */
+typedef enum
+{
+    TIM_MODE_ONE_PULSE = TIM_OPM_Msk,         /**< Stop the counter at the next update event. */
+    TIM_MODE_DOWN = TIM_DIR_Msk,              /**< Count down from the auto-reload value. */
+    TIM_MODE_CENTER = 0x03 << TIM_CMS_Pos,    /**< Count up and down; compare flags on both slopes. */
+    TIM_MODE_PRELOAD = TIM_ARPE_Msk,          /**< Buffer the auto-reload value until the next update. */
+    TIM_MODE_UPDATE_ON_OVERFLOW = TIM_URS_Msk /**< Only overflows set the update flag, not TIM_GenerateUpdate(). */
+} TIM_MODE;
+
+/**
+ * @brief Interrupt and DMA request enables (TIM_DMAINTENR), combined with '|'.
+ */
+typedef enum
+{
+    TIM_IRQ_UPDATE = TIM_UIE_Msk,  /**< Update interrupt. */
+    TIM_IRQ_CC1 = TIM_CC1IE_Msk,   /**< Channel 1 compare / capture interrupt. */
+    TIM_IRQ_CC2 = TIM_CC2IE_Msk,   /**< Channel 2 compare / capture interrupt. */
+    TIM_IRQ_CC3 = TIM_CC3IE_Msk,   /**< Channel 3 compare / capture interrupt. */
+    TIM_IRQ_CC4 = TIM_CC4IE_Msk,   /**< Channel 4 compare / capture interrupt. */
+    TIM_IRQ_COM = TIM_COMIE_Msk,   /**< Commutation interrupt (TIM1). */
+    TIM_IRQ_TRIGGER = TIM_TIE_Msk, /**< Trigger interrupt. */
+    TIM_IRQ_BREAK = TIM_BIE_Msk,   /**< Break interrupt (TIM1). */
+    TIM_DMA_UPDATE = TIM_UDE_Msk,  /**< DMA request on update. */
+    TIM_DMA_CC1 = TIM_CC1DE_Msk,   /**< DMA request on channel 1 compare / capture. */
+    TIM_DMA_CC2 = TIM_CC2DE_Msk,   /**< DMA request on channel 2 compare / capture. */
+    TIM_DMA_CC3 = TIM_CC3DE_Msk,   /**< DMA request on channel 3 compare / capture. */
+    TIM_DMA_CC4 = TIM_CC4DE_Msk,   /**< DMA request on channel 4 compare / capture. */
+    TIM_DMA_COM = TIM_COMDE_Msk,   /**< DMA request on commutation (TIM1). */
+    TIM_DMA_TRIGGER = TIM_TDE_Msk  /**< DMA request on trigger. */
+} TIM_INT;
+
+/**
+ * @brief Event flags (TIM_INTFR), as returned by TIM_GetFlags().
+ */
+typedef enum
+{
+    TIM_FLAG_UPDATE = TIM_UIF_Msk,     /**< Counter overflow / underflow or TIM_GenerateUpdate(). */
+    TIM_FLAG_CC1 = TIM_CC1IF_Msk,      /**< Channel 1 compare match or capture. */
+    TIM_FLAG_CC2 = TIM_CC2IF_Msk,      /**< Channel 2 compare match or capture. */
+    TIM_FLAG_CC3 = TIM_CC3IF_Msk,      /**< Channel 3 compare match or capture. */
+    TIM_FLAG_CC4 = TIM_CC4IF_Msk,      /**< Channel 4 compare match or capture. */
+    TIM_FLAG_COM = TIM_COMIF_Msk,      /**< Commutation (TIM1). */
+    TIM_FLAG_TRIGGER = TIM_TIF_Msk,    /**< Trigger input edge. */
+    TIM_FLAG_BREAK = TIM_BIF_Msk,      /**< Break input active (TIM1). */
+    TIM_FLAG_CC1_OVER = TIM_CC1OF_Msk, /**< Channel 1 captured again before the previous value was read. */
+    TIM_FLAG_CC2_OVER = TIM_CC2OF_Msk, /**< Channel 2 overcapture. */
+    TIM_FLAG_CC3_OVER = TIM_CC3OF_Msk, /**< Channel 3 overcapture. */
+    TIM_FLAG_CC4_OVER = TIM_CC4OF_Msk  /**< Channel 4 overcapture. */
+} TIM_FLAG;
+
+/**
+ * @brief Compare / capture channels.
+ */
+typedef enum
+{
+    TIM_CHANNEL_1, /**< Channel 1 (CHCVR[0]). */
+    TIM_CHANNEL_2, /**< Channel 2 (CHCVR[1]). */
+    TIM_CHANNEL_3, /**< Channel 3 (CHCVR[2]). */
+    TIM_CHANNEL_4  /**< Channel 4 (CHCVR[3]). */
+} TIM_CHANNEL;
+
+/**
+ * @brief Output options for TIM_PwmInit(), combined with '|'.
+ *
+ * The default (no option) is an active-high output with compare writes
+ * taking effect immediately.
+ */
+typedef enum
+{
+    TIM_PWM_ACTIVE_LOW = 0x01,               /**< Output low while the counter is below the compare value. */
+    TIM_PWM_PRELOAD = 0x02,                  /**< Buffer compare writes until the next update (needed for streaming). */
+    TIM_PWM_COMPLEMENTARY = 0x04,            /**< Also enable the CHxN output (TIM1 channels 1 to 3). */
+    TIM_PWM_COMPLEMENTARY_ACTIVE_LOW = 0x08 /**< CHxN polarity inverted. */
+} TIM_PWM;
+
+/**
+ * @brief Break input options for TIM_BreakInit(), combined with '|'.
+ *
+ * The default (no option) is an active-low break input after which the
+ * outputs stay off until TIM_EnableOutputs().
+ */
+typedef enum
+{
+    TIM_BREAK_ACTIVE_HIGH = TIM_BKP_Msk, /**< Break on a high level. */
+    TIM_BREAK_AUTO_RESTART = TIM_AOE_Msk /**< Re-enable the outputs at the next update once the break is gone. */
+} TIM_BREAK;
+
+/**
+ * @brief Per-channel state of one six-step commutation step, for TIM_SetPhase().
+ */
+typedef enum
+{
+    TIM_PHASE_OFF, /**< Both switches off (CHx and CHxN inactive). */
+    TIM_PHASE_PWM, /**< CHx switches with PWM, CHxN complementary. */
+    TIM_PHASE_LOW, /**< Low switch on: CHx inactive, CHxN active. */
+    TIM_PHASE_HIGH /**< High switch on: CHx active, CHxN inactive. */
+} TIM_PHASE;
+
+/**
+ * @brief Input options for TIM_CaptureInit(), combined with '|'.
+ *
+ * The default (no option) captures every rising edge of the channel's own
+ * pin, unfiltered. Other filter settings can be given as n << TIM_ICF_Pos.
+ */
+typedef enum
+{
+    TIM_CAPTURE_FALLING = 0x01,                 /**< Capture on falling instead of rising edges. */
+    TIM_CAPTURE_INDIRECT = 0x02,                /**< Take the input of the paired channel (1 / 2, 3 / 4). */
+    TIM_CAPTURE_DIV2 = 0x01 << TIM_ICPSC_Pos,   /**< Capture every 2nd edge. */
+    TIM_CAPTURE_DIV4 = 0x02 << TIM_ICPSC_Pos,   /**< Capture every 4th edge. */
+    TIM_CAPTURE_DIV8 = 0x03 << TIM_ICPSC_Pos,   /**< Capture every 8th edge. */
+    TIM_CAPTURE_FILTER_2 = 0x01 << TIM_ICF_Pos, /**< Edge valid after 2 equal samples at HCLK. */
+    TIM_CAPTURE_FILTER_4 = 0x02 << TIM_ICF_Pos, /**< Edge valid after 4 equal samples at HCLK. */
+    TIM_CAPTURE_FILTER_8 = 0x03 << TIM_ICF_Pos  /**< Edge valid after 8 equal samples at HCLK. */
+} TIM_CAPTURE;
+
+/**
+ * @brief Trigger inputs for TIM_SetSlaveMode() (SMCFGR TS).
+ */
+typedef enum
+{
+    TIM_TRIGGER_ITR0,    /**< Internal trigger 0. */
+    TIM_TRIGGER_ITR1,    /**< Internal trigger 1. */
+    TIM_TRIGGER_ITR2,    /**< Internal trigger 2. */
+    TIM_TRIGGER_ITR3,    /**< Internal trigger 3. */
+    TIM_TRIGGER_TI1F_ED, /**< Both edges of the CH1 input. */
+    TIM_TRIGGER_TI1FP1,  /**< CH1 input, filtered, with the channel 1 polarity. */
+    TIM_TRIGGER_TI2FP2,  /**< CH2 input, filtered, with the channel 2 polarity. */
+    TIM_TRIGGER_ETRF     /**< External trigger input. */
+} TIM_TRIGGER;
+
+/**
+ * @brief What the trigger input does to the counter, for TIM_SetSlaveMode() (SMCFGR SMS).
+ */
+typedef enum
+{
+    TIM_SLAVE_DISABLED,      /**< Counter clocked by the prescaler, trigger ignored. */
+    TIM_SLAVE_ENCODER_1,     /**< Encoder mode, counting CH2 edges. */
+    TIM_SLAVE_ENCODER_2,     /**< Encoder mode, counting CH1 edges. */
+    TIM_SLAVE_ENCODER_3,     /**< Encoder mode, counting edges of both. */
+    TIM_SLAVE_RESET,         /**< Restart the counter on each trigger edge. */
+    TIM_SLAVE_GATED,         /**< Count while the trigger is high. */
+    TIM_SLAVE_TRIGGER,       /**< Start the counter on a trigger edge. */
+    TIM_SLAVE_EXTERNAL_CLOCK /**< Count trigger edges. */
+} TIM_SLAVE;
+
+// --- TYPES ---
+
+/**
+ * @brief Timer interrupt handler, installed with TIM_SetHandler().
+ * @param flags The pending flags of the enabled interrupts, already cleared (TIM_FLAG bits).
+ */
+typedef void (*TIM_HANDLER)(uint32_t flags);
+
+// --- FUNCTION PROTOTYPES ---
+
+/**
+ * @brief Enables the timer clock and sets up a stopped counter.
+ * @param timer TIMER1 or TIMER2.
+ * @param prescaler Counter clock = HCLK / (prescaler + 1).
+ * @param reload Auto-reload value: the period is reload + 1 ticks.
+ * @param mode TIM_MODE options combined with '|'.
+ */
+void TIM_TimeBaseInit(TIM_Typedef *timer, uint16_t prescaler, uint16_t reload, uint32_t mode);
+
+/**
+ * @brief Returns the prescaler value closest to a counter tick rate at the current HCLK.
+ * @param tickRate Counter ticks per second.
+ * @return uint16_t: Prescaler value, clamped to 0..65535.
+ */
+uint16_t TIM_GetPrescaler(uint32_t tickRate);
+
+/**
+ * @brief Returns the counter tick rate a prescaler value gives at the current HCLK.
+ * @param prescaler Prescaler value.
+ * @return uint32_t: Counter ticks per second.
+ */
+uint32_t TIM_GetTickRate(uint16_t prescaler);
+
+/**
+ * @brief Installs the function the timer's interrupt vectors dispatch to.
+ * @param timer TIMER1 or TIMER2.
+ * @param handler The handler, or NULL to ignore the interrupts.
+ */
+void TIM_SetHandler(TIM_Typedef *timer, TIM_HANDLER handler);
+
+/**
+ * @brief Puts a channel in PWM mode 1 and enables its output.
+ * @param timer TIMER1 or TIMER2.
+ * @param channel The channel.
+ * @param compare Initial compare value: the output is active for compare ticks of each period.
+ * @param options TIM_PWM options combined with '|'.
+ */
+void TIM_PwmInit(TIM_Typedef *timer, TIM_CHANNEL channel, uint16_t compare, uint32_t options);
+
+/**
+ * @brief Sets up a channel's pin as an alternate function push-pull output.
+ * @param timer TIMER1 or TIMER2.
+ * @param channel The channel.
+ * @param remap The timer's remap selected with AFIO_PinRemap() (0..3).
+ */
+void TIM_PwmPinInit(TIM_Typedef *timer, TIM_CHANNEL channel, uint8_t remap);
+
+/**
+ * @brief Sets up a channel's complementary (CHxN) pin as an alternate function push-pull output.
+ * @param timer TIMER1.
+ * @param channel TIM_CHANNEL_1 to TIM_CHANNEL_3.
+ * @param remap The TIM1 remap selected with AFIO_PinRemap() (0..3).
+ */
+void TIM_ComplementaryPinInit(TIM_Typedef *timer, TIM_CHANNEL channel, uint8_t remap);
+
+/**
+ * @brief Sets up the break input (BKIN) pin as a pulled input.
+ * @param timer TIMER1.
+ * @param remap The TIM1 remap selected with AFIO_PinRemap() (0..3).
+ * @param options TIM_BREAK options; the pull resistor holds the input inactive.
+ */
+void TIM_BreakPinInit(TIM_Typedef *timer, uint8_t remap, uint32_t options);
+
+/**
+ * @brief Sets the dead time between complementary outputs.
+ * @param timer TIMER1.
+ * @param nanoseconds Minimum dead time.
+ * @return uint32_t: The dead time set, in ns.
+ */
+uint32_t TIM_SetDeadTime(TIM_Typedef *timer, uint32_t nanoseconds);
+
+/**
+ * @brief Arms the break input.
+ * @param timer TIMER1.
+ * @param options TIM_BREAK options combined with '|'.
+ */
+void TIM_BreakInit(TIM_Typedef *timer, uint32_t options);
+
+/**
+ * @brief Makes output modes and enables preloaded, applied at the COM event.
+ * @param timer TIMER1.
+ * @param triggered 1 to also generate COM on a rising edge of the trigger input.
+ */
+void TIM_CommutationInit(TIM_Typedef *timer, uint8_t triggered);
+
+/**
+ * @brief Sets the state of one channel pair (preloaded after TIM_CommutationInit()).
+ * @param timer TIMER1.
+ * @param channel TIM_CHANNEL_1 to TIM_CHANNEL_3.
+ * @param phase The state.
+ */
+void TIM_SetPhase(TIM_Typedef *timer, TIM_CHANNEL channel, TIM_PHASE phase);
+
+/**
+ * @brief Points the update DMA request at a channel's compare register.
+ * @param timer TIMER1 or TIMER2.
+ * @param channel The channel whose compare value is streamed.
+ * @param dmaMode Further DMA_MODE options (circular, interrupts, DMA_MODE_MEM_SIZE_16 for 16-bit values).
+ */
+void TIM_StreamInit(TIM_Typedef *timer, TIM_CHANNEL channel, uint32_t dmaMode);
+
+/**
+ * @brief Puts a channel in input capture mode and enables the capture.
+ * @param timer TIMER1 or TIMER2.
+ * @param channel The channel.
+ * @param options TIM_CAPTURE options combined with '|'.
+ */
+void TIM_CaptureInit(TIM_Typedef *timer, TIM_CHANNEL channel, uint32_t options);
+
+/**
+ * @brief Sets up a channel's pin as a floating input.
+ * @param timer TIMER1 or TIMER2.
+ * @param channel The channel.
+ * @param remap The timer's remap selected with AFIO_PinRemap() (0..3).
+ */
+void TIM_CapturePinInit(TIM_Typedef *timer, TIM_CHANNEL channel, uint8_t remap);
+
+/**
+ * @brief Points a channel's DMA request at its capture register.
+ * @param timer TIMER1 or TIMER2.
+ * @param channel The channel whose captured values are copied.
+ * @param dmaMode Further DMA_MODE options (circular, interrupts, priority).
+ */
+void TIM_CaptureDmaInit(TIM_Typedef *timer, TIM_CHANNEL channel, uint32_t dmaMode);
+
+/**
+ * @brief Selects the trigger input and what it does to the counter.
+ * @param timer TIMER1 or TIMER2.
+ * @param trigger The trigger input.
+ * @param mode The slave mode.
+ */
+void TIM_SetSlaveMode(TIM_Typedef *timer, TIM_TRIGGER trigger, TIM_SLAVE mode);
+
+// --- INLINE FUNCTIONS ---
+
+/**
+ * @brief Starts the counter from its current value.
+ * @param timer TIMER1 or TIMER2.
+ */
+static inline void TIM_Start(TIM_Typedef *timer)
+{
+    timer->CTLR1 |= TIM_CEN_Msk;
+}
+
+/**
+ * @brief Stops the counter; it keeps its value.
+ * @param timer TIMER1 or TIMER2.
+ */
+static inline void TIM_Stop(TIM_Typedef *timer)
+{
+    timer->CTLR1 &= ~TIM_CEN_Msk;
+}
+
+/**
+ * @brief Returns 1 while the counter runs (a one-pulse counter stops itself).
+ * @param timer TIMER1 or TIMER2.
+ * @return uint8_t: 1 if running, 0 if stopped.
+ */
+static inline uint8_t TIM_IsRunning(TIM_Typedef *timer)
+{
+    return (uint8_t)(timer->CTLR1 & TIM_CEN_Msk);
+}
+
+/**
+ * @brief Writes the counter.
+ * @param timer TIMER1 or TIMER2.
+ * @param value New counter value.
+ */
+static inline void TIM_SetCounter(TIM_Typedef *timer, uint16_t value)
+{
+    timer->CNT = value;
+}
+
+/**
+ * @brief Reads the counter.
+ * @param timer TIMER1 or TIMER2.
+ * @return uint16_t: The counter value.
+ */
+static inline uint16_t TIM_GetCounter(TIM_Typedef *timer)
+{
+    return (uint16_t)timer->CNT;
+}
+
+/**
+ * @brief Writes the auto-reload value (buffered with TIM_MODE_PRELOAD).
+ * @param timer TIMER1 or TIMER2.
+ * @param reload New auto-reload value.
+ */
+static inline void TIM_SetReload(TIM_Typedef *timer, uint16_t reload)
+{
+    timer->ATRLR = reload;
+}
+
+/**
+ * @brief Restarts the counter and loads the buffered prescaler and reload values.
+ * @param timer TIMER1 or TIMER2.
+ */
+static inline void TIM_GenerateUpdate(TIM_Typedef *timer)
+{
+    timer->SWEVGR = TIM_UG_Msk;
+}
+
+/**
+ * @brief Enables interrupts and DMA requests.
+ * @param timer TIMER1 or TIMER2.
+ * @param mask TIM_INT bits.
+ */
+static inline void TIM_EnableInterrupts(TIM_Typedef *timer, uint32_t mask)
+{
+    timer->DMAINTENR |= mask;
+}
+
+/**
+ * @brief Disables interrupts and DMA requests.
+ * @param timer TIMER1 or TIMER2.
+ * @param mask TIM_INT bits.
+ */
+static inline void TIM_DisableInterrupts(TIM_Typedef *timer, uint32_t mask)
+{
+    timer->DMAINTENR &= ~mask;
+}
+
+/**
+ * @brief Returns the pending event flags.
+ * @param timer TIMER1 or TIMER2.
+ * @return uint32_t: TIM_FLAG bits.
+ */
+static inline uint32_t TIM_GetFlags(TIM_Typedef *timer)
+{
+    return timer->INTFR;
+}
+
+/**
+ * @brief Writes a channel's compare value.
+ * @param timer TIMER1 or TIMER2.
+ * @param channel The channel.
+ * @param compare New compare value (buffered with TIM_PWM_PRELOAD).
+ */
+static inline void TIM_SetCompare(TIM_Typedef *timer, TIM_CHANNEL channel, uint16_t compare)
+{
+    timer->CHCVR[channel] = compare;
+}
+
+/**
+ * @brief Sets the repetition counter: one update event every count + 1 counter periods.
+ *
+ * In center-aligned mode the counter overflows and underflows once each per
+ * PWM period, so 1 gives one update per period.
+ *
+ * @param timer TIMER1.
+ * @param count Repetitions (0..255), loaded at the next update.
+ */
+static inline void TIM_SetRepetition(TIM_Typedef *timer, uint8_t count)
+{
+    timer->RPTCR = count;
+}
+
+/**
+ * @brief Holds the update event, so preloaded values written from now on stay buffered.
+ * @param timer TIMER1 or TIMER2.
+ */
+static inline void TIM_BeginUpdate(TIM_Typedef *timer)
+{
+    timer->CTLR1 |= TIM_UDIS_Msk;
+}
+
+/**
+ * @brief Releases the update event: the buffered values apply together at the next one.
+ * @param timer TIMER1 or TIMER2.
+ */
+static inline void TIM_EndUpdate(TIM_Typedef *timer)
+{
+    timer->CTLR1 &= ~TIM_UDIS_Msk;
+}
+
+/**
+ * @brief Enables the outputs (sets MOE), e.g. after a break.
+ * @param timer TIMER1.
+ */
+static inline void TIM_EnableOutputs(TIM_Typedef *timer)
+{
+    timer->BDTR |= TIM_MOE_Msk;
+}
+
+/**
+ * @brief Drives all outputs to their inactive level (clears MOE), as a break does.
+ * @param timer TIMER1.
+ */
+static inline void TIM_DisableOutputs(TIM_Typedef *timer)
+{
+    timer->BDTR &= ~TIM_MOE_Msk;
+}
+
+/**
+ * @brief Applies the preloaded output modes and enables now (software COM event).
+ * @param timer TIMER1.
+ */
+static inline void TIM_GenerateCommutation(TIM_Typedef *timer)
+{
+    timer->SWEVGR = TIM_COMG_Msk;
+}
+
+/**
+ * @brief Returns the DMA channel that serves a timer's update request.
+ * @param timer TIMER1 or TIMER2.
+ * @return DMA_CHANNEL: DMA_CHANNEL_5 for TIM1, DMA_CHANNEL_2 for TIM2.
+ */
+static inline DMA_CHANNEL TIM_GetUpdateDmaChannel(TIM_Typedef *timer)
+{
+    return timer == TIMER1 ? DMA_CHANNEL_5 : DMA_CHANNEL_2;
+}
+
+/**
+ * @brief Starts streaming compare values, one per update event.
+ * @param timer TIMER1 or TIMER2, set up with TIM_StreamInit().
+ * @param values The compare values (bytes, or halfwords with DMA_MODE_MEM_SIZE_16).
+ * @param count Number of values (1..65535).
+ */
+static inline void TIM_StreamStart(TIM_Typedef *timer, const volatile void *values, uint16_t count)
+{
+    DMA_ChannelStart(TIM_GetUpdateDmaChannel(timer), values, count);
+}
+
+/**
+ * @brief Stops streaming; the compare register keeps the last value.
+ * @param timer TIMER1 or TIMER2.
+ */
+static inline void TIM_StreamStop(TIM_Typedef *timer)
+{
+    DMA_ChannelStop(TIM_GetUpdateDmaChannel(timer));
+}
+
+/**
+ * @brief Returns the DMA channel that serves a timer channel's compare / capture request.
+ *
+ * One DMA channel number per nibble, channel 1 in the lowest: TIM1 CH1..CH4
+ * use DMA channels 2, 3, 6 and 4, TIM2 CH1..CH4 use 5, 7, 1 and 7.
+ *
+ * @param timer TIMER1 or TIMER2.
+ * @param channel The channel.
+ * @return DMA_CHANNEL: The DMA channel.
+ */
+static inline DMA_CHANNEL TIM_GetCaptureDmaChannel(TIM_Typedef *timer, TIM_CHANNEL channel)
+{
+    uint32_t map = timer == TIMER1 ? 0x3521 : 0x6064;
+
+    return (DMA_CHANNEL)((map >> (channel * 4)) & 0x0F);
+}
+
+/**
+ * @brief Starts copying captured values into a buffer, one per capture.
+ * @param timer TIMER1 or TIMER2, set up with TIM_CaptureDmaInit().
+ * @param channel The channel.
+ * @param values The buffer for the 16-bit captured values.
+ * @param count Number of values (1..65535).
+ */
+static inline void TIM_CaptureStart(TIM_Typedef *timer, TIM_CHANNEL channel, volatile uint16_t *values, uint16_t count)
+{
+    DMA_ChannelStart(TIM_GetCaptureDmaChannel(timer, channel), values, count);
+}
+
+/**
+ * @brief Stops copying captured values; the capture itself stays enabled.
+ * @param timer TIMER1 or TIMER2.
+ * @param channel The channel.
+ */
+static inline void TIM_CaptureStop(TIM_Typedef *timer, TIM_CHANNEL channel)
+{
+    DMA_ChannelStop(TIM_GetCaptureDmaChannel(timer, channel));
+}
+
+/**
+ * @brief Clears event flags.
+ *
+ * INTFR flags are cleared by writing 0 and kept by writing 1, so a single
+ * store clears exactly the given flags without a read-modify-write race.
+ *
+ * @param timer TIMER1 or TIMER2.
+ * @param flags TIM_FLAG bits to clear.
+ */
+static inline void TIM_ClearFlags(TIM_Typedef *timer, uint32_t flags)
+{
+    timer->INTFR = ~flags;
+}
+
+#endif /* TIM_H */
@@ -0,0 +1,264 @@
+#ifndef TIM_BITS_H
+#define TIM_BITS_H
+
+/**
+ * @file tim_bits.h
+ * @brief Register Bit Definitions for the TIM1 (advanced) and TIM2 (general purpose) timers.
+ *
+ * Field names carry a TIM_ prefix, as in usart_bits.h. Both timers share the
+ * register layout; the complementary output, repetition and break fields only
+ * exist on TIM1.
+ */
+
+// TIM Control Register 1 (TIM_CTLR1)
+
+// Single bit field position
+#define TIM_CEN_Pos 0
+#define TIM_UDIS_Pos 1
+#define TIM_URS_Pos 2
+#define TIM_OPM_Pos 3
+#define TIM_DIR_Pos 4
+#define TIM_ARPE_Pos 7
+// Single bit field mask
+#define TIM_CEN_Msk (0x01 << TIM_CEN_Pos)
+#define TIM_UDIS_Msk (0x01 << TIM_UDIS_Pos)
+#define TIM_URS_Msk (0x01 << TIM_URS_Pos)
+#define TIM_OPM_Msk (0x01 << TIM_OPM_Pos)
+#define TIM_DIR_Msk (0x01 << TIM_DIR_Pos)
+#define TIM_ARPE_Msk (0x01 << TIM_ARPE_Pos)
+// Multi bit field position
+#define TIM_CMS_Pos 5
+#define TIM_CKD_Pos 8
+// Multi bit field mask
+#define TIM_CMS_Msk (0x03 << TIM_CMS_Pos)
+#define TIM_CKD_Msk (0x03 << TIM_CKD_Pos)
+
+// TIM Control Register 2 (TIM_CTLR2)
+
+// Single bit field position
+#define TIM_CCPC_Pos 0
+#define TIM_CCUS_Pos 2
+#define TIM_CCDS_Pos 3
+#define TIM_TI1S_Pos 7
+#define TIM_OIS1_Pos 8
+#define TIM_OIS1N_Pos 9
+#define TIM_OIS2_Pos 10
+#define TIM_OIS2N_Pos 11
+#define TIM_OIS3_Pos 12
+#define TIM_OIS3N_Pos 13
+#define TIM_OIS4_Pos 14
+// Single bit field mask
+#define TIM_CCPC_Msk (0x01 << TIM_CCPC_Pos)
+#define TIM_CCUS_Msk (0x01 << TIM_CCUS_Pos)
+#define TIM_CCDS_Msk (0x01 << TIM_CCDS_Pos)
+#define TIM_TI1S_Msk (0x01 << TIM_TI1S_Pos)
+#define TIM_OIS1_Msk (0x01 << TIM_OIS1_Pos)
+#define TIM_OIS1N_Msk (0x01 << TIM_OIS1N_Pos)
+#define TIM_OIS2_Msk (0x01 << TIM_OIS2_Pos)
+#define TIM_OIS2N_Msk (0x01 << TIM_OIS2N_Pos)
+#define TIM_OIS3_Msk (0x01 << TIM_OIS3_Pos)
+#define TIM_OIS3N_Msk (0x01 << TIM_OIS3N_Pos)
+#define TIM_OIS4_Msk (0x01 << TIM_OIS4_Pos)
+// Multi bit field position
+#define TIM_MMS_Pos 4
+// Multi bit field mask
+#define TIM_MMS_Msk (0x07 << TIM_MMS_Pos)
+
+// TIM Slave Mode Control Register (TIM_SMCFGR)
+
+// Single bit field position
+#define TIM_MSM_Pos 7
+#define TIM_ECE_Pos 14
+#define TIM_ETP_Pos 15
+// Single bit field mask
+#define TIM_MSM_Msk (0x01 << TIM_MSM_Pos)
+#define TIM_ECE_Msk (0x01 << TIM_ECE_Pos)
+#define TIM_ETP_Msk (0x01 << TIM_ETP_Pos)
+// Multi bit field position
+#define TIM_SMS_Pos 0
+#define TIM_TS_Pos 4
+#define TIM_ETF_Pos 8
+#define TIM_ETPS_Pos 12
+// Multi bit field mask
+#define TIM_SMS_Msk (0x07 << TIM_SMS_Pos)
+#define TIM_TS_Msk (0x07 << TIM_TS_Pos)
+#define TIM_ETF_Msk (0x0F << TIM_ETF_Pos)
+#define TIM_ETPS_Msk (0x03 << TIM_ETPS_Pos)
+
+// TIM DMA / Interrupt Enable Register (TIM_DMAINTENR)
+
+// Single bit field position
+#define TIM_UIE_Pos 0
+#define TIM_CC1IE_Pos 1
+#define TIM_CC2IE_Pos 2
+#define TIM_CC3IE_Pos 3
+#define TIM_CC4IE_Pos 4
+#define TIM_COMIE_Pos 5
+#define TIM_TIE_Pos 6
+#define TIM_BIE_Pos 7
+#define TIM_UDE_Pos 8
+#define TIM_CC1DE_Pos 9
+#define TIM_CC2DE_Pos 10
+#define TIM_CC3DE_Pos 11
+#define TIM_CC4DE_Pos 12
+#define TIM_COMDE_Pos 13
+#define TIM_TDE_Pos 14
+// Single bit field mask
+#define TIM_UIE_Msk (0x01 << TIM_UIE_Pos)
+#define TIM_CC1IE_Msk (0x01 << TIM_CC1IE_Pos)
+#define TIM_CC2IE_Msk (0x01 << TIM_CC2IE_Pos)
+#define TIM_CC3IE_Msk (0x01 << TIM_CC3IE_Pos)
+#define TIM_CC4IE_Msk (0x01 << TIM_CC4IE_Pos)
+#define TIM_COMIE_Msk (0x01 << TIM_COMIE_Pos)
+#define TIM_TIE_Msk (0x01 << TIM_TIE_Pos)
+#define TIM_BIE_Msk (0x01 << TIM_BIE_Pos)
+#define TIM_UDE_Msk (0x01 << TIM_UDE_Pos)
+#define TIM_CC1DE_Msk (0x01 << TIM_CC1DE_Pos)
+#define TIM_CC2DE_Msk (0x01 << TIM_CC2DE_Pos)
+#define TIM_CC3DE_Msk (0x01 << TIM_CC3DE_Pos)
+#define TIM_CC4DE_Msk (0x01 << TIM_CC4DE_Pos)
+#define TIM_COMDE_Msk (0x01 << TIM_COMDE_Pos)
+#define TIM_TDE_Msk (0x01 << TIM_TDE_Pos)
+
+// TIM Interrupt Status Register (TIM_INTFR)
+// Flags are cleared by writing 0; writing 1 leaves them unchanged.
+
+// Single bit field position
+#define TIM_UIF_Pos 0
+#define TIM_CC1IF_Pos 1
+#define TIM_CC2IF_Pos 2
+#define TIM_CC3IF_Pos 3
+#define TIM_CC4IF_Pos 4
+#define TIM_COMIF_Pos 5
+#define TIM_TIF_Pos 6
+#define TIM_BIF_Pos 7
+#define TIM_CC1OF_Pos 9
+#define TIM_CC2OF_Pos 10
+#define TIM_CC3OF_Pos 11
+#define TIM_CC4OF_Pos 12
+// Single bit field mask
+#define TIM_UIF_Msk (0x01 << TIM_UIF_Pos)
+#define TIM_CC1IF_Msk (0x01 << TIM_CC1IF_Pos)
+#define TIM_CC2IF_Msk (0x01 << TIM_CC2IF_Pos)
+#define TIM_CC3IF_Msk (0x01 << TIM_CC3IF_Pos)
+#define TIM_CC4IF_Msk (0x01 << TIM_CC4IF_Pos)
+#define TIM_COMIF_Msk (0x01 << TIM_COMIF_Pos)
+#define TIM_TIF_Msk (0x01 << TIM_TIF_Pos)
+#define TIM_BIF_Msk (0x01 << TIM_BIF_Pos)
+#define TIM_CC1OF_Msk (0x01 << TIM_CC1OF_Pos)
+#define TIM_CC2OF_Msk (0x01 << TIM_CC2OF_Pos)
+#define TIM_CC3OF_Msk (0x01 << TIM_CC3OF_Pos)
+#define TIM_CC4OF_Msk (0x01 << TIM_CC4OF_Pos)
+
+// TIM Event Generation Register (TIM_SWEVGR)
+
+// Single bit field position
+#define TIM_UG_Pos 0
+#define TIM_CC1G_Pos 1
+#define TIM_CC2G_Pos 2
+#define TIM_CC3G_Pos 3
+#define TIM_CC4G_Pos 4
+#define TIM_COMG_Pos 5
+#define TIM_TG_Pos 6
+#define TIM_BG_Pos 7
+// Single bit field mask
+#define TIM_UG_Msk (0x01 << TIM_UG_Pos)
+#define TIM_CC1G_Msk (0x01 << TIM_CC1G_Pos)
+#define TIM_CC2G_Msk (0x01 << TIM_CC2G_Pos)
+#define TIM_CC3G_Msk (0x01 << TIM_CC3G_Pos)
+#define TIM_CC4G_Msk (0x01 << TIM_CC4G_Pos)
+#define TIM_COMG_Msk (0x01 << TIM_COMG_Pos)
+#define TIM_TG_Msk (0x01 << TIM_TG_Pos)
+#define TIM_BG_Msk (0x01 << TIM_BG_Pos)
+
+// TIM Compare / Capture Control Registers (TIM_CHCTLR1 = channels 1, 2; TIM_CHCTLR2 = channels 3, 4)
+// Each register holds two channels; the second channel's fields are TIM_CHCTLR_STRIDE bits up.
+
+// Bits per channel
+#define TIM_CHCTLR_STRIDE 8
+// Single bit field position (output compare)
+#define TIM_OCFE_Pos 2
+#define TIM_OCPE_Pos 3
+#define TIM_OCCE_Pos 7
+// Single bit field mask (output compare)
+#define TIM_OCFE_Msk (0x01 << TIM_OCFE_Pos)
+#define TIM_OCPE_Msk (0x01 << TIM_OCPE_Pos)
+#define TIM_OCCE_Msk (0x01 << TIM_OCCE_Pos)
+// Multi bit field position
+#define TIM_CCS_Pos 0
+#define TIM_OCM_Pos 4
+#define TIM_ICPSC_Pos 2
+#define TIM_ICF_Pos 4
+// Multi bit field mask
+#define TIM_CCS_Msk (0x03 << TIM_CCS_Pos)
+#define TIM_OCM_Msk (0x07 << TIM_OCM_Pos)
+#define TIM_ICPSC_Msk (0x03 << TIM_ICPSC_Pos)
+#define TIM_ICF_Msk (0x0F << TIM_ICF_Pos)
+
+// TIM Compare / Capture Enable Register (TIM_CCER)
+// Four bits per channel; the positions below are for channel 1 and move up by TIM_CCER_STRIDE.
+
+// Bits per channel
+#define TIM_CCER_STRIDE 4
+// Single bit field position (channel 1)
+#define TIM_CCE_Pos 0
+#define TIM_CCP_Pos 1
+#define TIM_CCNE_Pos 2
+#define TIM_CCNP_Pos 3
+// Single bit field mask (channel 1)
+#define TIM_CCE_Msk (0x01 << TIM_CCE_Pos)
+#define TIM_CCP_Msk (0x01 << TIM_CCP_Pos)
+#define TIM_CCNE_Msk (0x01 << TIM_CCNE_Pos)
+#define TIM_CCNP_Msk (0x01 << TIM_CCNP_Pos)
+
+// TIM Counter (TIM_CNT), Prescaler (TIM_PSC) and Auto-Reload (TIM_ATRLR) Registers
+
+// Multi bit field position
+#define TIM_CNT_Pos 0
+#define TIM_PSC_Pos 0
+#define TIM_ATRLR_Pos 0
+// Multi bit field mask
+#define TIM_CNT_Msk (0xFFFF << TIM_CNT_Pos)
+#define TIM_PSC_Msk (0xFFFF << TIM_PSC_Pos)
+#define TIM_ATRLR_Msk (0xFFFF << TIM_ATRLR_Pos)
+
+// TIM Repetition Counter Register (TIM_RPTCR), TIM1 only
+
+// Multi bit field position
+#define TIM_REP_Pos 0
+// Multi bit field mask
+#define TIM_REP_Msk (0xFF << TIM_REP_Pos)
+
+// TIM Brake and Dead-Time Register (TIM_BDTR), TIM1 only
+
+// Single bit field position
+#define TIM_OSSI_Pos 10
+#define TIM_OSSR_Pos 11
+#define TIM_BKE_Pos 12
+#define TIM_BKP_Pos 13
+#define TIM_AOE_Pos 14
+#define TIM_MOE_Pos 15
+// Single bit field mask
+#define TIM_OSSI_Msk (0x01 << TIM_OSSI_Pos)
+#define TIM_OSSR_Msk (0x01 << TIM_OSSR_Pos)
+#define TIM_BKE_Msk (0x01 << TIM_BKE_Pos)
+#define TIM_BKP_Msk (0x01 << TIM_BKP_Pos)
+#define TIM_AOE_Msk (0x01 << TIM_AOE_Pos)
+#define TIM_MOE_Msk (0x01 << TIM_MOE_Pos)
+// Multi bit field position
+#define TIM_DTG_Pos 0
+#define TIM_LOCK_Pos 8
+// Multi bit field mask
+#define TIM_DTG_Msk (0xFF << TIM_DTG_Pos)
+#define TIM_LOCK_Msk (0x03 << TIM_LOCK_Pos)
+
+// TIM DMA Control Register (TIM_DMACFGR)
+
+// Multi bit field position
+#define TIM_DBA_Pos 0
+#define TIM_DBL_Pos 8
+// Multi bit field mask
+#define TIM_DBA_Msk (0x1F << TIM_DBA_Pos)
+#define TIM_DBL_Msk (0x1F << TIM_DBL_Pos)
+
+#endif /* TIM_BITS_H */
@@ -0,0 +1,110 @@
+#ifndef TIM_REG_H
+#define TIM_REG_H
+
+#include <stdint.h>
+#include "tim_bits.h"
+
+/**
+ * @brief Base addresses of the timers.
+ * * TIM1 (advanced control) sits on APB2, TIM2 (general purpose) on APB1;
+ * on the CH32V003 both buses run at HCLK.
+ */
+#define TIM1_BASE 0x40012C00UL
+#define TIM2_BASE 0x40000000UL
+
+/**
+ * @brief Timer Register Map Structure, shared by TIM1 and TIM2.
+ * * The registers are 16 bits wide on a 32-bit stride.
+ */
+typedef struct
+{
+    /** @brief Control Register 1 (TIM_CTLR1)
+     * Counter enable, one-pulse mode, direction, center-aligned modes and
+     * auto-reload preload.
+     */
+    volatile uint32_t CTLR1;
+
+    /** @brief Control Register 2 (TIM_CTLR2)
+     * Master mode (TRGO) selection, compare DMA request timing and the TIM1
+     * output idle states.
+     */
+    volatile uint32_t CTLR2;
+
+    /** @brief Slave Mode Control Register (TIM_SMCFGR)
+     * Trigger selection, slave mode and external trigger filter.
+     */
+    volatile uint32_t SMCFGR;
+
+    /** @brief DMA / Interrupt Enable Register (TIM_DMAINTENR)
+     * Interrupt enables in the low byte, DMA request enables in the high byte.
+     */
+    volatile uint32_t DMAINTENR;
+
+    /** @brief Interrupt Status Register (TIM_INTFR)
+     * Event and overcapture flags, cleared by writing 0.
+     */
+    volatile uint32_t INTFR;
+
+    /** @brief Event Generation Register (TIM_SWEVGR)
+     * Software update, capture/compare, trigger and break events.
+     */
+    volatile uint32_t SWEVGR;
+
+    /** @brief Compare / Capture Control Register 1 (TIM_CHCTLR1)
+     * Mode of channels 1 and 2.
+     */
+    volatile uint32_t CHCTLR1;
+
+    /** @brief Compare / Capture Control Register 2 (TIM_CHCTLR2)
+     * Mode of channels 3 and 4.
+     */
+    volatile uint32_t CHCTLR2;
+
+    /** @brief Compare / Capture Enable Register (TIM_CCER)
+     * Output enables and polarities, capture enables and edges.
+     */
+    volatile uint32_t CCER;
+
+    /** @brief Counter (TIM_CNT) */
+    volatile uint32_t CNT;
+
+    /** @brief Prescaler (TIM_PSC)
+     * The counter clock is the timer clock / (PSC + 1). Loaded at the next update event.
+     */
+    volatile uint32_t PSC;
+
+    /** @brief Auto-Reload Register (TIM_ATRLR)
+     * The counter counts from 0 to ATRLR, a period of ATRLR + 1 ticks.
+     */
+    volatile uint32_t ATRLR;
+
+    /** @brief Repetition Counter Register (TIM_RPTCR), TIM1 only
+     * Update events are generated every RPTCR + 1 counter periods.
+     */
+    volatile uint32_t RPTCR;
+
+    /** @brief Compare / Capture Registers 1 to 4 (TIM_CH1CVR .. TIM_CH4CVR) */
+    volatile uint32_t CHCVR[4];
+
+    /** @brief Brake and Dead-Time Register (TIM_BDTR), TIM1 only
+     * Dead-time generator, break input and the main output enable (MOE).
+     */
+    volatile uint32_t BDTR;
+
+    /** @brief DMA Control Register (TIM_DMACFGR)
+     * Base address and length of DMA burst transfers.
+     */
+    volatile uint32_t DMACFGR;
+
+    /** @brief DMA Address for Burst Mode (TIM_DMAADR) */
+    volatile uint32_t DMAADR;
+} TIM_Typedef;
+
+/**
+ * @brief Pointer definitions for accessing the timer registers.
+ * * Named TIMER1 / TIMER2 because TIM1 and TIM2 are already RCC_PERIPHERAL enumerators.
+ */
+#define TIMER1 ((TIM_Typedef *)TIM1_BASE)
+#define TIMER2 ((TIM_Typedef *)TIM2_BASE)
+
+#endif /* TIM_REG_H */
@@ -0,0 +1,304 @@
+#ifndef USART_H
+#define USART_H
+
+#include <stdint.h>
+#include "usart_bits.h"
+#include "usart_reg.h"
+
+/**
+ * @file usart.h
+ * @brief Public interface for the interrupt-driven USART1 driver.
+ *
+ * USART1 runs 8N1 on its default pins (TX = PD5, RX = PD6). Received bytes
+ * are moved by USART1_IRQHandler into an RX ring, bytes to send are taken
+ * from a TX ring; the application side never waits on the peripheral.
+ *
+ * Both rings are single-producer/single-consumer: head is only written by the
+ * producer and tail only by the consumer (the handler produces RX and consumes
+ * TX), so neither side needs a lock. The read and write functions must only be
+ * called from one context (normally the main loop).
+ *
+ * A byte is lost when the RX ring is full (counted in USART_STATS.dropped) or
+ * when the handler is held off for more than one character time (hardware
+ * overrun, USART_STATS.overruns). At 1 Mbaud a character takes 10 us, 480
+ * cycles at 48 MHz, so higher priority handlers must stay below that.
+ *
+ * With USART_TX_DMA set, USART_WriteChain() sends a linked chain of
+ * (pointer, length) segments straight from their buffers through DMA1
+ * channel 4: a header, a payload and a checksum can go out back to back
+ * without being assembled in one buffer first. The channel's
+ * transfer-complete interrupt reloads it with the next segment and runs the
+ * finished segment's callback, after which its buffer may be reused. Chains
+ * and the TX ring share the transmitter: a chain queued while the ring is
+ * draining starts once the bytes written before it are out, and USART_Write()
+ * bytes written while chains are pending wait until the chain queue is empty.
+ * A continuously fed ring cannot hold a chain back, but a chain queue that
+ * never runs empty holds the ring back.
+ *
+ * With USART_RX_DMA set, reception runs from DMA1 channel 5 into a circular
+ * buffer instead of the RX ring, and the byte-wise read functions are left
+ * out. Frame ends are found with the idle-line interrupt (one character time
+ * of silence); the DMA half and full transfer interrupts cut long frames and
+ * the buffer wrap. Each event queues a USART_RX_VIEW, an (offset, length)
+ * window into the DMA buffer, and the application reads the bytes in place.
+ * That is one interrupt per frame instead of one per byte. Views must be
+ * released before the DMA comes round again: the buffer holds
+ * USART_RX_DMA_SIZE character times (1.28 ms for 128 bytes at 1 Mbaud).
+ *
+ * A protocol that needs the arrival time of each byte (Modbus RTU frame
+ * gaps) installs a receive hook with USART_SetRxHook(): the handler then
+ * passes every byte to the hook instead of the RX ring.
+ *
+ * The baud rate divisor is computed from RCC_GetHCLKFreq(). Call
+ * USART_SetBaudRate() again after changing SYSCLK or the AHB prescaler.
+ * USART_SetDivisor() takes the divisor in HCLK cycles per bit instead, as
+ * measured by the auto-baud detector (Middleware/inc/AUTOBAUD/autobaud.h).
+ * Tools/usart_throughput.py checks a link for lost bytes against the echo
+ * loop in User/main.c.
+ */
+
+// --- CONFIGURATION ---
+
+/**
+ * @brief Receive ring size in bytes. Must be a power of two no larger than 128.
+ */
+#ifndef USART_RX_BUFFER_SIZE
+#define USART_RX_BUFFER_SIZE 64
+#endif
+
+/**
+ * @brief Transmit ring size in bytes. Must be a power of two no larger than 128.
+ */
+#ifndef USART_TX_BUFFER_SIZE
+#define USART_TX_BUFFER_SIZE 64
+#endif
+
+/**
+ * @brief Set to 0 to leave out the DMA transmit path (USART_WriteChain()).
+ */
+#ifndef USART_TX_DMA
+#define USART_TX_DMA 1
+#endif
+
+/**
+ * @brief Set to 1 to receive through circular DMA and idle-line framing
+ * (USART_PeekRxView()) instead of the RX ring (USART_Read()).
+ */
+#ifndef USART_RX_DMA
+#define USART_RX_DMA 0
+#endif
+
+/**
+ * @brief Circular DMA receive buffer size in bytes (2..32768), USART_RX_DMA only.
+ */
+#ifndef USART_RX_DMA_SIZE
+#define USART_RX_DMA_SIZE 128
+#endif
+
+/**
+ * @brief Number of queued receive views. Must be a power of two no larger than
+ * 128, USART_RX_DMA only.
+ */
+#ifndef USART_RX_VIEW_DEPTH
+#define USART_RX_VIEW_DEPTH 8
+#endif
+
+// --- ENUMERATED TYPES ---
+
+/**
+ * @brief Status codes returned by the USART functions.
+ */
+typedef enum
+{
+    USART_STATUS_SUCCESS,      /**< Operation completed. */
+    USART_STATUS_INVALID_BAUD, /**< Baud rate out of range for the current HCLK. */
+    USART_STATUS_EMPTY,        /**< RX ring empty, no byte read. */
+    USART_STATUS_FULL,         /**< TX ring full, byte not queued. */
+    USART_STATUS_INVALID_CHAIN /**< Empty chain or a segment of length 0. */
+} USART_STATUS;
+
+// --- TYPES ---
+
+/**
+ * @brief Receive error counters, updated by USART1_IRQHandler.
+ */
+typedef struct
+{
+    uint32_t dropped;  /**< Bytes received while the RX ring (or view queue) was full, or overwritten unread by the DMA. */
+    uint32_t overruns; /**< Hardware overruns: a byte arrived before the previous one was read. */
+    uint32_t errors;   /**< Bytes received with a framing or noise error. */
+} USART_STATS;
+
+/**
+ * @brief One buffer of a DMA transmit chain.
+ *
+ * The segment and its buffer belong to the driver from USART_WriteChain()
+ * until its done callback runs. The driver links chains queued one after the
+ * other through the next field of the last segment.
+ */
+typedef struct USART_SEGMENT
+{
+    const uint8_t *data;                         /**< First byte, in RAM or flash. */
+    uint16_t length;                             /**< Number of bytes (at least 1). */
+    struct USART_SEGMENT *next;                  /**< Following segment, NULL at the end of the chain. */
+    void (*done)(struct USART_SEGMENT *segment); /**< Run from the DMA handler once the segment is read, may be NULL. */
+} USART_SEGMENT;
+
+/**
+ * @brief Contiguous run of received bytes in the circular DMA buffer.
+ *
+ * A frame is delivered as one or more views, the last one with end set. A
+ * view never wraps around the end of the buffer. A view of length 0 only
+ * marks the end of a frame whose bytes were all delivered already.
+ */
+typedef struct
+{
+    uint16_t offset; /**< First byte, from USART_GetRxDmaBuffer(). */
+    uint16_t length; /**< Number of bytes. */
+    uint8_t end;     /**< 1 if the line went idle after this view (end of frame). */
+} USART_RX_VIEW;
+
+#if !USART_RX_DMA
+/**
+ * @brief Receive hook, called from USART1_IRQHandler for every received byte.
+ * @param byte The received byte.
+ * @param error 1 if the byte has a framing or noise error, or bytes were lost to an overrun before it.
+ */
+typedef void (*USART_RX_HOOK)(uint8_t byte, uint8_t error);
+#endif
+
+// --- FUNCTION PROTOTYPES ---
+
+/**
+ * @brief Sets up USART1 for 8N1 on PD5 / PD6 and enables its interrupt.
+ * @param baudRate Baud rate in bit/s.
+ * @return USART_STATUS: USART_STATUS_SUCCESS or USART_STATUS_INVALID_BAUD.
+ */
+USART_STATUS USART_Init(uint32_t baudRate);
+
+/**
+ * @brief Reprograms the baud rate divisor from the current HCLK.
+ * @param baudRate Baud rate in bit/s.
+ * @return USART_STATUS: USART_STATUS_SUCCESS or USART_STATUS_INVALID_BAUD.
+ */
+USART_STATUS USART_SetBaudRate(uint32_t baudRate);
+
+/**
+ * @brief Programs the baud rate divisor directly, in HCLK cycles per bit.
+ * @param divisor HCLK cycles per bit (16..65535).
+ * @return USART_STATUS: USART_STATUS_SUCCESS or USART_STATUS_INVALID_BAUD.
+ */
+USART_STATUS USART_SetDivisor(uint32_t divisor);
+
+/**
+ * @brief Returns the current baud rate divisor.
+ * @return uint32_t: HCLK cycles per bit.
+ */
+uint32_t USART_GetDivisor(void);
+
+/**
+ * @brief Enables or disables the receiver.
+ * @param enable 1 to enable, 0 to disable.
+ */
+void USART_SetReceiver(uint8_t enable);
+
+/**
+ * @brief Queues as many bytes as the TX ring has room for.
+ * @param data The bytes to send.
+ * @param length Number of bytes.
+ * @return uint16_t: Number of bytes queued.
+ */
+uint16_t USART_Write(const uint8_t *data, uint16_t length);
+
+#if !USART_RX_DMA
+/**
+ * @brief Copies up to length received bytes out of the RX ring.
+ * @param data Destination buffer.
+ * @param length Size of the destination buffer.
+ * @return uint16_t: Number of bytes read.
+ */
+uint16_t USART_Read(uint8_t *data, uint16_t length);
+#else
+/**
+ * @brief Returns the circular DMA receive buffer the views point into.
+ *
+ * The bytes of a view belong to the caller until USART_ReleaseRxView() and
+ * may be changed in place, e.g. to decode a frame where it arrived.
+ *
+ * @return uint8_t*: Start of the buffer (USART_RX_DMA_SIZE bytes).
+ */
+uint8_t *USART_GetRxDmaBuffer(void);
+
+/**
+ * @brief Returns the oldest received view without removing it.
+ * @param view Receives the view.
+ * @return USART_STATUS: USART_STATUS_SUCCESS or USART_STATUS_EMPTY.
+ */
+USART_STATUS USART_PeekRxView(USART_RX_VIEW *view);
+
+/**
+ * @brief Removes the oldest view; its bytes may be overwritten from now on.
+ */
+void USART_ReleaseRxView(void);
+#endif
+
+#if USART_TX_DMA
+/**
+ * @brief Queues a chain of segments for DMA transmission.
+ * @param chain First segment, the chain ends at a NULL next.
+ * @return USART_STATUS: USART_STATUS_SUCCESS or USART_STATUS_INVALID_CHAIN.
+ */
+USART_STATUS USART_WriteChain(USART_SEGMENT *chain);
+#endif
+
+/**
+ * @brief Queues one byte.
+ * @param byte The byte to send.
+ * @return USART_STATUS: USART_STATUS_SUCCESS or USART_STATUS_FULL.
+ */
+USART_STATUS USART_PutChar(uint8_t byte);
+
+#if !USART_RX_DMA
+/**
+ * @brief Takes one byte from the RX ring.
+ * @param byte Receives the byte.
+ * @return USART_STATUS: USART_STATUS_SUCCESS or USART_STATUS_EMPTY.
+ */
+USART_STATUS USART_GetChar(uint8_t *byte);
+
+/**
+ * @brief Returns the number of received bytes waiting in the RX ring.
+ * @return uint16_t: Bytes available to USART_Read().
+ */
+uint16_t USART_GetRxCount(void);
+
+/**
+ * @brief Routes received bytes to a hook instead of the RX ring.
+ * @param hook The hook, or NULL to go back to the RX ring.
+ */
+void USART_SetRxHook(USART_RX_HOOK hook);
+#endif
+
+/**
+ * @brief Returns the free space in the TX ring.
+ * @return uint16_t: Bytes USART_Write() can queue right now.
+ */
+uint16_t USART_GetTxFree(void);
+
+/**
+ * @brief Waits until the TX ring and the chain queue are empty and the last stop bit is out.
+ */
+void USART_Flush(void);
+
+/**
+ * @brief Copies the receive error counters.
+ * @param stats Receives the counters.
+ */
+void USART_GetStats(USART_STATS *stats);
+
+/**
+ * @brief Zeroes the receive error counters.
+ */
+void USART_ClearStats(void);
+
+#endif /* USART_H */
@@ -0,0 +1,147 @@
+#ifndef USART_BITS_H
+#define USART_BITS_H
+
+/**
+ * @file usart_bits.h
+ * @brief Register Bit Definitions for the USART1 Peripheral.
+ *
+ * Field names carry a USART_ prefix: several of them (TCIE, TE, PE, ...) are
+ * also DMA and timer field names.
+ */
+
+// USART Status Register (USART_STATR)
+
+// Single bit field position
+#define USART_PE_Pos 0
+#define USART_FE_Pos 1
+#define USART_NE_Pos 2
+#define USART_ORE_Pos 3
+#define USART_IDLE_Pos 4
+#define USART_RXNE_Pos 5
+#define USART_TC_Pos 6
+#define USART_TXE_Pos 7
+#define USART_LBD_Pos 8
+#define USART_CTS_Pos 9
+// Single bit field mask
+#define USART_PE_Msk (0x01 << USART_PE_Pos)
+#define USART_FE_Msk (0x01 << USART_FE_Pos)
+#define USART_NE_Msk (0x01 << USART_NE_Pos)
+#define USART_ORE_Msk (0x01 << USART_ORE_Pos)
+#define USART_IDLE_Msk (0x01 << USART_IDLE_Pos)
+#define USART_RXNE_Msk (0x01 << USART_RXNE_Pos)
+#define USART_TC_Msk (0x01 << USART_TC_Pos)
+#define USART_TXE_Msk (0x01 << USART_TXE_Pos)
+#define USART_LBD_Msk (0x01 << USART_LBD_Pos)
+#define USART_CTS_Msk (0x01 << USART_CTS_Pos)
+
+// USART Data Register (USART_DATAR)
+
+// Multi bit field position
+#define USART_DR_Pos 0
+// Multi bit field mask
+#define USART_DR_Msk (0x1FF << USART_DR_Pos)
+
+// USART Baud Rate Register (USART_BRR)
+
+// Multi bit field position
+#define USART_DIV_FRACTION_Pos 0
+#define USART_DIV_MANTISSA_Pos 4
+// Multi bit field mask
+#define USART_DIV_FRACTION_Msk (0x0F << USART_DIV_FRACTION_Pos)
+#define USART_DIV_MANTISSA_Msk (0xFFF << USART_DIV_MANTISSA_Pos)
+
+// USART Control Register 1 (USART_CTLR1)
+
+// Single bit field position
+#define USART_SBK_Pos 0
+#define USART_RWU_Pos 1
+#define USART_RE_Pos 2
+#define USART_TE_Pos 3
+#define USART_IDLEIE_Pos 4
+#define USART_RXNEIE_Pos 5
+#define USART_TCIE_Pos 6
+#define USART_TXEIE_Pos 7
+#define USART_PEIE_Pos 8
+#define USART_PS_Pos 9
+#define USART_PCE_Pos 10
+#define USART_WAKE_Pos 11
+#define USART_M_Pos 12
+#define USART_UE_Pos 13
+// Single bit field mask
+#define USART_SBK_Msk (0x01 << USART_SBK_Pos)
+#define USART_RWU_Msk (0x01 << USART_RWU_Pos)
+#define USART_RE_Msk (0x01 << USART_RE_Pos)
+#define USART_TE_Msk (0x01 << USART_TE_Pos)
+#define USART_IDLEIE_Msk (0x01 << USART_IDLEIE_Pos)
+#define USART_RXNEIE_Msk (0x01 << USART_RXNEIE_Pos)
+#define USART_TCIE_Msk (0x01 << USART_TCIE_Pos)
+#define USART_TXEIE_Msk (0x01 << USART_TXEIE_Pos)
+#define USART_PEIE_Msk (0x01 << USART_PEIE_Pos)
+#define USART_PS_Msk (0x01 << USART_PS_Pos)
+#define USART_PCE_Msk (0x01 << USART_PCE_Pos)
+#define USART_WAKE_Msk (0x01 << USART_WAKE_Pos)
+#define USART_M_Msk (0x01 << USART_M_Pos)
+#define USART_UE_Msk (0x01 << USART_UE_Pos)
+
+// USART Control Register 2 (USART_CTLR2)
+
+// Single bit field position
+#define USART_LBDL_Pos 5
+#define USART_LBDIE_Pos 6
+#define USART_LBCL_Pos 8
+#define USART_CPHA_Pos 9
+#define USART_CPOL_Pos 10
+#define USART_CLKEN_Pos 11
+#define USART_LINEN_Pos 14
+// Single bit field mask
+#define USART_LBDL_Msk (0x01 << USART_LBDL_Pos)
+#define USART_LBDIE_Msk (0x01 << USART_LBDIE_Pos)
+#define USART_LBCL_Msk (0x01 << USART_LBCL_Pos)
+#define USART_CPHA_Msk (0x01 << USART_CPHA_Pos)
+#define USART_CPOL_Msk (0x01 << USART_CPOL_Pos)
+#define USART_CLKEN_Msk (0x01 << USART_CLKEN_Pos)
+#define USART_LINEN_Msk (0x01 << USART_LINEN_Pos)
+// Multi bit field position
+#define USART_ADD_Pos 0
+#define USART_STOP_Pos 12
+// Multi bit field mask
+#define USART_ADD_Msk (0x0F << USART_ADD_Pos)
+#define USART_STOP_Msk (0x03 << USART_STOP_Pos)
+
+// USART Control Register 3 (USART_CTLR3)
+
+// Single bit field position
+#define USART_EIE_Pos 0
+#define USART_IREN_Pos 1
+#define USART_IRLP_Pos 2
+#define USART_HDSEL_Pos 3
+#define USART_NACK_Pos 4
+#define USART_SCEN_Pos 5
+#define USART_DMAR_Pos 6
+#define USART_DMAT_Pos 7
+#define USART_RTSE_Pos 8
+#define USART_CTSE_Pos 9
+#define USART_CTSIE_Pos 10
+// Single bit field mask
+#define USART_EIE_Msk (0x01 << USART_EIE_Pos)
+#define USART_IREN_Msk (0x01 << USART_IREN_Pos)
+#define USART_IRLP_Msk (0x01 << USART_IRLP_Pos)
+#define USART_HDSEL_Msk (0x01 << USART_HDSEL_Pos)
+#define USART_NACK_Msk (0x01 << USART_NACK_Pos)
+#define USART_SCEN_Msk (0x01 << USART_SCEN_Pos)
+#define USART_DMAR_Msk (0x01 << USART_DMAR_Pos)
+#define USART_DMAT_Msk (0x01 << USART_DMAT_Pos)
+#define USART_RTSE_Msk (0x01 << USART_RTSE_Pos)
+#define USART_CTSE_Msk (0x01 << USART_CTSE_Pos)
+#define USART_CTSIE_Msk (0x01 << USART_CTSIE_Pos)
+
+// USART Guard Time and Prescaler Register (USART_GPR)
+
+// Multi bit field position
+#define USART_PSC_Pos 0
+#define USART_GT_Pos 8
+// Multi bit field mask
+#define USART_PSC_Msk (0xFF << USART_PSC_Pos)
+#define USART_GT_Msk (0xFF << USART_GT_Pos)
+
+#endif /* USART_BITS_H */
@@ -0,0 +1,62 @@
+#ifndef USART_REG_H
+#define USART_REG_H
+
+#include <stdint.h>
+#include "usart_bits.h"
+
+/**
+ * @brief Base address of USART1.
+ * * USART1 sits on APB2, which on the CH32V003 always runs at HCLK.
+ */
+#define USART_BASE 0x40013800UL
+
+/**
+ * @brief USART Register Map Structure.
+ */
+typedef struct
+{
+    /** @brief Status Register (USART_STATR)
+     * RXNE and ORE are cleared by reading STATR then DATAR. TXE is cleared by
+     * writing DATAR.
+     */
+    volatile uint32_t STATR;
+
+    /** @brief Data Register (USART_DATAR)
+     * Reads the receive buffer, writes the transmit buffer.
+     */
+    volatile uint32_t DATAR;
+
+    /** @brief Baud Rate Register (USART_BRR)
+     * HCLK / baud rate, as a 12-bit mantissa and a 4-bit fraction (1/16 units).
+     */
+    volatile uint32_t BRR;
+
+    /** @brief Control Register 1 (USART_CTLR1)
+     * Enables the USART, transmitter and receiver, selects word length and
+     * parity, and holds the TXE/TC/RXNE/IDLE interrupt enables.
+     */
+    volatile uint32_t CTLR1;
+
+    /** @brief Control Register 2 (USART_CTLR2)
+     * Stop bits, synchronous clock output and LIN mode.
+     */
+    volatile uint32_t CTLR2;
+
+    /** @brief Control Register 3 (USART_CTLR3)
+     * DMA requests, hardware flow control, half-duplex, IrDA and smartcard modes.
+     */
+    volatile uint32_t CTLR3;
+
+    /** @brief Guard Time and Prescaler Register (USART_GPR)
+     * Used in IrDA and smartcard modes only.
+     */
+    volatile uint32_t GPR;
+} USART_Typedef;
+
+/**
+ * @brief Pointer definition for accessing the USART1 registers.
+ * * Named USART because USART1 is already the RCC_PERIPHERAL enumerator.
+ */
+#define USART ((USART_Typedef *)USART_BASE)
+
+#endif /* USART_REG_H */
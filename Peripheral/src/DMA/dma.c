@@ -0,0 +1,27 @@
+#include "DMA/dma.h"
+#include "RCC/rcc.h"
+
+/**
+ * @brief Enables the DMA clock and configures a stopped channel.
+ *
+ * The channel is left disabled with its flags cleared; DMA_ChannelStart()
+ * supplies the memory address and the count of each transfer.
+ *
+ * @param channel The channel.
+ * @param mode DMA_MODE options combined with '|'.
+ * @param peripheral Address of the peripheral data register.
+ */
+void DMA_ChannelInit(DMA_CHANNEL channel, uint32_t mode, volatile void *peripheral)
+{
+    DMA_Channel_Typedef *regs = DMA_CHANNEL_REGS(channel);
+
+    RCC_PeripheralEnable(DMA1);
+
+    regs->CFGR = 0;
+    regs->CNTR = 0;
+    regs->PADDR = (uint32_t)(uintptr_t)peripheral;
+    regs->MADDR = 0;
+    regs->CFGR = mode & ~DMA_EN_Msk;
+
+    DMA_ClearFlags(channel, DMA_FLAG_ALL);
+}
@@ -1,4 +1,16 @@
 #include <EXTI/exti.h>
+#include <PFIC/pfic.h>
+#include <SYS/sys.h>
+#include <SYS/profile.h>
+#include <SYS/trace.h>
+
+// Number of GPIO lines served by EXTI7_0_IRQHandler
+#define EXTI_GPIO_LINES 8
+
+// Callbacks run by the EXTI7_0 dispatcher, indexed by line
+static EXTI_CALLBACK extiCallbacks[EXTI_GPIO_LINES];
+
+void EXTI7_0_IRQHandler(void) PFIC_INTERRUPT_HANDLER HIGHCODE;
 
 /**
  * @brief Configures the Interrupt Mask Register (INTENR).
@@ -49,6 +61,27 @@ void EXTI_EventInit(EXTI_INT_EVEN_EN enable_disable, EXTI_INT_EVEN channel)
     }
 }
 
+/**
+ * @brief Sleeps the core until one of the selected EXTI event lines fires.
+ * * The stale event latch is cleared before the lines are unmasked in EVENR, so an
+ * edge that arrives between unmasking and sleeping is still seen as a wake-up.
+ * The lines are masked again on wake so later edges do not leave a latched event.
+ * * @note The edge triggers (RTENR/FTENR) of the lines must already be configured.
+ * * @param lineMask OR of the MRx_Msk bits of the lines allowed to wake the core.
+ */
+void EXTI_WaitForEvent(uint32_t lineMask)
+{
+    uint32_t evenr = EXTI->EVENR;
+
+    PFIC_ClearEvent();
+
+    EXTI->EVENR = evenr | lineMask;
+
+    PFIC_WaitForEvent();
+
+    EXTI->EVENR = evenr;
+}
+
 /**
  * @brief Configures Rising or Falling edge triggers for a specific EXTI line.
  * *
@@ -100,6 +133,43 @@ void EXTI_SWInterruptTrigger(EXTI_SW_INT channel)
  */
 void EXTI_ClearInterruptFlag(EXTI_CLR_INT_FLAG channel)
 {
-    // Write 1 to clear the pending flag
-    EXTI->INTFR |= (1 << channel);
+    // Write 1 to clear the pending flag. A read-modify-write would also clear
+    // every other pending line, since they read back as 1.
+    EXTI->INTFR = (1 << channel);
+}
+
+/**
+ * @brief Registers the callback the EXTI7_0 interrupt dispatcher runs for a line.
+ * @param channel The EXTI line (0-7).
+ * @param callback The function to run, or 0 to ignore the line.
+ */
+void EXTI_RegisterCallback(EXTI_INT_EVEN channel, EXTI_CALLBACK callback)
+{
+    if (channel < EXTI_GPIO_LINES)
+        extiCallbacks[channel] = callback;
+}
+
+/**
+ * @brief Dispatcher for EXTI lines 0-7, overriding the weak vector.
+ *
+ * Placed in RAM (.highcode) so the flag scan does not stall on flash wait
+ * states at 48 MHz. All pending, enabled lines are acknowledged with a single
+ * write before their callbacks run, lowest line first.
+ */
+PROFILE_IRQ_HANDLER(EXTI7_0_IRQHandler, PFIC_IRQ_EXTI7_0)
+{
+    uint32_t pending = EXTI->INTFR & EXTI->INTENR & ((1 << EXTI_GPIO_LINES) - 1);
+
+    EXTI->INTFR = pending;
+
+    for (uint8_t line = 0; pending; line++, pending >>= 1)
+    {
+        if (!(pending & 0x01))
+            continue;
+
+        TRACE_EVENT(TRACE_ID_EXTI, line);
+
+        if (extiCallbacks[line])
+            extiCallbacks[line]();
+    }
 }
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "GPIO/gpio.h"
+#include "SYS/sys.h"
+#include "SYS/trace.h"
 
 /**
  * @brief Initializes a specific GPIO pin with the desired mode, configuration, and pull-up/pull-down state.
@@ -64,7 +66,7 @@ uint16_t GPIO_ReadPort(GPIO_Typedef *GPIOPort)
  * @param GPIOPin The pin number to read.
  * @return uint8_t: Returns 1 (HIGH) if the pin is high, or 0 (LOW) if the pin is low.
  */
-uint8_t GPIO_ReadPin(GPIO_Typedef *GPIOPort, GPIO_PIN GPIOPin)
+HIGHCODE uint8_t GPIO_ReadPin(GPIO_Typedef *GPIOPort, GPIO_PIN GPIOPin)
 {
     return ((GPIOPort->INDR >> GPIOPin) & 0x01);
 }
@@ -74,38 +76,48 @@ uint8_t GPIO_ReadPin(GPIO_Typedef *GPIOPort, GPIO_PIN GPIOPin)
  *
  * Uses the Port Bit Set/Reset Register (BSHR) for safe, atomic access.
  * Bits 0-15 (BSR) set the pin (HIGH). Bits 16-31 (BRR) clear the pin (LOW).
- *
+ * BSHR is write-only, so it is written directly rather than read-modify-written.
  *
  * @param GPIOPort Pointer to the GPIO Port structure.
  * @param GPIOPin The pin number to write to (0-7).
  * @param Value The desired output value (HIGH or LOW).
  */
-void GPIO_WritePin(GPIO_Typedef *GPIOPort, GPIO_PIN GPIOPin, GPIO_VALUE Value)
+HIGHCODE void GPIO_WritePin(GPIO_Typedef *GPIOPort, GPIO_PIN GPIOPin, GPIO_VALUE Value)
 {
+    TRACE_EVENT(TRACE_ID_GPIO_WRITE, (uint32_t)(uintptr_t)GPIOPort | (GPIOPin << 1) | (Value == HIGH));
+
     if (Value == HIGH)
     {
         // Write '1' to the BSR field (lower 16 bits) to set the pin.
-        GPIOPort->BSHR |= (0x01 << GPIOPin);
+        GPIOPort->BSHR = (0x01 << GPIOPin);
     }
     else
     {
         // Write '1' to the BRR field (upper 16 bits) to clear the pin.
         // Shifting by 0x10 (16) places the bit into the clear region.
-        GPIOPort->BSHR |= (0x01 << (GPIOPin + 0x10));
+        GPIOPort->BSHR = (0x01 << (GPIOPin + 0x10));
     }
 }
 
 /**
  * @brief Inverts the current output state of a single GPIO pin.
  *
- * Performs a safe atomic toggle operation by XORing the corresponding bit in the
- * Port Output Data Register (OUTDR).
+ * Reads OUTDR and writes the opposite state through BSHR. Unlike an XOR on
+ * OUTDR, an interrupt that changes another pin of the same port between the
+ * read and the write cannot be undone.
  *
  * @param GPIOPort Pointer to the GPIO Port structure.
  * @param GPIOPin The pin number to toggle (0-7).
  */
-void GPIO_TogglePin(GPIO_Typedef *GPIOPort, GPIO_PIN GPIOPin)
+HIGHCODE void GPIO_TogglePin(GPIO_Typedef *GPIOPort, GPIO_PIN GPIOPin)
 {
-    // XORing the OUTDR register is the simplest and most common way to toggle a pin
-    GPIOPort->OUTDR ^= (0x01 << GPIOPin);
-}
\ No newline at end of file
+    uint32_t mask = (0x01 << GPIOPin);
+
+    TRACE_EVENT(TRACE_ID_GPIO_TOGGLE, (uint32_t)(uintptr_t)GPIOPort | (GPIOPin << 1));
+
+    // A set pin goes into the BRR field, a cleared pin into the BSR field
+    if (GPIOPort->OUTDR & mask)
+        GPIOPort->BSHR = (mask << 0x10);
+    else
+        GPIOPort->BSHR = mask;
+}
@@ -0,0 +1,179 @@
+#include "PFIC/pfic.h"
+#include "SYS/profile.h"
+
+// Function run by SW_Handler, installed with PFIC_SetSWHook()
+static volatile PFIC_SW_HOOK swHook;
+
+#if PFIC_SW2_ENABLE
+// Function run by the PFIC_IRQ_SW2 handler, installed with PFIC_SetSW2Hook()
+static volatile PFIC_SW_HOOK sw2Hook;
+#endif
+
+/**
+ * @brief Enables the specified interrupt in the PFIC.
+ *
+ * PFIC_IENRx is a write-1-to-set register, so no read-modify-write is needed.
+ *
+ * @param irq The interrupt number to enable.
+ */
+void PFIC_EnableIRQ(PFIC_IRQ irq)
+{
+    if (irq < 32)
+        PFIC->PFIC_IENR1 = (1UL << irq);
+    else
+        PFIC->PFIC_IENR2 = (1UL << (irq - 32));
+}
+
+/**
+ * @brief Disables the specified interrupt in the PFIC.
+ *
+ * PFIC_IRERx is a write-1-to-clear register, so no read-modify-write is needed.
+ *
+ * @param irq The interrupt number to disable.
+ */
+void PFIC_DisableIRQ(PFIC_IRQ irq)
+{
+    if (irq < 32)
+        PFIC->PFIC_IRER1 = (1UL << irq);
+    else
+        PFIC->PFIC_IRER2 = (1UL << (irq - 32));
+}
+
+/**
+ * @brief Sets the pending flag of the specified interrupt.
+ *
+ * The interrupt is taken as soon as it is enabled and its priority allows it.
+ *
+ * @param irq The interrupt number to pend.
+ */
+void PFIC_SetPendingIRQ(PFIC_IRQ irq)
+{
+    if (irq < 32)
+        PFIC->PFIC_IPSR1 = (1UL << irq);
+    else
+        PFIC->PFIC_IPSR2 = (1UL << (irq - 32));
+}
+
+/**
+ * @brief Clears the pending flag of the specified interrupt.
+ * @param irq The interrupt number to un-pend.
+ */
+void PFIC_ClearPendingIRQ(PFIC_IRQ irq)
+{
+    if (irq < 32)
+        PFIC->PFIC_IPRR1 = (1UL << irq);
+    else
+        PFIC->PFIC_IPRR2 = (1UL << (irq - 32));
+}
+
+/**
+ * @brief Reports whether the specified interrupt is currently being serviced.
+ * @param irq The interrupt number to query.
+ * @return uint8_t: 1 if the interrupt is active, 0 otherwise.
+ */
+uint8_t PFIC_GetActive(PFIC_IRQ irq)
+{
+    if (irq < 32)
+        return ((PFIC->PFIC_IACTR1 >> irq) & 0x01);
+    else
+        return ((PFIC->PFIC_IACTR2 >> (irq - 32)) & 0x01);
+}
+
+/**
+ * @brief Sets the priority of the specified interrupt.
+ * @param irq The interrupt number to configure.
+ * @param priority The raw IPRIOR byte (lower value = higher priority).
+ */
+void PFIC_SetPriority(PFIC_IRQ irq, uint8_t priority)
+{
+    PFIC->PFIC_IPRIORX[irq] = priority;
+}
+
+/**
+ * @brief Installs the function that SW_Handler runs.
+ * @param hook The function to run, or 0 to make SW_Handler return immediately.
+ */
+void PFIC_SetSWHook(PFIC_SW_HOOK hook)
+{
+    swHook = hook;
+}
+
+/**
+ * @brief Software interrupt handler, overriding the weak vector in the startup file.
+ *
+ * Entered when PFIC_IRQ_SW is pended with PFIC_SetPendingIRQ().
+ */
+PROFILE_IRQ_HANDLER(SW_Handler, PFIC_IRQ_SW)
+{
+    PFIC_SW_HOOK hook = swHook;
+
+    if (hook)
+        hook();
+}
+
+#if PFIC_SW2_ENABLE
+/**
+ * @brief Installs the function that the PFIC_IRQ_SW2 handler runs.
+ * @param hook The function to run, or 0 to make the handler return immediately.
+ */
+void PFIC_SetSW2Hook(PFIC_SW_HOOK hook)
+{
+    sw2Hook = hook;
+}
+
+/**
+ * @brief Second software interrupt handler, on the PFIC_SW2_IRQ vector.
+ *
+ * Entered when PFIC_IRQ_SW2 is pended with PFIC_SetPendingIRQ().
+ */
+PROFILE_IRQ_HANDLER(PFIC_SW2_HANDLER, PFIC_IRQ_SW2)
+{
+    PFIC_SW_HOOK hook = sw2Hook;
+
+    if (hook)
+        hook();
+}
+#endif /* PFIC_SW2_ENABLE */
+
+/**
+ * @brief Discards any latched wake-up event and arms WFI to behave as WFE.
+ *
+ * The QingKe V2A core has no dedicated WFE instruction. Setting WFITOWFE turns
+ * the next WFI into a wait-for-event, and SETEVENT posts a dummy event so that
+ * the first WFI returns immediately, leaving the event latch empty.
+ */
+void PFIC_ClearEvent(void)
+{
+    PFIC->PFIC_SCTLR |= WFITOWFE_Msk | SETEVENT_Msk;
+    PFIC->PFIC_SCTLR &= ~SETEVENT_Msk;
+
+    // Consumes the dummy event and returns without sleeping
+    __asm volatile("wfi");
+}
+
+/**
+ * @brief Sleeps until a wake-up event arrives, then resumes inline.
+ *
+ * An event unmasked in EXTI_EVENR wakes the core without entering any handler.
+ * WFI is switched back to its normal behaviour afterwards.
+ */
+void PFIC_WaitForEvent(void)
+{
+    __asm volatile("wfi");
+
+    PFIC->PFIC_SCTLR &= ~WFITOWFE_Msk;
+}
+
+/**
+ * @brief Resets the whole system (core and peripherals). Does not return.
+ *
+ * PFIC_CFGR only accepts the reset request together with KEY3. The loop
+ * covers the few cycles until the reset takes effect.
+ */
+void PFIC_SystemReset(void)
+{
+    PFIC->PFIC_CFGR = KEYCODE_KEY3 | RESETSYS_Msk;
+
+    while (1)
+        ;
+}
@@ -1,6 +1,8 @@
 #include "RCC/rcc.h"
 #include "RCC/rcc_bits.h"
 #include "RCC/rcc_reg.h"
+#include "FLASH/flash_reg.h"
+#include "SYS/trace.h"
 #include "stdint.h"
 
 /**
@@ -300,6 +302,41 @@ RCC_SYSCLK_SRC RCC_GetSystemClock(void)
     return clkSrc;
 }
 
+/**
+ * @brief Computes the current AHB clock (HCLK) frequency from the RCC configuration.
+ *
+ * SYSCLK follows the SWS status bits. The PLL doubles its input. HPRE values
+ * 0-7 divide by HPRE + 1, values 8-15 divide by 2, 4, 8, ... 256.
+ *
+ * @return uint32_t: HCLK frequency in Hz.
+ */
+uint32_t RCC_GetHCLKFreq(void)
+{
+    uint32_t cfgr0 = RCC->RCC_CFGR0;
+    uint32_t hpre = (cfgr0 & HPRE_Msk) >> HPRE_Pos;
+    uint32_t sysclk;
+
+    switch ((cfgr0 & SWS_Msk) >> SWS_Pos)
+    {
+    case RCC_SYSCLK_HSE:
+        sysclk = RCC_HSE_VALUE;
+        break;
+
+    case RCC_SYSCLK_PLL:
+        sysclk = ((cfgr0 & PLLSRC_Msk) ? RCC_HSE_VALUE : RCC_HSI_VALUE) * 2;
+        break;
+
+    default:
+        sysclk = RCC_HSI_VALUE;
+        break;
+    }
+
+    if (hpre < 8)
+        return sysclk / (hpre + 1);
+
+    return sysclk >> (hpre - 7);
+}
+
 /**
  * @brief Sets the System Clock (SYSCLK) source.
  *
@@ -336,6 +373,9 @@ RCC_STATUS RCC_SetSystemClock(RCC_SYSCLK_SRC src)
         if (RCC_EnablePLL(PLL_CLKSRC_HSI) != STATUS_SUCCESS)
             return STATUS_BUSY;
 
+        // 48 MHz needs one flash wait state, which must be in place before the switch
+        FLASH->ACTLR = (FLASH->ACTLR & ~LATENCY_Msk) | LATENCY_1WS;
+
         // Select PLL as system clock
         RCC->RCC_CFGR0 = (RCC->RCC_CFGR0 & ~SW_Msk) | (0x02 << SW_Pos);
         break;
@@ -351,6 +391,12 @@ RCC_STATUS RCC_SetSystemClock(RCC_SYSCLK_SRC src)
     if (timeout == 0)
         return STATUS_BUSY;
 
+    // HSI and HSE run at 24 MHz or below, where flash needs no wait state
+    if (src != RCC_SYSCLK_PLL)
+        FLASH->ACTLR = (FLASH->ACTLR & ~LATENCY_Msk) | LATENCY_0WS;
+
+    TRACE_EVENT(TRACE_ID_RCC_SYSCLK, src);
+
     return STATUS_SUCCESS;
 }
 
@@ -0,0 +1,239 @@
+#include <stddef.h>
+#include "SYS/fault.h"
+#include "SYS/sys.h"
+#include "PFIC/pfic.h"
+
+// Marks a record written by FAULT_Capture(), changed with the record layout
+#define FAULT_MAGIC 0x464C5432UL
+
+// Lowest valid stack address (start of SRAM)
+#define FAULT_RAM_BASE 0x20000000UL
+
+// Bytes HPE pushes on trap entry: ra, t0..t2 and a0..a5
+#define FAULT_HPE_FRAME 40
+
+// INTSYSCR (CSR 0x804) bit enabling HPE
+#define FAULT_INTSYSCR_HPE 0x01
+
+#if FAULT_STACK_WORDS > 10
+#error "FAULT_STACK_WORDS must not exceed 10"
+#endif
+
+/**
+ * @brief Registers saved by the handler stubs before sp is moved.
+ *
+ * Kept apart from the record so the previous record can still be validated
+ * before it is overwritten.
+ */
+typedef struct
+{
+    uint32_t sp;
+    uint32_t ra;
+    uint32_t a0;
+    uint32_t stack[FAULT_STACK_WORDS];
+} FAULT_FRAME;
+
+static FAULT_RECORD faultRecord NOINIT;
+static FAULT_FRAME faultFrame __attribute__((used));
+
+extern uint32_t _eusrstack[];
+
+/**
+ * @brief Returns the checksum of a record: the complement of the sum of every word before it.
+ */
+static uint32_t FAULT_Checksum(const FAULT_RECORD *record)
+{
+    const uint32_t *word = (const uint32_t *)record;
+    uint32_t sum = 0;
+
+    for (uint8_t index = 0; index < offsetof(FAULT_RECORD, checksum) / sizeof(uint32_t); index++)
+        sum += word[index];
+
+    return ~sum;
+}
+
+/**
+ * @brief Reports whether the record in .noinit holds a crash.
+ */
+static uint8_t FAULT_IsValid(void)
+{
+    return faultRecord.magic == FAULT_MAGIC && faultRecord.checksum == FAULT_Checksum(&faultRecord);
+}
+
+/**
+ * @brief Fills the record from the trap CSRs and the saved frame, then resets.
+ *
+ * Runs on a fresh stack at _eusrstack, entered from FAULT_Entry.
+ *
+ * @param source FAULT_SOURCE of the trap.
+ */
+__attribute__((used, noreturn)) static void FAULT_Capture(uint32_t source)
+{
+    uint32_t count = FAULT_IsValid() ? faultRecord.count + 1 : 1;
+
+    __asm volatile("csrr %0, mcause" : "=r"(faultRecord.mcause));
+    __asm volatile("csrr %0, mepc" : "=r"(faultRecord.mepc));
+    __asm volatile("csrr %0, mtval" : "=r"(faultRecord.mtval));
+
+    faultRecord.magic = FAULT_MAGIC;
+    faultRecord.count = count;
+    faultRecord.source = source;
+    faultRecord.sp = faultFrame.sp;
+    faultRecord.ra = faultFrame.ra;
+    faultRecord.a0 = faultFrame.a0;
+    for (uint8_t index = 0; index < FAULT_STACK_WORDS; index++)
+        faultRecord.stack[index] = faultFrame.stack[index];
+    faultRecord.checksum = FAULT_Checksum(&faultRecord);
+
+    PFIC_SystemReset();
+}
+
+/**
+ * @brief Saves sp, ra, a0 and the stack window, then continues in FAULT_Capture() on a fresh stack.
+ *
+ * Expects the FAULT_SOURCE in a0 and the faulting a0 in mscratch. When HPE is
+ * enabled it has pushed ra, t0..t2 and a0..a5 below the faulting sp on trap
+ * entry, so its frame is dropped first: the saved sp and the window are those
+ * of the faulting code. HPE only saves, so ra still holds its faulting value.
+ * The window is only copied when sp is word aligned and the whole window lies
+ * in RAM below _eusrstack, so a corrupted sp cannot cause a second fault;
+ * otherwise it is zeroed.
+ */
+__attribute__((naked, used)) static void FAULT_Entry(void)
+{
+    __asm volatile(
+        "csrr a1, 0x804\n"
+        "andi a1, a1, %6\n"
+        "beqz a1, 2f\n"
+        "addi sp, sp, %5\n"
+        "2:\n"
+        "la   t0, faultFrame\n"
+        "sw   sp, %0(t0)\n"
+        "sw   ra, %1(t0)\n"
+        "csrr a1, mscratch\n"
+        "sw   a1, %7(t0)\n"
+        "addi t1, t0, %2\n"
+        "li   t2, %3\n"
+        "andi a1, sp, 3\n"
+        "bnez a1, 3f\n"
+        "li   a1, %4\n"
+        "bltu sp, a1, 3f\n"
+        "la   a1, _eusrstack - %3 * 4\n"
+        "bltu a1, sp, 3f\n"
+        "1:\n"
+        "lw   a1, 0(sp)\n"
+        "sw   a1, 0(t1)\n"
+        "addi sp, sp, 4\n"
+        "addi t1, t1, 4\n"
+        "addi t2, t2, -1\n"
+        "bnez t2, 1b\n"
+        "j    4f\n"
+        "3:\n"
+        "sw   zero, 0(t1)\n"
+        "addi t1, t1, 4\n"
+        "addi t2, t2, -1\n"
+        "bnez t2, 3b\n"
+        "4:\n"
+        "la   sp, _eusrstack\n"
+        "j    FAULT_Capture\n"
+        :
+        : "i"(offsetof(FAULT_FRAME, sp)), "i"(offsetof(FAULT_FRAME, ra)), "i"(offsetof(FAULT_FRAME, stack)),
+          "i"(FAULT_STACK_WORDS), "i"(FAULT_RAM_BASE), "i"(FAULT_HPE_FRAME), "i"(FAULT_INTSYSCR_HPE),
+          "i"(offsetof(FAULT_FRAME, a0)));
+}
+
+/**
+ * @brief HardFault handler, replaces the spin loop of the startup file.
+ *
+ * sp and ra must reach FAULT_Entry untouched, so the stub only parks a0 in
+ * mscratch, loads the source and jumps.
+ */
+__attribute__((naked)) void HardFault_Handler(void)
+{
+    __asm volatile(
+        "csrw mscratch, a0\n"
+        "li a0, %0\n"
+        "j  FAULT_Entry\n"
+        :
+        : "i"(FAULT_SOURCE_HARDFAULT));
+}
+
+/**
+ * @brief NMI handler, replaces the spin loop of the startup file.
+ */
+__attribute__((naked)) void NMI_Handler(void)
+{
+    __asm volatile(
+        "csrw mscratch, a0\n"
+        "li a0, %0\n"
+        "j  FAULT_Entry\n"
+        :
+        : "i"(FAULT_SOURCE_NMI));
+}
+
+/**
+ * @brief Copies the crash record left by a previous fault.
+ * @param record Receives the record when valid.
+ * @return FAULT_STATUS: FAULT_STATUS_VALID or FAULT_STATUS_NONE.
+ */
+FAULT_STATUS FAULT_GetRecord(FAULT_RECORD *record)
+{
+    if (!FAULT_IsValid())
+        return FAULT_STATUS_NONE;
+
+    *record = faultRecord;
+    return FAULT_STATUS_VALID;
+}
+
+/**
+ * @brief Discards the crash record.
+ */
+void FAULT_Clear(void)
+{
+    faultRecord.magic = 0;
+}
+
+/**
+ * @brief Writes one "name=0xVALUE" line.
+ */
+static void FAULT_PutField(FAULT_PUTC putChar, const char *name, uint32_t value)
+{
+    static const char hex[] = "0123456789ABCDEF";
+
+    while (*name)
+        putChar(*name++);
+
+    putChar('=');
+    putChar('0');
+    putChar('x');
+    for (int8_t shift = 28; shift >= 0; shift -= 4)
+        putChar(hex[(value >> shift) & 0x0F]);
+    putChar('\n');
+}
+
+/**
+ * @brief Writes a crash record as text, one "name=0xVALUE" field per line.
+ * @param record The record to dump.
+ * @param putChar Character output function.
+ */
+void FAULT_Dump(const FAULT_RECORD *record, FAULT_PUTC putChar)
+{
+    static const char stackName[] = "stack[0]";
+    char name[sizeof(stackName)];
+
+    FAULT_PutField(putChar, record->source == FAULT_SOURCE_NMI ? "nmi" : "hardfault", record->count);
+    FAULT_PutField(putChar, "mcause", record->mcause);
+    FAULT_PutField(putChar, "mepc", record->mepc);
+    FAULT_PutField(putChar, "mtval", record->mtval);
+    FAULT_PutField(putChar, "sp", record->sp);
+    FAULT_PutField(putChar, "ra", record->ra);
+    FAULT_PutField(putChar, "a0", record->a0);
+
+    for (uint8_t index = 0; index < FAULT_STACK_WORDS; index++)
+    {
+        for (uint8_t pos = 0; pos < sizeof(stackName); pos++)
+            name[pos] = stackName[pos];
+        name[6] = (char)('0' + index);
+        FAULT_PutField(putChar, name, record->stack[index]);
+    }
+}
@@ -0,0 +1,197 @@
+#include <stddef.h>
+#include "SYS/log.h"
+#include "PFIC/pfic.h"
+
+#if (LOG_BUFFER_WORDS & (LOG_BUFFER_WORDS - 1)) != 0 || LOG_BUFFER_WORDS > 32768
+#error "LOG_BUFFER_WORDS must be a power of two no larger than 32768"
+#endif
+
+// Header word layout
+#define LOG_COUNT_Pos 16
+#define LOG_SEQUENCE_Pos 24
+
+// Word ring: head and tail are free-running word counters. head is written by
+// the producers with interrupts disabled, tail only by the consumer.
+static uint32_t logRing[LOG_BUFFER_WORDS];
+static volatile uint16_t logHead;
+static volatile uint16_t logTail;
+
+// Sequence number of the next message, counts dropped messages too
+static uint8_t logSequence;
+
+// Messages dropped because the ring was full
+static uint32_t logDropped;
+
+/**
+ * @brief Appends a header and its arguments as one message.
+ *
+ * The free space is checked first, so a message is either stored whole or
+ * dropped; the sequence number advances in both cases.
+ *
+ * @param id Format ID.
+ * @param args The argument words.
+ * @param count Number of arguments (0..4).
+ */
+static void LOG_Append(uint16_t id, const uint32_t *args, uint8_t count)
+{
+    uint32_t irqState = PFIC_DisableGlobalIRQ();
+    uint16_t head = logHead;
+    uint32_t header = id | ((uint32_t)count << LOG_COUNT_Pos) | ((uint32_t)logSequence++ << LOG_SEQUENCE_Pos);
+
+    if ((uint16_t)(LOG_BUFFER_WORDS - (uint16_t)(head - logTail)) <= count)
+    {
+        logDropped++;
+        PFIC_RestoreGlobalIRQ(irqState);
+        return;
+    }
+
+    logRing[head++ & (LOG_BUFFER_WORDS - 1)] = header;
+    for (uint8_t index = 0; index < count; index++)
+        logRing[head++ & (LOG_BUFFER_WORDS - 1)] = args[index];
+    logHead = head;
+
+    PFIC_RestoreGlobalIRQ(irqState);
+}
+
+/**
+ * @brief Empties the ring and resets the sequence number and drop counter.
+ */
+void LOG_Init(void)
+{
+    uint32_t irqState = PFIC_DisableGlobalIRQ();
+
+    logHead = 0;
+    logTail = 0;
+    logSequence = 0;
+    logDropped = 0;
+
+    PFIC_RestoreGlobalIRQ(irqState);
+}
+
+/**
+ * @brief Appends a message without arguments. Use the LOG_ macros.
+ * @param id Format ID.
+ */
+void LOG_Write0(uint16_t id)
+{
+    LOG_Append(id, NULL, 0);
+}
+
+/**
+ * @brief Appends a message with one argument. Use the LOG_ macros.
+ * @param id Format ID.
+ * @param a0 First argument.
+ */
+void LOG_Write1(uint16_t id, uint32_t a0)
+{
+    LOG_Append(id, &a0, 1);
+}
+
+/**
+ * @brief Appends a message with two arguments. Use the LOG_ macros.
+ * @param id Format ID.
+ * @param a0 First argument.
+ * @param a1 Second argument.
+ */
+void LOG_Write2(uint16_t id, uint32_t a0, uint32_t a1)
+{
+    uint32_t args[2] = {a0, a1};
+
+    LOG_Append(id, args, 2);
+}
+
+/**
+ * @brief Appends a message with three arguments. Use the LOG_ macros.
+ * @param id Format ID.
+ * @param a0 First argument.
+ * @param a1 Second argument.
+ * @param a2 Third argument.
+ */
+void LOG_Write3(uint16_t id, uint32_t a0, uint32_t a1, uint32_t a2)
+{
+    uint32_t args[3] = {a0, a1, a2};
+
+    LOG_Append(id, args, 3);
+}
+
+/**
+ * @brief Appends a message with four arguments. Use the LOG_ macros.
+ * @param id Format ID.
+ * @param a0 First argument.
+ * @param a1 Second argument.
+ * @param a2 Third argument.
+ * @param a3 Fourth argument.
+ */
+void LOG_Write4(uint16_t id, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3)
+{
+    uint32_t args[4] = {a0, a1, a2, a3};
+
+    LOG_Append(id, args, 4);
+}
+
+/**
+ * @brief Returns the oldest contiguous run of pending stream bytes.
+ *
+ * The run ends at the newest word or at the end of the ring, whichever comes
+ * first; a message may span two runs. The bytes stay in place until
+ * LOG_Release(), so they can be handed to DMA directly.
+ *
+ * @param data Receives the start of the run.
+ * @return uint16_t: Number of bytes, 0 if the ring is empty.
+ */
+uint16_t LOG_Peek(const uint8_t **data)
+{
+    uint16_t tail = logTail;
+    uint16_t index = tail & (LOG_BUFFER_WORDS - 1);
+    uint16_t words = (uint16_t)(logHead - tail);
+
+    if (words > LOG_BUFFER_WORDS - index)
+        words = LOG_BUFFER_WORDS - index;
+
+    *data = (const uint8_t *)&logRing[index];
+
+    return (uint16_t)(words << 2);
+}
+
+/**
+ * @brief Frees bytes returned by LOG_Peek() once they are sent.
+ *
+ * May be called from an interrupt handler, e.g. a DMA done callback, as long
+ * as only one context consumes.
+ *
+ * @param length Number of bytes, a multiple of 4.
+ */
+void LOG_Release(uint16_t length)
+{
+    logTail = (uint16_t)(logTail + (length >> 2));
+}
+
+/**
+ * @brief Writes every pending message to a byte output.
+ *
+ * Messages logged while the ring drains are written too.
+ *
+ * @param putByte Byte output function.
+ */
+void LOG_Drain(LOG_PUTC putByte)
+{
+    const uint8_t *data;
+    uint16_t length;
+
+    while ((length = LOG_Peek(&data)) != 0)
+    {
+        for (uint16_t index = 0; index < length; index++)
+            putByte(data[index]);
+
+        LOG_Release(length);
+    }
+}
+
+/**
+ * @brief Returns the number of messages dropped because the ring was full.
+ * @return uint32_t: Dropped messages since LOG_Init().
+ */
+uint32_t LOG_GetDropped(void)
+{
+    return logDropped;
+}
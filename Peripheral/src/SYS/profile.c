@@ -0,0 +1,153 @@
+#include "SYS/profile.h"
+
+#if PROFILE_ENABLE
+
+PROFILE_IRQ_STATS profileIrq[PROFILE_IRQ_COUNT];
+volatile uint32_t profileNested;
+uint32_t profileIdle;
+
+// SysTick counter at the start of the window
+static uint32_t profileWindowStart;
+
+/**
+ * @brief Writes a 32-bit value, least significant byte first.
+ */
+static void PROFILE_PutWord(PROFILE_PUTC putByte, uint32_t value)
+{
+    for (uint8_t shift = 0; shift < 32; shift += 8)
+        putByte((uint8_t)(value >> shift));
+}
+
+#endif /* PROFILE_ENABLE */
+
+/**
+ * @brief Clears every record and starts a new measurement window.
+ */
+void PROFILE_Reset(void)
+{
+#if PROFILE_ENABLE
+    uint32_t irqState = PFIC_DisableGlobalIRQ();
+
+    for (uint8_t index = 0; index < PROFILE_IRQ_COUNT; index++)
+    {
+        profileIrq[index].calls = 0;
+        profileIrq[index].cycles = 0;
+    }
+
+    profileIdle = 0;
+    profileWindowStart = SYSTICK->CNT;
+
+    PFIC_RestoreGlobalIRQ(irqState);
+#endif
+}
+
+/**
+ * @brief Returns the CPU load over the current window.
+ *
+ * Both times are shifted down until idle * 1000 fits in 32 bits, which keeps
+ * the division in 32 bits.
+ *
+ * @return uint16_t: Busy time in per mille (0-1000), 0 when the profiler is disabled.
+ */
+uint16_t PROFILE_GetLoad(void)
+{
+#if PROFILE_ENABLE
+    uint32_t window = SYSTICK->CNT - profileWindowStart;
+    uint32_t idle = profileIdle;
+
+    while (window > 0x3FFFFF)
+    {
+        window >>= 1;
+        idle >>= 1;
+    }
+
+    if (window == 0 || idle >= window)
+        return 0;
+
+    return 1000 - (uint16_t)((idle * 1000) / window);
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Copies the record of one IRQ.
+ * @param irq The IRQ number (PROFILE_FIRST_IRQ..PFIC_IRQ_TIM2).
+ * @param stats Receives the record, all zero when the profiler is disabled.
+ */
+void PROFILE_GetIrqStats(PFIC_IRQ irq, PROFILE_IRQ_STATS *stats)
+{
+    stats->calls = 0;
+    stats->cycles = 0;
+
+#if PROFILE_ENABLE
+    if (irq >= PROFILE_FIRST_IRQ && irq <= PFIC_IRQ_TIM2)
+    {
+        uint32_t irqState = PFIC_DisableGlobalIRQ();
+
+        *stats = profileIrq[irq - PROFILE_FIRST_IRQ];
+
+        PFIC_RestoreGlobalIRQ(irqState);
+    }
+#else
+    (void)irq;
+#endif
+}
+
+/**
+ * @brief Writes the current window as a compact binary record.
+ *
+ * The set of IRQs to write is fixed first, with interrupts disabled, so the
+ * count in the header matches the records that follow. Each record is then
+ * copied under its own short critical section and written with interrupts
+ * enabled, so a slow output function does not stall handlers.
+ *
+ * @param putByte Byte output function.
+ */
+void PROFILE_Dump(PROFILE_PUTC putByte)
+{
+#if PROFILE_ENABLE
+    uint32_t irqState = PFIC_DisableGlobalIRQ();
+    uint32_t window = SYSTICK->CNT - profileWindowStart;
+    uint32_t idle = profileIdle;
+    uint32_t usedMask = 0;
+    uint8_t used = 0;
+
+    for (uint8_t index = 0; index < PROFILE_IRQ_COUNT; index++)
+    {
+        if (profileIrq[index].calls)
+        {
+            usedMask |= (1UL << index);
+            used++;
+        }
+    }
+
+    PFIC_RestoreGlobalIRQ(irqState);
+
+    putByte('P');
+    putByte(used);
+    PROFILE_PutWord(putByte, window);
+    PROFILE_PutWord(putByte, idle);
+
+    for (uint8_t index = 0; index < PROFILE_IRQ_COUNT; index++)
+    {
+        PROFILE_IRQ_STATS stats;
+
+        if (!(usedMask & (1UL << index)))
+            continue;
+
+        irqState = PFIC_DisableGlobalIRQ();
+        stats = profileIrq[index];
+        PFIC_RestoreGlobalIRQ(irqState);
+
+        putByte(index + PROFILE_FIRST_IRQ);
+        PROFILE_PutWord(putByte, stats.calls);
+        PROFILE_PutWord(putByte, stats.cycles);
+    }
+#else
+    putByte('P');
+    putByte(0);
+    for (uint8_t index = 0; index < 8; index++)
+        putByte(0);
+#endif
+}
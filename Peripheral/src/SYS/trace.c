@@ -0,0 +1,150 @@
+#include "SYS/trace.h"
+#include "SYS/sys.h"
+#include "PFIC/pfic.h"
+#include "RCC/rcc.h"
+#include "SYSTICK/systick_reg.h"
+
+#if (TRACE_DEPTH & (TRACE_DEPTH - 1)) != 0
+#error "TRACE_DEPTH must be a power of two"
+#endif
+
+// Marks a ring that was set up by TRACE_Init() or TRACE_Clear()
+#define TRACE_MAGIC 0x54524331UL
+
+// Largest delta that fits a record
+#define TRACE_DELTA_MAX 0xFFFF
+
+/**
+ * @brief Ring state and records, kept across resets.
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t head;   /**< Records written since the last clear (free-running). */
+    uint32_t last;   /**< SysTick count the last delta was measured up to. */
+    uint32_t paused; /**< Nonzero while TRACE_Dump() runs. */
+    TRACE_RECORD ring[TRACE_DEPTH];
+} TRACE_BUFFER;
+
+static TRACE_BUFFER traceBuffer NOINIT;
+
+/**
+ * @brief Writes a value least significant byte first.
+ */
+static void TRACE_PutBytes(TRACE_PUTC putByte, uint32_t value, uint8_t count)
+{
+    while (count--)
+    {
+        putByte((uint8_t)value);
+        value >>= 8;
+    }
+}
+
+/**
+ * @brief Validates the ring left in .noinit, or clears it if it is not valid.
+ *
+ * The content is undefined after power-up; the magic value tells a ring that
+ * survived a reset from random RAM.
+ */
+void TRACE_Init(void)
+{
+    if (traceBuffer.magic != TRACE_MAGIC)
+    {
+        TRACE_Clear();
+        return;
+    }
+
+    // Restart the delta chain from now, the counter was reset with the core
+    traceBuffer.last = SYSTICK->CNT;
+    traceBuffer.paused = 0;
+}
+
+/**
+ * @brief Discards every record.
+ */
+void TRACE_Clear(void)
+{
+    uint32_t irqState = PFIC_DisableGlobalIRQ();
+
+    traceBuffer.head = 0;
+    traceBuffer.last = SYSTICK->CNT;
+    traceBuffer.paused = 0;
+    traceBuffer.magic = TRACE_MAGIC;
+
+    PFIC_RestoreGlobalIRQ(irqState);
+}
+
+/**
+ * @brief Appends a record.
+ *
+ * The reference time advances by the stored delta, not to now, so the
+ * truncated low bits carry over to the next record instead of drifting.
+ *
+ * @param id Event ID.
+ * @param arg Event argument.
+ */
+void TRACE_Event(uint16_t id, uint32_t arg)
+{
+    uint32_t irqState = PFIC_DisableGlobalIRQ();
+    uint32_t now = SYSTICK->CNT;
+    uint32_t delta = (now - traceBuffer.last) >> TRACE_TIME_SHIFT;
+    TRACE_RECORD *record;
+
+    if (traceBuffer.paused)
+    {
+        PFIC_RestoreGlobalIRQ(irqState);
+        return;
+    }
+
+    if (delta > TRACE_DELTA_MAX)
+    {
+        record = &traceBuffer.ring[traceBuffer.head++ & (TRACE_DEPTH - 1)];
+        record->id = TRACE_ID_SYNC;
+        record->delta = 0;
+        record->arg = now - traceBuffer.last;
+        traceBuffer.last = now;
+        delta = 0;
+    }
+
+    record = &traceBuffer.ring[traceBuffer.head++ & (TRACE_DEPTH - 1)];
+    record->id = id;
+    record->delta = (uint16_t)delta;
+    record->arg = arg;
+    traceBuffer.last += delta << TRACE_TIME_SHIFT;
+
+    PFIC_RestoreGlobalIRQ(irqState);
+}
+
+/**
+ * @brief Writes the ring, oldest record first, as a binary dump.
+ * @param putByte Byte output function.
+ */
+void TRACE_Dump(TRACE_PUTC putByte)
+{
+    uint32_t count;
+    uint32_t index;
+
+    traceBuffer.paused = 1;
+
+    count = traceBuffer.head;
+    if (count > TRACE_DEPTH)
+        count = TRACE_DEPTH;
+
+    putByte('T');
+    putByte(1);
+    putByte(TRACE_TIME_SHIFT);
+    putByte(0);
+    TRACE_PutBytes(putByte, RCC_GetHCLKFreq(), 4);
+    TRACE_PutBytes(putByte, count, 2);
+
+    for (index = traceBuffer.head - count; index != traceBuffer.head; index++)
+    {
+        const TRACE_RECORD *record = &traceBuffer.ring[index & (TRACE_DEPTH - 1)];
+
+        TRACE_PutBytes(putByte, record->id, 2);
+        TRACE_PutBytes(putByte, record->delta, 2);
+        TRACE_PutBytes(putByte, record->arg, 4);
+    }
+
+    traceBuffer.paused = 0;
+}
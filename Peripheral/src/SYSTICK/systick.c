@@ -0,0 +1,313 @@
+#include "SYSTICK/systick.h"
+#include "PFIC/pfic.h"
+#include "RCC/rcc.h"
+#include "SYS/profile.h"
+
+// Half counter periods elapsed (cycles >> 31), updated by SysTick_Handler
+static volatile uint32_t sysTickEpoch;
+
+// HCLK frequency in Hz and in cycles per millisecond
+static uint32_t sysTickClock;
+static uint32_t sysTickCyclesPerMilli;
+
+// Cycle count and times at the last clock change
+static uint64_t sysTickBaseCycles;
+static uint64_t sysTickBaseMicros;
+static uint64_t sysTickBaseMillis;
+
+// One-shot alarm: absolute cycle count and the function run when it is reached
+static uint64_t sysTickAlarm;
+static volatile SYSTICK_ALARM_FN sysTickAlarmFn;
+
+/**
+ * @brief Divides a 64-bit value by a 32-bit one without pulling in __udivdi3.
+ *
+ * The high word is divided with the 32-bit routine, then the remainder and the
+ * low word are shifted through a 32-step restoring division.
+ */
+static uint64_t SYSTICK_Divide(uint64_t dividend, uint32_t divisor)
+{
+    uint32_t high = (uint32_t)(dividend >> 32);
+    uint32_t low = (uint32_t)dividend;
+    uint32_t quotHigh = high / divisor;
+    uint32_t rem = high % divisor;
+    uint32_t quotLow = 0;
+
+    for (uint8_t bit = 0; bit < 32; bit++)
+    {
+        uint32_t carry = rem >> 31;
+
+        rem = (rem << 1) | (low >> 31);
+        low <<= 1;
+        quotLow <<= 1;
+
+        if (carry || rem >= divisor)
+        {
+            rem -= divisor;
+            quotLow |= 1;
+        }
+    }
+
+    return ((uint64_t)quotHigh << 32) | quotLow;
+}
+
+/**
+ * @brief Converts cycles since the last clock change to microseconds.
+ */
+static uint64_t SYSTICK_ToMicros(uint64_t cycles)
+{
+    // cycles * 1000 as shifts, the core has no multiplier
+    return sysTickBaseMicros +
+           SYSTICK_Divide((cycles << 10) - (cycles << 4) - (cycles << 3), sysTickCyclesPerMilli);
+}
+
+/**
+ * @brief Converts cycles since the last clock change to milliseconds.
+ */
+static uint64_t SYSTICK_ToMillis(uint64_t cycles)
+{
+    return sysTickBaseMillis + SYSTICK_Divide(cycles, sysTickCyclesPerMilli);
+}
+
+/**
+ * @brief Points the compare register at the nearer of the next half period
+ * boundary and the alarm.
+ *
+ * Called from SysTick_Handler or with interrupts disabled. The compare only
+ * matches on equality, so if the counter already passed the new value the
+ * handler is pended by software instead.
+ */
+static void SYSTICK_Reprogram(void)
+{
+    uint64_t next = ((SYSTICK_GetCycles() >> 31) + 1) << 31;
+
+    if (sysTickAlarmFn && sysTickAlarm < next)
+        next = sysTickAlarm;
+
+    SYSTICK->CMP = (uint32_t)next;
+
+    if (SYSTICK_GetCycles() >= next)
+        PFIC_SetPendingIRQ(PFIC_IRQ_SYSTICK);
+}
+
+/**
+ * @brief Starts the counter from 0 at HCLK and enables the wrap compare interrupt.
+ *
+ * The counter runs upward without auto-reload, so it wraps at 2^32. The
+ * first compare event is set half way, at 0x80000000.
+ */
+void SYSTICK_Init(void)
+{
+    SYSTICK->CTLR = 0;
+    SYSTICK->CNT = 0;
+    SYSTICK->CMP = 0x80000000UL;
+    SYSTICK->SR = 0;
+
+    sysTickEpoch = 0;
+    sysTickBaseCycles = 0;
+    sysTickBaseMicros = 0;
+    sysTickBaseMillis = 0;
+    sysTickAlarmFn = 0;
+    sysTickClock = RCC_GetHCLKFreq();
+    sysTickCyclesPerMilli = sysTickClock / 1000;
+
+    SYSTICK->CTLR = STIE_Msk | STCLK_Msk | STE_Msk;
+    PFIC_EnableIRQ(PFIC_IRQ_SYSTICK);
+}
+
+/**
+ * @brief Reloads the HCLK frequency after a clock change.
+ *
+ * The current time is frozen into the base values, so micros and millis do
+ * not jump. The cycle count keeps counting at whatever rate HCLK has.
+ */
+void SYSTICK_UpdateClock(void)
+{
+    uint32_t irqState = PFIC_DisableGlobalIRQ();
+    uint64_t now = SYSTICK_GetCycles();
+
+    sysTickBaseMicros = SYSTICK_ToMicros(now - sysTickBaseCycles);
+    sysTickBaseMillis = SYSTICK_ToMillis(now - sysTickBaseCycles);
+    sysTickBaseCycles = now;
+    sysTickClock = RCC_GetHCLKFreq();
+    sysTickCyclesPerMilli = sysTickClock / 1000;
+
+    PFIC_RestoreGlobalIRQ(irqState);
+}
+
+/**
+ * @brief Returns the HCLK frequency the driver currently works with.
+ * @return uint32_t: Frequency in Hz.
+ */
+uint32_t SYSTICK_GetClock(void)
+{
+    return sysTickClock;
+}
+
+/**
+ * @brief Returns the number of HCLK cycles per millisecond at the current clock.
+ * @return uint32_t: HCLK / 1000.
+ */
+uint32_t SYSTICK_GetCyclesPerMilli(void)
+{
+    return sysTickCyclesPerMilli;
+}
+
+/**
+ * @brief Returns the number of HCLK cycles since SYSTICK_Init().
+ *
+ * The epoch is re-read until it is stable around the counter read. If the
+ * top counter bit disagrees with the epoch parity, a compare event is pending
+ * and not yet served, and the epoch is advanced locally.
+ *
+ * @return uint64_t: Monotonic cycle count.
+ */
+uint64_t SYSTICK_GetCycles(void)
+{
+    uint32_t epoch;
+    uint32_t count;
+
+    do
+    {
+        epoch = sysTickEpoch;
+        count = SYSTICK->CNT;
+    } while (epoch != sysTickEpoch);
+
+    if ((count >> 31) != (epoch & 0x01))
+        epoch++;
+
+    return ((uint64_t)(epoch >> 1) << 32) | count;
+}
+
+/**
+ * @brief Returns the number of microseconds since SYSTICK_Init().
+ * @return uint64_t: Monotonic time in us.
+ */
+uint64_t SYSTICK_GetMicros(void)
+{
+    return SYSTICK_ToMicros(SYSTICK_GetCycles() - sysTickBaseCycles);
+}
+
+/**
+ * @brief Returns the number of milliseconds since SYSTICK_Init().
+ * @return uint64_t: Monotonic time in ms.
+ */
+uint64_t SYSTICK_GetMillis(void)
+{
+    return SYSTICK_ToMillis(SYSTICK_GetCycles() - sysTickBaseCycles);
+}
+
+/**
+ * @brief Busy-waits for a number of HCLK cycles.
+ *
+ * The wait is measured from the first counter read, so it is exact to the
+ * polling loop period (a few cycles) plus the call overhead.
+ *
+ * @param cycles Cycles to wait (up to 2^32 - 1).
+ */
+void SYSTICK_DelayCycles(uint32_t cycles)
+{
+    uint32_t start = SYSTICK->CNT;
+
+    while ((SYSTICK->CNT - start) < cycles)
+        ;
+}
+
+/**
+ * @brief Busy-waits for a number of microseconds.
+ *
+ * The start is stamped before the conversion, so its software multiply and
+ * divide are part of the wait rather than added to it. Whole milliseconds are
+ * waited in steps from the same reference, so there is no overflow limit.
+ *
+ * @param us Microseconds to wait.
+ */
+void SYSTICK_DelayMicros(uint32_t us)
+{
+    uint32_t start = SYSTICK->CNT;
+    uint32_t ms = us / 1000;
+    uint32_t cycles = ((us - (ms * 1000)) * sysTickCyclesPerMilli) / 1000;
+
+    while (ms--)
+    {
+        while ((SYSTICK->CNT - start) < sysTickCyclesPerMilli)
+            ;
+        start += sysTickCyclesPerMilli;
+    }
+
+    while ((SYSTICK->CNT - start) < cycles)
+        ;
+}
+
+/**
+ * @brief Busy-waits for a number of milliseconds.
+ * @param ms Milliseconds to wait.
+ */
+void SYSTICK_DelayMillis(uint32_t ms)
+{
+    uint32_t start = SYSTICK->CNT;
+
+    while (ms--)
+    {
+        while ((SYSTICK->CNT - start) < sysTickCyclesPerMilli)
+            ;
+        start += sysTickCyclesPerMilli;
+    }
+}
+
+/**
+ * @brief Arms the one-shot alarm, replacing any previous one.
+ *
+ * The function runs from SysTick_Handler once SYSTICK_GetCycles() reaches the
+ * given count. A count in the past fires immediately.
+ *
+ * @param cycles Absolute cycle count, as returned by SYSTICK_GetCycles().
+ * @param fn The function to run.
+ */
+void SYSTICK_SetAlarm(uint64_t cycles, SYSTICK_ALARM_FN fn)
+{
+    uint32_t irqState = PFIC_DisableGlobalIRQ();
+
+    sysTickAlarm = cycles;
+    sysTickAlarmFn = fn;
+    SYSTICK_Reprogram();
+
+    PFIC_RestoreGlobalIRQ(irqState);
+}
+
+/**
+ * @brief Disarms the alarm.
+ *
+ * The compare register is left as is; the next event just reprograms it.
+ */
+void SYSTICK_CancelAlarm(void)
+{
+    sysTickAlarmFn = 0;
+}
+
+/**
+ * @brief SysTick compare handler, overriding the weak vector.
+ *
+ * The epoch is recomputed from the corrected cycle count, so a pended or late
+ * entry is harmless. A due alarm is disarmed before its function runs, which
+ * may arm it again.
+ */
+PROFILE_IRQ_HANDLER(SysTick_Handler, PFIC_IRQ_SYSTICK)
+{
+    SYSTICK_ALARM_FN fn;
+    uint64_t now;
+
+    SYSTICK->SR = 0;
+
+    now = SYSTICK_GetCycles();
+    sysTickEpoch = (uint32_t)(now >> 31);
+
+    fn = sysTickAlarmFn;
+    if (fn && now >= sysTickAlarm)
+    {
+        sysTickAlarmFn = 0;
+        fn();
+    }
+
+    SYSTICK_Reprogram();
+}
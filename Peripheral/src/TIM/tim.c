@@ -0,0 +1,543 @@
+#include <stddef.h>
+#include "TIM/tim.h"
+#include "GPIO/gpio.h"
+#include "PFIC/pfic.h"
+#include "RCC/rcc.h"
+#include "SYS/profile.h"
+
+// Interrupt flags that have an enable bit in DMAINTENR at the same position
+#define TIM_IRQ_FLAGS 0xFF
+
+// Output compare mode field values
+#define TIM_OCM_FORCE_INACTIVE 0x04
+#define TIM_OCM_FORCE_ACTIVE 0x05
+#define TIM_OCM_PWM1 0x06
+
+// Flags served by each TIM1 vector
+#define TIM_BRK_FLAGS TIM_BIF_Msk
+#define TIM_UP_FLAGS TIM_UIF_Msk
+#define TIM_TRG_COM_FLAGS (TIM_TIF_Msk | TIM_COMIF_Msk)
+#define TIM_CC_FLAGS (TIM_CC1IF_Msk | TIM_CC2IF_Msk | TIM_CC3IF_Msk | TIM_CC4IF_Msk)
+
+// Dead-time generator ranges (DTG[7:5]), in HCLK cycles
+#define TIM_DTG_LINEAR_MAX 127
+#define TIM_DTG_STEP2_MAX 254
+#define TIM_DTG_STEP8_MAX 504
+#define TIM_DTG_STEP16_MAX 1008
+
+// Pin table entries: GPIO port index (0 = A, 2 = C, 3 = D) in the high nibble, pin in the low nibble
+#define TIM_PIN(port, pin) (((port) << 4) | (pin))
+#define TIM_PIN_PORT(entry) ((entry) >> 4)
+#define TIM_PIN_NUMBER(entry) ((entry) & 0x0F)
+#define TIM_PORT_A 0
+#define TIM_PORT_C 2
+#define TIM_PORT_D 3
+
+// Index of the CHxN and BKIN pins in the TIM1 pin table, after CH1..CH4
+#define TIM_PIN_CHN 4
+#define TIM_PIN_BKIN 7
+
+// TIM2 channel pins for each AFIO_PCFR1 TIM2_RM value
+static const uint8_t timTim2Pins[4][4] = {
+    {TIM_PIN(TIM_PORT_D, 4), TIM_PIN(TIM_PORT_D, 3), TIM_PIN(TIM_PORT_C, 0), TIM_PIN(TIM_PORT_D, 7)},
+    {TIM_PIN(TIM_PORT_C, 5), TIM_PIN(TIM_PORT_C, 2), TIM_PIN(TIM_PORT_D, 2), TIM_PIN(TIM_PORT_C, 1)},
+    {TIM_PIN(TIM_PORT_C, 1), TIM_PIN(TIM_PORT_D, 3), TIM_PIN(TIM_PORT_C, 0), TIM_PIN(TIM_PORT_D, 7)},
+    {TIM_PIN(TIM_PORT_C, 1), TIM_PIN(TIM_PORT_C, 7), TIM_PIN(TIM_PORT_D, 6), TIM_PIN(TIM_PORT_D, 5)}};
+
+// TIM1 CH1..CH4, CH1N..CH3N and BKIN pins for each AFIO_PCFR1 TIM1_RM value
+static const uint8_t timTim1Pins[4][8] = {
+    {TIM_PIN(TIM_PORT_D, 2), TIM_PIN(TIM_PORT_A, 1), TIM_PIN(TIM_PORT_C, 3), TIM_PIN(TIM_PORT_C, 4),
+     TIM_PIN(TIM_PORT_D, 0), TIM_PIN(TIM_PORT_A, 2), TIM_PIN(TIM_PORT_D, 1), TIM_PIN(TIM_PORT_C, 2)},
+    {TIM_PIN(TIM_PORT_C, 6), TIM_PIN(TIM_PORT_C, 7), TIM_PIN(TIM_PORT_C, 0), TIM_PIN(TIM_PORT_D, 3),
+     TIM_PIN(TIM_PORT_C, 3), TIM_PIN(TIM_PORT_C, 4), TIM_PIN(TIM_PORT_D, 1), TIM_PIN(TIM_PORT_C, 1)},
+    {TIM_PIN(TIM_PORT_D, 2), TIM_PIN(TIM_PORT_A, 1), TIM_PIN(TIM_PORT_C, 3), TIM_PIN(TIM_PORT_C, 4),
+     TIM_PIN(TIM_PORT_D, 0), TIM_PIN(TIM_PORT_A, 2), TIM_PIN(TIM_PORT_D, 1), TIM_PIN(TIM_PORT_C, 2)},
+    {TIM_PIN(TIM_PORT_C, 4), TIM_PIN(TIM_PORT_C, 7), TIM_PIN(TIM_PORT_C, 5), TIM_PIN(TIM_PORT_D, 4),
+     TIM_PIN(TIM_PORT_C, 3), TIM_PIN(TIM_PORT_D, 2), TIM_PIN(TIM_PORT_C, 6), TIM_PIN(TIM_PORT_C, 1)}};
+
+// Handlers run by the timer vectors, installed with TIM_SetHandler()
+static volatile TIM_HANDLER timTim1Handler;
+static volatile TIM_HANDLER timTim2Handler;
+
+void TIM1_BRK_IRQHandler(void) PFIC_INTERRUPT_HANDLER;
+void TIM1_UP_IRQHandler(void) PFIC_INTERRUPT_HANDLER;
+void TIM1_TRG_COM_IRQHandler(void) PFIC_INTERRUPT_HANDLER;
+void TIM1_CC_IRQHandler(void) PFIC_INTERRUPT_HANDLER;
+void TIM2_IRQHandler(void) PFIC_INTERRUPT_HANDLER;
+
+/**
+ * @brief Clears the pending, enabled flags of one vector and runs the handler.
+ *
+ * The flags are cleared with one store before the handler runs, so an event
+ * that happens during the handler raises the interrupt again instead of
+ * being lost.
+ *
+ * @param timer The timer.
+ * @param handler The installed handler, may be NULL.
+ * @param mask The flags the vector serves.
+ */
+static inline __attribute__((always_inline)) void TIM_Dispatch(TIM_Typedef *timer, TIM_HANDLER handler, uint32_t mask)
+{
+    uint32_t flags = timer->INTFR & timer->DMAINTENR & mask;
+
+    timer->INTFR = ~flags;
+
+    if (handler != NULL)
+        handler(flags);
+}
+
+/**
+ * @brief Sets up one pin from a pin table entry.
+ * @param entry TIM_PIN() value.
+ * @param mode Pin mode.
+ * @param config Pin configuration.
+ * @param pull Pull resistor (inputs only).
+ */
+static void TIM_PinInit(uint8_t entry, GPIO_MODE mode, GPIO_INPUT_OUTPUT_CONFIG config, GPIO_PULL_CONFIG pull)
+{
+    static GPIO_Typedef *const ports[] = {GPIOA, 0, GPIOC, GPIOD};
+    static const RCC_PERIPHERAL clocks[] = {IOPA, IOPA, IOPC, IOPD};
+
+    RCC_PeripheralEnable(clocks[TIM_PIN_PORT(entry)]);
+    GPIO_Init(ports[TIM_PIN_PORT(entry)], (GPIO_PIN)TIM_PIN_NUMBER(entry), mode, config, pull);
+}
+
+/**
+ * @brief Enables the timer clock and sets up a stopped counter.
+ *
+ * The prescaler is only loaded at an update event, so one is generated here
+ * with its flag cleared afterwards; the counter starts from 0 on
+ * TIM_Start(). Interrupt and DMA enables are cleared.
+ *
+ * @param timer TIMER1 or TIMER2.
+ * @param prescaler Counter clock = HCLK / (prescaler + 1).
+ * @param reload Auto-reload value: the period is reload + 1 ticks.
+ * @param mode TIM_MODE options combined with '|'.
+ */
+void TIM_TimeBaseInit(TIM_Typedef *timer, uint16_t prescaler, uint16_t reload, uint32_t mode)
+{
+    RCC_PeripheralEnable(timer == TIMER1 ? TIM1 : TIM2);
+
+    timer->CTLR1 = 0;
+    timer->DMAINTENR = 0;
+    timer->PSC = prescaler;
+    timer->ATRLR = reload;
+    timer->CTLR1 = mode & ~TIM_CEN_Msk;
+
+    TIM_GenerateUpdate(timer);
+    timer->CNT = 0;
+    timer->INTFR = 0;
+}
+
+/**
+ * @brief Returns the prescaler value closest to a counter tick rate at the current HCLK.
+ * @param tickRate Counter ticks per second.
+ * @return uint16_t: Prescaler value, clamped to 0..65535.
+ */
+uint16_t TIM_GetPrescaler(uint32_t tickRate)
+{
+    uint32_t divisor;
+
+    if (tickRate == 0)
+        return 0xFFFF;
+
+    divisor = (RCC_GetHCLKFreq() + (tickRate >> 1)) / tickRate;
+    if (divisor == 0)
+        return 0;
+    if (divisor > 0x10000)
+        return 0xFFFF;
+
+    return (uint16_t)(divisor - 1);
+}
+
+/**
+ * @brief Returns the counter tick rate a prescaler value gives at the current HCLK.
+ * @param prescaler Prescaler value.
+ * @return uint32_t: Counter ticks per second.
+ */
+uint32_t TIM_GetTickRate(uint16_t prescaler)
+{
+    return RCC_GetHCLKFreq() / ((uint32_t)prescaler + 1);
+}
+
+/**
+ * @brief Installs the function the timer's interrupt vectors dispatch to.
+ *
+ * All four TIM1 vectors run the same handler, each with its own flags.
+ *
+ * @param timer TIMER1 or TIMER2.
+ * @param handler The handler, or NULL to ignore the interrupts.
+ */
+void TIM_SetHandler(TIM_Typedef *timer, TIM_HANDLER handler)
+{
+    if (timer == TIMER1)
+        timTim1Handler = handler;
+    else
+        timTim2Handler = handler;
+}
+
+/**
+ * @brief Puts a channel in PWM mode 1 and enables its output.
+ *
+ * The output is disabled while the mode changes, so no glitch from the old
+ * mode reaches the pin. On TIM1 the main output enable (MOE) is set as
+ * well, without it no TIM1 channel drives its pin.
+ *
+ * @param timer TIMER1 or TIMER2.
+ * @param channel The channel.
+ * @param compare Initial compare value: the output is active for compare ticks of each period.
+ * @param options TIM_PWM options combined with '|'.
+ */
+void TIM_PwmInit(TIM_Typedef *timer, TIM_CHANNEL channel, uint16_t compare, uint32_t options)
+{
+    volatile uint32_t *chctlr = channel < TIM_CHANNEL_3 ? &timer->CHCTLR1 : &timer->CHCTLR2;
+    uint32_t shift = (channel & 0x01) * TIM_CHCTLR_STRIDE;
+    uint32_t ccerShift = channel * TIM_CCER_STRIDE;
+    uint32_t mode = TIM_OCM_PWM1 << TIM_OCM_Pos;
+    uint32_t enable = TIM_CCE_Msk;
+
+    if (options & TIM_PWM_PRELOAD)
+        mode |= TIM_OCPE_Msk;
+    if (options & TIM_PWM_ACTIVE_LOW)
+        enable |= TIM_CCP_Msk;
+    if (options & TIM_PWM_COMPLEMENTARY)
+        enable |= TIM_CCNE_Msk;
+    if (options & TIM_PWM_COMPLEMENTARY_ACTIVE_LOW)
+        enable |= TIM_CCNP_Msk;
+
+    timer->CCER &= ~((TIM_CCE_Msk | TIM_CCP_Msk | TIM_CCNE_Msk | TIM_CCNP_Msk) << ccerShift);
+    *chctlr = (*chctlr & ~((TIM_CCS_Msk | TIM_OCFE_Msk | TIM_OCPE_Msk | TIM_OCM_Msk | TIM_OCCE_Msk) << shift)) |
+              (mode << shift);
+    timer->CHCVR[channel] = compare;
+    timer->CCER |= enable << ccerShift;
+
+    if (timer == TIMER1)
+        timer->BDTR |= TIM_MOE_Msk;
+}
+
+/**
+ * @brief Sets up a channel's pin as an alternate function push-pull output.
+ * @param timer TIMER1 or TIMER2.
+ * @param channel The channel.
+ * @param remap The timer's remap selected with AFIO_PinRemap() (0..3).
+ */
+void TIM_PwmPinInit(TIM_Typedef *timer, TIM_CHANNEL channel, uint8_t remap)
+{
+    if (remap > 3)
+        return;
+
+    TIM_PinInit(timer == TIMER1 ? timTim1Pins[remap][channel] : timTim2Pins[remap][channel],
+                MODE_OUTPUT_MODE_SPEED_50MHZ, OUTPUT_MODE_MULTIPLEXED_FUNCTION_PUSH_PULL, PIN_DEFAULT);
+}
+
+/**
+ * @brief Sets up a channel's complementary (CHxN) pin as an alternate function push-pull output.
+ * @param timer TIMER1.
+ * @param channel TIM_CHANNEL_1 to TIM_CHANNEL_3.
+ * @param remap The TIM1 remap selected with AFIO_PinRemap() (0..3).
+ */
+void TIM_ComplementaryPinInit(TIM_Typedef *timer, TIM_CHANNEL channel, uint8_t remap)
+{
+    if (timer != TIMER1 || channel > TIM_CHANNEL_3 || remap > 3)
+        return;
+
+    TIM_PinInit(timTim1Pins[remap][TIM_PIN_CHN + channel], MODE_OUTPUT_MODE_SPEED_50MHZ,
+                OUTPUT_MODE_MULTIPLEXED_FUNCTION_PUSH_PULL, PIN_DEFAULT);
+}
+
+/**
+ * @brief Sets up the break input (BKIN) pin as a pulled input.
+ *
+ * The internal pull resistor holds the input at its inactive level while
+ * nothing drives it. For an input that also trips on a broken wire, fit an
+ * external resistor to the active level instead.
+ *
+ * @param timer TIMER1.
+ * @param remap The TIM1 remap selected with AFIO_PinRemap() (0..3).
+ * @param options TIM_BREAK options; the pull resistor holds the input inactive.
+ */
+void TIM_BreakPinInit(TIM_Typedef *timer, uint8_t remap, uint32_t options)
+{
+    if (timer != TIMER1 || remap > 3)
+        return;
+
+    TIM_PinInit(timTim1Pins[remap][TIM_PIN_BKIN], MODE_INPUT_MODE, INPUT_MODE_PULL_UP_PULL_DOWN,
+                (options & TIM_BREAK_ACTIVE_HIGH) ? PIN_PULL_DOWN : PIN_PULL_UP);
+}
+
+/**
+ * @brief Sets the dead time between complementary outputs.
+ *
+ * The dead-time clock is HCLK (CKD = 0). The requested time is rounded up
+ * to the next value the generator can make: 1-cycle steps up to 127
+ * cycles, then steps of 2, 8 and 16 cycles up to 1008 cycles (21 us at
+ * 48 MHz), where it is clamped.
+ *
+ * @param timer TIMER1.
+ * @param nanoseconds Minimum dead time.
+ * @return uint32_t: The dead time set, in ns.
+ */
+uint32_t TIM_SetDeadTime(TIM_Typedef *timer, uint32_t nanoseconds)
+{
+    uint32_t khz = RCC_GetHCLKFreq() / 1000;
+    uint32_t cycles;
+    uint32_t dtg;
+
+    // Keeps nanoseconds * khz within 32 bits up to 65 MHz
+    if (nanoseconds > 65535)
+        nanoseconds = 65535;
+
+    cycles = (nanoseconds * khz + 999999) / 1000000;
+
+    if (cycles <= TIM_DTG_LINEAR_MAX)
+    {
+        dtg = cycles;
+    }
+    else if (cycles <= TIM_DTG_STEP2_MAX)
+    {
+        dtg = 0x80 | ((cycles + 1) / 2 - 64);
+        cycles = (64 + (dtg & 0x3F)) * 2;
+    }
+    else if (cycles <= TIM_DTG_STEP8_MAX)
+    {
+        dtg = 0xC0 | ((cycles + 7) / 8 - 32);
+        cycles = (32 + (dtg & 0x1F)) * 8;
+    }
+    else
+    {
+        if (cycles > TIM_DTG_STEP16_MAX)
+            cycles = TIM_DTG_STEP16_MAX;
+        dtg = 0xE0 | ((cycles + 15) / 16 - 32);
+        cycles = (32 + (dtg & 0x1F)) * 16;
+    }
+
+    timer->BDTR = (timer->BDTR & ~TIM_DTG_Msk) | (dtg << TIM_DTG_Pos);
+
+    return (cycles * 1000000 + (khz >> 1)) / khz;
+}
+
+/**
+ * @brief Arms the break input.
+ *
+ * Off-state selection is set for both run and idle (OSSR, OSSI): while MOE
+ * is clear, and on channels whose output is disabled, the pins are driven
+ * to their inactive level instead of being released, so a gate driver
+ * never sees a floating input. The idle levels (CTLR2 OISx) are left at
+ * their reset value, all outputs low.
+ *
+ * @param timer TIMER1.
+ * @param options TIM_BREAK options combined with '|'.
+ */
+void TIM_BreakInit(TIM_Typedef *timer, uint32_t options)
+{
+    timer->BDTR = (timer->BDTR & (TIM_DTG_Msk | TIM_MOE_Msk)) | TIM_BKE_Msk | TIM_OSSR_Msk | TIM_OSSI_Msk |
+                  (options & (TIM_BKP_Msk | TIM_AOE_Msk));
+    TIM_ClearFlags(timer, TIM_FLAG_BREAK);
+}
+
+/**
+ * @brief Makes output modes and enables preloaded, applied at the COM event.
+ *
+ * From now on TIM_SetPhase() writes only take effect at the next COM event.
+ * With triggered set, COM is also generated by a rising edge on the trigger
+ * input selected in SMCFGR (TS).
+ *
+ * @param timer TIMER1.
+ * @param triggered 1 to also generate COM on a rising edge of the trigger input.
+ */
+void TIM_CommutationInit(TIM_Typedef *timer, uint8_t triggered)
+{
+    uint32_t control = timer->CTLR2 & ~TIM_CCUS_Msk;
+
+    if (triggered)
+        control |= TIM_CCUS_Msk;
+
+    timer->CTLR2 = control | TIM_CCPC_Msk;
+}
+
+/**
+ * @brief Sets the state of one channel pair (preloaded after TIM_CommutationInit()).
+ *
+ * The compare value and preload setting of the channel are kept, so a
+ * TIM_PHASE_PWM channel continues with the duty it had.
+ *
+ * @param timer TIMER1.
+ * @param channel TIM_CHANNEL_1 to TIM_CHANNEL_3.
+ * @param phase The state.
+ */
+void TIM_SetPhase(TIM_Typedef *timer, TIM_CHANNEL channel, TIM_PHASE phase)
+{
+    volatile uint32_t *chctlr = channel < TIM_CHANNEL_3 ? &timer->CHCTLR1 : &timer->CHCTLR2;
+    uint32_t shift = (channel & 0x01) * TIM_CHCTLR_STRIDE;
+    uint32_t ccerShift = channel * TIM_CCER_STRIDE;
+    uint32_t enable = TIM_CCE_Msk | TIM_CCNE_Msk;
+    uint32_t mode;
+
+    switch (phase)
+    {
+    case TIM_PHASE_PWM:
+        mode = TIM_OCM_PWM1;
+        break;
+
+    case TIM_PHASE_HIGH:
+        mode = TIM_OCM_FORCE_ACTIVE;
+        break;
+
+    case TIM_PHASE_LOW:
+        mode = TIM_OCM_FORCE_INACTIVE;
+        break;
+
+    default:
+        mode = TIM_OCM_FORCE_INACTIVE;
+        enable = 0;
+        break;
+    }
+
+    *chctlr = (*chctlr & ~(TIM_OCM_Msk << shift)) | ((mode << TIM_OCM_Pos) << shift);
+    timer->CCER = (timer->CCER & ~((TIM_CCE_Msk | TIM_CCNE_Msk) << ccerShift)) | (enable << ccerShift);
+}
+
+/**
+ * @brief Points the update DMA request at a channel's compare register.
+ *
+ * The DMA channel is set up memory to peripheral with the memory address
+ * incrementing and 32-bit peripheral writes, so byte or halfword values are
+ * zero-extended into the compare register. Call after TIM_TimeBaseInit(),
+ * which clears the DMA request enables.
+ *
+ * @param timer TIMER1 or TIMER2.
+ * @param channel The channel whose compare value is streamed.
+ * @param dmaMode Further DMA_MODE options (circular, interrupts, DMA_MODE_MEM_SIZE_16 for 16-bit values).
+ */
+void TIM_StreamInit(TIM_Typedef *timer, TIM_CHANNEL channel, uint32_t dmaMode)
+{
+    DMA_ChannelInit(TIM_GetUpdateDmaChannel(timer),
+                    DMA_MODE_MEM_TO_PERIPH | DMA_MODE_MEM_INC | DMA_MODE_PERIPH_SIZE_32 | dmaMode,
+                    &timer->CHCVR[channel]);
+    TIM_EnableInterrupts(timer, TIM_DMA_UPDATE);
+}
+
+/**
+ * @brief Puts a channel in input capture mode and enables the capture.
+ *
+ * The capture is disabled while the channel is reconfigured. The input
+ * comes from the channel's own pin (CCS = 01) or, with
+ * TIM_CAPTURE_INDIRECT, from the other channel of its pair (CCS = 10).
+ *
+ * @param timer TIMER1 or TIMER2.
+ * @param channel The channel.
+ * @param options TIM_CAPTURE options combined with '|'.
+ */
+void TIM_CaptureInit(TIM_Typedef *timer, TIM_CHANNEL channel, uint32_t options)
+{
+    volatile uint32_t *chctlr = channel < TIM_CHANNEL_3 ? &timer->CHCTLR1 : &timer->CHCTLR2;
+    uint32_t shift = (channel & 0x01) * TIM_CHCTLR_STRIDE;
+    uint32_t ccerShift = channel * TIM_CCER_STRIDE;
+    uint32_t mode = ((options & TIM_CAPTURE_INDIRECT) ? 0x02 : 0x01) << TIM_CCS_Pos;
+    uint32_t enable = TIM_CCE_Msk;
+
+    mode |= options & (TIM_ICPSC_Msk | TIM_ICF_Msk);
+    if (options & TIM_CAPTURE_FALLING)
+        enable |= TIM_CCP_Msk;
+
+    timer->CCER &= ~((TIM_CCE_Msk | TIM_CCP_Msk | TIM_CCNE_Msk | TIM_CCNP_Msk) << ccerShift);
+    *chctlr = (*chctlr & ~((TIM_CCS_Msk | TIM_ICPSC_Msk | TIM_ICF_Msk) << shift)) | (mode << shift);
+    timer->CCER |= enable << ccerShift;
+}
+
+/**
+ * @brief Sets up a channel's pin as a floating input.
+ * @param timer TIMER1 or TIMER2.
+ * @param channel The channel.
+ * @param remap The timer's remap selected with AFIO_PinRemap() (0..3).
+ */
+void TIM_CapturePinInit(TIM_Typedef *timer, TIM_CHANNEL channel, uint8_t remap)
+{
+    if (remap > 3)
+        return;
+
+    TIM_PinInit(timer == TIMER1 ? timTim1Pins[remap][channel] : timTim2Pins[remap][channel], MODE_INPUT_MODE,
+                INPUT_MODE_FLOATING_INPUT, PIN_DEFAULT);
+}
+
+/**
+ * @brief Points a channel's DMA request at its capture register.
+ *
+ * The DMA channel is set up peripheral to memory with 16-bit transfers and
+ * the memory address incrementing, one halfword per capture. Reading the
+ * register clears the capture flag, so no overcapture is flagged while the
+ * DMA keeps up. Call after TIM_TimeBaseInit(), which clears the DMA request
+ * enables.
+ *
+ * @param timer TIMER1 or TIMER2.
+ * @param channel The channel whose captured values are copied.
+ * @param dmaMode Further DMA_MODE options (circular, interrupts, priority).
+ */
+void TIM_CaptureDmaInit(TIM_Typedef *timer, TIM_CHANNEL channel, uint32_t dmaMode)
+{
+    DMA_ChannelInit(TIM_GetCaptureDmaChannel(timer, channel), DMA_MODE_MEM_INC | DMA_MODE_SIZE_16 | dmaMode,
+                    &timer->CHCVR[channel]);
+    TIM_EnableInterrupts(timer, TIM_DMA_CC1 << channel);
+}
+
+/**
+ * @brief Selects the trigger input and what it does to the counter.
+ *
+ * For PWM input, TIM_SLAVE_RESET on TIM_TRIGGER_TI1FP1 restarts the counter
+ * at each active edge of CH1, so the CH1 capture holds the period and an
+ * indirect capture of the other edge on CH2 holds the pulse width.
+ *
+ * @param timer TIMER1 or TIMER2.
+ * @param trigger The trigger input.
+ * @param mode The slave mode.
+ */
+void TIM_SetSlaveMode(TIM_Typedef *timer, TIM_TRIGGER trigger, TIM_SLAVE mode)
+{
+    timer->SMCFGR = (timer->SMCFGR & ~(TIM_TS_Msk | TIM_SMS_Msk)) | ((uint32_t)trigger << TIM_TS_Pos) |
+                    ((uint32_t)mode << TIM_SMS_Pos);
+}
+
+/**
+ * @brief TIM1 break handler, overriding the weak vector.
+ *
+ * MOE is already clear when this runs; the handler only reports the fault.
+ */
+PROFILE_IRQ_HANDLER(TIM1_BRK_IRQHandler, PFIC_IRQ_TIM1_BRK)
+{
+    TIM_Dispatch(TIMER1, timTim1Handler, TIM_BRK_FLAGS);
+}
+
+/**
+ * @brief TIM1 update handler, overriding the weak vector.
+ */
+PROFILE_IRQ_HANDLER(TIM1_UP_IRQHandler, PFIC_IRQ_TIM1_UP)
+{
+    TIM_Dispatch(TIMER1, timTim1Handler, TIM_UP_FLAGS);
+}
+
+/**
+ * @brief TIM1 trigger and commutation handler, overriding the weak vector.
+ */
+PROFILE_IRQ_HANDLER(TIM1_TRG_COM_IRQHandler, PFIC_IRQ_TIM1_TRG_COM)
+{
+    TIM_Dispatch(TIMER1, timTim1Handler, TIM_TRG_COM_FLAGS);
+}
+
+/**
+ * @brief TIM1 compare / capture handler, overriding the weak vector.
+ */
+PROFILE_IRQ_HANDLER(TIM1_CC_IRQHandler, PFIC_IRQ_TIM1_CC)
+{
+    TIM_Dispatch(TIMER1, timTim1Handler, TIM_CC_FLAGS);
+}
+
+/**
+ * @brief TIM2 handler, overriding the weak vector.
+ *
+ * All TIM2 events share one vector. Overcapture flags are left to the
+ * handler.
+ */
+PROFILE_IRQ_HANDLER(TIM2_IRQHandler, PFIC_IRQ_TIM2)
+{
+    TIM_Dispatch(TIMER2, timTim2Handler, TIM_IRQ_FLAGS);
+}
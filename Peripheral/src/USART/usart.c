@@ -0,0 +1,733 @@
+#include <stddef.h>
+#include "USART/usart.h"
+#include "DMA/dma.h"
+#include "GPIO/gpio.h"
+#include "PFIC/pfic.h"
+#include "RCC/rcc.h"
+#include "SYS/sys.h"
+#include "SYS/profile.h"
+
+#if (USART_RX_BUFFER_SIZE & (USART_RX_BUFFER_SIZE - 1)) != 0 || USART_RX_BUFFER_SIZE > 128
+#error "USART_RX_BUFFER_SIZE must be a power of two no larger than 128"
+#endif
+
+#if (USART_TX_BUFFER_SIZE & (USART_TX_BUFFER_SIZE - 1)) != 0 || USART_TX_BUFFER_SIZE > 128
+#error "USART_TX_BUFFER_SIZE must be a power of two no larger than 128"
+#endif
+
+#if USART_RX_DMA && (USART_RX_DMA_SIZE < 2 || USART_RX_DMA_SIZE > 32768)
+#error "USART_RX_DMA_SIZE must be within 2..32768"
+#endif
+
+#if USART_RX_DMA && ((USART_RX_VIEW_DEPTH & (USART_RX_VIEW_DEPTH - 1)) != 0 || USART_RX_VIEW_DEPTH > 128)
+#error "USART_RX_VIEW_DEPTH must be a power of two no larger than 128"
+#endif
+
+// Smallest and largest BRR values (USARTDIV 1.0 and 4095 + 15/16)
+#define USART_BRR_MIN 0x0010
+#define USART_BRR_MAX 0xFFFF
+
+// Rings: head and tail are free-running 8-bit counters. The RX head and TX
+// tail are only written by USART1_IRQHandler, the RX tail and TX head only by
+// the application.
+#if !USART_RX_DMA
+static uint8_t usartRxBuffer[USART_RX_BUFFER_SIZE];
+static volatile uint8_t usartRxHead;
+static volatile uint8_t usartRxTail;
+
+// Takes the received bytes instead of the RX ring when set
+static USART_RX_HOOK volatile usartRxHook;
+#endif
+static uint8_t usartTxBuffer[USART_TX_BUFFER_SIZE];
+static volatile uint8_t usartTxHead;
+static volatile uint8_t usartTxTail;
+
+// Receive error counters
+static USART_STATS usartStats;
+
+#if USART_TX_DMA
+// DMA1 channel hard-wired to the USART1 TX request
+#define USART_TX_DMA_CHANNEL DMA_CHANNEL_4
+
+// Chain queue: the head segment is on the DMA channel, or waits for the TX
+// ring to drain. Both are only changed with interrupts disabled or from the
+// handlers.
+static USART_SEGMENT *volatile usartChainHead;
+static USART_SEGMENT *usartChainTail;
+
+// TX ring position at which the pending chain was queued: the TXE handler
+// stops there and hands the transmitter to the chain. Valid while
+// usartChainHead is set.
+static uint8_t usartTxStop;
+
+void DMA1_Channel4_IRQHandler(void) PFIC_INTERRUPT_HANDLER;
+#endif
+
+#if USART_RX_DMA
+// DMA1 channel hard-wired to the USART1 RX request
+#define USART_RX_DMA_CHANNEL DMA_CHANNEL_5
+
+// Circular receive buffer, only read where the DMA has written
+static NOINIT uint8_t usartRxDmaBuffer[USART_RX_DMA_SIZE];
+
+// Buffer position up to which bytes were queued as views (handlers only)
+static uint16_t usartRxDmaPosition;
+
+// Free-running byte counts: queued as views by the handlers, released by the
+// application. The difference is the part of the buffer still in use.
+static volatile uint16_t usartRxDmaQueued;
+static volatile uint16_t usartRxDmaReleased;
+
+// View queue: head only written by the handlers, tail only by the application
+static USART_RX_VIEW usartRxViews[USART_RX_VIEW_DEPTH];
+static volatile uint8_t usartRxViewHead;
+static volatile uint8_t usartRxViewTail;
+
+void DMA1_Channel5_IRQHandler(void) PFIC_INTERRUPT_HANDLER;
+#endif
+
+void USART1_IRQHandler(void) PFIC_INTERRUPT_HANDLER HIGHCODE;
+
+/**
+ * @brief Sets up USART1 for 8N1 on PD5 / PD6 and enables its interrupt.
+ *
+ * The rings and counters are cleared. RX is configured as an input with
+ * pull-up so a disconnected line idles high instead of producing noise.
+ * Receive interrupts are enabled at once; the transmit interrupt is only
+ * enabled while the TX ring holds data. With USART_RX_DMA the receive DMA
+ * runs before the receiver is enabled, so no byte can reach the data register
+ * unserved.
+ *
+ * @param baudRate Baud rate in bit/s.
+ * @return USART_STATUS: USART_STATUS_SUCCESS, or USART_STATUS_INVALID_BAUD
+ * (the USART is left disabled).
+ */
+USART_STATUS USART_Init(uint32_t baudRate)
+{
+    uint32_t control = USART_UE_Msk | USART_TE_Msk | USART_RE_Msk;
+    USART_STATUS status;
+
+    RCC_PeripheralEnable(IOPD);
+    RCC_PeripheralEnable(USART1);
+
+    USART->CTLR1 = 0;
+    USART->CTLR2 = 0;
+    USART->CTLR3 = 0;
+
+#if !USART_RX_DMA
+    usartRxHead = 0;
+    usartRxTail = 0;
+    usartRxHook = NULL;
+#endif
+    usartTxHead = 0;
+    usartTxTail = 0;
+    USART_ClearStats();
+
+#if USART_TX_DMA
+    usartChainHead = NULL;
+    usartChainTail = NULL;
+    DMA_ChannelInit(USART_TX_DMA_CHANNEL, DMA_MODE_MEM_TO_PERIPH | DMA_MODE_MEM_INC | DMA_MODE_IRQ_COMPLETE,
+                    &USART->DATAR);
+#endif
+
+    status = USART_SetBaudRate(baudRate);
+    if (status != USART_STATUS_SUCCESS)
+        return status;
+
+    GPIO_Init(GPIOD, GPIO_PIN_5, MODE_OUTPUT_MODE_SPEED_50MHZ, OUTPUT_MODE_MULTIPLEXED_FUNCTION_PUSH_PULL, PIN_DEFAULT);
+    GPIO_Init(GPIOD, GPIO_PIN_6, MODE_INPUT_MODE, INPUT_MODE_PULL_UP_PULL_DOWN, PIN_PULL_UP);
+
+#if USART_TX_DMA
+    // The TX request only reaches the channel while it is enabled
+    USART->CTLR3 |= USART_DMAT_Msk;
+    PFIC_EnableIRQ(PFIC_IRQ_DMA1_CHANNEL4);
+#endif
+
+#if USART_RX_DMA
+    usartRxDmaPosition = 0;
+    usartRxDmaQueued = 0;
+    usartRxDmaReleased = 0;
+    usartRxViewHead = 0;
+    usartRxViewTail = 0;
+    DMA_ChannelInit(USART_RX_DMA_CHANNEL,
+                    DMA_MODE_CIRCULAR | DMA_MODE_MEM_INC | DMA_MODE_IRQ_COMPLETE | DMA_MODE_IRQ_HALF |
+                        DMA_MODE_PRIORITY_HIGH,
+                    &USART->DATAR);
+    DMA_ChannelStart(USART_RX_DMA_CHANNEL, usartRxDmaBuffer, USART_RX_DMA_SIZE);
+    USART->CTLR3 |= USART_DMAR_Msk;
+    PFIC_EnableIRQ(PFIC_IRQ_DMA1_CHANNEL5);
+    control |= USART_IDLEIE_Msk;
+#else
+    control |= USART_RXNEIE_Msk;
+#endif
+
+    USART->CTLR1 = control;
+    PFIC_EnableIRQ(PFIC_IRQ_USART1);
+
+    return USART_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Reprograms the baud rate divisor from the current HCLK.
+ *
+ * USART1 is clocked from APB2, which runs at HCLK. BRR holds HCLK / baud
+ * rate in 1/16 units of the 16x oversampling clock, i.e. the plain rounded
+ * quotient. The slowest rate is HCLK / 65535 (about 730 bit/s at 48 MHz) and
+ * the fastest HCLK / 16. A frame in progress is corrupted, so call this while
+ * the line is idle.
+ *
+ * @param baudRate Baud rate in bit/s.
+ * @return USART_STATUS: USART_STATUS_SUCCESS, or USART_STATUS_INVALID_BAUD
+ * (BRR is left unchanged).
+ */
+USART_STATUS USART_SetBaudRate(uint32_t baudRate)
+{
+    if (baudRate == 0)
+        return USART_STATUS_INVALID_BAUD;
+
+    return USART_SetDivisor((RCC_GetHCLKFreq() + (baudRate >> 1)) / baudRate);
+}
+
+/**
+ * @brief Programs the baud rate divisor directly, in HCLK cycles per bit.
+ *
+ * For callers that measured the bit time in HCLK cycles (auto-baud), which
+ * is exactly the BRR value.
+ *
+ * @param divisor HCLK cycles per bit (16..65535).
+ * @return USART_STATUS: USART_STATUS_SUCCESS, or USART_STATUS_INVALID_BAUD
+ * (BRR is left unchanged).
+ */
+USART_STATUS USART_SetDivisor(uint32_t divisor)
+{
+    if (divisor < USART_BRR_MIN || divisor > USART_BRR_MAX)
+        return USART_STATUS_INVALID_BAUD;
+
+    USART->BRR = divisor;
+
+    return USART_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Returns the current baud rate divisor.
+ * @return uint32_t: HCLK cycles per bit.
+ */
+uint32_t USART_GetDivisor(void)
+{
+    return USART->BRR;
+}
+
+/**
+ * @brief Enables or disables the receiver.
+ *
+ * While disabled the RX pin is ignored and nothing reaches the RX ring, the
+ * hook or the DMA buffer. After enabling, the receiver waits for a falling
+ * edge, so a character already in progress is skipped rather than received
+ * as garbage.
+ *
+ * @param enable 1 to enable, 0 to disable.
+ */
+void USART_SetReceiver(uint8_t enable)
+{
+    uint32_t irqState = PFIC_DisableGlobalIRQ();
+
+    if (enable)
+        USART->CTLR1 |= USART_RE_Msk;
+    else
+        USART->CTLR1 &= ~USART_RE_Msk;
+
+    PFIC_RestoreGlobalIRQ(irqState);
+}
+
+/**
+ * @brief Queues as many bytes as the TX ring has room for.
+ *
+ * The bytes are published with a single head update, then the transmit
+ * interrupt is enabled. If the handler disables it concurrently (it just sent
+ * the previous last byte), the next TXE interrupt sees the new bytes anyway.
+ * While a DMA chain is queued the interrupt is not turned on, and the bytes
+ * wait behind the chain; the DMA handler turns it on once the last segment is
+ * out.
+ *
+ * @param data The bytes to send.
+ * @param length Number of bytes.
+ * @return uint16_t: Number of bytes queued, less than length if the ring filled up.
+ */
+uint16_t USART_Write(const uint8_t *data, uint16_t length)
+{
+    uint8_t head = usartTxHead;
+    uint16_t space = USART_TX_BUFFER_SIZE - (uint8_t)(head - usartTxTail);
+
+    if (length > space)
+        length = space;
+    if (length == 0)
+        return 0;
+
+    for (uint16_t index = 0; index < length; index++)
+        usartTxBuffer[(uint8_t)(head + index) & (USART_TX_BUFFER_SIZE - 1)] = data[index];
+
+    // Publish the bytes only after they are in memory
+    __asm volatile("" ::: "memory");
+    usartTxHead = (uint8_t)(head + length);
+
+#if USART_TX_DMA
+    {
+        uint32_t irqState = PFIC_DisableGlobalIRQ();
+
+        if (usartChainHead == NULL)
+            USART->CTLR1 |= USART_TXEIE_Msk;
+
+        PFIC_RestoreGlobalIRQ(irqState);
+    }
+#else
+    USART->CTLR1 |= USART_TXEIE_Msk;
+#endif
+
+    return length;
+}
+
+#if !USART_RX_DMA
+/**
+ * @brief Copies up to length received bytes out of the RX ring.
+ * @param data Destination buffer.
+ * @param length Size of the destination buffer.
+ * @return uint16_t: Number of bytes read, 0 if nothing was received.
+ */
+uint16_t USART_Read(uint8_t *data, uint16_t length)
+{
+    uint8_t tail = usartRxTail;
+    uint16_t count = (uint8_t)(usartRxHead - tail);
+
+    if (length > count)
+        length = count;
+
+    for (uint16_t index = 0; index < length; index++)
+        data[index] = usartRxBuffer[(uint8_t)(tail + index) & (USART_RX_BUFFER_SIZE - 1)];
+
+    // Release the slots only after they have been copied out
+    __asm volatile("" ::: "memory");
+    usartRxTail = (uint8_t)(tail + length);
+
+    return length;
+}
+#else
+/**
+ * @brief Returns the circular DMA receive buffer the views point into.
+ *
+ * The DMA does not write the bytes of a view again before it is released,
+ * so the caller may change them in place until then.
+ *
+ * @return uint8_t*: Start of the buffer (USART_RX_DMA_SIZE bytes).
+ */
+uint8_t *USART_GetRxDmaBuffer(void)
+{
+    return usartRxDmaBuffer;
+}
+
+/**
+ * @brief Returns the oldest received view without removing it.
+ *
+ * The bytes stay valid until USART_ReleaseRxView(), as long as the sender
+ * does not get a full buffer ahead (USART_STATS.dropped counts it if so).
+ *
+ * @param view Receives the view.
+ * @return USART_STATUS: USART_STATUS_SUCCESS, or USART_STATUS_EMPTY if no view is queued.
+ */
+USART_STATUS USART_PeekRxView(USART_RX_VIEW *view)
+{
+    uint8_t tail = usartRxViewTail;
+
+    if (tail == usartRxViewHead)
+        return USART_STATUS_EMPTY;
+
+    *view = usartRxViews[tail & (USART_RX_VIEW_DEPTH - 1)];
+
+    return USART_STATUS_SUCCESS;
+}
+
+/**
+ * @brief Removes the oldest view; its bytes may be overwritten from now on.
+ */
+void USART_ReleaseRxView(void)
+{
+    uint8_t tail = usartRxViewTail;
+
+    if (tail == usartRxViewHead)
+        return;
+
+    usartRxDmaReleased += usartRxViews[tail & (USART_RX_VIEW_DEPTH - 1)].length;
+
+    // Release the slot only after its length has been read
+    __asm volatile("" ::: "memory");
+    usartRxViewTail = (uint8_t)(tail + 1);
+}
+
+/**
+ * @brief Queues one receive view. Called from the handlers only.
+ */
+static inline void USART_PushRxView(uint16_t offset, uint16_t length, uint8_t end)
+{
+    uint8_t head = usartRxViewHead;
+    USART_RX_VIEW *view;
+
+    if ((uint8_t)(head - usartRxViewTail) >= USART_RX_VIEW_DEPTH)
+    {
+        usartStats.dropped += length;
+        return;
+    }
+
+    view = &usartRxViews[head & (USART_RX_VIEW_DEPTH - 1)];
+    view->offset = offset;
+    view->length = length;
+    view->end = end;
+    usartRxDmaQueued += length;
+
+    // Publish the view only after it is in memory
+    __asm volatile("" ::: "memory");
+    usartRxViewHead = (uint8_t)(head + 1);
+}
+
+/**
+ * @brief Queues the bytes the DMA wrote since the previous event.
+ *
+ * The write position comes from the channel count. New bytes that run over
+ * the end of the buffer are split into two views. If the unreleased views
+ * and the new bytes together exceed the buffer, the DMA has overwritten
+ * unread data, and the excess is counted as dropped.
+ *
+ * @param end 1 when called for the idle line, which ends the frame.
+ */
+static inline void USART_UpdateRxDma(uint8_t end)
+{
+    uint16_t position = USART_RX_DMA_SIZE - DMA_GetRemaining(USART_RX_DMA_CHANNEL);
+    uint16_t start = usartRxDmaPosition;
+    uint32_t count;
+    uint32_t used;
+
+    if (position >= USART_RX_DMA_SIZE)
+        position = 0;
+
+    count = (position >= start) ? (uint32_t)(position - start) : (uint32_t)(USART_RX_DMA_SIZE - start + position);
+    used = (uint16_t)(usartRxDmaQueued - usartRxDmaReleased) + count;
+    if (used > USART_RX_DMA_SIZE)
+        usartStats.dropped += used - USART_RX_DMA_SIZE;
+
+    usartRxDmaPosition = position;
+
+    if (position < start)
+    {
+        USART_PushRxView(start, USART_RX_DMA_SIZE - start, end && position == 0);
+        if (position == 0)
+            return;
+        start = 0;
+    }
+
+    if (position != start || end)
+        USART_PushRxView(start, position - start, end);
+}
+#endif
+
+#if USART_TX_DMA
+/**
+ * @brief Starts the DMA channel on a segment.
+ */
+static inline void USART_StartSegment(const USART_SEGMENT *segment)
+{
+    DMA_ChannelStart(USART_TX_DMA_CHANNEL, segment->data, segment->length);
+}
+
+/**
+ * @brief Queues a chain of segments for DMA transmission.
+ *
+ * The chain is appended to the queue as a whole. If the transmitter is idle
+ * the first segment starts at once; otherwise it starts when the running
+ * chain is done, or when the TX ring has sent the bytes written before this
+ * call. Bytes written to the ring afterwards wait until the chain queue is
+ * empty. No byte is copied: the DMA reads each buffer
+ * in place. May also be called from a segment's done callback.
+ *
+ * @param chain First segment, the chain ends at a NULL next.
+ * @return USART_STATUS: USART_STATUS_SUCCESS, or USART_STATUS_INVALID_CHAIN
+ * (nothing queued) for a NULL chain or a segment of length 0.
+ */
+USART_STATUS USART_WriteChain(USART_SEGMENT *chain)
+{
+    USART_SEGMENT *last = chain;
+    uint32_t irqState;
+
+    if (chain == NULL)
+        return USART_STATUS_INVALID_CHAIN;
+
+    while (1)
+    {
+        if (last->length == 0)
+            return USART_STATUS_INVALID_CHAIN;
+        if (last->next == NULL)
+            break;
+        last = last->next;
+    }
+
+    irqState = PFIC_DisableGlobalIRQ();
+
+    if (usartChainHead == NULL)
+    {
+        usartChainHead = chain;
+        usartTxStop = usartTxHead;
+
+        // A draining TX ring starts the chain from its handler at usartTxStop
+        if (!(USART->CTLR1 & USART_TXEIE_Msk))
+            USART_StartSegment(chain);
+    }
+    else
+    {
+        usartChainTail->next = chain;
+    }
+    usartChainTail = last;
+
+    PFIC_RestoreGlobalIRQ(irqState);
+
+    return USART_STATUS_SUCCESS;
+}
+#endif
+
+/**
+ * @brief Queues one byte.
+ * @param byte The byte to send.
+ * @return USART_STATUS: USART_STATUS_SUCCESS, or USART_STATUS_FULL if the TX ring has no room.
+ */
+USART_STATUS USART_PutChar(uint8_t byte)
+{
+    return USART_Write(&byte, 1) ? USART_STATUS_SUCCESS : USART_STATUS_FULL;
+}
+
+#if !USART_RX_DMA
+/**
+ * @brief Takes one byte from the RX ring.
+ * @param byte Receives the byte.
+ * @return USART_STATUS: USART_STATUS_SUCCESS, or USART_STATUS_EMPTY if nothing was received.
+ */
+USART_STATUS USART_GetChar(uint8_t *byte)
+{
+    return USART_Read(byte, 1) ? USART_STATUS_SUCCESS : USART_STATUS_EMPTY;
+}
+
+/**
+ * @brief Returns the number of received bytes waiting in the RX ring.
+ * @return uint16_t: Bytes available to USART_Read().
+ */
+uint16_t USART_GetRxCount(void)
+{
+    return (uint8_t)(usartRxHead - usartRxTail);
+}
+
+/**
+ * @brief Routes received bytes to a hook instead of the RX ring.
+ *
+ * The hook runs in USART1_IRQHandler, once per byte, right after the byte is
+ * read; keep it short, the next byte arrives one character time later. Bytes
+ * already in the ring stay there.
+ *
+ * @param hook The hook, or NULL to go back to the RX ring.
+ */
+void USART_SetRxHook(USART_RX_HOOK hook)
+{
+    usartRxHook = hook;
+}
+#endif
+
+/**
+ * @brief Returns the free space in the TX ring.
+ * @return uint16_t: Bytes USART_Write() can queue right now.
+ */
+uint16_t USART_GetTxFree(void)
+{
+    return USART_TX_BUFFER_SIZE - (uint8_t)(usartTxHead - usartTxTail);
+}
+
+/**
+ * @brief Waits until the TX ring is empty and the last stop bit is out.
+ *
+ * Needs interrupts enabled while the ring drains. Use before changing the
+ * baud rate or the clocks, or entering a low-power mode.
+ */
+void USART_Flush(void)
+{
+    while (usartTxHead != usartTxTail)
+        ;
+
+#if USART_TX_DMA
+    while (usartChainHead != NULL)
+        ;
+#endif
+
+    while (!(USART->STATR & USART_TC_Msk))
+        ;
+}
+
+/**
+ * @brief Copies the receive error counters.
+ * @param stats Receives the counters.
+ */
+void USART_GetStats(USART_STATS *stats)
+{
+    uint32_t irqState = PFIC_DisableGlobalIRQ();
+
+    *stats = usartStats;
+
+    PFIC_RestoreGlobalIRQ(irqState);
+}
+
+/**
+ * @brief Zeroes the receive error counters.
+ */
+void USART_ClearStats(void)
+{
+    uint32_t irqState = PFIC_DisableGlobalIRQ();
+
+    usartStats.dropped = 0;
+    usartStats.overruns = 0;
+    usartStats.errors = 0;
+
+    PFIC_RestoreGlobalIRQ(irqState);
+}
+
+/**
+ * @brief USART1 handler, overriding the weak vector. Runs from RAM.
+ *
+ * STATR is read once. Reading DATAR then clears RXNE together with ORE and
+ * the error flags, so one received byte costs a status read, a data read and
+ * a ring store (or a call of the receive hook). With USART_RX_DMA the DMA takes the bytes and only the idle
+ * line interrupts; the same read sequence clears IDLE. On TXE the next byte is written; after the last one the
+ * transmit interrupt is disabled straight away instead of taking one more
+ * interrupt on an empty ring, and a DMA chain queued meanwhile is started.
+ */
+PROFILE_IRQ_HANDLER(USART1_IRQHandler, PFIC_IRQ_USART1)
+{
+    uint32_t status = USART->STATR;
+
+#if USART_RX_DMA
+    if (status & USART_IDLE_Msk)
+    {
+        (void)USART->DATAR;
+
+        if (status & USART_ORE_Msk)
+            usartStats.overruns++;
+        if (status & (USART_FE_Msk | USART_NE_Msk))
+            usartStats.errors++;
+
+        USART_UpdateRxDma(1);
+    }
+#else
+    if (status & (USART_RXNE_Msk | USART_ORE_Msk))
+    {
+        uint8_t byte = (uint8_t)USART->DATAR;
+        uint8_t head = usartRxHead;
+        USART_RX_HOOK hook = usartRxHook;
+        uint8_t error = 0;
+
+        if (status & (USART_ORE_Msk | USART_FE_Msk | USART_NE_Msk))
+        {
+            if (status & USART_ORE_Msk)
+                usartStats.overruns++;
+            if (status & (USART_FE_Msk | USART_NE_Msk))
+                usartStats.errors++;
+            error = 1;
+        }
+
+        if (hook != NULL)
+        {
+            hook(byte, error);
+        }
+        else if ((uint8_t)(head - usartRxTail) < USART_RX_BUFFER_SIZE)
+        {
+            usartRxBuffer[head & (USART_RX_BUFFER_SIZE - 1)] = byte;
+            usartRxHead = (uint8_t)(head + 1);
+        }
+        else
+        {
+            usartStats.dropped++;
+        }
+    }
+#endif
+
+    if ((status & USART_TXE_Msk) && (USART->CTLR1 & USART_TXEIE_Msk))
+    {
+        uint8_t tail = usartTxTail;
+        uint8_t end = usartTxHead;
+
+#if USART_TX_DMA
+        // Bytes written after a pending chain was queued go out after it
+        if (usartChainHead != NULL)
+            end = usartTxStop;
+#endif
+
+        if (tail != end)
+        {
+            USART->DATAR = usartTxBuffer[tail & (USART_TX_BUFFER_SIZE - 1)];
+            usartTxTail = ++tail;
+        }
+
+        if (tail == end)
+        {
+            USART->CTLR1 &= ~USART_TXEIE_Msk;
+
+#if USART_TX_DMA
+            if (usartChainHead != NULL)
+                USART_StartSegment(usartChainHead);
+#endif
+        }
+    }
+}
+
+#if USART_TX_DMA
+/**
+ * @brief USART1 TX DMA transfer-complete handler, overriding the weak vector.
+ *
+ * Runs once per segment, not per byte, so it stays in flash and leaves RAM
+ * to USART1_IRQHandler.
+ *
+ * The next segment is started before the finished one's callback runs, so the
+ * gap between segments is a few stores rather than the callback's duration.
+ * When the queue runs empty, bytes queued with USART_Write() in the meantime
+ * are handed back to the TXE interrupt.
+ */
+PROFILE_IRQ_HANDLER(DMA1_Channel4_IRQHandler, PFIC_IRQ_DMA1_CHANNEL4)
+{
+    USART_SEGMENT *segment = usartChainHead;
+    USART_SEGMENT *next;
+
+    DMA_ClearFlags(USART_TX_DMA_CHANNEL, DMA_FLAG_ALL);
+
+    if (segment == NULL)
+        return;
+
+    next = segment->next;
+    usartChainHead = next;
+    if (next != NULL)
+        USART_StartSegment(next);
+    else
+        usartChainTail = NULL;
+
+    if (segment->done != NULL)
+        segment->done(segment);
+
+    if (usartChainHead == NULL && usartTxHead != usartTxTail)
+        USART->CTLR1 |= USART_TXEIE_Msk;
+}
+#endif
+
+#if USART_RX_DMA
+/**
+ * @brief USART1 RX DMA half / full transfer handler, overriding the weak
+ * vector. Runs twice per buffer revolution, so it stays in flash.
+ *
+ * Hands over what the DMA wrote so far, so a frame longer than half the buffer
+ * is delivered in pieces before the DMA comes round to it.
+ */
+PROFILE_IRQ_HANDLER(DMA1_Channel5_IRQHandler, PFIC_IRQ_DMA1_CHANNEL5)
+{
+    DMA_ClearFlags(USART_RX_DMA_CHANNEL, DMA_FLAG_ALL);
+
+    USART_UpdateRxDma(0);
+}
+#endif
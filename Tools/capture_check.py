@@ -0,0 +1,395 @@
+#!/usr/bin/env python3
+"""Host model test of Middleware/src/CAPTURE/capture.c.
+
+Builds capture.c for the host as a shared library against mock DMA, TIM,
+AFIO and PFIC headers, and replays random input signals through a model of
+the hardware:
+
+  - each edge latches the 16-bit counter and sets the channel's capture
+    flag; the channel's DMA writes it to the buffer and clears the flag a
+    few ticks later, or after a few flag polls by the code;
+  - each counter overflow copies the capture DMA count through the update
+    DMA request. A capture write due in the same tick goes after it, since
+    the update request has the higher priority;
+  - the update interrupt runs after a random latency, with the counter
+    value of that moment;
+  - CAPTURE_Read() is called at random times, also while an update
+    interrupt is pending.
+
+Every CAPTURE_STATUS_SUCCESS reading of CAPTURE_MODE_FREQUENCY is compared
+with the exact span of the edges it covers. Signals mix fast bursts, slow
+inputs of several counter periods and edges placed on the overflow itself.
+Exits with status 1 on the first wrong reading.
+
+Usage:
+    capture_check.py [--edges N] [--seed S]
+"""
+
+import argparse
+import ctypes
+import os
+import random
+import subprocess
+import sys
+import tempfile
+
+TOOLS = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.dirname(TOOLS)
+SOURCE = os.path.join(ROOT, "Middleware", "src", "CAPTURE", "capture.c")
+INCLUDE = os.path.join(ROOT, "Middleware", "inc")
+
+PERIOD = 0x10000
+BUFFER_SIZE = 32
+MARKS = 8
+STATUS_SUCCESS = 0
+
+DMA_H = """
+#ifndef DMA_H
+#define DMA_H
+#include <stdint.h>
+typedef enum { DMA_CHANNEL_1, DMA_CHANNEL_2, DMA_CHANNEL_3, DMA_CHANNEL_4,
+               DMA_CHANNEL_5, DMA_CHANNEL_6, DMA_CHANNEL_7 } DMA_CHANNEL;
+enum { DMA_MODE_MEM_TO_PERIPH = 0x01, DMA_MODE_CIRCULAR = 0x02, DMA_MODE_MEM_INC = 0x04,
+       DMA_MODE_SIZE_16 = 0x08, DMA_MODE_PRIORITY_HIGH = 0x10, DMA_MODE_PRIORITY_VERY_HIGH = 0x20 };
+enum { DMA_FLAG_GLOBAL = 0x01, DMA_FLAG_COMPLETE = 0x02, DMA_FLAG_HALF = 0x04,
+       DMA_FLAG_ERROR = 0x08, DMA_FLAG_ALL = 0x0F };
+typedef struct { volatile uint32_t CFGR; volatile uint32_t CNTR; } DMA_Channel_Typedef;
+extern DMA_Channel_Typedef mockDmaRegs[7];
+#define DMA_CHANNEL_REGS(channel) (&mockDmaRegs[channel])
+void DMA_ChannelInit(DMA_CHANNEL channel, uint32_t mode, volatile void *peripheral);
+void DMA_ChannelStart(DMA_CHANNEL channel, const volatile void *memory, uint16_t count);
+void DMA_ChannelStop(DMA_CHANNEL channel);
+uint16_t DMA_GetRemaining(DMA_CHANNEL channel);
+uint32_t DMA_GetFlags(DMA_CHANNEL channel);
+void DMA_ClearFlags(DMA_CHANNEL channel, uint32_t flags);
+#endif
+"""
+
+TIM_H = """
+#ifndef TIM_H
+#define TIM_H
+#include <stdint.h>
+#include "DMA/dma.h"
+typedef struct { int unused; } TIM_Typedef;
+extern TIM_Typedef mockTimers[2];
+#define TIMER1 (&mockTimers[0])
+#define TIMER2 (&mockTimers[1])
+typedef enum { TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3, TIM_CHANNEL_4 } TIM_CHANNEL;
+typedef enum { TIM_TRIGGER_ITR0, TIM_TRIGGER_TI1FP1, TIM_TRIGGER_TI2FP2 } TIM_TRIGGER;
+typedef enum { TIM_SLAVE_DISABLED, TIM_SLAVE_RESET } TIM_SLAVE;
+enum { TIM_MODE_UPDATE_ON_OVERFLOW = 0x01 };
+enum { TIM_CAPTURE_DIV2 = 0x01, TIM_CAPTURE_DIV4 = 0x02, TIM_CAPTURE_DIV8 = 0x03,
+       TIM_CAPTURE_INDIRECT = 0x10, TIM_CAPTURE_FALLING = 0x20 };
+enum { TIM_IRQ_UPDATE = 0x0001, TIM_DMA_UPDATE = 0x0100, TIM_DMA_CC1 = 0x0200, TIM_DMA_CC2 = 0x0400,
+       TIM_DMA_CC3 = 0x0800, TIM_DMA_CC4 = 0x1000 };
+enum { TIM_FLAG_UPDATE = 0x0001, TIM_FLAG_CC1 = 0x0002 };
+typedef void (*TIM_HANDLER)(uint32_t flags);
+uint16_t TIM_GetPrescaler(uint32_t tickRate);
+uint32_t TIM_GetTickRate(uint16_t prescaler);
+void TIM_TimeBaseInit(TIM_Typedef *timer, uint16_t prescaler, uint16_t reload, uint32_t mode);
+void TIM_CapturePinInit(TIM_Typedef *timer, TIM_CHANNEL channel, uint8_t remap);
+void TIM_CaptureInit(TIM_Typedef *timer, TIM_CHANNEL channel, uint32_t options);
+void TIM_SetSlaveMode(TIM_Typedef *timer, TIM_TRIGGER trigger, TIM_SLAVE mode);
+void TIM_CaptureDmaInit(TIM_Typedef *timer, TIM_CHANNEL channel, uint32_t dmaMode);
+void TIM_SetHandler(TIM_Typedef *timer, TIM_HANDLER handler);
+void TIM_EnableInterrupts(TIM_Typedef *timer, uint32_t mask);
+void TIM_DisableInterrupts(TIM_Typedef *timer, uint32_t mask);
+void TIM_Start(TIM_Typedef *timer);
+void TIM_Stop(TIM_Typedef *timer);
+uint16_t TIM_GetCounter(TIM_Typedef *timer);
+uint32_t TIM_GetFlags(TIM_Typedef *timer);
+void TIM_ClearFlags(TIM_Typedef *timer, uint32_t flags);
+static inline DMA_CHANNEL TIM_GetUpdateDmaChannel(TIM_Typedef *timer)
+{
+    return timer == TIMER1 ? DMA_CHANNEL_5 : DMA_CHANNEL_2;
+}
+static inline DMA_CHANNEL TIM_GetCaptureDmaChannel(TIM_Typedef *timer, TIM_CHANNEL channel)
+{
+    uint16_t map = timer == TIMER1 ? 0x3521 : 0x6064;
+    return (DMA_CHANNEL)((map >> (channel * 4)) & 0x0F);
+}
+static inline void TIM_CaptureStart(TIM_Typedef *timer, TIM_CHANNEL channel, volatile uint16_t *values, uint16_t count)
+{
+    DMA_ChannelStart(TIM_GetCaptureDmaChannel(timer, channel), values, count);
+}
+static inline void TIM_CaptureStop(TIM_Typedef *timer, TIM_CHANNEL channel)
+{
+    DMA_ChannelStop(TIM_GetCaptureDmaChannel(timer, channel));
+}
+#endif
+"""
+
+AFIO_H = """
+#ifndef AFIO_H
+#define AFIO_H
+#include <stdint.h>
+typedef enum { AFIO_RM_TMI1_RM, AFIO_RM_TIM2_RM } AFIO_RM;
+typedef uint8_t AFIO_MAP;
+static inline void AFIO_PinRemap(AFIO_RM remap, AFIO_MAP map) { (void)remap; (void)map; }
+#endif
+"""
+
+PFIC_H = """
+#ifndef PFIC_H
+#define PFIC_H
+#include <stdint.h>
+enum { PFIC_IRQ_TIM1_UP, PFIC_IRQ_TIM2 };
+static inline void PFIC_EnableIRQ(int irq) { (void)irq; }
+static inline uint32_t PFIC_DisableGlobalIRQ(void) { return 0; }
+static inline void PFIC_RestoreGlobalIRQ(uint32_t state) { (void)state; }
+#endif
+"""
+
+HARNESS = r"""
+#include <stddef.h>
+#include "DMA/dma.h"
+#include "TIM/tim.h"
+
+DMA_Channel_Typedef mockDmaRegs[7];
+TIM_Typedef mockTimers[2];
+
+static struct
+{
+    volatile uint16_t *memory;
+    volatile void *peripheral;
+    uint16_t size;
+    uint32_t flags;
+    uint8_t enabled;
+} mockDma[7];
+
+static TIM_HANDLER mockHandler;
+static uint32_t mockTimerFlags;
+static uint32_t mockTimerEnables;
+static uint16_t mockCounter;
+static uint8_t mockPending;
+static uint8_t mockPendingPolls;
+static uint16_t mockPendingValue;
+
+uint32_t mockCaptures;
+
+void DMA_ChannelInit(DMA_CHANNEL channel, uint32_t mode, volatile void *peripheral)
+{
+    (void)mode;
+    mockDma[channel].peripheral = peripheral;
+    mockDma[channel].enabled = 0;
+    mockDma[channel].flags = 0;
+}
+
+void DMA_ChannelStart(DMA_CHANNEL channel, const volatile void *memory, uint16_t count)
+{
+    mockDma[channel].memory = (volatile uint16_t *)memory;
+    mockDma[channel].size = count;
+    mockDma[channel].flags = 0;
+    mockDma[channel].enabled = 1;
+    mockDmaRegs[channel].CNTR = count;
+}
+
+void DMA_ChannelStop(DMA_CHANNEL channel) { mockDma[channel].enabled = 0; }
+uint16_t DMA_GetRemaining(DMA_CHANNEL channel) { return (uint16_t)mockDmaRegs[channel].CNTR; }
+uint32_t DMA_GetFlags(DMA_CHANNEL channel) { return mockDma[channel].flags; }
+void DMA_ClearFlags(DMA_CHANNEL channel, uint32_t flags) { mockDma[channel].flags &= ~flags; }
+
+uint16_t TIM_GetPrescaler(uint32_t tickRate) { (void)tickRate; return 0; }
+uint32_t TIM_GetTickRate(uint16_t prescaler) { (void)prescaler; return 1000000; }
+void TIM_TimeBaseInit(TIM_Typedef *timer, uint16_t prescaler, uint16_t reload, uint32_t mode) {}
+void TIM_CapturePinInit(TIM_Typedef *timer, TIM_CHANNEL channel, uint8_t remap) {}
+void TIM_CaptureInit(TIM_Typedef *timer, TIM_CHANNEL channel, uint32_t options) {}
+void TIM_SetSlaveMode(TIM_Typedef *timer, TIM_TRIGGER trigger, TIM_SLAVE mode) {}
+void TIM_CaptureDmaInit(TIM_Typedef *timer, TIM_CHANNEL channel, uint32_t dmaMode)
+{
+    DMA_ChannelInit(TIM_GetCaptureDmaChannel(timer, channel), dmaMode, NULL);
+}
+void TIM_SetHandler(TIM_Typedef *timer, TIM_HANDLER handler) { mockHandler = handler; }
+void TIM_EnableInterrupts(TIM_Typedef *timer, uint32_t mask) { mockTimerEnables |= mask; }
+void TIM_DisableInterrupts(TIM_Typedef *timer, uint32_t mask) { mockTimerEnables &= ~mask; }
+void TIM_Start(TIM_Typedef *timer) {}
+void TIM_Stop(TIM_Typedef *timer) {}
+uint16_t TIM_GetCounter(TIM_Typedef *timer) { return mockCounter; }
+void TIM_ClearFlags(TIM_Typedef *timer, uint32_t flags) { mockTimerFlags &= ~flags; }
+
+/* One DMA transfer of a peripheral-to-memory channel. */
+static void MockTransfer(DMA_CHANNEL channel, uint16_t value)
+{
+    uint16_t remaining = (uint16_t)mockDmaRegs[channel].CNTR;
+
+    if (!mockDma[channel].enabled)
+        return;
+
+    mockDma[channel].memory[mockDma[channel].size - remaining] = value;
+    remaining--;
+    if (remaining == mockDma[channel].size / 2)
+        mockDma[channel].flags |= DMA_FLAG_HALF | DMA_FLAG_GLOBAL;
+    if (remaining == 0)
+    {
+        mockDma[channel].flags |= DMA_FLAG_COMPLETE | DMA_FLAG_GLOBAL;
+        remaining = mockDma[channel].size;
+    }
+    mockDmaRegs[channel].CNTR = remaining;
+}
+
+/* The capture DMA writes the latched counter value and clears the capture flag. */
+void SimServe(void)
+{
+    if (!mockPending)
+        return;
+
+    mockPending = 0;
+    MockTransfer(TIM_GetCaptureDmaChannel(TIMER1, TIM_CHANNEL_1), mockPendingValue);
+    mockCaptures++;
+}
+
+/* An edge: the counter is latched, and the DMA serves it after polls flag reads at most. */
+void SimLatch(uint16_t value, uint8_t polls)
+{
+    SimServe();
+    mockPending = 1;
+    mockPendingPolls = polls;
+    mockPendingValue = value;
+}
+
+/* Each flag read takes bus cycles in which the DMA moves on. */
+uint32_t TIM_GetFlags(TIM_Typedef *timer)
+{
+    if (mockPending && mockPendingPolls-- == 0)
+        SimServe();
+    return mockTimerFlags | (mockPending ? TIM_FLAG_CC1 : 0);
+}
+
+/* Counter overflow: update flag, and the update DMA request if enabled. */
+void SimOverflow(void)
+{
+    DMA_CHANNEL update = TIM_GetUpdateDmaChannel(TIMER1);
+
+    mockTimerFlags |= TIM_FLAG_UPDATE;
+    if ((mockTimerEnables & TIM_DMA_UPDATE) && mockDma[update].peripheral != NULL)
+        MockTransfer(update, (uint16_t)*(volatile uint32_t *)mockDma[update].peripheral);
+}
+
+/* The update interrupt, as dispatched by the TIM driver. */
+void SimInterrupt(uint16_t counter)
+{
+    uint32_t flags = mockTimerFlags & TIM_FLAG_UPDATE;
+
+    mockCounter = counter;
+    mockTimerFlags &= ~flags;
+    if (mockHandler != NULL)
+        mockHandler(flags);
+}
+
+void SimSetCounter(uint16_t counter) { mockCounter = counter; }
+"""
+
+
+def build_host_library(directory):
+    headers = {"DMA/dma.h": DMA_H, "TIM/tim.h": TIM_H, "GPIO/afio.h": AFIO_H, "PFIC/pfic.h": PFIC_H}
+    for name, text in headers.items():
+        os.makedirs(os.path.join(directory, os.path.dirname(name)), exist_ok=True)
+        with open(os.path.join(directory, name), "w") as header:
+            header.write(text)
+    harness = os.path.join(directory, "harness.c")
+    with open(harness, "w") as source:
+        source.write(HARNESS)
+
+    path = os.path.join(directory, "capture.so")
+    subprocess.check_call([os.environ.get("CC", "cc"), "-O2", "-shared", "-fPIC",
+                           "-DCAPTURE_BUFFER_SIZE=%d" % BUFFER_SIZE, "-DCAPTURE_MARKS=%d" % MARKS,
+                           "-I" + directory, "-I" + INCLUDE, SOURCE, harness, "-o", path])
+    lib = ctypes.CDLL(path)
+    lib.CAPTURE_Init.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_uint8, ctypes.c_uint32, ctypes.c_int]
+    lib.CAPTURE_Read.argtypes = [ctypes.c_uint8, ctypes.c_void_p]
+    lib.SimLatch.argtypes = [ctypes.c_uint16, ctypes.c_uint8]
+    lib.SimInterrupt.argtypes = [ctypes.c_uint16]
+    lib.SimSetCounter.argtypes = [ctypes.c_uint16]
+    return lib
+
+
+class Result(ctypes.Structure):
+    _fields_ = [("ticks", ctypes.c_uint32), ("highTicks", ctypes.c_uint32), ("periods", ctypes.c_uint16)]
+
+
+def make_signal(rng, count):
+    """Returns sorted edge times: bursts, slow stretches and edges on the overflow."""
+    edges = []
+    time = rng.randrange(PERIOD)
+    while len(edges) < count:
+        kind = rng.random()
+        if kind < 0.4:
+            gap = rng.randrange(4, 300)
+        elif kind < 0.7:
+            gap = rng.randrange(300, PERIOD)
+        elif kind < 0.85:
+            gap = rng.randrange(PERIOD, 4 * PERIOD)
+        else:
+            # Within a few ticks of the next overflow, on either side
+            target = (time // PERIOD + 1) * PERIOD + rng.randrange(-3, 4)
+            gap = max(4, target - time)
+        time += gap
+        edges.append(time)
+    return edges
+
+
+def run(lib, rng, count):
+    timers = ctypes.c_void_p.in_dll(lib, "mockTimers")
+    timer1 = ctypes.addressof(timers)
+    if lib.CAPTURE_Init(timer1, 0, 0, 1000000, 0) != STATUS_SUCCESS:
+        sys.exit("CAPTURE_Init failed")
+
+    edges = make_signal(rng, count)
+    end = edges[-1] + PERIOD
+
+    # (time, order, kind, value): the update DMA request comes before a
+    # capture due in the same tick, the interrupt after both
+    events = []
+    for edge in edges:
+        events.append((edge, 1, "latch", edge))
+        events.append((edge + rng.choice((0, 1, 2, 3)), 1, "serve", edge))
+    for overflow in range(PERIOD, end, PERIOD):
+        events.append((overflow, 0, "overflow", overflow))
+        latency = rng.choice((rng.randrange(1, 50), rng.randrange(1, 3000)))
+        events.append((overflow + latency, 2, "interrupt", overflow))
+    for _ in range(count):
+        events.append((rng.randrange(edges[0], end), 3, "read", 0))
+    events.sort()
+
+    captures_written = ctypes.c_uint32.in_dll(lib, "mockCaptures")
+    readings = 0
+    result = Result()
+    for time, _, kind, value in events:
+        if kind == "latch":
+            lib.SimLatch(value & 0xFFFF, rng.choice((0, 1, 2, 3)))
+        elif kind == "serve":
+            lib.SimServe()
+        elif kind == "overflow":
+            lib.SimOverflow()
+        elif kind == "interrupt":
+            lib.SimInterrupt(time & 0xFFFF)
+        else:
+            captures = rng.randrange(1, BUFFER_SIZE)
+            lib.SimSetCounter(time & 0xFFFF)
+            if lib.CAPTURE_Read(captures, ctypes.byref(result)) != STATUS_SUCCESS:
+                continue
+            written = edges[:captures_written.value]
+            expected = written[-1] - written[-1 - captures]
+            if result.ticks != expected:
+                sys.exit("at tick %d, %d captures: %d ticks, expected %d (edges %s)"
+                         % (time, captures, result.ticks, expected, written[-1 - captures:]))
+            readings += 1
+    return readings
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Host model test of capture.c.")
+    parser.add_argument("--edges", type=int, default=20000, help="edges per run")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as directory:
+        lib = build_host_library(directory)
+        readings = run(lib, random.Random(args.seed), args.edges)
+
+    print("%d edges, %d exact readings: ok" % (args.edges, readings))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,261 @@
+#!/usr/bin/env python3
+"""Accuracy tests and cycle benchmark of Middleware/src/FIXMATH/fixmath.c.
+
+Accuracy: builds fixmath.c for the host as a shared library, sweeps every
+function against Python's libm and fails (exit status 1) when an error
+exceeds its documented bound.
+
+Benchmark (--bench): links an RV32EC build of fixmath.c with the RTLIB
+objects and the newlib libm / libc / libgcc archives, then runs the
+fixed-point routines and their float counterparts on the simulator of
+rtlib_bench.py. The simulated fixed-point results are also compared with
+the host build.
+
+Usage:
+    fixmath_check.py
+    fixmath_check.py --bench fixmath.o rtlib_arith.o rtlib_mem.o \\
+                     --libs libm.a libc_nano.a libgcc.a
+"""
+
+import argparse
+import ctypes
+import math
+import os
+import random
+import struct
+import subprocess
+import sys
+import tempfile
+
+TOOLS = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.dirname(TOOLS)
+SOURCE = os.path.join(ROOT, "Middleware", "src", "FIXMATH", "fixmath.c")
+INCLUDE = os.path.join(ROOT, "Middleware", "inc")
+
+TURN = 2 * math.pi / 65536
+
+
+def build_host_library(directory):
+    path = os.path.join(directory, "fixmath.so")
+    subprocess.check_call([os.environ.get("CC", "cc"), "-O2", "-shared", "-fPIC",
+                           "-I" + INCLUDE, SOURCE, "-o", path])
+    lib = ctypes.CDLL(path)
+    lib.FIXMATH_Sin.restype = ctypes.c_int16
+    lib.FIXMATH_Sin.argtypes = [ctypes.c_uint16]
+    lib.FIXMATH_Cos.restype = ctypes.c_int16
+    lib.FIXMATH_Cos.argtypes = [ctypes.c_uint16]
+    lib.FIXMATH_Atan2.restype = ctypes.c_uint16
+    lib.FIXMATH_Atan2.argtypes = [ctypes.c_int32, ctypes.c_int32]
+    lib.FIXMATH_Sqrt32.restype = ctypes.c_uint16
+    lib.FIXMATH_Sqrt32.argtypes = [ctypes.c_uint32]
+    lib.FIXMATH_SqrtQ16.restype = ctypes.c_int32
+    lib.FIXMATH_SqrtQ16.argtypes = [ctypes.c_int32]
+    lib.FIXMATH_Q16Mul.restype = ctypes.c_int32
+    lib.FIXMATH_Q16Mul.argtypes = [ctypes.c_int32, ctypes.c_int32]
+    lib.FIXMATH_IIR1Update.restype = ctypes.c_int16
+    lib.FIXMATH_IIR1Update.argtypes = [ctypes.c_void_p, ctypes.c_int16]
+    lib.FIXMATH_AverageUpdate.restype = ctypes.c_int16
+    lib.FIXMATH_AverageUpdate.argtypes = [ctypes.c_void_p, ctypes.c_int16]
+    return lib
+
+
+class Iir1(ctypes.Structure):
+    _fields_ = [("state", ctypes.c_int32), ("shift", ctypes.c_uint8)]
+
+
+class Average(ctypes.Structure):
+    _fields_ = [("buffer", ctypes.POINTER(ctypes.c_int16)), ("sum", ctypes.c_int32),
+                ("order", ctypes.c_uint8), ("index", ctypes.c_uint16)]
+
+
+def angle_error(result, reference):
+    """Difference of two angles in FIXMATH_ANGLE units, wrapped to +-half a turn."""
+    return (result - reference + 32768) % 65536 - 32768
+
+
+def random_vector(rng):
+    while True:
+        x = rng.randint(-2 ** 31, 2 ** 31 - 1) >> rng.randint(0, 31)
+        y = rng.randint(-2 ** 31, 2 ** 31 - 1) >> rng.randint(0, 31)
+        if x or y:
+            return x, y
+
+
+def check_accuracy(lib, rng):
+    """Returns [(name, max error, bound, unit)]."""
+    results = []
+
+    sin_error = cos_error = 0.0
+    for angle in range(65536):
+        sin_error = max(sin_error, abs(lib.FIXMATH_Sin(angle) - min(32767, math.sin(angle * TURN) * 32768)))
+        cos_error = max(cos_error, abs(lib.FIXMATH_Cos(angle) - min(32767, math.cos(angle * TURN) * 32768)))
+    results.append(("FIXMATH_Sin", sin_error, 1.0, "Q15 LSB"))
+    results.append(("FIXMATH_Cos", cos_error, 1.0, "Q15 LSB"))
+
+    error = 0.0
+    for _ in range(200000):
+        x, y = random_vector(rng)
+        error = max(error, abs(angle_error(lib.FIXMATH_Atan2(y, x), math.atan2(y, x) / TURN)))
+    results.append(("FIXMATH_Atan2", error, 1.0, "angle LSB"))
+
+    error = 0
+    values = list(range(70000)) + [0xFFFFFFFF - i for i in range(1000)] + [rng.getrandbits(32) for _ in range(200000)]
+    for value in values:
+        error = max(error, abs(lib.FIXMATH_Sqrt32(value) - math.isqrt(value)))
+    results.append(("FIXMATH_Sqrt32", error, 0, "LSB"))
+
+    error = 0.0
+    values = list(range(1, 70000)) + [0x7FFFFFFF - i for i in range(1000)] + [rng.getrandbits(31) for _ in range(200000)]
+    for value in values:
+        error = max(error, abs(lib.FIXMATH_SqrtQ16(value) - math.sqrt(value / 65536) * 65536))
+    results.append(("FIXMATH_SqrtQ16", error, 1.0, "Q16 LSB"))
+
+    error = 0.0
+    for _ in range(200000):
+        a = rng.randint(-2 ** 31, 2 ** 31 - 1) >> rng.randint(0, 31)
+        b = rng.randint(-2 ** 31, 2 ** 31 - 1) >> rng.randint(0, 31)
+        exact = a * b / 65536
+        if abs(exact) >= 2 ** 31:
+            continue
+        error = max(error, abs(lib.FIXMATH_Q16Mul(a, b) - exact))
+    results.append(("FIXMATH_Q16Mul", error, 0.5, "Q16 LSB"))
+
+    error = 0.0
+    for shift in (1, 4, 8, 12):
+        filt = Iir1()
+        lib.FIXMATH_IIR1Init(ctypes.byref(filt), shift, 0)
+        reference = 0.0
+        for step in range(20000):
+            sample = rng.choice((-32768, 32767)) if step % 5000 < 100 else rng.randint(-32768, 32767)
+            reference += (sample - reference) / (1 << shift)
+            error = max(error, abs(lib.FIXMATH_IIR1Update(ctypes.byref(filt), sample) - reference))
+    results.append(("FIXMATH_IIR1Update", error, 1.0, "LSB"))
+
+    error = 0.0
+    for order in (0, 3, 8):
+        buffer = (ctypes.c_int16 * (1 << order))()
+        average = Average()
+        lib.FIXMATH_AverageInit(ctypes.byref(average), buffer, order)
+        window = [0] * (1 << order)
+        for step in range(5000):
+            sample = rng.randint(-32768, 32767)
+            window[step % len(window)] = sample
+            result = lib.FIXMATH_AverageUpdate(ctypes.byref(average), sample)
+            error = max(error, abs(result - sum(window) / len(window)))
+    results.append(("FIXMATH_AverageUpdate", error, 0.5, "LSB"))
+
+    return results
+
+
+def float_bits(value):
+    return struct.unpack("<I", struct.pack("<f", value))[0]
+
+
+def bits_float(bits):
+    return struct.unpack("<f", struct.pack("<I", bits & 0xFFFFFFFF))[0]
+
+
+def s32(value):
+    value &= 0xFFFFFFFF
+    return value - (1 << 32) if value >> 31 else value
+
+
+def benchmark(lib, paths, rng, count):
+    sys.path.insert(0, TOOLS)
+    from rtlib_bench import Cpu, Image, SimError
+
+    pairs = [
+        ("sin", "FIXMATH_Sin", "sinf"),
+        ("cos", "FIXMATH_Cos", "cosf"),
+        ("atan2", "FIXMATH_Atan2", "atan2f"),
+        ("sqrt (32-bit int)", "FIXMATH_Sqrt32", "sqrtf"),
+        ("sqrt (Q16.16)", "FIXMATH_SqrtQ16", "sqrtf"),
+        ("multiply (Q16.16)", "FIXMATH_Q16Mul", "__mulsf3"),
+    ]
+    image = Image(paths, {name for pair in pairs for name in pair[1:]})
+    cpu = Cpu(image)
+
+    def run(name, args):
+        if name not in image.globals:
+            return None
+        return cpu.call(image.globals[name], args)
+
+    print("%-20s %14s %14s %8s" % ("operation", "fixmath cyc", "libm cyc", "speedup"))
+    try:
+        for label, fixed, floating in pairs:
+            totals = [0, 0]
+            present = [True, True]
+            for _ in range(count):
+                if fixed == "FIXMATH_Atan2":
+                    x, y = random_vector(rng)
+                    fixed_args, host = (y & 0xFFFFFFFF, x & 0xFFFFFFFF), lib.FIXMATH_Atan2(y, x)
+                    float_args, reference = (float_bits(y), float_bits(x)), math.atan2(y, x)
+                elif fixed in ("FIXMATH_Sin", "FIXMATH_Cos"):
+                    angle = rng.getrandbits(16)
+                    fixed_args, host = (angle,), getattr(lib, fixed)(angle)
+                    float_args = (float_bits(angle * TURN),)
+                    reference = (math.sin if fixed == "FIXMATH_Sin" else math.cos)(angle * TURN)
+                elif fixed == "FIXMATH_Sqrt32":
+                    value = rng.getrandbits(32)
+                    fixed_args, host = (value,), lib.FIXMATH_Sqrt32(value)
+                    float_args, reference = (float_bits(value),), math.sqrt(value)
+                elif fixed == "FIXMATH_SqrtQ16":
+                    value = rng.getrandbits(31)
+                    fixed_args, host = (value,), lib.FIXMATH_SqrtQ16(value)
+                    float_args, reference = (float_bits(value / 65536),), math.sqrt(value / 65536)
+                else:
+                    a, b = rng.getrandbits(20) - 2 ** 19, rng.getrandbits(20) - 2 ** 19
+                    fixed_args, host = (a & 0xFFFFFFFF, b & 0xFFFFFFFF), lib.FIXMATH_Q16Mul(a, b)
+                    float_args, reference = (float_bits(a / 65536), float_bits(b / 65536)), a * b / 65536 ** 2
+
+                result = run(fixed, fixed_args)
+                if result is None:
+                    present[0] = False
+                else:
+                    if s32(result[0]) != host:
+                        raise SimError("%s%s = %d on the target, %d on the host" % (fixed, fixed_args, s32(result[0]), host))
+                    totals[0] += result[3]
+
+                result = run(floating, float_args)
+                if result is None:
+                    present[1] = False
+                else:
+                    if abs(bits_float(result[0]) - reference) > 1e-5 * max(1.0, abs(reference)):
+                        raise SimError("%s = %g, expected %g" % (floating, bits_float(result[0]), reference))
+                    totals[1] += result[3]
+
+            cells = ["%14.1f" % (total / count) if ok else "%14s" % "missing" for total, ok in zip(totals, present)]
+            speedup = "%7.1fx" % (totals[1] / totals[0]) if all(present) else "%8s" % "-"
+            print("%-20s %s %s %s" % (label, cells[0], cells[1], speedup))
+    except SimError as error:
+        sys.exit("simulation failed: %s" % error)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Check fixmath.c accuracy and benchmark it against libm.")
+    parser.add_argument("--bench", nargs="+", metavar="OBJ", help="RV32EC fixmath and RTLIB objects")
+    parser.add_argument("--libs", nargs="*", default=[], help="libm.a, libc_nano.a, libgcc.a")
+    parser.add_argument("--count", type=int, default=100, help="random inputs per benchmark")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+    with tempfile.TemporaryDirectory() as directory:
+        lib = build_host_library(directory)
+
+        failed = False
+        print("%-22s %12s %8s  %s" % ("function", "max error", "bound", "unit"))
+        for name, error, bound, unit in check_accuracy(lib, rng):
+            ok = error <= bound + 1e-9
+            failed |= not ok
+            print("%-22s %12.4f %8.1f  %-10s %s" % (name, error, bound, unit, "ok" if ok else "FAIL"))
+
+        if args.bench:
+            print()
+            benchmark(lib, args.bench + args.libs, rng, args.count)
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
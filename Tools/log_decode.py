@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+"""Decoder for the tokenized log stream of Peripheral/src/SYS/log.c.
+
+The format strings never reach the target: they sit in the non-loaded
+.log_fmt section of the ELF, and a message carries only the string's address
+in that section (its 16-bit format ID) and the raw argument words. This tool
+reads the strings from the ELF, then formats the stream from a file, stdin
+or a serial device.
+
+Stream format (little-endian 32-bit words), see Peripheral/inc/SYS/log.h:
+    header: format ID (bits 0..15), argument count (bits 16..18),
+            sequence number (bits 24..31); then one word per argument.
+Stored strings: "<level letter>|<file>:<line>|<format>".
+
+A header that does not match a known format and its argument count is
+skipped one byte at a time, so the decoder also locks onto a stream joined in
+the middle. Sequence gaps are reported as dropped messages.
+
+Usage:
+    log_decode.py obj/CH32V003F4P.elf /dev/ttyUSB0 --baud 115200
+    log_decode.py obj/CH32V003F4P.elf capture.bin
+    log_decode.py obj/CH32V003F4P.elf --list
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from trace_decode import BAUD_RATES, open_input  # noqa: E402
+
+SECTION = ".log_fmt"
+LEVELS = {"E": "ERROR", "W": "WARN", "I": "INFO", "D": "DEBUG"}
+MAX_ARGS = 4
+
+# printf conversion: flags, width, precision, length modifier, conversion
+CONVERSION = re.compile(r"%([-+ #0]*)(\d*)(?:\.(\d+))?(?:hh|h|ll|l|z|j|t)?([diouxXcp%])")
+
+
+def read_section(path, name):
+    """Returns (address, bytes) of a section of a 32- or 64-bit little-endian ELF."""
+    with open(path, "rb") as elf:
+        data = elf.read()
+    if data[:4] != b"\x7fELF" or data[5] != 1:
+        sys.exit("%s: not a little-endian ELF file" % path)
+
+    if data[4] == 1:
+        shoff, = struct.unpack_from("<I", data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x2E)
+        header = struct.Struct("<IIIIIIIIII")
+    else:
+        shoff, = struct.unpack_from("<Q", data, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x3A)
+        header = struct.Struct("<IIQQQQIIQQ")
+
+    sections = [header.unpack_from(data, shoff + index * shentsize) for index in range(shnum)]
+    names = sections[shstrndx]
+    for section in sections:
+        start = names[4] + section[0]
+        if data[start:data.index(b"\0", start)].decode() == name:
+            return section[3], data[section[4]:section[4] + section[5]]
+    sys.exit("%s: no %s section (no log calls, or LOG_ENABLE = 0)" % (path, name))
+
+
+def parse_format(text):
+    """Splits a stored string into (level, location, format, argument count)."""
+    level, location, fmt = text.split("|", 2)
+    count = sum(1 for match in CONVERSION.finditer(fmt) if match.group(4) != "%")
+    return LEVELS.get(level, level), location, fmt, count
+
+
+def read_formats(path):
+    """Maps each format ID (address of its string) to parse_format() fields."""
+    address, data = read_section(path, SECTION)
+    formats = {}
+    offset = 0
+    while offset < len(data):
+        if data[offset] == 0:
+            offset += 1
+            continue
+        end = data.index(b"\0", offset)
+        formats[address + offset] = parse_format(data[offset:end].decode(errors="replace"))
+        offset = end + 1
+    return formats
+
+
+def render(fmt, args):
+    """printf-style formatting of 32-bit argument words."""
+    values = iter(args)
+
+    def convert(match):
+        flags, width, precision, conversion = match.groups()
+        if conversion == "%":
+            return "%"
+        value = next(values)
+        if conversion in "di" and value & 0x80000000:
+            value -= 1 << 32
+        if conversion == "p":
+            return "0x%08x" % value
+        spec = "%" + flags + width + ("." + precision if precision else "") + conversion.replace("u", "d")
+        return spec % value
+
+    return CONVERSION.sub(convert, fmt)
+
+
+def decode(stream, formats, show_location):
+    window = b""
+    expected = None
+
+    while True:
+        while len(window) < 4:
+            chunk = stream.read(4 - len(window))
+            if not chunk:
+                return
+            window += chunk
+
+        header, = struct.unpack("<I", window)
+        ident = header & 0xFFFF
+        count = (header >> 16) & 0x07
+        sequence = header >> 24
+        entry = formats.get(ident)
+
+        if (header >> 19) & 0x1F or count > MAX_ARGS or entry is None or entry[3] != count:
+            window = window[1:]
+            continue
+
+        payload = b""
+        while len(payload) < 4 * count:
+            chunk = stream.read(4 * count - len(payload))
+            if not chunk:
+                return
+            payload += chunk
+        window = b""
+
+        if expected is not None and sequence != expected:
+            print("# %d message(s) dropped" % ((sequence - expected) & 0xFF))
+        expected = (sequence + 1) & 0xFF
+
+        level, location, fmt, _ = entry
+        text = render(fmt, struct.unpack("<%dI" % count, payload))
+        if show_location:
+            print("%-5s %-24s %s" % (level, location, text))
+        else:
+            print("%-5s %s" % (level, text))
+        sys.stdout.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode the tokenized log stream with the format strings from the ELF.")
+    parser.add_argument("elf", help="firmware ELF with the .log_fmt section")
+    parser.add_argument("input", nargs="?", help="capture file, serial device or '-' for stdin")
+    parser.add_argument("--baud", type=int, default=115200, choices=sorted(BAUD_RATES))
+    parser.add_argument("--list", action="store_true", help="print the format table and exit")
+    parser.add_argument("--no-location", action="store_true", help="omit file:line")
+    args = parser.parse_args()
+
+    formats = read_formats(args.elf)
+    if args.list or args.input is None:
+        print("%-6s %-5s %-24s %s" % ("id", "level", "location", "format"))
+        for ident in sorted(formats):
+            level, location, fmt, _ = formats[ident]
+            print("0x%04X %-5s %-24s %s" % (ident, level, location, fmt))
+        return 0
+
+    decode(open_input(args.input, args.baud), formats, not args.no_location)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
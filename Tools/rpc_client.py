@@ -0,0 +1,246 @@
+#!/usr/bin/env python3
+"""Host client for the COBS-framed RPC layer of Middleware/src/RPC/rpc.c.
+
+Frames (see Middleware/inc/RPC/rpc.h), COBS encoded and ended by 0x00:
+    request:  seq | command | payload | CRC-16/CCITT-FALSE (little-endian)
+    response: seq | status  | payload | CRC-16
+
+RpcClient.call() sends one request and waits for its response;
+RpcClient.pipeline() keeps up to --window requests in flight and matches the
+responses by seq. The commands below are the ones of the demo table in
+User/main.c (MAIN_RPC set to 1).
+
+Works on any tty: a USB serial adapter or a pty (see rpc_loopback.py).
+
+Usage:
+    rpc_client.py /dev/ttyUSB0 echo 00ff1234
+    rpc_client.py /dev/ttyUSB0 add 40000 2
+    rpc_client.py /dev/ttyUSB0 stats
+    rpc_client.py /dev/ttyUSB0 --baud 921600 bench --count 2000 --window 4
+"""
+
+import argparse
+import os
+import select
+import struct
+import sys
+import termios
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from trace_decode import BAUD_RATES  # noqa: E402
+
+COMMAND_ECHO = 0
+COMMAND_ADD = 1
+COMMAND_STATS = 2
+COMMAND_UPTIME = 3
+
+STATUS_NAMES = {0: "SUCCESS", 1: "UNKNOWN_COMMAND", 2: "INVALID_LENGTH", 3: "INVALID_ARGUMENT"}
+
+FRAME_SIZE = 64                   # RPC_FRAME_SIZE of the firmware
+PAYLOAD_SIZE = FRAME_SIZE - 4
+
+
+class RpcError(Exception):
+    pass
+
+
+class RpcTimeout(RpcError):
+    pass
+
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE: polynomial 0x1021, initial value 0xFFFF."""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+        crc &= 0xFFFF
+    return crc
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code_index = 0
+    for byte in data:
+        if byte:
+            out.append(byte)
+        if not byte or len(out) - code_index == 0xFF:
+            out[code_index] = len(out) - code_index
+            code_index = len(out)
+            out.append(0)
+    out[code_index] = len(out) - code_index
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    index = 0
+    while index < len(data):
+        code = data[index]
+        if code == 0 or index + code > len(data):
+            raise RpcError("bad COBS code")
+        out += data[index + 1:index + code]
+        index += code
+        if code != 0xFF and index < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def status_name(status):
+    if status >= 0x80:
+        return "USER_%02X" % status
+    return STATUS_NAMES.get(status, "0x%02X" % status)
+
+
+def open_port(path, baud):
+    """Opens a serial device or pty read/write, raw 8N1, non-blocking reads."""
+    fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+    attrs = termios.tcgetattr(fd)
+    attrs[0] = 0                                           # iflag
+    attrs[1] = 0                                           # oflag
+    attrs[2] = termios.CS8 | termios.CREAD | termios.CLOCAL  # cflag
+    attrs[3] = 0                                           # lflag
+    attrs[4] = attrs[5] = BAUD_RATES[baud]
+    attrs[6][termios.VMIN] = 0
+    attrs[6][termios.VTIME] = 0
+    termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    termios.tcflush(fd, termios.TCIOFLUSH)
+    return fd
+
+
+class RpcClient:
+    def __init__(self, fd, timeout=1.0):
+        self.fd = fd
+        self.timeout = timeout
+        self.seq = 0
+        self.pending = bytearray()
+        # End any partial frame left in the device by an earlier session
+        os.write(self.fd, b"\0")
+
+    def send(self, command, payload=b""):
+        """Sends one request, returns its seq."""
+        if len(payload) > PAYLOAD_SIZE:
+            raise RpcError("payload longer than %d bytes" % PAYLOAD_SIZE)
+        seq = self.seq
+        self.seq = (self.seq + 1) & 0xFF
+        self.send_raw(seq, command, payload)
+        return seq
+
+    def send_raw(self, seq, command, payload, corrupt=False):
+        frame = bytes([seq, command]) + bytes(payload)
+        crc = crc16(frame) ^ (1 if corrupt else 0)
+        data = cobs_encode(frame + struct.pack("<H", crc)) + b"\0"
+        while data:
+            data = data[os.write(self.fd, data):]
+
+    def receive(self, timeout=None):
+        """Returns the next valid response as (seq, status, payload)."""
+        deadline = time.monotonic() + (self.timeout if timeout is None else timeout)
+        while True:
+            end = self.pending.find(b"\0")
+            if end >= 0:
+                encoded = bytes(self.pending[:end])
+                del self.pending[:end + 1]
+                if not encoded:
+                    continue
+                try:
+                    frame = cobs_decode(encoded)
+                except RpcError:
+                    continue
+                if len(frame) < 4 or crc16(frame[:-2]) != struct.unpack("<H", frame[-2:])[0]:
+                    continue
+                return frame[0], frame[1], frame[2:-2]
+
+            remaining = deadline - time.monotonic()
+            if remaining <= 0:
+                raise RpcTimeout("no response")
+            if select.select([self.fd], [], [], remaining)[0]:
+                self.pending += os.read(self.fd, 4096)
+
+    def call(self, command, payload=b""):
+        """Sends one request and returns (status, payload) of its response."""
+        seq = self.send(command, payload)
+        while True:
+            response_seq, status, data = self.receive()
+            if response_seq == seq:
+                return status, data
+
+    def pipeline(self, requests, window=4):
+        """Runs (command, payload) requests with up to window in flight.
+
+        Returns the (status, payload) responses in request order. The device
+        answers in order, so a response with an unexpected seq means a
+        request was lost (bad CRC on the way in).
+        """
+        results = []
+        in_flight = []
+        queue = list(requests)
+        while queue or in_flight:
+            while queue and len(in_flight) < window:
+                command, payload = queue.pop(0)
+                in_flight.append(self.send(command, payload))
+            seq, status, data = self.receive()
+            if seq != in_flight[0]:
+                raise RpcError("expected seq %d, got %d" % (in_flight[0], seq))
+            in_flight.pop(0)
+            results.append((status, data))
+        return results
+
+
+def check(status):
+    if status != 0:
+        sys.exit("error: %s" % status_name(status))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Call the RPC commands of the demo firmware.")
+    parser.add_argument("port", help="serial device or pty")
+    parser.add_argument("--baud", type=int, default=115200, choices=sorted(BAUD_RATES))
+    parser.add_argument("--timeout", type=float, default=1.0)
+    commands = parser.add_subparsers(dest="command", required=True)
+    echo = commands.add_parser("echo", help="echo a hex payload")
+    echo.add_argument("data", nargs="?", default="")
+    add = commands.add_parser("add", help="add two 32-bit numbers on the device")
+    add.add_argument("a", type=int)
+    add.add_argument("b", type=int)
+    commands.add_parser("stats", help="RPC frame counters")
+    commands.add_parser("uptime", help="milliseconds since reset")
+    bench = commands.add_parser("bench", help="pipelined echo round trips")
+    bench.add_argument("--count", type=int, default=1000)
+    bench.add_argument("--window", type=int, default=4)
+    bench.add_argument("--size", type=int, default=32, help="payload bytes")
+    args = parser.parse_args()
+
+    client = RpcClient(open_port(args.port, args.baud), args.timeout)
+
+    if args.command == "echo":
+        status, data = client.call(COMMAND_ECHO, bytes.fromhex(args.data))
+        check(status)
+        print(data.hex())
+    elif args.command == "add":
+        status, data = client.call(COMMAND_ADD, struct.pack("<II", args.a & 0xFFFFFFFF, args.b & 0xFFFFFFFF))
+        check(status)
+        print(struct.unpack("<I", data)[0])
+    elif args.command == "stats":
+        status, data = client.call(COMMAND_STATS)
+        check(status)
+        print("requests %d  crc errors %d  overflows %d" % struct.unpack("<III", data))
+    elif args.command == "uptime":
+        status, data = client.call(COMMAND_UPTIME)
+        check(status)
+        print("%d ms" % struct.unpack("<I", data)[0])
+    else:
+        payloads = [os.urandom(args.size) for _ in range(args.count)]
+        start = time.monotonic()
+        results = client.pipeline([(COMMAND_ECHO, payload) for payload in payloads], args.window)
+        seconds = time.monotonic() - start
+        bad = sum(1 for payload, (status, data) in zip(payloads, results) if status != 0 or data != payload)
+        print("%d calls in %.2f s: %.0f calls/s, %d mismatched" % (args.count, seconds, args.count / seconds, bad))
+        return 1 if bad else 0
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
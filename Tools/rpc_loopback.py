@@ -0,0 +1,322 @@
+#!/usr/bin/env python3
+"""Loopback test of Middleware/src/RPC/rpc.c against rpc_client.py over a pty.
+
+Builds rpc.c for the host together with a stand-in for the USART1 driver
+that moves bytes to and from the slave side of a pty, runs it as the device
+and drives it through the master side with RpcClient. Each build variant
+covers one driver configuration:
+
+    dma       USART_TX_DMA: responses sent as chain segments, completed one
+              per loop pass, so pipelined requests wait for a free buffer
+    dma-1     as dma with RPC_TX_BUFFERS = 1
+    ring      USART_TX_DMA = 0: responses copied into the TX ring
+    rx-views  USART_RX_DMA: requests read from receive views in a 128-byte
+              circular buffer, split at its wrap
+
+The checks cover echo of every payload length with and without zero bytes,
+the table length limits, unknown commands, bad CRCs, broken COBS frames,
+overlong frames, pipelined calls and the frame counters. Exit status 1 on
+the first failure.
+
+Usage:
+    rpc_loopback.py
+    rpc_loopback.py --variant ring --calls 5000
+"""
+
+import argparse
+import os
+import random
+import struct
+import subprocess
+import sys
+import tempfile
+import tty
+
+TOOLS = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.dirname(TOOLS)
+SOURCE = os.path.join(ROOT, "Middleware", "src", "RPC", "rpc.c")
+INCLUDES = [os.path.join(ROOT, "Middleware", "inc"), os.path.join(ROOT, "Peripheral", "inc")]
+
+sys.path.insert(0, TOOLS)
+from rpc_client import (COMMAND_ADD, COMMAND_ECHO, COMMAND_STATS, PAYLOAD_SIZE,  # noqa: E402
+                        RpcClient, RpcTimeout)
+
+VARIANTS = {
+    "dma": ["-DUSART_TX_DMA=1", "-DUSART_RX_DMA=0"],
+    "dma-1": ["-DUSART_TX_DMA=1", "-DUSART_RX_DMA=0", "-DRPC_TX_BUFFERS=1"],
+    "ring": ["-DUSART_TX_DMA=0", "-DUSART_RX_DMA=0"],
+    "rx-views": ["-DUSART_TX_DMA=1", "-DUSART_RX_DMA=1"],
+}
+
+# Host stand-in for the parts of USART/usart.h that rpc.c uses, and the
+# command table of User/main.c (uptime left out).
+DEVICE = r"""
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include "RPC/rpc.h"
+#include "USART/usart.h"
+
+static int port;
+static USART_SEGMENT *chainHead;
+
+#if USART_RX_DMA
+static uint8_t dmaBuffer[USART_RX_DMA_SIZE];
+static uint16_t dmaPosition;
+static uint16_t dmaPending;
+static USART_RX_VIEW views[USART_RX_VIEW_DEPTH];
+static uint8_t viewHead;
+static uint8_t viewTail;
+
+uint8_t *USART_GetRxDmaBuffer(void)
+{
+    return dmaBuffer;
+}
+
+USART_STATUS USART_PeekRxView(USART_RX_VIEW *view)
+{
+    if (viewHead == viewTail)
+        return USART_STATUS_EMPTY;
+    *view = views[viewTail % USART_RX_VIEW_DEPTH];
+    return USART_STATUS_SUCCESS;
+}
+
+void USART_ReleaseRxView(void)
+{
+    dmaPending -= views[viewTail % USART_RX_VIEW_DEPTH].length;
+    viewTail++;
+}
+
+static void Receive(void)
+{
+    uint16_t room = USART_RX_DMA_SIZE - dmaPending;
+    uint16_t toWrap = USART_RX_DMA_SIZE - dmaPosition;
+    ssize_t count;
+
+    if ((uint8_t)(viewHead - viewTail) == USART_RX_VIEW_DEPTH)
+        return;
+    if (room > toWrap)
+        room = toWrap;
+    count = read(port, &dmaBuffer[dmaPosition], room);
+    if (count <= 0)
+        return;
+
+    views[viewHead % USART_RX_VIEW_DEPTH] = (USART_RX_VIEW){dmaPosition, (uint16_t)count, 1};
+    viewHead++;
+    dmaPending += count;
+    dmaPosition = (dmaPosition + count) % USART_RX_DMA_SIZE;
+}
+#else
+uint16_t USART_Read(uint8_t *data, uint16_t length)
+{
+    ssize_t count = length ? read(port, data, length) : 0;
+
+    return count > 0 ? (uint16_t)count : 0;
+}
+
+static void Receive(void)
+{
+}
+#endif
+
+static void WriteAll(const uint8_t *data, uint16_t length)
+{
+    while (length)
+    {
+        ssize_t count = write(port, data, length);
+
+        if (count > 0)
+        {
+            data += count;
+            length -= count;
+        }
+    }
+}
+
+uint16_t USART_Write(const uint8_t *data, uint16_t length)
+{
+    WriteAll(data, length);
+    return length;
+}
+
+USART_STATUS USART_WriteChain(USART_SEGMENT *chain)
+{
+    USART_SEGMENT **last = &chainHead;
+
+    while (*last != NULL)
+        last = &(*last)->next;
+    *last = chain;
+    return USART_STATUS_SUCCESS;
+}
+
+/* One "DMA transfer complete" per loop pass */
+static void SendSegment(void)
+{
+    USART_SEGMENT *segment = chainHead;
+    struct pollfd input = {port, POLLIN, 0};
+
+    if (segment == NULL)
+    {
+        poll(&input, 1, 10);
+        return;
+    }
+    WriteAll(segment->data, segment->length);
+    chainHead = segment->next;
+    if (segment->done != NULL)
+        segment->done(segment);
+}
+
+static uint8_t RpcEcho(const uint8_t *request, uint8_t length, uint8_t *response, uint8_t *responseLength)
+{
+    memcpy(response, request, length);
+    *responseLength = length;
+    return RPC_STATUS_SUCCESS;
+}
+
+static uint8_t RpcAdd(const uint8_t *request, uint8_t length, uint8_t *response, uint8_t *responseLength)
+{
+    RPC_PutU32(response, RPC_GetU32(&request[0]) + RPC_GetU32(&request[4]));
+    *responseLength = 4;
+    return RPC_STATUS_SUCCESS;
+}
+
+static uint8_t RpcStats(const uint8_t *request, uint8_t length, uint8_t *response, uint8_t *responseLength)
+{
+    RPC_STATS stats;
+
+    RPC_GetStats(&stats);
+    RPC_PutU32(&response[0], stats.requests);
+    RPC_PutU32(&response[4], stats.crcErrors);
+    RPC_PutU32(&response[8], stats.overflows);
+    *responseLength = 12;
+    return RPC_STATUS_SUCCESS;
+}
+
+static const RPC_COMMAND commands[] = {
+    {RpcEcho, 0, RPC_PAYLOAD_SIZE},
+    {RpcAdd, 8, 8},
+    {RpcStats, 0, 0}};
+
+int main(int argc, char **argv)
+{
+    struct termios attrs;
+
+    port = open(argv[1], O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (argc != 2 || port < 0)
+        return 2;
+    tcgetattr(port, &attrs);
+    cfmakeraw(&attrs);
+    tcsetattr(port, TCSANOW, &attrs);
+
+    RPC_Init(commands, sizeof(commands) / sizeof(commands[0]));
+    while (1)
+    {
+        Receive();
+        RPC_Poll();
+        SendSegment();
+    }
+}
+"""
+
+
+def build_device(directory, variant):
+    source = os.path.join(directory, "device.c")
+    path = os.path.join(directory, "device-" + variant)
+    with open(source, "w") as out:
+        out.write(DEVICE)
+    subprocess.check_call([os.environ.get("CC", "cc"), "-O1", "-Wall", "-Wno-unused-parameter"] +
+                          ["-I" + include for include in INCLUDES] + VARIANTS[variant] +
+                          [source, SOURCE, "-o", path])
+    return path
+
+
+def expect(condition, message):
+    if not condition:
+        raise AssertionError(message)
+
+
+def stats(client):
+    status, data = client.call(COMMAND_STATS)
+    expect(status == 0, "stats status %d" % status)
+    return struct.unpack("<III", data)
+
+
+def expect_silence(client, message):
+    try:
+        client.receive(timeout=0.2)
+    except RpcTimeout:
+        return
+    raise AssertionError(message)
+
+
+def run_checks(client, rng, calls):
+    for length in range(PAYLOAD_SIZE + 1):
+        for payload in (bytes(length), bytes(rng.randrange(1, 256) for _ in range(length)),
+                        bytes(rng.choice((0, rng.randrange(256))) for _ in range(length))):
+            status, data = client.call(COMMAND_ECHO, payload)
+            expect(status == 0 and data == payload, "echo of %d bytes: %s" % (length, payload.hex()))
+
+    status, data = client.call(COMMAND_ADD, struct.pack("<II", 0xFFFFFFFF, 3))
+    expect(status == 0 and data == struct.pack("<I", 2), "add wraps")
+    status, _ = client.call(COMMAND_ADD, bytes(7))
+    expect(status == 2, "short add payload gives INVALID_LENGTH, got %d" % status)
+    status, _ = client.call(COMMAND_STATS, b"\1")
+    expect(status == 2, "stats with a payload gives INVALID_LENGTH, got %d" % status)
+    status, _ = client.call(0x7F)
+    expect(status == 1, "unknown command gives UNKNOWN_COMMAND, got %d" % status)
+
+    requests, crc_errors, overflows = stats(client)
+
+    client.send_raw(200, COMMAND_ECHO, b"bad", corrupt=True)
+    expect_silence(client, "frame with a bad CRC was answered")
+    os.write(client.fd, b"\x05\x01\x02\0")          # code points past the end
+    os.write(client.fd, b"\x02\x01\0")              # shorter than seq, command and CRC
+    expect_silence(client, "broken COBS frame was answered")
+    client.send_raw(201, COMMAND_ECHO, bytes(range(1, PAYLOAD_SIZE + 2)))
+    os.write(client.fd, bytes(rng.randrange(1, 256) for _ in range(300)) + b"\0")
+    expect_silence(client, "overlong frame was answered")
+    expect(stats(client) == (requests + 1, crc_errors + 3, overflows + 2),
+           "counters after bad frames: %s" % (stats(client),))
+
+    payloads = [bytes(rng.choice((0, rng.randrange(256))) for _ in range(rng.randrange(PAYLOAD_SIZE + 1)))
+                for _ in range(calls)]
+    for window in (1, 3, 8):
+        results = client.pipeline([(COMMAND_ECHO, payload) for payload in payloads], window)
+        for index, (payload, (status, data)) in enumerate(zip(payloads, results)):
+            expect(status == 0 and data == payload, "pipelined echo %d, window %d" % (index, window))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Run rpc.c against the host client over a pty.")
+    parser.add_argument("--variant", choices=sorted(VARIANTS), action="append",
+                        help="driver configuration (default: all)")
+    parser.add_argument("--calls", type=int, default=500, help="pipelined calls per window size")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    failed = False
+    with tempfile.TemporaryDirectory() as directory:
+        for variant in args.variant or sorted(VARIANTS):
+            master, slave = os.openpty()
+            tty.setraw(slave)
+            device = subprocess.Popen([build_device(directory, variant), os.ttyname(slave)])
+            try:
+                run_checks(RpcClient(master), random.Random(args.seed), args.calls)
+                print("%-9s ok" % variant)
+            except (AssertionError, RpcTimeout) as error:
+                print("%-9s FAIL: %s" % (variant, error))
+                failed = True
+            finally:
+                device.kill()
+                device.wait()
+                os.close(master)
+                os.close(slave)
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
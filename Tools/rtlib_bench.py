@@ -0,0 +1,687 @@
+#!/usr/bin/env python3
+"""Cycle benchmark of the RTLIB runtime routines against libgcc/newlib.
+
+Links two sets of RV32EC objects in memory (the project RTLIB objects and
+the toolchain libgcc.a / libc_nano.a), runs __mulsi3, __udivsi3, __umodsi3,
+__divsi3, __modsi3, memcpy, memmove and memset of each set on a small RV32EC
+instruction set simulator, checks every result against Python and prints
+the average instruction and cycle counts per operand class.
+
+Inputs are relocatable objects (.o, loaded whole) and archives (.a, members
+are loaded on demand to resolve the benchmarked symbols). Both sets must be
+built for plain rv32ec: the WCH XW compressed extension is not simulated.
+
+Cycle model: one cycle per instruction, plus one for loads and one for taken
+branches and jumps. Flash wait states are not modelled.
+
+Without --baseline only the RTLIB routines are checked and timed. Speedups
+are only meaningful against the archives of the toolchain the firmware is
+linked with, not against rewritten copies of their routines.
+
+Usage:
+    rtlib_bench.py --candidate rtlib_arith.o rtlib_mem.o \\
+                   --baseline libgcc.a libc_nano.a
+    rtlib_bench.py --candidate rtlib_arith.o rtlib_mem.o
+"""
+
+import argparse
+import random
+import struct
+import sys
+
+CODE_BASE = 0x00000100
+CODE_SIZE = 0x10000
+RAM_BASE = 0x20000000
+RAM_SIZE = 0x10000
+RETURN_ADDRESS = 0x00000000  # Nothing is placed below CODE_BASE
+MAX_STEPS = 100000
+
+SHF_ALLOC = 0x2
+SHT_PROGBITS = 1
+SHT_SYMTAB = 2
+SHT_RELA = 4
+SHT_NOBITS = 8
+SHN_UNDEF = 0
+SHN_ABS = 0xFFF1
+STB_LOCAL = 0
+
+MASK32 = 0xFFFFFFFF
+
+
+def sext(value, bits):
+    value &= (1 << bits) - 1
+    return value - (1 << bits) if value >> (bits - 1) else value
+
+
+# --- Object file loading ---
+
+
+class ElfObject:
+    """Sections, symbols and relocations of an ELF32 little-endian relocatable object."""
+
+    def __init__(self, name, data):
+        self.name = name
+        if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+            raise ValueError("%s: not an ELF32 little-endian file" % name)
+        if struct.unpack_from("<H", data, 16)[0] != 1:
+            raise ValueError("%s: not a relocatable object" % name)
+
+        shoff, = struct.unpack_from("<I", data, 32)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 46)
+        self.sections = []
+        for index in range(shnum):
+            fields = struct.unpack_from("<IIIIIIIIII", data, shoff + index * shentsize)
+            self.sections.append(dict(zip(
+                ("name", "type", "flags", "addr", "offset", "size", "link", "info", "align", "entsize"),
+                fields)))
+
+        shstr = self.sections[shstrndx]
+        for section in self.sections:
+            section["name"] = self._string(data, shstr, section["name"])
+            section["data"] = data[section["offset"]:section["offset"] + section["size"]]
+
+        self.symbols = []
+        self.relocations = []
+        for section in self.sections:
+            if section["type"] == SHT_SYMTAB:
+                strtab = self.sections[section["link"]]
+                for offset in range(0, section["size"], 16):
+                    name, value, size, info, _, shndx = struct.unpack_from("<IIIBBH", section["data"], offset)
+                    self.symbols.append({
+                        "name": self._string(data, strtab, name),
+                        "value": value,
+                        "bind": info >> 4,
+                        "type": info & 0x0F,
+                        "shndx": shndx,
+                    })
+            elif section["type"] == SHT_RELA:
+                for offset in range(0, section["size"], 12):
+                    where, info, addend = struct.unpack_from("<IIi", section["data"], offset)
+                    self.relocations.append((section["info"], where, info >> 8, info & 0xFF, addend))
+
+    @staticmethod
+    def _string(data, table, offset):
+        start = table["offset"] + offset
+        return data[start:data.index(b"\0", start)].decode()
+
+    def defined(self):
+        """Global symbols defined by this object."""
+        return {s["name"] for s in self.symbols if s["bind"] != STB_LOCAL and s["shndx"] != SHN_UNDEF}
+
+    def undefined(self):
+        return {s["name"] for s in self.symbols if s["bind"] != STB_LOCAL and s["shndx"] == SHN_UNDEF and s["name"]}
+
+
+def read_archive(path, data):
+    """Returns the object members of a System V / GNU ar archive."""
+    if data[:8] != b"!<arch>\n":
+        raise ValueError("%s: not an archive" % path)
+
+    members = []
+    long_names = b""
+    offset = 8
+    while offset + 60 <= len(data):
+        header = data[offset:offset + 60]
+        name = header[:16].decode().rstrip()
+        size = int(header[48:58].decode())
+        body = data[offset + 60:offset + 60 + size]
+        offset += 60 + size + (size & 1)
+
+        if name == "//":
+            long_names = body
+        elif name in ("/", "/SYM64/"):
+            continue
+        else:
+            if name.startswith("/") and name[1:].isdigit():
+                start = int(name[1:])
+                name = long_names[start:long_names.index(b"/\n", start)].decode()
+            members.append(ElfObject("%s(%s)" % (path, name.rstrip("/")), body))
+    return members
+
+
+class Image:
+    """Objects linked at CODE_BASE, with the global symbol table."""
+
+    def __init__(self, paths, needed):
+        whole, lazy = [], []
+        for path in paths:
+            with open(path, "rb") as handle:
+                data = handle.read()
+            if data[:8] == b"!<arch>\n":
+                lazy.extend(read_archive(path, data))
+            else:
+                whole.append(ElfObject(path, data))
+
+        self.objects = list(whole)
+        defined = set()
+        for obj in self.objects:
+            defined |= obj.defined()
+
+        # Pull archive members until every referenced symbol is defined
+        providers = {}
+        for member in lazy:
+            for symbol in member.defined():
+                providers.setdefault(symbol, member)
+        wanted = set(needed)
+        for obj in self.objects:
+            wanted |= obj.undefined()
+        while wanted - defined:
+            symbol = sorted(wanted - defined)[0]
+            member = providers.get(symbol)
+            if member is None:
+                if symbol in needed:
+                    wanted.discard(symbol)
+                    continue
+                raise ValueError("undefined symbol %s" % symbol)
+            self.objects.append(member)
+            defined |= member.defined()
+            wanted |= member.undefined()
+
+        self.memory = bytearray(CODE_SIZE)
+        self._layout()
+        self._relocate()
+
+    def _layout(self):
+        cursor = CODE_BASE
+        self.globals = {}
+        for obj in self.objects:
+            obj.base = {}
+            for index, section in enumerate(obj.sections):
+                if not section["flags"] & SHF_ALLOC or section["type"] not in (SHT_PROGBITS, SHT_NOBITS):
+                    continue
+                if section["name"].startswith(".eh_frame"):
+                    continue
+                align = max(section["align"], 1)
+                cursor = (cursor + align - 1) // align * align
+                obj.base[index] = cursor
+                if section["type"] == SHT_PROGBITS:
+                    self.memory[cursor - CODE_BASE:cursor - CODE_BASE + section["size"]] = section["data"]
+                cursor += section["size"]
+            if cursor - CODE_BASE > CODE_SIZE:
+                raise ValueError("image larger than %d bytes" % CODE_SIZE)
+
+            for symbol in obj.symbols:
+                if symbol["bind"] != STB_LOCAL and symbol["shndx"] in obj.base:
+                    self.globals.setdefault(symbol["name"], obj.base[symbol["shndx"]] + symbol["value"])
+
+    def _symbol_address(self, obj, index):
+        symbol = obj.symbols[index]
+        if index == 0:
+            return 0
+        if symbol["shndx"] == SHN_UNDEF:
+            return self.globals[symbol["name"]]
+        if symbol["shndx"] == SHN_ABS:
+            return symbol["value"]
+        return obj.base[symbol["shndx"]] + symbol["value"]
+
+    def _relocate(self):
+        for obj in self.objects:
+            pcrel_hi = {}
+            pending_lo = []
+            for section, where, sym, kind, addend in obj.relocations:
+                if section not in obj.base:
+                    continue
+                place = obj.base[section] + where
+                value = (self._symbol_address(obj, sym) + addend) & MASK32
+                if kind == 23:
+                    pcrel_hi[place] = (value - place) & MASK32
+                if kind in (24, 25):
+                    pending_lo.append((place, kind, self._symbol_address(obj, sym)))
+                else:
+                    self._apply(place, kind, value)
+            for place, kind, label in pending_lo:
+                offset = pcrel_hi[label]
+                self._apply(place, 27 if kind == 24 else 28, offset - ((offset + 0x800) & ~0xFFF))
+
+    def _read(self, place, size):
+        return int.from_bytes(self.memory[place - CODE_BASE:place - CODE_BASE + size], "little")
+
+    def _write(self, place, size, value):
+        self.memory[place - CODE_BASE:place - CODE_BASE + size] = (value & ((1 << (8 * size)) - 1)).to_bytes(size, "little")
+
+    def _apply(self, place, kind, value):
+        pcrel = (value - place) & MASK32
+        if kind == 1:                     # R_RISCV_32
+            self._write(place, 4, value)
+        elif kind == 16:                  # R_RISCV_BRANCH
+            inst = self._read(place, 4) & 0x01FFF07F
+            imm = pcrel
+            inst |= ((imm >> 12) & 1) << 31 | ((imm >> 5) & 0x3F) << 25 | ((imm >> 1) & 0xF) << 8 | ((imm >> 11) & 1) << 7
+            self._write(place, 4, inst)
+        elif kind == 17:                  # R_RISCV_JAL
+            inst = self._read(place, 4) & 0xFFF
+            imm = pcrel
+            inst |= ((imm >> 20) & 1) << 31 | ((imm >> 1) & 0x3FF) << 21 | ((imm >> 11) & 1) << 20 | ((imm >> 12) & 0xFF) << 12
+            self._write(place, 4, inst)
+        elif kind in (18, 19):            # R_RISCV_CALL, R_RISCV_CALL_PLT
+            hi = (pcrel + 0x800) & 0xFFFFF000
+            self._write(place, 4, (self._read(place, 4) & 0xFFF) | hi)
+            self._write(place + 4, 4, (self._read(place + 4, 4) & 0xFFFFF) | ((pcrel - hi) & 0xFFF) << 20)
+        elif kind == 23:                  # R_RISCV_PCREL_HI20
+            self._write(place, 4, (self._read(place, 4) & 0xFFF) | ((pcrel + 0x800) & 0xFFFFF000))
+        elif kind == 26:                  # R_RISCV_HI20
+            self._write(place, 4, (self._read(place, 4) & 0xFFF) | ((value + 0x800) & 0xFFFFF000))
+        elif kind == 27:                  # R_RISCV_LO12_I
+            self._write(place, 4, (self._read(place, 4) & 0xFFFFF) | (value & 0xFFF) << 20)
+        elif kind == 28:                  # R_RISCV_LO12_S
+            inst = self._read(place, 4) & 0x01FFF07F
+            self._write(place, 4, inst | ((value >> 5) & 0x7F) << 25 | (value & 0x1F) << 7)
+        elif kind == 44:                  # R_RISCV_RVC_BRANCH
+            inst = self._read(place, 2) & 0xE383
+            imm = pcrel
+            inst |= ((imm >> 8) & 1) << 12 | ((imm >> 3) & 3) << 10 | ((imm >> 6) & 3) << 5 | ((imm >> 1) & 3) << 3 | ((imm >> 5) & 1) << 2
+            self._write(place, 2, inst)
+        elif kind == 45:                  # R_RISCV_RVC_JUMP
+            inst = self._read(place, 2) & 0xE003
+            imm = pcrel
+            inst |= (((imm >> 11) & 1) << 12 | ((imm >> 4) & 1) << 11 | ((imm >> 8) & 3) << 9 | ((imm >> 10) & 1) << 8
+                     | ((imm >> 6) & 1) << 7 | ((imm >> 7) & 1) << 6 | ((imm >> 1) & 7) << 3 | ((imm >> 5) & 1) << 2)
+            self._write(place, 2, inst)
+        elif kind in (43, 51):            # R_RISCV_ALIGN, R_RISCV_RELAX: nothing is relaxed
+            pass
+        else:
+            raise ValueError("unsupported relocation type %d at 0x%08X" % (kind, place))
+
+
+# --- RV32EC simulator ---
+
+
+class SimError(Exception):
+    pass
+
+
+class Cpu:
+    """RV32EC core: 16 registers, flat code image and RAM."""
+
+    def __init__(self, image):
+        self.code = image.memory
+        self.ram = bytearray(RAM_SIZE)
+
+    def _region(self, address, size):
+        if CODE_BASE <= address and address + size <= CODE_BASE + CODE_SIZE:
+            return self.code, address - CODE_BASE
+        if RAM_BASE <= address and address + size <= RAM_BASE + RAM_SIZE:
+            return self.ram, address - RAM_BASE
+        raise SimError("access outside memory at 0x%08X" % address)
+
+    def load(self, address, size, signed=False):
+        if address % size:
+            raise SimError("misaligned %d-byte load at 0x%08X" % (size, address))
+        memory, offset = self._region(address, size)
+        value = int.from_bytes(memory[offset:offset + size], "little")
+        return sext(value, 8 * size) & MASK32 if signed else value
+
+    def store(self, address, size, value):
+        if address % size:
+            raise SimError("misaligned %d-byte store at 0x%08X" % (size, address))
+        memory, offset = self._region(address, size)
+        memory[offset:offset + size] = (value & ((1 << (8 * size)) - 1)).to_bytes(size, "little")
+
+    def call(self, address, args):
+        """Runs a function until it returns, returns (a0, a1, instructions, cycles)."""
+        x = [0] * 16
+        x[1] = RETURN_ADDRESS
+        x[2] = RAM_BASE + RAM_SIZE
+        for index, value in enumerate(args):
+            x[10 + index] = value & MASK32
+
+        pc = address
+        instructions = cycles = 0
+        while pc != RETURN_ADDRESS:
+            if instructions >= MAX_STEPS:
+                raise SimError("no return after %d instructions" % MAX_STEPS)
+            instructions += 1
+            cycles += 1
+            inst = self.load(pc, 2)
+            if inst & 3 == 3:
+                inst |= self.load(pc + 2, 2) << 16
+                next_pc, extra = self._execute32(x, pc, inst)
+            else:
+                next_pc, extra = self._execute16(x, pc, inst)
+            cycles += extra
+            x[0] = 0
+            pc = next_pc & MASK32
+        return x[10], x[11], instructions, cycles
+
+    @staticmethod
+    def _reg(index, pc):
+        if index > 15:
+            raise SimError("x%d is not an RV32E register (pc 0x%08X)" % (index, pc))
+        return index
+
+    def _execute32(self, x, pc, inst):
+        opcode = inst & 0x7F
+        rd = (inst >> 7) & 31
+        f3 = (inst >> 12) & 7
+        rs1 = (inst >> 15) & 31
+        rs2 = (inst >> 20) & 31
+        f7 = inst >> 25
+        nxt = pc + 4
+
+        # Check the register fields each format actually has
+        if opcode in (0x37, 0x17, 0x6F, 0x67, 0x03, 0x13, 0x33):
+            self._reg(rd, pc)
+        if opcode in (0x67, 0x63, 0x03, 0x23, 0x13, 0x33):
+            self._reg(rs1, pc)
+        if opcode in (0x63, 0x23, 0x33):
+            self._reg(rs2, pc)
+        a = x[rs1 & 15]
+
+        if opcode == 0x37:                                        # LUI
+            x[rd] = inst & 0xFFFFF000
+        elif opcode == 0x17:                                      # AUIPC
+            x[rd] = (pc + (inst & 0xFFFFF000)) & MASK32
+        elif opcode == 0x6F:                                      # JAL
+            imm = sext(((inst >> 31) & 1) << 20 | ((inst >> 12) & 0xFF) << 12
+                       | ((inst >> 20) & 1) << 11 | ((inst >> 21) & 0x3FF) << 1, 21)
+            x[rd] = nxt
+            return pc + imm, 1
+        elif opcode == 0x67:                                      # JALR
+            target = (a + sext(inst >> 20, 12)) & ~1
+            x[rd] = nxt
+            return target, 1
+        elif opcode == 0x63:                                      # Branches
+            b = x[rs2]
+            imm = sext(((inst >> 31) & 1) << 12 | ((inst >> 7) & 1) << 11
+                       | ((inst >> 25) & 0x3F) << 5 | ((inst >> 8) & 0xF) << 1, 13)
+            taken = {
+                0: a == b, 1: a != b,
+                4: sext(a, 32) < sext(b, 32), 5: sext(a, 32) >= sext(b, 32),
+                6: a < b, 7: a >= b,
+            }.get(f3)
+            if taken is None:
+                raise SimError("illegal branch 0x%08X at 0x%08X" % (inst, pc))
+            return (pc + imm, 1) if taken else (nxt, 0)
+        elif opcode == 0x03:                                      # Loads
+            address = (a + sext(inst >> 20, 12)) & MASK32
+            size, signed = {0: (1, True), 1: (2, True), 2: (4, False), 4: (1, False), 5: (2, False)}[f3]
+            x[rd] = self.load(address, size, signed)
+            return nxt, 1
+        elif opcode == 0x23:                                      # Stores
+            imm = sext((f7 << 5) | ((inst >> 7) & 31), 12)
+            self.store((a + imm) & MASK32, {0: 1, 1: 2, 2: 4}[f3], x[rs2])
+        elif opcode in (0x13, 0x33):                              # ALU
+            if opcode == 0x33:
+                if f7 == 1:
+                    raise SimError("M extension instruction at 0x%08X" % pc)
+                b = x[rs2]
+            else:
+                b = sext(inst >> 20, 12) & MASK32
+            x[rd] = self._alu(f3, a, b, f7 == 0x20, opcode == 0x33) & MASK32
+        elif opcode == 0x0F:                                      # FENCE
+            pass
+        else:
+            raise SimError("unsupported instruction 0x%08X at 0x%08X" % (inst, pc))
+        return nxt, 0
+
+    @staticmethod
+    def _alu(f3, a, b, alt, register):
+        shamt = b & 31
+        if f3 == 0:
+            return a - b if alt and register else a + b
+        if f3 == 1:
+            return a << shamt
+        if f3 == 2:
+            return int(sext(a, 32) < sext(b, 32))
+        if f3 == 3:
+            return int(a < (b & MASK32))
+        if f3 == 4:
+            return a ^ b
+        if f3 == 5:
+            return sext(a, 32) >> shamt if alt else a >> shamt
+        if f3 == 6:
+            return a | b
+        return a & b
+
+    def _execute16(self, x, pc, inst):
+        quadrant = inst & 3
+        f3 = inst >> 13
+        rd = (inst >> 7) & 31
+        rs2 = (inst >> 2) & 31
+        rdp = 8 + ((inst >> 7) & 7)
+        rs2p = 8 + ((inst >> 2) & 7)
+        imm6 = sext(((inst >> 12) & 1) << 5 | ((inst >> 2) & 31), 6)
+        nxt = pc + 2
+
+        # Full register fields of CI/CR/CSS formats
+        if (quadrant == 1 and f3 in (0, 2, 3)) or (quadrant == 2 and f3 in (0, 2, 4)):
+            self._reg(rd, pc)
+        if quadrant == 2 and f3 in (4, 6):
+            self._reg(rs2, pc)
+
+        def illegal():
+            raise SimError("unsupported compressed instruction 0x%04X at 0x%08X" % (inst, pc))
+
+        if quadrant == 0:
+            offset = ((inst >> 10) & 7) << 3 | ((inst >> 6) & 1) << 2 | ((inst >> 5) & 1) << 6
+            if f3 == 0 and inst:                                  # C.ADDI4SPN
+                imm = ((inst >> 7) & 0xF) << 6 | ((inst >> 11) & 3) << 4 | ((inst >> 5) & 1) << 3 | ((inst >> 6) & 1) << 2
+                x[rs2p] = (x[2] + imm) & MASK32
+            elif f3 == 2:                                         # C.LW
+                x[rs2p] = self.load((x[rdp] + offset) & MASK32, 4)
+                return nxt, 1
+            elif f3 == 6:                                         # C.SW
+                self.store((x[rdp] + offset) & MASK32, 4, x[rs2p])
+            else:
+                illegal()
+        elif quadrant == 1:
+            cj = sext(((inst >> 12) & 1) << 11 | ((inst >> 8) & 1) << 10 | ((inst >> 9) & 3) << 8
+                      | ((inst >> 6) & 1) << 7 | ((inst >> 7) & 1) << 6 | ((inst >> 2) & 1) << 5
+                      | ((inst >> 11) & 1) << 4 | ((inst >> 3) & 7) << 1, 12)
+            if f3 == 0:                                           # C.ADDI / C.NOP
+                x[rd] = (x[rd] + imm6) & MASK32
+            elif f3 == 1:                                         # C.JAL
+                x[1] = nxt
+                return pc + cj, 1
+            elif f3 == 2:                                         # C.LI
+                x[rd] = imm6 & MASK32
+            elif f3 == 3 and rd == 2:                             # C.ADDI16SP
+                imm = sext(((inst >> 12) & 1) << 9 | ((inst >> 3) & 3) << 7 | ((inst >> 5) & 1) << 6
+                           | ((inst >> 2) & 1) << 5 | ((inst >> 6) & 1) << 4, 10)
+                x[2] = (x[2] + imm) & MASK32
+            elif f3 == 3:                                         # C.LUI
+                x[rd] = (imm6 << 12) & MASK32
+            elif f3 == 4:
+                f2 = (inst >> 10) & 3
+                shamt = rs2
+                if f2 == 0:                                       # C.SRLI
+                    x[rdp] = x[rdp] >> shamt
+                elif f2 == 1:                                     # C.SRAI
+                    x[rdp] = (sext(x[rdp], 32) >> shamt) & MASK32
+                elif f2 == 2:                                     # C.ANDI
+                    x[rdp] = x[rdp] & (imm6 & MASK32)
+                elif not (inst >> 12) & 1:
+                    op = (inst >> 5) & 3                          # C.SUB, C.XOR, C.OR, C.AND
+                    a, b = x[rdp], x[rs2p]
+                    x[rdp] = (a - b if op == 0 else a ^ b if op == 1 else a | b if op == 2 else a & b) & MASK32
+                else:
+                    illegal()
+            elif f3 == 5:                                         # C.J
+                return pc + cj, 1
+            else:                                                 # C.BEQZ, C.BNEZ
+                imm = sext(((inst >> 12) & 1) << 8 | ((inst >> 5) & 3) << 6 | ((inst >> 2) & 1) << 5
+                           | ((inst >> 10) & 3) << 3 | ((inst >> 3) & 3) << 1, 9)
+                taken = (x[rdp] == 0) == (f3 == 6)
+                return (pc + imm, 1) if taken else (nxt, 0)
+        elif quadrant == 2:
+            if f3 == 0:                                           # C.SLLI
+                x[rd] = (x[rd] << rs2) & MASK32
+            elif f3 == 2:                                         # C.LWSP
+                offset = ((inst >> 12) & 1) << 5 | ((inst >> 4) & 7) << 2 | ((inst >> 2) & 3) << 6
+                x[rd] = self.load((x[2] + offset) & MASK32, 4)
+                return nxt, 1
+            elif f3 == 4:
+                if not (inst >> 12) & 1:
+                    if rs2 == 0:                                  # C.JR
+                        return x[rd], 1
+                    x[rd] = x[rs2]                                # C.MV
+                elif rs2 == 0 and rd != 0:                        # C.JALR
+                    target = x[rd]
+                    x[1] = nxt
+                    return target, 1
+                elif rs2 != 0:                                    # C.ADD
+                    x[rd] = (x[rd] + x[rs2]) & MASK32
+                else:
+                    illegal()
+            elif f3 == 6:                                         # C.SWSP
+                offset = ((inst >> 9) & 0xF) << 2 | ((inst >> 7) & 3) << 6
+                self.store((x[2] + offset) & MASK32, 4, x[rs2])
+            else:
+                illegal()
+        return nxt, 0
+
+
+# --- Benchmark ---
+
+SRC = RAM_BASE + 0x1000
+DST = RAM_BASE + 0x4000
+
+
+def s32(value):
+    return sext(value, 32)
+
+
+def c_div(a, b):
+    """C semantics of signed 32-bit division, with the RISC-V results for b == 0."""
+    a, b = s32(a), s32(b)
+    if b == 0:
+        return MASK32
+    q = abs(a) // abs(b)
+    return (-q if (a < 0) != (b < 0) else q) & MASK32
+
+
+def c_mod(a, b):
+    a, b = s32(a), s32(b)
+    if b == 0:
+        return a & MASK32
+    r = abs(a) % abs(b)
+    return (-r if a < 0 else r) & MASK32
+
+
+def u32(rng, bits):
+    return rng.getrandbits(bits) if bits else 0
+
+
+ARITH_CASES = [
+    ("__mulsi3", "8 x 8 bit", lambda r: (u32(r, 8), u32(r, 8)), lambda a, b: (a * b) & MASK32),
+    ("__mulsi3", "16 x 16 bit", lambda r: (u32(r, 16), u32(r, 16)), lambda a, b: (a * b) & MASK32),
+    ("__mulsi3", "32 x 8 bit", lambda r: (u32(r, 32), u32(r, 8)), lambda a, b: (a * b) & MASK32),
+    ("__mulsi3", "-8 x 8 bit", lambda r: (-u32(r, 8) & MASK32, u32(r, 8)), lambda a, b: (a * b) & MASK32),
+    ("__mulsi3", "32 x 32 bit", lambda r: (u32(r, 32), u32(r, 32)), lambda a, b: (a * b) & MASK32),
+    ("__udivsi3", "32 / 32 bit", lambda r: (u32(r, 32), u32(r, 32) | 1), lambda a, b: a // b),
+    ("__udivsi3", "32 / 16 bit", lambda r: (u32(r, 32), u32(r, 16) | 1), lambda a, b: a // b),
+    ("__udivsi3", "32 / 10", lambda r: (u32(r, 32), 10), lambda a, b: a // b),
+    ("__udivsi3", "16 / 8 bit", lambda r: (u32(r, 16), u32(r, 8) | 1), lambda a, b: a // b),
+    ("__udivsi3", "small / large", lambda r: (u32(r, 8), u32(r, 16) | 0x100), lambda a, b: a // b),
+    ("__umodsi3", "32 / 16 bit", lambda r: (u32(r, 32), u32(r, 16) | 1), lambda a, b: a % b),
+    ("__divsi3", "+-32 / +-16 bit", lambda r: (u32(r, 32), s32(u32(r, 16) | 1) * r.choice((1, -1)) & MASK32), c_div),
+    ("__modsi3", "+-32 / +-16 bit", lambda r: (u32(r, 32), s32(u32(r, 16) | 1) * r.choice((1, -1)) & MASK32), c_mod),
+]
+
+MEMORY_CASES = [
+    ("memcpy", 0, 0, 0), ("memcpy", 1, 0, 0), ("memcpy", 4, 0, 0), ("memcpy", 11, 1, 0),
+    ("memcpy", 12, 0, 0), ("memcpy", 12, 1, 0), ("memcpy", 16, 0, 0), ("memcpy", 64, 0, 0),
+    ("memcpy", 256, 0, 0), ("memcpy", 64, 1, 1), ("memcpy", 64, 1, 0), ("memcpy", 64, 2, 1),
+    ("memcpy", 64, 0, 3), ("memcpy", 256, 3, 2),
+    ("memmove", 7, 3, 0), ("memmove", 64, 0, 0), ("memmove", 64, 8, 0), ("memmove", 64, 9, 0),
+    ("memmove", 64, 0, 8), ("memmove", 64, 0, 5),
+    ("memset", 0, 0, 0), ("memset", 5, 1, 0), ("memset", 16, 0, 0), ("memset", 64, 0, 0),
+    ("memset", 256, 3, 0),
+]
+
+
+def run_arith(cpu, address, case, operands, reference):
+    a, b = operands
+    result, _, instructions, cycles = cpu.call(address, (a, b))
+    if result != reference(a, b) & MASK32:
+        raise SimError("%s(0x%08X, 0x%08X) = 0x%08X, expected 0x%08X" % (case, a, b, result, reference(a, b)))
+    return instructions, cycles
+
+
+def run_memory(cpu, address, name, size, dst_offset, src_offset, rng):
+    """Runs one memory routine and compares RAM with the expected content."""
+    dst = DST + dst_offset
+    src = SRC + src_offset
+    if name == "memmove":
+        # Overlapping blocks in one buffer, the offsets select the direction
+        dst, src = SRC + dst_offset, SRC + src_offset
+
+    cpu.ram[:] = bytes(rng.getrandbits(8) for _ in range(RAM_SIZE // 16)) * 16
+    expected = bytearray(cpu.ram)
+    value = rng.getrandbits(8)
+    if name == "memset":
+        expected[dst - RAM_BASE:dst - RAM_BASE + size] = bytes([value]) * size
+        args = (dst, value, size)
+    else:
+        expected[dst - RAM_BASE:dst - RAM_BASE + size] = cpu.ram[src - RAM_BASE:src - RAM_BASE + size]
+        args = (dst, src, size)
+
+    result, _, instructions, cycles = cpu.call(address, args)
+    if result != dst or cpu.ram != expected:
+        raise SimError("%s(0x%08X, 0x%08X, %d) produced wrong memory" % ((name,) + args))
+    return instructions, cycles
+
+
+def measure(images, runner, count):
+    """Runs one case on every image, returns [(instructions, cycles) averages or None]."""
+    results = []
+    for image, cpu in images:
+        runs = runner(image, cpu, random.Random(count))
+        if runs is None:
+            results.append(None)
+            continue
+        results.append((sum(r[0] for r in runs) / len(runs), sum(r[1] for r in runs) / len(runs)))
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare RTLIB routines with libgcc/newlib on a simulated RV32EC core.")
+    parser.add_argument("--candidate", nargs="+", required=True, help="RTLIB objects")
+    parser.add_argument("--baseline", nargs="+", help="libgcc.a, libc_nano.a or objects")
+    parser.add_argument("--count", type=int, default=200, help="random operand sets per arithmetic case")
+    args = parser.parse_args()
+
+    needed = sorted({case[0] for case in ARITH_CASES} | {case[0] for case in MEMORY_CASES})
+    images = []
+    for paths in (args.baseline, args.candidate):
+        if paths:
+            image = Image(paths, needed)
+            images.append((image, Cpu(image)))
+
+    if args.baseline:
+        print("%-10s %-18s %16s %16s %8s" % ("function", "case", "baseline cyc", "rtlib cyc", "speedup"))
+    else:
+        print("%-10s %-18s %16s" % ("function", "case", "rtlib cyc"))
+
+    def report(name, case, results):
+        cells = ["%9.1f (%4.0f)" % (r[1], r[0]) if r else "%16s" % "missing" for r in results]
+        if len(results) == 1:
+            print("%-10s %-18s %s" % (name, case, cells[0]))
+            return
+        speedup = "%7.2fx" % (results[0][1] / results[1][1]) if all(results) else "%8s" % "-"
+        print("%-10s %-18s %s %s %s" % (name, case, cells[0], cells[1], speedup))
+
+    try:
+        for name, case, operands, reference in ARITH_CASES:
+            def runner(image, cpu, rng):
+                if name not in image.globals:
+                    return None
+                return [run_arith(cpu, image.globals[name], name, operands(rng), reference) for _ in range(args.count)]
+            report(name, case, measure(images, runner, args.count))
+
+        for name, size, dst_offset, src_offset in MEMORY_CASES:
+            def runner(image, cpu, rng):
+                if name not in image.globals:
+                    return None
+                return [run_memory(cpu, image.globals[name], name, size, dst_offset, src_offset, rng) for _ in range(4)]
+            case = "%d B, +%d/+%d" % (size, dst_offset, src_offset)
+            report(name, case, measure(images, runner, args.count))
+    except SimError as error:
+        sys.exit("simulation failed: %s" % error)
+
+    print("cycles are averages, instructions in parentheses")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
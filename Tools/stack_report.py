@@ -0,0 +1,194 @@
+#!/usr/bin/env python3
+"""Worst-case stack depth report.
+
+Combines the per-function frame sizes written by -fstack-usage (*.su) with
+the call graph, taken either from the RTL dumps written by -fdump-rtl-expand
+(*.expand) or from a Graphviz callgraph.dot, and prints the deepest call
+chain of every entry point: main() and each interrupt handler.
+
+The worst case for the whole program is main() plus the two deepest handlers,
+since the PFIC nests at most two preemption levels. HPE saves the caller-saved
+registers of the interrupted context by pushing them onto the same SRAM
+stack, so every nesting level also adds one HPE frame (--hpe-frame bytes).
+
+Calls through function pointers (hooks, timer, scheduler and work queue
+callbacks) do not show up in the call graph. Each function making one must be
+given a bound with --indirect, either the possible targets or a byte count:
+    --indirect TIM2_IRQHandler=CAPTURE_Overflow,MODBUS_Timeout
+    --indirect SCHED_Activate=96
+
+Usage (from the build directory):
+    stack_report.py [--stack-size N] [--hpe-frame N] [--root FN ...]
+                    [--indirect FN=TARGET[,TARGET...]|FN=BYTES ...]
+                    FILE.su ... FILE.expand|callgraph.dot ...
+
+The exit status is 1 if the worst case exceeds --stack-size, or if a
+recursive or dynamically sized frame, or an indirect call without a bound,
+makes the result unbounded.
+"""
+
+import argparse
+import re
+import sys
+
+EXPAND_FUNC = re.compile(r"^;; Function (\S+)")
+EXPAND_CALL = re.compile(r"\(call \(mem:\w+ \(symbol_ref:\w+ \(\"([^\"]+)\"\)")
+EXPAND_INDIRECT = re.compile(r"\(call \(mem:\w+ \(reg")
+DOT_EDGE = re.compile(r"\"?([\w.$]+)\"?\s*->\s*\"?([\w.$]+)\"?")
+HANDLER = re.compile(r"_(IRQ)?Handler$")
+
+# PFIC preemption levels, each adds the deepest remaining handler
+NEST_LEVELS = 2
+
+# Bytes HPE pushes per interrupt: ra, t0..t2 and a0..a5
+HPE_FRAME = 40
+
+
+def read_stack_usage(paths):
+    """Returns {function: (bytes, qualifier)} from -fstack-usage files."""
+    frames = {}
+    for path in paths:
+        with open(path) as su:
+            for line in su:
+                fields = line.rstrip("\n").split("\t")
+                if len(fields) != 3:
+                    continue
+                name = fields[0].rsplit(":", 1)[-1]
+                size = int(fields[1])
+                # Static functions of the same name in two files: keep the larger
+                if name not in frames or size > frames[name][0]:
+                    frames[name] = (size, fields[2])
+    return frames
+
+
+def read_expand(path, graph, indirect):
+    """Adds the call edges of one RTL expand dump."""
+    caller = None
+    with open(path) as dump:
+        for line in dump:
+            match = EXPAND_FUNC.match(line)
+            if match:
+                caller = match.group(1)
+                graph.setdefault(caller, set())
+                continue
+            if caller is None:
+                continue
+            for callee in EXPAND_CALL.findall(line):
+                graph[caller].add(callee)
+            if EXPAND_INDIRECT.search(line):
+                indirect.add(caller)
+
+
+def read_dot(path, graph):
+    """Adds the call edges of a Graphviz call graph."""
+    with open(path) as dot:
+        for line in dot:
+            match = DOT_EDGE.search(line)
+            if match:
+                graph.setdefault(match.group(1), set()).add(match.group(2))
+
+
+def read_indirect(specs, graph):
+    """Returns {caller: bytes} for --indirect byte bounds, adds target lists to the graph."""
+    bounds = {}
+    for spec in specs:
+        caller, _, value = spec.partition("=")
+        if not caller or not value:
+            raise SystemExit("--indirect expects FN=TARGET[,TARGET...] or FN=BYTES: " + spec)
+        if value.isdigit():
+            bounds[caller] = int(value)
+        else:
+            graph.setdefault(caller, set()).update(t for t in value.split(",") if t)
+            bounds.setdefault(caller, 0)
+    return bounds
+
+
+def deepest(name, frames, graph, unresolved, bounds, stack, memo):
+    """Returns (bytes, path, unbounded) for the deepest chain starting at name."""
+    if name in memo:
+        return memo[name]
+    if name in stack:
+        return 0, [name + " (recursion)"], True
+
+    size, qualifier = frames.get(name, (0, "static"))
+    unbounded = qualifier.startswith("dynamic") and "bounded" not in qualifier
+
+    best = (0, [])
+    if name in unresolved:
+        best = (0, ["(indirect call)"])
+        unbounded = True
+    elif bounds.get(name):
+        best = (bounds[name], ["(indirect call, %d bytes)" % bounds[name]])
+    stack.add(name)
+    for callee in sorted(graph.get(name, ())):
+        result = deepest(callee, frames, graph, unresolved, bounds, stack, memo)
+        if result[0] > best[0]:
+            best = result[:2]
+        unbounded = unbounded or result[2]
+    stack.discard(name)
+
+    result = (size + best[0], [name] + best[1], unbounded)
+    memo[name] = result
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Worst-case stack depth per entry point.")
+    parser.add_argument("files", nargs="+", help="*.su, *.expand and/or callgraph.dot files")
+    parser.add_argument("--stack-size", type=int, default=0, help="__stack_size from Ld/Link.ld")
+    parser.add_argument("--hpe-frame", type=int, default=HPE_FRAME,
+                        help="bytes HPE pushes per nesting level (0 with HPE disabled)")
+    parser.add_argument("--root", action="append", default=[], help="extra entry point")
+    parser.add_argument("--indirect", action="append", default=[],
+                        help="FN=TARGET[,TARGET...] or FN=BYTES bound for the indirect calls of FN")
+    args = parser.parse_args()
+
+    graph = {}
+    indirect = set()
+    su_files = [f for f in args.files if f.endswith(".su")]
+    for path in args.files:
+        if path.endswith(".expand"):
+            read_expand(path, graph, indirect)
+        elif path.endswith(".dot"):
+            read_dot(path, graph)
+    frames = read_stack_usage(su_files)
+    bounds = read_indirect(args.indirect, graph)
+    unresolved = indirect - set(bounds)
+
+    names = set(frames) | set(graph)
+    handlers = sorted(n for n in names if HANDLER.search(n))
+    roots = ["main"] + [r for r in args.root if r != "main"]
+
+    memo = {}
+    print("%-28s %6s  %s" % ("entry point", "bytes", "deepest path"))
+    results = {}
+    for name in roots + handlers:
+        depth, path, unbounded = deepest(name, frames, graph, unresolved, bounds, set(), memo)
+        results[name] = (depth, unbounded)
+        flag = " (unbounded)" if unbounded else ""
+        print("%-28s %6d  %s%s" % (name, depth, " > ".join(path), flag))
+
+    if unresolved:
+        print("\nindirect calls without a bound (--indirect) in: " + ", ".join(sorted(unresolved)))
+
+    base = max(results[r][0] for r in roots)
+    nested = sorted((results[h][0] for h in handlers), reverse=True)[:NEST_LEVELS]
+    hpe = args.hpe_frame * len(nested)
+    worst = base + sum(nested) + hpe
+    unbounded = any(u for _, u in results.values())
+
+    print("\nworst case: %d bytes (entry %d + %d nested handlers %s + HPE frames %d)"
+          % (worst, base, len(nested), "+".join(str(n) for n in nested) or "0", hpe))
+    if unbounded:
+        print("unbounded: recursion, dynamic frames or indirect calls without a bound")
+
+    if args.stack_size:
+        print("stack size: %d bytes, margin %d" % (args.stack_size, args.stack_size - worst))
+
+    if unbounded or (args.stack_size and worst > args.stack_size):
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
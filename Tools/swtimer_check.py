@@ -0,0 +1,258 @@
+#!/usr/bin/env python3
+"""Randomized host test of Middleware/src/SWTIMER/swtimer.c.
+
+Builds swtimer.c for the host as a shared library, with SysTick and PFIC
+replaced by a simulated millisecond clock whose alarm fires as soon as the
+clock reaches it. A random sequence of starts, stops and clock advances is
+run on a full pool of SWTIMER_COUNT timers, some of whose one-shot
+callbacks take several milliseconds so that other timers fall due while a batch runs.
+
+After every step the test checks that:
+  - the alarm is armed while a timer runs, and no later than the earliest
+    expiry (or now, for a timer already overdue);
+  - no callback runs before its expiry, and a one-shot timer fires once.
+
+Exits with status 1 on the first violation.
+
+Usage:
+    swtimer_check.py [--steps N] [--seed S]
+"""
+
+import argparse
+import ctypes
+import os
+import random
+import subprocess
+import sys
+import tempfile
+
+TOOLS = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.dirname(TOOLS)
+SOURCE = os.path.join(ROOT, "Middleware", "src", "SWTIMER", "swtimer.c")
+INCLUDE = os.path.join(ROOT, "Middleware", "inc")
+
+SYSTICK_H = """
+#include <stdint.h>
+typedef void (*SYSTICK_ALARM_FN)(void);
+uint32_t SYSTICK_GetCyclesPerMilli(void);
+uint64_t SYSTICK_GetCycles(void);
+uint64_t SYSTICK_GetMillis(void);
+void SYSTICK_SetAlarm(uint64_t cycles, SYSTICK_ALARM_FN fn);
+void SYSTICK_CancelAlarm(void);
+"""
+
+PFIC_H = """
+#include <stdint.h>
+static inline uint32_t PFIC_DisableGlobalIRQ(void) { return 0; }
+static inline void PFIC_RestoreGlobalIRQ(uint32_t state) { (void)state; }
+"""
+
+# Included after swtimer.c, so the checks can read its static state
+HARNESS = r"""
+#include "swtimer.c"
+
+#define MOCK_CYCLES_PER_MS 1000
+#define MOCK_LOG 4096
+
+static uint64_t mockMillis;
+static uint64_t mockAlarm;
+static uint8_t mockAlarmSet;
+static SYSTICK_ALARM_FN mockAlarmFn;
+
+uint32_t mockDuration[SWTIMER_COUNT];
+uint32_t mockLogArg[MOCK_LOG];
+uint32_t mockLogTime[MOCK_LOG];
+uint32_t mockLogCount;
+
+uint32_t SYSTICK_GetCyclesPerMilli(void) { return MOCK_CYCLES_PER_MS; }
+uint64_t SYSTICK_GetCycles(void) { return mockMillis * MOCK_CYCLES_PER_MS; }
+uint64_t SYSTICK_GetMillis(void) { return mockMillis; }
+
+void SYSTICK_SetAlarm(uint64_t cycles, SYSTICK_ALARM_FN fn)
+{
+    mockAlarm = cycles / MOCK_CYCLES_PER_MS;
+    mockAlarmFn = fn;
+    mockAlarmSet = 1;
+}
+
+void SYSTICK_CancelAlarm(void) { mockAlarmSet = 0; }
+
+void MockCallback(uint32_t arg)
+{
+    if (mockLogCount < MOCK_LOG)
+    {
+        mockLogArg[mockLogCount] = arg;
+        mockLogTime[mockLogCount] = (uint32_t)mockMillis;
+        mockLogCount++;
+    }
+    mockMillis += mockDuration[arg];
+}
+
+void MockReset(uint32_t start)
+{
+    mockMillis = start;
+    mockAlarmSet = 0;
+    mockLogCount = 0;
+}
+
+uint32_t MockNow(void) { return (uint32_t)mockMillis; }
+
+/* Runs the clock for ms milliseconds, firing the alarm whenever it is due. */
+void MockAdvance(uint32_t ms)
+{
+    uint64_t end = mockMillis + ms;
+
+    for (;;)
+    {
+        if (mockAlarmSet && mockAlarm <= mockMillis)
+        {
+            mockAlarmSet = 0;
+            mockAlarmFn();
+        }
+        else if (mockMillis < end)
+        {
+            mockMillis++;
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+/* Returns 0, or the id + 1 of a running timer the alarm would miss. */
+uint32_t MockCheckAlarm(void)
+{
+    uint32_t now = (uint32_t)mockMillis;
+
+    for (uint8_t id = 0; id < swTimerCount; id++)
+    {
+        int32_t due;
+
+        if (swTimers[id].state != SWTIMER_STATE_RUNNING)
+            continue;
+
+        due = (int32_t)(swTimers[id].expiry - now);
+        if (due < 0)
+            due = 0;
+
+        if (!mockAlarmSet || (int64_t)(mockAlarm - mockMillis) > due)
+            return id + 1U;
+    }
+
+    return 0;
+}
+
+uint32_t MockExpiry(uint8_t id) { return swTimers[id].expiry; }
+"""
+
+
+def build_host_library(directory):
+    for name, text in (("SYSTICK", SYSTICK_H), ("PFIC", PFIC_H)):
+        os.makedirs(os.path.join(directory, name))
+        with open(os.path.join(directory, name, name.lower() + ".h"), "w") as header:
+            header.write(text)
+    harness = os.path.join(directory, "harness.c")
+    with open(harness, "w") as source:
+        source.write(HARNESS)
+
+    path = os.path.join(directory, "swtimer.so")
+    subprocess.check_call([os.environ.get("CC", "cc"), "-O2", "-shared", "-fPIC",
+                           "-I" + directory, "-I" + INCLUDE,
+                           "-I" + os.path.dirname(SOURCE), harness, "-o", path])
+    lib = ctypes.CDLL(path)
+    lib.SWTIMER_Create.restype = ctypes.c_uint8
+    lib.SWTIMER_Create.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
+    lib.SWTIMER_Start.argtypes = [ctypes.c_uint8, ctypes.c_uint32, ctypes.c_uint32]
+    lib.SWTIMER_Stop.argtypes = [ctypes.c_uint8]
+    lib.SWTIMER_IsActive.restype = ctypes.c_uint8
+    lib.SWTIMER_IsActive.argtypes = [ctypes.c_uint8]
+    lib.MockReset.argtypes = [ctypes.c_uint32]
+    lib.MockNow.restype = ctypes.c_uint32
+    lib.MockAdvance.argtypes = [ctypes.c_uint32]
+    lib.MockCheckAlarm.restype = ctypes.c_uint32
+    lib.MockExpiry.restype = ctypes.c_uint32
+    lib.MockExpiry.argtypes = [ctypes.c_uint8]
+    return lib
+
+
+def run(lib, rng, steps):
+    count = ctypes.c_uint32.in_dll(lib, "mockLogCount")
+    log_arg = (ctypes.c_uint32 * 4096).in_dll(lib, "mockLogArg")
+    log_time = (ctypes.c_uint32 * 4096).in_dll(lib, "mockLogTime")
+    duration = (ctypes.c_uint32 * 256).in_dll(lib, "mockDuration")
+    callback = ctypes.cast(lib.MockCallback, ctypes.c_void_p)
+
+    # Start close to the 32-bit wrap of the millisecond count
+    lib.MockReset(0xFFFFFFFF - rng.randrange(steps * 20))
+    lib.SWTIMER_Init()
+
+    timers = []
+    while True:
+        timer = lib.SWTIMER_Create(callback, len(timers))
+        if timer == 0xFF:
+            break
+        timers.append(timer)
+
+    # Expected (expiry, period) of each timer, None while stopped
+    expected = [None] * len(timers)
+    fired = 0
+
+    for step in range(steps):
+        action = rng.random()
+        timer = rng.choice(timers)
+
+        if action < 0.45:
+            delay = rng.choice((rng.randrange(1, 40), rng.randrange(1, 200)))
+            period = rng.choice((0, 0, rng.randrange(1, 50)))
+            # Only one-shot callbacks are slow, so periodic ones cannot overload the clock
+            duration[timer] = 0 if period else rng.choice((0, 0, 1, 3, 7))
+            lib.SWTIMER_Start(timer, delay, period)
+            expected[timer] = (lib.MockExpiry(timer), period)
+        elif action < 0.55:
+            lib.SWTIMER_Stop(timer)
+            expected[timer] = None
+        else:
+            count.value = 0
+            lib.MockAdvance(rng.randrange(1, 60))
+
+            for index in range(min(count.value, 4096)):
+                arg, time = log_arg[index], log_time[index]
+                if expected[arg] is None:
+                    sys.exit("step %d: stopped timer %d fired at %d" % (step, arg, time))
+                expiry, period = expected[arg]
+                if (time - expiry) & 0x80000000:
+                    sys.exit("step %d: timer %d fired at %d, before its expiry %d" % (step, arg, time, expiry))
+                # A periodic timer keeps its phase or slips, never fires early
+                expected[arg] = ((expiry + period) & 0xFFFFFFFF, period) if period else None
+                fired += 1
+
+        missed = lib.MockCheckAlarm()
+        if missed:
+            timer = missed - 1
+            sys.exit("step %d: at %d the alarm misses timer %d due at %d"
+                     % (step, lib.MockNow(), timer, lib.MockExpiry(timer)))
+
+        for timer in timers:
+            if bool(lib.SWTIMER_IsActive(timer)) != (expected[timer] is not None):
+                sys.exit("step %d: timer %d active state differs from the model" % (step, timer))
+
+    return len(timers), fired
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Randomized host test of swtimer.c.")
+    parser.add_argument("--steps", type=int, default=20000, help="operations per run")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as directory:
+        lib = build_host_library(directory)
+        timers, fired = run(lib, random.Random(args.seed), args.steps)
+
+    print("%d timers, %d steps, %d callbacks: ok" % (timers, args.steps, fired))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
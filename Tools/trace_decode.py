@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+"""Decoder for TRACE_Dump() output.
+
+Reads a binary trace dump from a file, stdin or a serial device and prints
+one line per event: absolute time since the first record, time since the
+previous event, event name and argument.
+
+Dump format (little-endian), see Peripheral/inc/SYS/trace.h:
+    'T', version (1), TRACE_TIME_SHIFT, reserved, HCLK (u32), N (u16),
+    N x { id (u16), delta (u16), arg (u32) }
+
+Usage:
+    trace_decode.py dump.bin
+    trace_decode.py /dev/ttyUSB0 --baud 115200
+    trace_decode.py dump.bin --names events.txt
+
+The names file maps application event IDs to names, one "<id> <name>" per
+line (IDs in decimal or 0x hex, '#' starts a comment).
+"""
+
+import argparse
+import os
+import struct
+import sys
+import termios
+
+HEADER = struct.Struct("<BBBBIH")
+RECORD = struct.Struct("<HHI")
+VERSION = 1
+
+TRACE_ID_SYNC = 0
+DRIVER_EVENTS = {
+    0: "SYNC",
+    1: "EXTI",
+    2: "RCC_SYSCLK",
+    3: "GPIO_WRITE",
+    4: "GPIO_TOGGLE",
+}
+
+GPIO_PORTS = {0x40010800: "A", 0x40011000: "C", 0x40011400: "D"}
+SYSCLK_SOURCES = {0: "HSI", 1: "HSE", 2: "PLL"}
+
+BAUD_RATES = {
+    9600: termios.B9600,
+    19200: termios.B19200,
+    38400: termios.B38400,
+    57600: termios.B57600,
+    115200: termios.B115200,
+    230400: termios.B230400,
+    460800: termios.B460800,
+    921600: termios.B921600,
+}
+
+
+def format_arg(event, arg):
+    """Decodes the argument of the driver events, hex for everything else."""
+    if event == 1:
+        return "line %d" % arg
+    if event == 2:
+        return SYSCLK_SOURCES.get(arg, "src %d" % arg)
+    if event in (3, 4):
+        port = GPIO_PORTS.get(arg & ~0x3FF, "?")
+        text = "P%s%d" % (port, (arg >> 1) & 0x0F)
+        if event == 3:
+            text += " = %d" % (arg & 0x01)
+        return text
+    return "0x%08X" % arg
+
+
+def read_names(path):
+    """Reads '<id> <name>' lines into a dictionary."""
+    names = {}
+    with open(path) as table:
+        for line in table:
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            ident, name = line.split(None, 1)
+            names[int(ident, 0)] = name
+    return names
+
+
+def open_input(path, baud):
+    """Opens a file, stdin ('-') or a serial device configured for raw 8N1."""
+    if path == "-":
+        return sys.stdin.buffer
+
+    stream = open(path, "rb", buffering=0)
+    if os.isatty(stream.fileno()):
+        attrs = termios.tcgetattr(stream.fileno())
+        attrs[0] = 0                                           # iflag
+        attrs[1] = 0                                           # oflag
+        attrs[2] = termios.CS8 | termios.CREAD | termios.CLOCAL  # cflag
+        attrs[3] = 0                                           # lflag
+        attrs[4] = attrs[5] = BAUD_RATES[baud]
+        termios.tcsetattr(stream.fileno(), termios.TCSANOW, attrs)
+    return stream
+
+
+def read_exact(stream, size):
+    data = b""
+    while len(data) < size:
+        chunk = stream.read(size - len(data))
+        if not chunk:
+            raise EOFError("dump truncated")
+        data += chunk
+    return data
+
+
+def find_header(stream):
+    """Skips bytes until a 'T' with a supported version, returns the header fields."""
+    while True:
+        if read_exact(stream, 1) != b"T":
+            continue
+        rest = read_exact(stream, HEADER.size - 1)
+        fields = HEADER.unpack(b"T" + rest)
+        if fields[1] == VERSION:
+            return fields
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode a TRACE_Dump() into a timeline.")
+    parser.add_argument("input", help="dump file, serial device or '-' for stdin")
+    parser.add_argument("--baud", type=int, default=115200, choices=sorted(BAUD_RATES))
+    parser.add_argument("--names", help="file mapping application event IDs to names")
+    args = parser.parse_args()
+
+    names = dict(DRIVER_EVENTS)
+    if args.names:
+        names.update(read_names(args.names))
+
+    stream = open_input(args.input, args.baud)
+    _, _, shift, _, hclk, count = find_header(stream)
+    if hclk == 0:
+        sys.exit("dump reports HCLK = 0")
+
+    cycles = 0
+    previous = 0
+    print("# %d records, HCLK %d Hz, delta unit %d cycles" % (count, hclk, 1 << shift))
+    print("%14s %12s  %-16s %s" % ("time [us]", "+dt [us]", "event", "arg"))
+
+    for _ in range(count):
+        event, delta, arg = RECORD.unpack(read_exact(stream, RECORD.size))
+
+        if event == TRACE_ID_SYNC:
+            cycles += arg
+            continue
+
+        cycles += delta << shift
+        now = cycles * 1e6 / hclk
+        step = (cycles - previous) * 1e6 / hclk
+        previous = cycles
+
+        name = names.get(event, "EVENT_0x%04X" % event)
+        print("%14.2f %12.2f  %-16s %s" % (now, step, name, format_arg(event, arg)))
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
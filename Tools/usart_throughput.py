@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""Throughput and loss test of the USART1 driver against the echo loop in User/main.c.
+
+Streams pseudo-random data to the board and compares the echo byte by byte.
+At most --window bytes are in flight: the board echoes at its own baud rate,
+which differs from the host's by the BRR rounding error, so an unbounded
+stream would eventually overrun the rings on either side without any fault in
+the driver. With the default window the device rings (64 + 64 bytes) cannot
+fill up, so every lost or changed byte is a driver or link error.
+
+Build the firmware with MAIN_BAUD_RATE set to the rate under test, e.g.
+115200 and 1000000. Requires pyserial.
+
+Usage:
+    usart_throughput.py /dev/ttyUSB0 --baud 1000000 --bytes 1000000
+"""
+
+import argparse
+import random
+import sys
+import time
+
+try:
+    import serial
+except ImportError:
+    sys.exit("pyserial is required: pip install pyserial")
+
+
+def run(port, total, window, seed, timeout):
+    """Returns (bytes sent, bytes echoed correctly, first mismatch offset or None, seconds)."""
+    rng = random.Random(seed)
+    data = bytes(rng.getrandbits(8) for _ in range(total))
+    sent = 0
+    received = bytearray()
+    last_progress = time.monotonic()
+    start = last_progress
+
+    port.reset_input_buffer()
+    while len(received) < total:
+        if sent < total and sent - len(received) < window:
+            chunk = data[sent:min(total, len(received) + window)]
+            port.write(chunk)
+            sent += len(chunk)
+
+        incoming = port.read(port.in_waiting or 1)
+        if incoming:
+            received += incoming
+            last_progress = time.monotonic()
+        elif time.monotonic() - last_progress > timeout:
+            break
+
+    elapsed = time.monotonic() - start
+    mismatch = None
+    for offset, (expected, actual) in enumerate(zip(data, received)):
+        if expected != actual:
+            mismatch = offset
+            break
+    if mismatch is None and len(received) < total:
+        mismatch = len(received)
+    good = mismatch if mismatch is not None else total
+    return sent, good, mismatch, elapsed
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Stream data through the USART1 echo and count lost bytes.")
+    parser.add_argument("port", help="serial port, e.g. /dev/ttyUSB0 or COM3")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--bytes", type=int, default=100000, help="bytes to stream")
+    parser.add_argument("--window", type=int, default=96, help="maximum bytes in flight")
+    parser.add_argument("--timeout", type=float, default=1.0, help="seconds without echo before giving up")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    with serial.Serial(args.port, args.baud, timeout=0.05) as port:
+        sent, good, mismatch, elapsed = run(port, args.bytes, args.window, args.seed, args.timeout)
+
+    line_rate = args.baud / 10
+    rate = good / elapsed if elapsed else 0.0
+    print("baud %d: %d bytes sent, %d echoed intact in %.2f s" % (args.baud, sent, good, elapsed))
+    print("throughput %.0f bytes/s (%.1f%% of the 8N1 line rate)" % (rate, 100.0 * rate / line_rate))
+    if mismatch is not None:
+        print("FAIL: echo stream broken at byte %d" % mismatch)
+        return 1
+    print("ok: no bytes lost")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -12,22 +12,354 @@
 
 /*
  *@Note
- *Multiprocessor communication mode routine:
- *Master:USART1_Tx(PD5)\USART1_Rx(PD6).
- *This routine demonstrates that USART1 receives the data sent by CH341 and inverts
- *it and sends it (baud rate 115200).
+ *USART1 echo routine:
+ *USART1_Tx(PD5)\USART1_Rx(PD6).
+ *This routine echoes every byte received on USART1 (baud rate 115200). The
+ *main loop stalls for MAIN_BUSY_US after each pass to stand in for application
+ *work; the driver's ring buffers carry the link in the meantime.
+ *Tools/usart_throughput.py streams data through the echo and reports lost bytes.
+ *With USART_RX_DMA set the echo sends each received DMA view back from
+ *where it arrived instead of reading the RX ring.
+ *
+ *With MAIN_RPC set to 1 the loop serves the binary RPC protocol instead
+ *(Middleware/inc/RPC/rpc.h): echo, add, frame counters and uptime, called with
+ *Tools/rpc_client.py.
+ *
+ *With MAIN_SCHED_BENCH set to 1 the loop measures scheduler context switches
+ *instead (Middleware/inc/SCHED/sched.h) and prints one LATENCY record per
+ *path every second: main loop to task, task to task of the same level, and
+ *task to a task of the higher level through its vector. It needs
+ *SCHED_ENABLE=1 in the project defines.
+ *
+ *With MAIN_HIGHCODE_BENCH set to 1 it prints the cycles per call of the RAM
+ *resident (HIGHCODE) GPIO fast paths and the EXTI7_0 dispatcher, at 24 MHz
+ *(HSI, no flash wait state) and 48 MHz (PLL, one wait state). Build it once
+ *as is and once with SYS_NO_HIGHCODE defined; the difference between the two
+ *runs is the gain of RAM placement per function.
+ *
+ *With MAIN_SWTIMER_BENCH set to 1 it prints the cost of the software timer
+ *wheel (Middleware/inc/SWTIMER/swtimer.h) with all SWTIMER_COUNT timers
+ *running: one SWTIMER_Start() call, one expiry among the running timers and
+ *the expiry of every timer in the same millisecond. Expiry costs are the
+ *longest stall seen by the main loop, SysTick entry and exit included.
+ *Tools/swtimer_check.py tests the wheel on the host.
+ *
+ *Every benchmark build needs CRITICAL_TRACK=1 in the project defines, so the
+ *worst critical sections (Middleware/inc/CRITICAL/critical.h) are recorded
+ *alongside the measurements.
  *
  *Hardware connection:PD5 -- Rx
  *                     PD6 -- Tx
  *
  */
- #include <stdint.h>
+#include <stdint.h>
 #include "RCC/rcc.h"
 #include "GPIO/gpio.h"
+#include "SYSTICK/systick.h"
+#include "USART/usart.h"
+#include "RPC/rpc.h"
+#include "PFIC/pfic.h"
+#include "SCHED/sched.h"
+#include "CRITICAL/critical.h"
+#include "LATENCY/latency.h"
+#include "EXTI/exti.h"
+#include "SWTIMER/swtimer.h"
 /* Global define */
+#define MAIN_BAUD_RATE 115200
+#define MAIN_BUSY_US 200
+#define MAIN_RPC 0
+#define MAIN_SCHED_BENCH 0
+#define MAIN_HIGHCODE_BENCH 0
+#define MAIN_SWTIMER_BENCH 0
+#define MAIN_BENCH_SAMPLES 256
+
+#if MAIN_SCHED_BENCH && !SCHED_ENABLE
+#error "MAIN_SCHED_BENCH needs SCHED_ENABLE=1 in the project defines"
+#endif
+
+#if (MAIN_SCHED_BENCH || MAIN_HIGHCODE_BENCH || MAIN_SWTIMER_BENCH) && !CRITICAL_TRACK
+#error "The benchmark builds need CRITICAL_TRACK=1 in the project defines"
+#endif
 
 
 /* Global Variable */
+#if MAIN_SCHED_BENCH || MAIN_HIGHCODE_BENCH || MAIN_SWTIMER_BENCH
+/*********************************************************************
+ * @fn      BenchPutChar
+ *
+ * @brief   LATENCY_Dump() output on USART1.
+ *
+ * @return  none
+ */
+static void BenchPutChar(char c)
+{
+    while (USART_Write((const uint8_t *)&c, 1) == 0)
+        ;
+}
+
+/*********************************************************************
+ * @fn      BenchPutString
+ *
+ * @brief   Writes a label on USART1.
+ *
+ * @return  none
+ */
+static void BenchPutString(const char *str)
+{
+    while (*str)
+        BenchPutChar(*str++);
+}
+#endif
+
+#if MAIN_SCHED_BENCH
+static LATENCY_STATS benchPost;
+static LATENCY_STATS benchSync;
+static LATENCY_STATS benchPreempt;
+
+/*********************************************************************
+ * @fn      BenchLowTask
+ *
+ * @brief   Priority 1, low level. Event 0 measures the post from the main
+ *          loop, event 1 then posts to the other two tasks.
+ *
+ * @return  none
+ */
+static void BenchLowTask(SCHED_EVENT event)
+{
+    if (event == 0)
+    {
+        LATENCY_MarkEntry(&benchPost);
+        return;
+    }
+
+    LATENCY_MarkTrigger();
+    SCHED_Post(2, 0);
+
+    LATENCY_MarkTrigger();
+    SCHED_Post(3, 0);
+}
+
+/*********************************************************************
+ * @fn      BenchSyncTask
+ *
+ * @brief   Priority 2, low level: started synchronously by BenchLowTask().
+ *
+ * @return  none
+ */
+static void BenchSyncTask(SCHED_EVENT event)
+{
+    (void)event;
+
+    LATENCY_MarkEntry(&benchSync);
+}
+
+/*********************************************************************
+ * @fn      BenchHighTask
+ *
+ * @brief   Priority 3, high level: preempts BenchLowTask() through PFIC_IRQ_SW2.
+ *
+ * @return  none
+ */
+static void BenchHighTask(SCHED_EVENT event)
+{
+    (void)event;
+
+    LATENCY_MarkEntry(&benchPreempt);
+}
+#elif MAIN_HIGHCODE_BENCH
+static LATENCY_STATS benchRead;
+static LATENCY_STATS benchWrite;
+static LATENCY_STATS benchToggle;
+static LATENCY_STATS benchExti;
+
+/*********************************************************************
+ * @fn      BenchExtiCallback
+ *
+ * @brief   EXTI line 0 callback, stamps the end of the dispatch.
+ *
+ * @return  none
+ */
+static void BenchExtiCallback(void)
+{
+    LATENCY_MarkEntry(&benchExti);
+}
+
+/*********************************************************************
+ * @fn      BenchHighcode
+ *
+ * @brief   Switches SYSCLK, times every fast path and prints the records.
+ *
+ * @return  none
+ */
+static void BenchHighcode(RCC_SYSCLK_SRC clock, const char *label)
+{
+    USART_Flush();
+    RCC_SetSystemClock(clock);
+    USART_Init(MAIN_BAUD_RATE);
+
+    // The stamp pair runs from flash, so its cost changes with the wait states
+    LATENCY_Init();
+    LATENCY_Reset(&benchRead);
+    LATENCY_Reset(&benchWrite);
+    LATENCY_Reset(&benchToggle);
+    LATENCY_Reset(&benchExti);
+
+    for (uint16_t sample = 0; sample < MAIN_BENCH_SAMPLES; sample++)
+    {
+        LATENCY_MarkTrigger();
+        (void)GPIO_ReadPin(GPIOC, GPIO_PIN_4);
+        LATENCY_MarkEntry(&benchRead);
+
+        LATENCY_MarkTrigger();
+        GPIO_WritePin(GPIOC, GPIO_PIN_4, (GPIO_VALUE)(sample & 0x01));
+        LATENCY_MarkEntry(&benchWrite);
+
+        LATENCY_MarkTrigger();
+        GPIO_TogglePin(GPIOC, GPIO_PIN_4);
+        LATENCY_MarkEntry(&benchToggle);
+
+        LATENCY_MarkTrigger();
+        EXTI_SWInterruptTrigger(EXTI_SW_INT_SW0);
+        SYSTICK_DelayMicros(10);
+    }
+
+    BenchPutString(label);
+    BenchPutString("GPIO_ReadPin ");
+    LATENCY_Dump(&benchRead, BenchPutChar);
+    BenchPutString("GPIO_WritePin ");
+    LATENCY_Dump(&benchWrite, BenchPutChar);
+    BenchPutString("GPIO_TogglePin ");
+    LATENCY_Dump(&benchToggle, BenchPutChar);
+    BenchPutString("EXTI7_0 trigger to callback ");
+    LATENCY_Dump(&benchExti, BenchPutChar);
+}
+#elif MAIN_SWTIMER_BENCH
+static LATENCY_STATS benchStart;
+static LATENCY_STATS benchExpireOne;
+static LATENCY_STATS benchExpireAll;
+static volatile uint8_t benchFired;
+
+/*********************************************************************
+ * @fn      BenchTimerCallback
+ *
+ * @brief   Timer callback, counts the expiries.
+ *
+ * @return  none
+ */
+static void BenchTimerCallback(uint32_t arg)
+{
+    (void)arg;
+
+    benchFired++;
+}
+
+/*********************************************************************
+ * @fn      BenchWaitFired
+ *
+ * @brief   Spins until count timers have fired and records the longest
+ *          gap between two reads of the SysTick counter.
+ *
+ * @return  none
+ */
+static void BenchWaitFired(LATENCY_STATS *stats, uint8_t count)
+{
+    uint32_t last = SYSTICK->CNT;
+    uint32_t gap = 0;
+
+    while (benchFired < count)
+    {
+        uint32_t now = SYSTICK->CNT;
+
+        if (now - last > gap)
+            gap = now - last;
+        last = now;
+    }
+
+    LATENCY_Record(stats, gap);
+}
+#elif !MAIN_RPC && USART_RX_DMA
+// Bytes of the oldest RX view already echoed
+static uint16_t echoSent;
+#elif !MAIN_RPC
+static uint8_t echoBuffer[32];
+#else
+/*********************************************************************
+ * @fn      RpcEcho
+ *
+ * @brief   Command 0: returns the request payload.
+ *
+ * @return  RPC_STATUS_SUCCESS
+ */
+static uint8_t RpcEcho(const uint8_t *request, uint8_t length, uint8_t *response, uint8_t *responseLength)
+{
+    for (uint8_t index = 0; index < length; index++)
+        response[index] = request[index];
+
+    *responseLength = length;
+    return RPC_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      RpcAdd
+ *
+ * @brief   Command 1: adds two 32-bit numbers.
+ *
+ * @return  RPC_STATUS_SUCCESS
+ */
+static uint8_t RpcAdd(const uint8_t *request, uint8_t length, uint8_t *response, uint8_t *responseLength)
+{
+    (void)length;
+
+    RPC_PutU32(response, RPC_GetU32(&request[0]) + RPC_GetU32(&request[4]));
+    *responseLength = 4;
+    return RPC_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      RpcStats
+ *
+ * @brief   Command 2: returns the RPC frame counters.
+ *
+ * @return  RPC_STATUS_SUCCESS
+ */
+static uint8_t RpcStats(const uint8_t *request, uint8_t length, uint8_t *response, uint8_t *responseLength)
+{
+    RPC_STATS stats;
+
+    (void)request;
+    (void)length;
+
+    RPC_GetStats(&stats);
+    RPC_PutU32(&response[0], stats.requests);
+    RPC_PutU32(&response[4], stats.crcErrors);
+    RPC_PutU32(&response[8], stats.overflows);
+    *responseLength = 12;
+    return RPC_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+ * @fn      RpcUptime
+ *
+ * @brief   Command 3: returns the milliseconds since reset.
+ *
+ * @return  RPC_STATUS_SUCCESS
+ */
+static uint8_t RpcUptime(const uint8_t *request, uint8_t length, uint8_t *response, uint8_t *responseLength)
+{
+    (void)request;
+    (void)length;
+
+    RPC_PutU32(response, (uint32_t)SYSTICK_GetMillis());
+    *responseLength = 4;
+    return RPC_STATUS_SUCCESS;
+}
+
+static const RPC_COMMAND rpcCommands[] = {
+    {RpcEcho, 0, RPC_PAYLOAD_SIZE},
+    {RpcAdd, 8, 8},
+    {RpcStats, 0, 0},
+    {RpcUptime, 0, 0}};
+#endif
 
 /*********************************************************************
  * @fn      main
@@ -44,5 +376,129 @@ int main(void)
 
     GPIO_Init(GPIOC, GPIO_PIN_4, MODE_OUTPUT_MODE_SPEED_50MHZ, OUTPUT_MODE_MULTIPLEXED_FUNCTION_PUSH_PULL, PIN_DEFAULT);
 
-    while (1);
+    SYSTICK_Init();
+    USART_Init(MAIN_BAUD_RATE);
+
+#if MAIN_SCHED_BENCH
+    LATENCY_Init();
+    SCHED_Init();
+    SCHED_CreateTask(1, BenchLowTask, PREEMPT_Msk | SUBPRIO_Msk);
+    SCHED_CreateTask(2, BenchSyncTask, PREEMPT_Msk | SUBPRIO_Msk);
+    SCHED_CreateTask(3, BenchHighTask, SUBPRIO_Msk);
+
+    while (1)
+    {
+        LATENCY_Reset(&benchPost);
+        LATENCY_Reset(&benchSync);
+        LATENCY_Reset(&benchPreempt);
+
+        for (uint16_t sample = 0; sample < MAIN_BENCH_SAMPLES; sample++)
+        {
+            LATENCY_MarkTrigger();
+            SCHED_Post(1, 0);
+            SCHED_Post(1, 1);
+        }
+
+        LATENCY_Dump(&benchPost, BenchPutChar);
+        LATENCY_Dump(&benchSync, BenchPutChar);
+        LATENCY_Dump(&benchPreempt, BenchPutChar);
+
+        SYSTICK_DelayMillis(1000);
+    }
+#elif MAIN_HIGHCODE_BENCH
+    EXTI_RegisterCallback(EXTI_INT_EVEN_MR0, BenchExtiCallback);
+    EXTI_InterruptInit(EXTI_INT_EVEN_ENABLE, EXTI_INT_EVEN_MR0);
+    PFIC_EnableIRQ(PFIC_IRQ_EXTI7_0);
+
+    while (1)
+    {
+        BenchHighcode(RCC_SYSCLK_HSI, "24 MHz 0 WS\r\n");
+        BenchHighcode(RCC_SYSCLK_PLL, "48 MHz 1 WS\r\n");
+
+        SYSTICK_DelayMillis(1000);
+    }
+#elif MAIN_SWTIMER_BENCH
+    LATENCY_Init();
+    SWTIMER_Init();
+
+    for (uint8_t id = 0; id < SWTIMER_COUNT; id++)
+        SWTIMER_Create(BenchTimerCallback, id);
+
+    while (1)
+    {
+        LATENCY_Reset(&benchStart);
+        LATENCY_Reset(&benchExpireOne);
+        LATENCY_Reset(&benchExpireAll);
+
+        for (uint16_t sample = 0; sample < MAIN_BENCH_SAMPLES; sample++)
+        {
+            uint8_t id = sample % SWTIMER_COUNT;
+
+            // One timer per slot, then restart one of them while all run
+            for (uint8_t other = 0; other < SWTIMER_COUNT; other++)
+                SWTIMER_Start(other, 100 + other, 0);
+
+            LATENCY_MarkTrigger();
+            SWTIMER_Start(id, 2, 0);
+            LATENCY_MarkEntry(&benchStart);
+
+            benchFired = 0;
+            BenchWaitFired(&benchExpireOne, 1);
+
+            // Every timer due in the same millisecond
+            for (uint8_t other = 0; other < SWTIMER_COUNT; other++)
+                SWTIMER_Start(other, 2, 0);
+
+            benchFired = 0;
+            BenchWaitFired(&benchExpireAll, SWTIMER_COUNT);
+        }
+
+        BenchPutString("SWTIMER_Start ");
+        LATENCY_Dump(&benchStart, BenchPutChar);
+        BenchPutString("expiry of 1 ");
+        LATENCY_Dump(&benchExpireOne, BenchPutChar);
+        BenchPutString("expiry of 32 ");
+        LATENCY_Dump(&benchExpireAll, BenchPutChar);
+
+        SYSTICK_DelayMillis(1000);
+    }
+#elif MAIN_RPC
+    RPC_Init(rpcCommands, sizeof(rpcCommands) / sizeof(rpcCommands[0]));
+
+    while (1)
+        RPC_Poll();
+#elif USART_RX_DMA
+    while (1)
+    {
+        USART_RX_VIEW view;
+
+        // Echo the bytes in place; a view is released once all of it is queued
+        if (USART_PeekRxView(&view) == USART_STATUS_SUCCESS)
+        {
+            echoSent += USART_Write(USART_GetRxDmaBuffer() + view.offset + echoSent, view.length - echoSent);
+
+            if (echoSent == view.length)
+            {
+                USART_ReleaseRxView();
+                echoSent = 0;
+            }
+        }
+
+        SYSTICK_DelayMicros(MAIN_BUSY_US);
+    }
+#else
+    while (1)
+    {
+        // Never take more than the TX ring can echo back
+        uint16_t count = USART_GetTxFree();
+
+        if (count > sizeof(echoBuffer))
+            count = sizeof(echoBuffer);
+
+        count = USART_Read(echoBuffer, count);
+        USART_Write(echoBuffer, count);
+
+        SYSTICK_DelayMicros(MAIN_BUSY_US);
+    }
+#endif
 }